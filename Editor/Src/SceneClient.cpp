@@ -116,7 +116,9 @@ namespace Editor::Internal {
 
         Runtime::AssetPtr<Runtime::StaticMesh> mesh = new Runtime::StaticMesh(cubeMeshUri);
         mesh->SetMaterial(inMaterial);
-        mesh->EmplaceLOD().vertices = BuildCubeVertices();
+        auto& lod = mesh->EmplaceLOD();
+        lod.vertices = BuildCubeVertices();
+        lod.UpdateBounds();
         SaveAsset(mesh);
         return mesh;
     }
@@ -0,0 +1,137 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Common/Math/Adapters.h>
+#include <Common/Serialization.h>
+
+namespace Common::SerializationBenchmark::Internal {
+    static constexpr size_t blobBytes = 64 * 1024 * 1024;
+    // a stream endian different from the native one, which forces every element to be swapped
+    static constexpr std::endian swappedEndian = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+
+    enum class SerializeMode : uint8_t {
+        perElement,
+        bulk,
+        max
+    };
+
+    template <typename T>
+    static std::vector<T> MakeBlob()
+    {
+        std::vector<T> result(blobBytes / sizeof(T));
+        for (auto i = 0; i < result.size(); i++) {
+            result[i] = T(static_cast<uint8_t>(i * 31));
+        }
+        return result;
+    }
+
+    // the previous Serializer<std::vector<T>>, one stream call per element
+    template <typename T>
+    static void SerializePerElement(BinarySerializeStream& inStream, const std::vector<T>& inValue)
+    {
+        Serializer<uint64_t>::Serialize(inStream, static_cast<uint64_t>(inValue.size()));
+        for (const auto& element : inValue) {
+            Serializer<T>::Serialize(inStream, element);
+        }
+    }
+
+    template <typename T>
+    static void DeserializePerElement(BinaryDeserializeStream& inStream, std::vector<T>& outValue)
+    {
+        outValue.clear();
+        uint64_t size;
+        Serializer<uint64_t>::Deserialize(inStream, size);
+        outValue.reserve(size);
+        for (auto i = 0; i < size; i++) {
+            T element;
+            Serializer<T>::Deserialize(inStream, element);
+            outValue.emplace_back(std::move(element));
+        }
+    }
+
+    template <typename T, SerializeMode M, std::endian E>
+    static void SerializeBlob(benchmark::State& state)
+    {
+        const auto blob = MakeBlob<T>();
+        std::vector<uint8_t> bytes;
+        bytes.reserve(blobBytes + sizeof(uint64_t));
+
+        for (auto _ : state) {
+            bytes.clear();
+            MemorySerializeStream<E> stream(bytes);
+            if constexpr (M == SerializeMode::perElement) {
+                SerializePerElement(stream, blob);
+            } else {
+                Serializer<std::vector<T>>::Serialize(stream, blob);
+            }
+            benchmark::DoNotOptimize(bytes.data());
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(blobBytes));
+    }
+
+    template <typename T, SerializeMode M, std::endian E>
+    static void DeserializeBlob(benchmark::State& state)
+    {
+        std::vector<uint8_t> bytes;
+        {
+            MemorySerializeStream<E> stream(bytes);
+            Serializer<std::vector<T>>::Serialize(stream, MakeBlob<T>());
+        }
+
+        std::vector<T> blob;
+        for (auto _ : state) {
+            MemoryDeserializeStream<E> stream(bytes);
+            if constexpr (M == SerializeMode::perElement) {
+                DeserializePerElement(stream, blob);
+            } else {
+                Serializer<std::vector<T>>::Deserialize(stream, blob);
+            }
+            benchmark::DoNotOptimize(blob.data());
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(blobBytes));
+    }
+
+    static void RegisterBenchmarkCase(std::string_view inCaseName, void (*inFunction)(benchmark::State&))
+    {
+        std::string name = "Common::SerializationBenchmark::";
+        name.append(inCaseName);
+
+        benchmark::RegisterBenchmark(name.c_str(), inFunction)
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    }
+
+    template <typename T>
+    static void RegisterBlobCases(std::string_view inTypeName)
+    {
+        const auto registerCase = [&](std::string_view inCaseName, void (*inFunction)(benchmark::State&)) -> void {
+            std::string name(inCaseName);
+            name.append("/");
+            name.append(inTypeName);
+            RegisterBenchmarkCase(name, inFunction);
+        };
+
+        registerCase("SerializePerElement", &SerializeBlob<T, SerializeMode::perElement, std::endian::native>);
+        registerCase("SerializeBulk", &SerializeBlob<T, SerializeMode::bulk, std::endian::native>);
+        registerCase("SerializePerElementSwapped", &SerializeBlob<T, SerializeMode::perElement, swappedEndian>);
+        registerCase("SerializeBulkSwapped", &SerializeBlob<T, SerializeMode::bulk, swappedEndian>);
+        registerCase("DeserializePerElement", &DeserializeBlob<T, SerializeMode::perElement, std::endian::native>);
+        registerCase("DeserializeBulk", &DeserializeBlob<T, SerializeMode::bulk, std::endian::native>);
+        registerCase("DeserializePerElementSwapped", &DeserializeBlob<T, SerializeMode::perElement, swappedEndian>);
+        registerCase("DeserializeBulkSwapped", &DeserializeBlob<T, SerializeMode::bulk, swappedEndian>);
+    }
+
+    const bool benchmarksRegistered = []() -> bool {
+        // texture pixel blobs and mesh position streams
+        RegisterBlobCases<uint8_t>("UInt8");
+        RegisterBlobCases<FVec3>("FVec3");
+        return true;
+    }();
+}
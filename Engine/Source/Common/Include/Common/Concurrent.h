@@ -4,14 +4,21 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <queue>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
 #include <future>
 #include <functional>
 #include <type_traits>
+#include <utility>
 
 #include <Common/Debug.h>
 #include <Common/Memory.h>
@@ -70,6 +77,96 @@ namespace Common {
         NamedThread thread;
         std::queue<std::function<void()>> tasks;
     };
+
+    // move-only type-erased void() callable, callables up to InlineSize bytes are stored inline without heap allocation
+    template <size_t InlineSize>
+    class InlineTask {
+    public:
+        InlineTask();
+        template <typename F> requires (!std::is_same_v<std::decay_t<F>, InlineTask>) && std::is_invocable_v<std::decay_t<F>&> InlineTask(F&& inFunc); // NOLINT
+        InlineTask(InlineTask&& inOther) noexcept;
+        ~InlineTask();
+        NonCopyable(InlineTask)
+
+        InlineTask& operator=(InlineTask&& inOther) noexcept;
+        void operator()();
+        explicit operator bool() const;
+
+    private:
+        struct VTable {
+            void(*invoke)(void*);
+            void(*moveConstruct)(void*, void*);
+            void(*destruct)(void*);
+        };
+
+        template <typename F> static constexpr bool storeInline = sizeof(F) <= InlineSize && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+        template <typename F> static const VTable* GetVTable();
+        void Reset();
+
+        alignas(std::max_align_t) uint8_t storage[InlineSize];
+        const VTable* vtable;
+    };
+
+    // bounded lock-free multi-producer single-consumer ring buffer, capacity must be a power of two
+    template <typename T>
+    class MpscRingBuffer {
+    public:
+        explicit MpscRingBuffer(size_t inCapacity);
+        ~MpscRingBuffer();
+        NonCopyable(MpscRingBuffer)
+        NonMovable(MpscRingBuffer)
+
+        // producers, returns false and leave inValue untouched when the buffer is full
+        bool TryPush(T&& inValue);
+        // consumer only
+        bool TryPop(T& outValue);
+        size_t Capacity() const;
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            alignas(T) uint8_t storage[sizeof(T)];
+        };
+
+        size_t mask;
+        std::unique_ptr<Cell[]> cells;
+        alignas(64) std::atomic<size_t> enqueuePos;
+        alignas(64) size_t dequeuePos;
+    };
+
+    // a dedicated thread consuming commands from a lock-free ring buffer, submitting a small command does not allocate,
+    // fences are monotonic tokens which can be waited without allocating either
+    class CommandThread {
+    public:
+        using Fence = uint64_t;
+        using Task = InlineTask<64>;
+
+        CommandThread(const std::string& inName, size_t inCapacity);
+        ~CommandThread();
+        NonCopyable(CommandThread)
+        NonMovable(CommandThread)
+
+        template <typename F> void EmplaceTask(F&& inTask);
+        template <typename F> auto EmplaceTaskWithFuture(F&& inTask);
+        Fence EmplaceFence();
+        bool IsFenceCompleted(Fence inFence) const;
+        void WaitFence(Fence inFence);
+        void Flush();
+
+    private:
+        void Push(Task&& inTask);
+        void CompleteFence(Fence inFence);
+
+        MpscRingBuffer<Task> queue;
+        std::atomic<bool> stop;
+        std::atomic<bool> sleeping;
+        std::atomic<Fence> nextFence;
+        std::atomic<Fence> completedFence;
+        std::mutex mutex;
+        std::condition_variable taskCondition;
+        std::condition_variable fenceCondition;
+        NamedThread thread;
+    };
 }
 
 namespace Common {
@@ -132,4 +229,184 @@ namespace Common {
         taskCondition.notify_one();
         return result;
     }
+
+    template <size_t InlineSize>
+    InlineTask<InlineSize>::InlineTask()
+        : storage()
+        , vtable(nullptr)
+    {
+    }
+
+    template <size_t InlineSize>
+    template <typename F> requires (!std::is_same_v<std::decay_t<F>, InlineTask<InlineSize>>) && std::is_invocable_v<std::decay_t<F>&>
+    InlineTask<InlineSize>::InlineTask(F&& inFunc)
+        : vtable(GetVTable<std::decay_t<F>>())
+    {
+        using Func = std::decay_t<F>;
+        if constexpr (storeInline<Func>) {
+            new (storage) Func(std::forward<F>(inFunc));
+        } else {
+            new (storage) Func*(new Func(std::forward<F>(inFunc)));
+        }
+    }
+
+    template <size_t InlineSize>
+    InlineTask<InlineSize>::InlineTask(InlineTask&& inOther) noexcept
+        : vtable(std::exchange(inOther.vtable, nullptr))
+    {
+        if (vtable != nullptr) {
+            vtable->moveConstruct(storage, inOther.storage);
+        }
+    }
+
+    template <size_t InlineSize>
+    InlineTask<InlineSize>::~InlineTask()
+    {
+        Reset();
+    }
+
+    template <size_t InlineSize>
+    InlineTask<InlineSize>& InlineTask<InlineSize>::operator=(InlineTask&& inOther) noexcept
+    {
+        if (this != &inOther) {
+            Reset();
+            vtable = std::exchange(inOther.vtable, nullptr);
+            if (vtable != nullptr) {
+                vtable->moveConstruct(storage, inOther.storage);
+            }
+        }
+        return *this;
+    }
+
+    template <size_t InlineSize>
+    void InlineTask<InlineSize>::operator()()
+    {
+        Assert(vtable != nullptr);
+        vtable->invoke(storage);
+    }
+
+    template <size_t InlineSize>
+    InlineTask<InlineSize>::operator bool() const
+    {
+        return vtable != nullptr;
+    }
+
+    template <size_t InlineSize>
+    template <typename F>
+    const typename InlineTask<InlineSize>::VTable* InlineTask<InlineSize>::GetVTable()
+    {
+        // moveConstruct always destructs the source, a moved-from task is empty
+        if constexpr (storeInline<F>) {
+            static constexpr VTable vtable = {
+                [](void* inStorage) -> void { (*std::launder(static_cast<F*>(inStorage)))(); },
+                [](void* inDst, void* inSrc) -> void {
+                    F* src = std::launder(static_cast<F*>(inSrc));
+                    new (inDst) F(std::move(*src));
+                    src->~F();
+                },
+                [](void* inStorage) -> void { std::launder(static_cast<F*>(inStorage))->~F(); }
+            };
+            return &vtable;
+        } else {
+            static constexpr VTable vtable = {
+                [](void* inStorage) -> void { (**std::launder(static_cast<F**>(inStorage)))(); },
+                [](void* inDst, void* inSrc) -> void { new (inDst) F*(*std::launder(static_cast<F**>(inSrc))); },
+                [](void* inStorage) -> void { delete *std::launder(static_cast<F**>(inStorage)); }
+            };
+            return &vtable;
+        }
+    }
+
+    template <size_t InlineSize>
+    void InlineTask<InlineSize>::Reset()
+    {
+        if (vtable != nullptr) {
+            vtable->destruct(storage);
+            vtable = nullptr;
+        }
+    }
+
+    template <typename T>
+    MpscRingBuffer<T>::MpscRingBuffer(size_t inCapacity)
+        : mask(inCapacity - 1)
+        , cells(std::make_unique<Cell[]>(inCapacity))
+        , enqueuePos(0)
+        , dequeuePos(0)
+    {
+        Assert(inCapacity >= 2 && (inCapacity & (inCapacity - 1)) == 0);
+        for (size_t i = 0; i < inCapacity; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    MpscRingBuffer<T>::~MpscRingBuffer()
+    {
+        T value;
+        while (TryPop(value)) {}
+    }
+
+    template <typename T>
+    bool MpscRingBuffer<T>::TryPush(T&& inValue)
+    {
+        Cell* cell;
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells[pos & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->storage) T(std::move(inValue));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool MpscRingBuffer<T>::TryPop(T& outValue)
+    {
+        Cell& cell = cells[dequeuePos & mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(dequeuePos + 1) < 0) {
+            return false;
+        }
+
+        T* value = std::launder(reinterpret_cast<T*>(cell.storage));
+        outValue = std::move(*value);
+        value->~T();
+        cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        dequeuePos++;
+        return true;
+    }
+
+    template <typename T>
+    size_t MpscRingBuffer<T>::Capacity() const
+    {
+        return mask + 1;
+    }
+
+    template <typename F>
+    void CommandThread::EmplaceTask(F&& inTask)
+    {
+        Push(Task(std::forward<F>(inTask)));
+    }
+
+    template <typename F>
+    auto CommandThread::EmplaceTaskWithFuture(F&& inTask)
+    {
+        using RetType = std::invoke_result_t<F>;
+        auto packagedTask = Common::MakeShared<std::packaged_task<RetType()>>(std::forward<F>(inTask));
+        auto result = packagedTask->get_future();
+        Push(Task([packagedTask]() -> void { (*packagedTask)(); }));
+        return result;
+    }
 }
@@ -4,11 +4,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include <rapidjson/document.h>
 
 #include <Common/Result.h>
+#include <Common/Utility.h>
 
 namespace Common {
     class FileUtils {
@@ -18,4 +20,41 @@ namespace Common {
         static Result<rapidjson::Document, std::string> ReadJsonFile(const std::string& inFileName);
         static Result<void, std::string> WriteJsonFile(const std::string& inFileName, const rapidjson::Document& inJsonDocument, bool inPretty = true);
     };
+
+    enum class MappedFileAccess : uint8_t {
+        normal,
+        sequential,
+        random,
+        max
+    };
+
+    // read only mapping of a whole file, the bytes are served from the page cache without copying into user buffers
+    class MappedFile {
+    public:
+        NonCopyable(MappedFile)
+        MappedFile();
+        explicit MappedFile(const std::string& inFileName);
+        ~MappedFile();
+
+        MappedFile(MappedFile&& inOther) noexcept;
+        MappedFile& operator=(MappedFile&& inOther) noexcept;
+
+        bool IsMapped() const;
+        const uint8_t* Data() const;
+        size_t Size() const;
+        // hints for the kernel read ahead, prefetch ranges are expanded to whole pages
+        void Advise(MappedFileAccess inAccess) const;
+        void Prefetch(size_t inOffset, size_t inSize) const;
+
+    private:
+        void Unmap();
+
+        bool mapped;
+        const uint8_t* data;
+        size_t size;
+#if PLATFORM_WINDOWS
+        void* nativeFile;
+        void* nativeMapping;
+#endif
+    };
 }
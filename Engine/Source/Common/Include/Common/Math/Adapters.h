@@ -30,6 +30,14 @@ namespace Common {
         }
     };
 
+    template <std::endian E>
+    requires (sizeof(HalfFloat<E>) == sizeof(uint16_t))
+    struct BulkSerializer<HalfFloat<E>> {
+        static constexpr bool enabled = true;
+        static constexpr size_t scalarNum = 1;
+        using Scalar = uint16_t;
+    };
+
     template <std::endian E>
     struct StringConverter<HalfFloat<E>> {
         static std::string ToString(const HalfFloat<E>& inValue)
@@ -76,6 +84,14 @@ namespace Common {
         }
     };
 
+    template <CppArithmetic T, uint8_t L, MathBackend B>
+    requires (sizeof(Vec<T, L, B>) == sizeof(T) * L)
+    struct BulkSerializer<Vec<T, L, B>> {
+        static constexpr bool enabled = true;
+        static constexpr size_t scalarNum = L;
+        using Scalar = T;
+    };
+
     template <StringConvertible T, uint8_t L, MathBackend B>
     struct StringConverter<Vec<T, L, B>> {
         static std::string ToString(const Vec<T, L, B>& inValue)
@@ -140,6 +156,14 @@ namespace Common {
         }
     };
 
+    template <CppArithmetic T, uint8_t R, uint8_t C, MathBackend B>
+    requires (sizeof(Mat<T, R, C, B>) == sizeof(T) * R * C)
+    struct BulkSerializer<Mat<T, R, C, B>> {
+        static constexpr bool enabled = true;
+        static constexpr size_t scalarNum = R * C;
+        using Scalar = T;
+    };
+
     template <StringConvertible T, uint8_t R, uint8_t C, MathBackend B>
     struct StringConverter<Mat<T, R, C, B>> {
         static std::string ToString(const Mat<T, R, C, B>& inValue)
@@ -59,6 +59,9 @@ namespace Common::Simd {
     inline float LengthSquared(F32x4 v) { return Dot(v, v); }
     inline float MaxValue(F32x4 v) { return std::max(std::max(v.lanes[0], v.lanes[1]), std::max(v.lanes[2], v.lanes[3])); }
     inline F32x4 Set(float x, float y, float z, float w) { return { x, y, z, w }; }
+    inline F32x4 CmpGe(F32x4 a, F32x4 b) { return { a.lanes[0] >= b.lanes[0] ? 1.0f : 0.0f, a.lanes[1] >= b.lanes[1] ? 1.0f : 0.0f, a.lanes[2] >= b.lanes[2] ? 1.0f : 0.0f, a.lanes[3] >= b.lanes[3] ? 1.0f : 0.0f }; }
+    inline F32x4 And(F32x4 a, F32x4 b) { return Mul(a, b); }
+    inline int MoveMask(F32x4 v) { return (v.lanes[0] != 0.0f ? 1 : 0) | (v.lanes[1] != 0.0f ? 2 : 0) | (v.lanes[2] != 0.0f ? 4 : 0) | (v.lanes[3] != 0.0f ? 8 : 0); }
 
     template <int L>
     inline F32x4 Splat(F32x4 v) { return Set1(v.lanes[L]); }
@@ -119,6 +122,11 @@ namespace Common::Simd {
 
     inline F32x4 Set(float x, float y, float z, float w) { return _mm_set_ps(w, z, y, x); }
 
+    // lane masks, CmpGe sets every bit of a lane where a >= b, MoveMask packs the top bit of each lane into bits 0..3
+    inline F32x4 CmpGe(F32x4 a, F32x4 b) { return _mm_cmpge_ps(a, b); }
+    inline F32x4 And(F32x4 a, F32x4 b) { return _mm_and_ps(a, b); }
+    inline int MoveMask(F32x4 v) { return _mm_movemask_ps(v); }
+
     template <int L>
     inline F32x4 Splat(F32x4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(L, L, L, L)); }
 
@@ -181,6 +189,17 @@ namespace Common::Simd {
         return vld1q_f32(values);
     }
 
+    // lane masks, CmpGe sets every bit of a lane where a >= b, MoveMask packs the top bit of each lane into bits 0..3
+    inline F32x4 CmpGe(F32x4 a, F32x4 b) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+    inline F32x4 And(F32x4 a, F32x4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+
+    inline int MoveMask(F32x4 v)
+    {
+        static constexpr int32_t shifts[4] = { 0, 1, 2, 3 };
+        const uint32x4_t signs = vshrq_n_u32(vreinterpretq_u32_f32(v), 31);
+        return static_cast<int>(vaddvq_u32(vshlq_u32(signs, vld1q_s32(shifts))));
+    }
+
     template <int L>
     inline F32x4 Splat(F32x4 v) { return vdupq_n_f32(vgetq_lane_f32(v, L)); }
 
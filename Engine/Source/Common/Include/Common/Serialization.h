@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <cmath>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <optional>
+#include <span>
 #include <array>
 #include <vector>
 #include <list>
@@ -34,6 +37,7 @@ namespace Common {
         virtual ~BinarySerializeStream();
 
         template <CppArithmetic T> void Write(const T& value);
+        template <CppArithmetic T> void Write(const T* values, size_t count);
         virtual void Seek(int64_t offset) = 0;
         virtual size_t Loc() = 0;
         virtual std::endian Endian() = 0;
@@ -50,9 +54,13 @@ namespace Common {
         virtual ~BinaryDeserializeStream();
 
         template <CppArithmetic T> void Read(T& value);
+        template <CppArithmetic T> void Read(T* values, size_t count);
         virtual void Seek(int64_t offset) = 0;
         virtual size_t Loc() = 0;
         virtual std::endian Endian() = 0;
+        // consumes size bytes as a view into the storage behind the stream, valid while the stream lives, returns empty
+        // and consumes nothing when the stream is not backed by memory
+        virtual std::optional<std::span<const uint8_t>> ReadView(size_t size);
 
     protected:
         BinaryDeserializeStream();
@@ -128,6 +136,7 @@ namespace Common {
         void Seek(int64_t offset) override;
         std::endian Endian() override;
         size_t Loc() override;
+        std::optional<std::span<const uint8_t>> ReadView(size_t size) override;
 
     protected:
         void ReadInternal(void* data, size_t size) override;
@@ -137,6 +146,59 @@ namespace Common {
         const std::vector<uint8_t>& bytes;
     };
 
+    // reads are pointer bumps over a read only mapping of the file, prefetched a window ahead of the read location
+    template <std::endian E = std::endian::little>
+    class MappedFileDeserializeStream final : public BinaryDeserializeStream {
+    public:
+        NonCopyable(MappedFileDeserializeStream)
+        explicit MappedFileDeserializeStream(const std::string& inFileName);
+        ~MappedFileDeserializeStream() override;
+
+        void Seek(int64_t offset) override;
+        size_t Loc() override;
+        std::endian Endian() override;
+        std::optional<std::span<const uint8_t>> ReadView(size_t size) override;
+        bool IsMapped() const;
+
+    protected:
+        void ReadInternal(void* data, size_t size) override;
+
+    private:
+        void PrefetchFor(size_t inSize);
+
+        MappedFile file;
+        size_t pointer;
+        size_t prefetched;
+    };
+
+    // reads bytes that may be truncated or corrupt, e.g. cache files. a read past the end fails the stream instead of
+    // asserting, it zero fills its output and every later read fails as well, so a parser checks Failed() once at the end.
+    // length prefixes go through ReadLength() so a corrupt length never drives an allocation or a loop
+    template <std::endian E = std::endian::little>
+    class BoundedDeserializeStream final : public BinaryDeserializeStream {
+    public:
+        NonCopyable(BoundedDeserializeStream)
+        explicit BoundedDeserializeStream(std::span<const uint8_t> inBytes);
+        ~BoundedDeserializeStream() override;
+
+        void Seek(int64_t offset) override;
+        size_t Loc() override;
+        std::endian Endian() override;
+        std::optional<std::span<const uint8_t>> ReadView(size_t size) override;
+        // reads a uint64_t element count, fails the stream unless that many elements of inElementSize bytes fit in the rest
+        bool ReadLength(uint64_t& outLength, size_t inElementSize = 1);
+        size_t Remaining() const;
+        bool Failed() const;
+
+    protected:
+        void ReadInternal(void* data, size_t size) override;
+
+    private:
+        std::span<const uint8_t> bytes;
+        size_t pointer;
+        bool failed;
+    };
+
     template <typename T> struct Serializer {};
     template <typename T> concept Serializable = requires(T inValue, BinarySerializeStream& serializeStream, BinaryDeserializeStream& deserializeStream)
     {
@@ -145,6 +207,13 @@ namespace Common {
         { Serializer<T>::Deserialize(deserializeStream, inValue) } -> std::convertible_to<size_t>;
     };
 
+    // element types whose serialized bytes are their in memory bytes, scalarNum values of Scalar each, containers of them
+    // are written and read with one stream call instead of one call per element
+    template <typename T> struct BulkSerializer {
+        static constexpr bool enabled = false;
+    };
+    template <typename T> concept BulkSerializable = Serializable<T> && BulkSerializer<T>::enabled;
+
     template <Serializable T> struct FieldSerializer;
 
     template <typename T> size_t Serialize(BinarySerializeStream& inStream, const T& inValue);
@@ -187,6 +256,11 @@ namespace Common {
     }; \
 
 namespace Common::Internal {
+    // read ahead window of mapped file streams, large enough to keep the disk busy while the previous window is parsed
+    constexpr size_t mappedStreamPrefetchBytes = 4 * 1024 * 1024;
+    // scratch size used to swap the endian of bulk writes, swapping a whole blob at once would double its memory footprint
+    constexpr size_t bulkSwapChunkBytes = 4096;
+
     inline std::vector<uint8_t> SwapEndian(const void* data, const size_t size)
     {
         std::vector<uint8_t> result;
@@ -220,6 +294,25 @@ namespace Common {
         }
     }
 
+    template <CppArithmetic T>
+    void BinarySerializeStream::Write(const T* values, size_t count)
+    {
+        if (sizeof(T) == 1 || std::endian::native == Endian()) {
+            WriteInternal(values, sizeof(T) * count);
+            return;
+        }
+
+        std::array<T, Internal::bulkSwapChunkBytes / sizeof(T)> chunk;
+        for (size_t begin = 0; begin < count; begin += chunk.size()) {
+            const auto chunkCount = std::min(chunk.size(), count - begin);
+            memcpy(chunk.data(), values + begin, sizeof(T) * chunkCount);
+            for (auto i = 0; i < chunkCount; i++) {
+                Internal::SwapEndianInplace(&chunk[i], sizeof(T));
+            }
+            WriteInternal(chunk.data(), sizeof(T) * chunkCount);
+        }
+    }
+
     template <CppArithmetic T>
     void BinaryDeserializeStream::Read(T& value)
     {
@@ -229,6 +322,18 @@ namespace Common {
         }
     }
 
+    template <CppArithmetic T>
+    void BinaryDeserializeStream::Read(T* values, size_t count)
+    {
+        ReadInternal(values, sizeof(T) * count);
+        if (sizeof(T) == 1 || std::endian::native == Endian()) {
+            return;
+        }
+        for (auto i = 0; i < count; i++) {
+            Internal::SwapEndianInplace(values + i, sizeof(T));
+        }
+    }
+
     template <std::endian E>
     BinaryFileSerializeStream<E>::BinaryFileSerializeStream(const std::string& inFileName)
     {
@@ -416,6 +521,173 @@ namespace Common {
         return E;
     }
 
+    template <std::endian E>
+    std::optional<std::span<const uint8_t>> MemoryDeserializeStream<E>::ReadView(const size_t size)
+    {
+        const auto newPointer = pointer + size;
+        Assert(newPointer <= bytes.size());
+        const std::span result(bytes.data() + pointer, size);
+        pointer = newPointer;
+        return result;
+    }
+
+    template <std::endian E>
+    MappedFileDeserializeStream<E>::MappedFileDeserializeStream(const std::string& inFileName)
+        : file(inFileName)
+        , pointer(0)
+        , prefetched(0)
+    {
+        file.Advise(MappedFileAccess::sequential);
+        PrefetchFor(0);
+    }
+
+    template <std::endian E>
+    MappedFileDeserializeStream<E>::~MappedFileDeserializeStream() = default;
+
+    template <std::endian E>
+    void MappedFileDeserializeStream<E>::ReadInternal(void* data, const size_t size)
+    {
+        const auto newPointer = pointer + size;
+        Assert(newPointer <= file.Size());
+        PrefetchFor(size);
+        memcpy(data, file.Data() + pointer, size);
+        pointer = newPointer;
+    }
+
+    template <std::endian E>
+    void MappedFileDeserializeStream<E>::Seek(int64_t offset)
+    {
+        pointer += offset;
+    }
+
+    template <std::endian E>
+    size_t MappedFileDeserializeStream<E>::Loc()
+    {
+        return pointer;
+    }
+
+    template <std::endian E>
+    std::endian MappedFileDeserializeStream<E>::Endian()
+    {
+        return E;
+    }
+
+    template <std::endian E>
+    std::optional<std::span<const uint8_t>> MappedFileDeserializeStream<E>::ReadView(const size_t size)
+    {
+        const auto newPointer = pointer + size;
+        Assert(newPointer <= file.Size());
+        PrefetchFor(size);
+        const std::span result(file.Data() + pointer, size);
+        pointer = newPointer;
+        return result;
+    }
+
+    template <std::endian E>
+    bool MappedFileDeserializeStream<E>::IsMapped() const
+    {
+        return file.IsMapped();
+    }
+
+    template <std::endian E>
+    void MappedFileDeserializeStream<E>::PrefetchFor(size_t inSize)
+    {
+        // keeps up to one window hinted past the end of the current read, and only hints again once less than half of it
+        // is left, so small reads do not cost a syscall each
+        if (pointer + inSize + Internal::mappedStreamPrefetchBytes / 2 <= prefetched) {
+            return;
+        }
+        const auto begin = std::max(pointer, prefetched);
+        const auto end = std::min(file.Size(), pointer + inSize + Internal::mappedStreamPrefetchBytes);
+        if (begin >= end) {
+            return;
+        }
+        file.Prefetch(begin, end - begin);
+        prefetched = end;
+    }
+
+    template <std::endian E>
+    BoundedDeserializeStream<E>::BoundedDeserializeStream(std::span<const uint8_t> inBytes)
+        : bytes(inBytes)
+        , pointer(0)
+        , failed(false)
+    {
+    }
+
+    template <std::endian E>
+    BoundedDeserializeStream<E>::~BoundedDeserializeStream() = default;
+
+    template <std::endian E>
+    void BoundedDeserializeStream<E>::ReadInternal(void* data, const size_t size)
+    {
+        if (failed || size > Remaining()) {
+            failed = true;
+            memset(data, 0, size);
+            return;
+        }
+        memcpy(data, bytes.data() + pointer, size);
+        pointer += size;
+    }
+
+    template <std::endian E>
+    void BoundedDeserializeStream<E>::Seek(int64_t offset)
+    {
+        if (failed || (offset < 0 ? static_cast<size_t>(-offset) > pointer : static_cast<size_t>(offset) > Remaining())) {
+            failed = true;
+            return;
+        }
+        pointer += offset;
+    }
+
+    template <std::endian E>
+    size_t BoundedDeserializeStream<E>::Loc()
+    {
+        return pointer;
+    }
+
+    template <std::endian E>
+    std::endian BoundedDeserializeStream<E>::Endian()
+    {
+        return E;
+    }
+
+    template <std::endian E>
+    std::optional<std::span<const uint8_t>> BoundedDeserializeStream<E>::ReadView(const size_t size)
+    {
+        if (failed || size > Remaining()) {
+            failed = true;
+            return std::nullopt;
+        }
+        const std::span result(bytes.data() + pointer, size);
+        pointer += size;
+        return result;
+    }
+
+    template <std::endian E>
+    bool BoundedDeserializeStream<E>::ReadLength(uint64_t& outLength, const size_t inElementSize)
+    {
+        Read<uint64_t>(outLength);
+        if (!failed && inElementSize > 0 && outLength > Remaining() / inElementSize) {
+            failed = true;
+        }
+        if (failed) {
+            outLength = 0;
+        }
+        return !failed;
+    }
+
+    template <std::endian E>
+    size_t BoundedDeserializeStream<E>::Remaining() const
+    {
+        return bytes.size() - pointer;
+    }
+
+    template <std::endian E>
+    bool BoundedDeserializeStream<E>::Failed() const
+    {
+        return failed;
+    }
+
     template <typename T>
     size_t Serialize(BinarySerializeStream& inStream, const T& inValue)
     {
@@ -554,6 +826,13 @@ namespace Common {
     IMPL_BASIC_TYPE_SERIALIZER(float)
     IMPL_BASIC_TYPE_SERIALIZER(double)
 
+    template <CppArithmetic T>
+    struct BulkSerializer<T> {
+        static constexpr bool enabled = true;
+        static constexpr size_t scalarNum = 1;
+        using Scalar = T;
+    };
+
     template <>
     struct Serializer<std::string> {
         static constexpr size_t typeId = HashUtils::StrCrc32("std::string");
@@ -565,10 +844,7 @@ namespace Common {
             const uint64_t size = value.size();
             serialized += Serializer<uint64_t>::Serialize(stream, size);
 
-            const auto* data = reinterpret_cast<const uint8_t*>(value.data());
-            for (auto i = 0; i < size; i++) {
-                stream.Write<uint8_t>(data[i]);
-            }
+            stream.Write<uint8_t>(reinterpret_cast<const uint8_t*>(value.data()), size);
 
             serialized += size;
             return serialized;
@@ -582,10 +858,7 @@ namespace Common {
             deserialized += Serializer<uint64_t>::Deserialize(stream, size);
 
             value.resize(size);
-            auto* data = reinterpret_cast<uint8_t*>(value.data());
-            for (auto i = 0; i < size; i++) {
-                stream.Read<uint8_t>(data[i]);
-            }
+            stream.Read<uint8_t>(reinterpret_cast<uint8_t*>(value.data()), size);
 
             deserialized += size;
             return deserialized;
@@ -742,6 +1015,8 @@ namespace Common {
         static constexpr size_t typeId
             = HashUtils::StrCrc32("std::vector")
             + Serializer<T>::typeId;
+        // std::vector<bool> is bit packed and has no contiguous element storage
+        static constexpr bool bulk = BulkSerializable<T> && !std::is_same_v<T, bool>;
 
         static size_t Serialize(BinarySerializeStream& stream, const std::vector<T>& value)
         {
@@ -750,6 +1025,13 @@ namespace Common {
             const uint64_t size = value.size();
             serialized += Serializer<uint64_t>::Serialize(stream, size);
 
+            if constexpr (bulk) {
+                using Scalar = typename BulkSerializer<T>::Scalar;
+                const auto scalarNum = value.size() * BulkSerializer<T>::scalarNum;
+                stream.Write<Scalar>(reinterpret_cast<const Scalar*>(value.data()), scalarNum);
+                return serialized + sizeof(Scalar) * scalarNum;
+            }
+
             for (auto i = 0; i < size; i++) {
                 serialized += Serializer<T>::Serialize(stream, value[i]);
             }
@@ -764,6 +1046,29 @@ namespace Common {
             uint64_t size;
             deserialized += Serializer<uint64_t>::Deserialize(stream, size);
 
+            if constexpr (bulk) {
+                using Scalar = typename BulkSerializer<T>::Scalar;
+                const auto scalarNum = size * BulkSerializer<T>::scalarNum;
+                const auto byteNum = sizeof(Scalar) * scalarNum;
+                // memory backed streams hand the payload out in place, so it is copied once straight into the container
+                if (sizeof(Scalar) == 1 || std::endian::native == stream.Endian()) {
+                    if (const auto view = stream.ReadView(byteNum);
+                        view.has_value()) {
+                        if constexpr (sizeof(T) == 1) {
+                            const auto* begin = reinterpret_cast<const T*>(view->data());
+                            value.assign(begin, begin + size);
+                        } else {
+                            value.resize(size);
+                            memcpy(value.data(), view->data(), byteNum);
+                        }
+                        return deserialized + byteNum;
+                    }
+                }
+                value.resize(size);
+                stream.Read<Scalar>(reinterpret_cast<Scalar*>(value.data()), scalarNum);
+                return deserialized + byteNum;
+            }
+
             value.reserve(size);
             for (auto i = 0; i < size; i++) {
                 T element;
@@ -128,4 +128,113 @@ namespace Common {
             flushCondition.wait(lock);
         }
     }
+
+    CommandThread::CommandThread(const std::string& inName, size_t inCapacity)
+        : queue(inCapacity)
+        , stop(false)
+        , sleeping(false)
+        , nextFence(0)
+        , completedFence(0)
+    {
+        thread = NamedThread(inName, [this]() -> void {
+            Task task;
+            while (true) {
+                if (queue.TryPop(task)) {
+                    task();
+                    task = Task();
+                    continue;
+                }
+                if (stop.load(std::memory_order_acquire)) {
+                    // stop is published after the last push, so an empty pop observed after it means the queue is drained
+                    return;
+                }
+
+                // producers only touch the mutex when they observe the sleeping flag, the seq_cst store paired with the
+                // fence in Push() guarantees either the re-check below sees the new command or the producer sees the flag
+                bool popped;
+                {
+                    std::unique_lock lock(mutex);
+                    sleeping.store(true, std::memory_order_seq_cst);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    popped = queue.TryPop(task);
+                    if (!popped && !stop.load(std::memory_order_acquire)) {
+                        taskCondition.wait(lock, [this]() -> bool { return !sleeping.load(std::memory_order_relaxed); });
+                    }
+                    sleeping.store(false, std::memory_order_relaxed);
+                }
+                if (popped) {
+                    task();
+                    task = Task();
+                }
+            }
+        });
+    }
+
+    CommandThread::~CommandThread()
+    {
+        stop.store(true, std::memory_order_release);
+        {
+            std::unique_lock lock(mutex);
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+        taskCondition.notify_one();
+        thread.Join();
+    }
+
+    CommandThread::Fence CommandThread::EmplaceFence()
+    {
+        // commands pushed before a fence number is taken always sit in front of the fence, and fence numbers grow
+        // monotonically, so completing fence n implies every command submitted before any fence <= n has been executed
+        const Fence fence = nextFence.fetch_add(1, std::memory_order_relaxed) + 1;
+        Push(Task([this, fence]() -> void { CompleteFence(fence); }));
+        return fence;
+    }
+
+    bool CommandThread::IsFenceCompleted(Fence inFence) const
+    {
+        return completedFence.load(std::memory_order_acquire) >= inFence;
+    }
+
+    void CommandThread::WaitFence(Fence inFence)
+    {
+        if (IsFenceCompleted(inFence)) {
+            return;
+        }
+        std::unique_lock lock(mutex);
+        fenceCondition.wait(lock, [this, inFence]() -> bool { return IsFenceCompleted(inFence); });
+    }
+
+    void CommandThread::Flush()
+    {
+        WaitFence(EmplaceFence());
+    }
+
+    void CommandThread::Push(Task&& inTask)
+    {
+        while (!queue.TryPush(std::move(inTask))) {
+            std::this_thread::yield();
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_seq_cst)) {
+            {
+                std::unique_lock lock(mutex);
+                sleeping.store(false, std::memory_order_relaxed);
+            }
+            taskCondition.notify_one();
+        }
+    }
+
+    void CommandThread::CompleteFence(Fence inFence)
+    {
+        // fences from different producers may be consumed out of numeric order, completed fence only moves forward
+        if (inFence <= completedFence.load(std::memory_order_relaxed)) {
+            return;
+        }
+        {
+            std::unique_lock lock(mutex);
+            completedFence.store(inFence, std::memory_order_release);
+        }
+        fenceCondition.notify_all();
+    }
 }
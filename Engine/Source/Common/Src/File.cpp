@@ -2,9 +2,20 @@
 // Created by johnk on 2024/4/14.
 //
 
+#if PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <fstream>
 #include <cstdio>
 #include <format>
+#include <utility>
 
 #include <rapidjson/filereadstream.h>
 #include <rapidjson/filewritestream.h>
@@ -14,6 +25,20 @@
 
 #include <Common/File.h>
 #include <Common/FileSystem.h>
+#include <Common/Debug.h>
+
+namespace Common::Internal {
+    static size_t GetPageSize()
+    {
+#if PLATFORM_WINDOWS
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        return systemInfo.dwPageSize;
+#else
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+}
 
 namespace Common {
     Result<std::string, std::string> FileUtils::ReadTextFile(const std::string& inFileName)
@@ -93,4 +118,178 @@ namespace Common {
         (void) fclose(file);
         return Ok();
     }
+
+    MappedFile::MappedFile()
+        : mapped(false)
+        , data(nullptr)
+        , size(0)
+#if PLATFORM_WINDOWS
+        , nativeFile(nullptr)
+        , nativeMapping(nullptr)
+#endif
+    {
+    }
+
+    MappedFile::MappedFile(const std::string& inFileName)
+        : MappedFile()
+    {
+#if PLATFORM_WINDOWS
+        HANDLE file = CreateFileA(inFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return;
+        }
+        nativeFile = file;
+        size = static_cast<size_t>(fileSize.QuadPart);
+        mapped = true;
+        if (size == 0) {
+            return;
+        }
+
+        // the mapping object only keeps the view alive, both handles are released in Unmap()
+        nativeMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (nativeMapping == nullptr) {
+            Unmap();
+            return;
+        }
+        data = static_cast<const uint8_t*>(MapViewOfFile(nativeMapping, FILE_MAP_READ, 0, 0, 0));
+        if (data == nullptr) {
+            Unmap();
+        }
+#else
+        const int file = open(inFileName.c_str(), O_RDONLY); // NOLINT
+        if (file < 0) {
+            return;
+        }
+        struct stat fileStat {};
+        if (fstat(file, &fileStat) != 0) {
+            close(file);
+            return;
+        }
+        size = static_cast<size_t>(fileStat.st_size);
+        if (size == 0) {
+            // mmap rejects empty ranges, an empty file is still a valid mapping without data
+            mapped = true;
+            close(file);
+            return;
+        }
+
+        // the mapping keeps its own reference to the file, the descriptor is not needed after mmap
+        void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (view == MAP_FAILED) {
+            size = 0;
+            return;
+        }
+        data = static_cast<const uint8_t*>(view);
+        mapped = true;
+#endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& inOther) noexcept
+        : mapped(std::exchange(inOther.mapped, false))
+        , data(std::exchange(inOther.data, nullptr))
+        , size(std::exchange(inOther.size, 0))
+#if PLATFORM_WINDOWS
+        , nativeFile(std::exchange(inOther.nativeFile, nullptr))
+        , nativeMapping(std::exchange(inOther.nativeMapping, nullptr))
+#endif
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& inOther) noexcept
+    {
+        Unmap();
+        mapped = std::exchange(inOther.mapped, false);
+        data = std::exchange(inOther.data, nullptr);
+        size = std::exchange(inOther.size, 0);
+#if PLATFORM_WINDOWS
+        nativeFile = std::exchange(inOther.nativeFile, nullptr);
+        nativeMapping = std::exchange(inOther.nativeMapping, nullptr);
+#endif
+        return *this;
+    }
+
+    bool MappedFile::IsMapped() const
+    {
+        return mapped;
+    }
+
+    const uint8_t* MappedFile::Data() const
+    {
+        return data;
+    }
+
+    size_t MappedFile::Size() const
+    {
+        return size;
+    }
+
+    void MappedFile::Advise(MappedFileAccess inAccess) const
+    {
+        if (data == nullptr) {
+            return;
+        }
+#if PLATFORM_WINDOWS
+        // windows has no access pattern hint for an existing view, sequential reads rely on Prefetch()
+        (void) inAccess;
+#else
+        static constexpr int nativeAdvices[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM };
+        Assert(inAccess < MappedFileAccess::max);
+        (void) madvise(const_cast<uint8_t*>(data), size, nativeAdvices[static_cast<uint8_t>(inAccess)]);
+#endif
+    }
+
+    void MappedFile::Prefetch(size_t inOffset, size_t inSize) const
+    {
+        if (data == nullptr || inOffset >= size || inSize == 0) {
+            return;
+        }
+
+        static const size_t pageSize = Internal::GetPageSize();
+        const size_t begin = inOffset / pageSize * pageSize;
+        const size_t end = std::min(inOffset + inSize, size);
+        auto* address = const_cast<uint8_t*>(data + begin);
+#if PLATFORM_WINDOWS
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = address;
+        range.NumberOfBytes = end - begin;
+        (void) PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+        (void) madvise(address, end - begin, MADV_WILLNEED);
+#endif
+    }
+
+    void MappedFile::Unmap()
+    {
+#if PLATFORM_WINDOWS
+        if (data != nullptr) {
+            UnmapViewOfFile(data);
+        }
+        if (nativeMapping != nullptr) {
+            CloseHandle(nativeMapping);
+        }
+        if (nativeFile != nullptr) {
+            CloseHandle(nativeFile);
+        }
+        nativeFile = nullptr;
+        nativeMapping = nullptr;
+#else
+        if (data != nullptr) {
+            munmap(const_cast<uint8_t*>(data), size);
+        }
+#endif
+        mapped = false;
+        data = nullptr;
+        size = 0;
+    }
 }
@@ -12,4 +12,9 @@ namespace Common {
     BinaryDeserializeStream::BinaryDeserializeStream() = default;
 
     BinaryDeserializeStream::~BinaryDeserializeStream() = default;
+
+    std::optional<std::span<const uint8_t>> BinaryDeserializeStream::ReadView(size_t)
+    {
+        return {};
+    }
 }
@@ -2,6 +2,8 @@
 // Created by johnk on 2022/7/20.
 //
 
+#include <array>
+
 #include <Test/Test.h>
 
 #include <Common/Concurrent.h>
@@ -123,3 +125,139 @@ TEST(ConcurrentTest, WorkerThread3)
     syncSignal.wait();
     ASSERT_EQ(value, 10);
 }
+
+TEST(ConcurrentTest, InlineTaskTest)
+{
+    uint32_t value = 0;
+    Common::InlineTask<64> smallTask([&value]() -> void { ++value; });
+    smallTask();
+    ASSERT_EQ(value, 1);
+
+    std::array<uint64_t, 32> payload {};
+    payload[31] = 5;
+    Common::InlineTask<64> largeTask([&value, payload]() -> void { value += payload[31]; });
+    Common::InlineTask<64> movedTask = std::move(largeTask);
+    ASSERT_FALSE(largeTask);
+    movedTask();
+    ASSERT_EQ(value, 6);
+
+    auto uniqueValue = Common::MakeUnique<uint32_t>(4);
+    Common::InlineTask<64> moveOnlyTask([&value, uniqueValue = std::move(uniqueValue)]() mutable -> void { value += *uniqueValue; });
+    moveOnlyTask();
+    ASSERT_EQ(value, 10);
+}
+
+TEST(ConcurrentTest, MpscRingBufferTest)
+{
+    Common::MpscRingBuffer<uint32_t> ringBuffer(4);
+    for (uint32_t i = 0; i < 4; i++) {
+        uint32_t value = i;
+        ASSERT_TRUE(ringBuffer.TryPush(std::move(value)));
+    }
+    uint32_t overflow = 4;
+    ASSERT_FALSE(ringBuffer.TryPush(std::move(overflow)));
+
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(ringBuffer.TryPop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(ringBuffer.TryPop(value));
+}
+
+TEST(ConcurrentTest, MpscRingBufferMultiProducerTest)
+{
+    static constexpr uint32_t producerNum = 4;
+    static constexpr uint32_t valueNumPerProducer = 10000;
+
+    Common::MpscRingBuffer<uint32_t> ringBuffer(256);
+    std::vector<Common::NamedThread> producers;
+    producers.reserve(producerNum);
+    for (uint32_t p = 0; p < producerNum; p++) {
+        producers.emplace_back("TestProducer", [&ringBuffer, p]() -> void {
+            for (uint32_t i = 0; i < valueNumPerProducer; i++) {
+                uint32_t value = p * valueNumPerProducer + i;
+                while (!ringBuffer.TryPush(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint32_t> lastValues(producerNum, 0);
+    std::vector<bool> received(producerNum, false);
+    uint32_t popped = 0;
+    while (popped < producerNum * valueNumPerProducer) {
+        uint32_t value;
+        if (!ringBuffer.TryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        // values from the same producer must be consumed in submission order
+        const uint32_t producer = value / valueNumPerProducer;
+        ASSERT_TRUE(!received[producer] || value > lastValues[producer]);
+        received[producer] = true;
+        lastValues[producer] = value;
+        popped++;
+    }
+    for (auto& producer : producers) {
+        producer.Join();
+    }
+}
+
+TEST(ConcurrentTest, CommandThreadTest0)
+{
+    uint32_t value = 0;
+    Common::CommandThread commandThread("TestCommandThread", 16);
+    for (auto i = 0; i < 100; i++) {
+        commandThread.EmplaceTask([&value]() -> void { ++value; });
+    }
+    commandThread.Flush();
+    ASSERT_EQ(value, 100);
+}
+
+TEST(ConcurrentTest, CommandThreadTest1)
+{
+    uint32_t value = 0;
+    Common::CommandThread commandThread("TestCommandThread", 1024);
+    commandThread.EmplaceTask([&value]() -> void { ++value; });
+    const auto fence0 = commandThread.EmplaceFence();
+    commandThread.EmplaceTask([&value]() -> void { value *= 3; });
+    const auto fence1 = commandThread.EmplaceFence();
+    ASSERT_LT(fence0, fence1);
+
+    commandThread.WaitFence(fence1);
+    ASSERT_TRUE(commandThread.IsFenceCompleted(fence0));
+    ASSERT_TRUE(commandThread.IsFenceCompleted(fence1));
+    ASSERT_EQ(value, 3);
+
+    auto future = commandThread.EmplaceTaskWithFuture([&value]() -> uint32_t { return value + 1; });
+    ASSERT_EQ(future.get(), 4);
+}
+
+TEST(ConcurrentTest, CommandThreadMultiProducerTest)
+{
+    std::atomic<uint32_t> value = 0;
+    {
+        Common::CommandThread commandThread("TestCommandThread", 64);
+        std::vector<Common::NamedThread> producers;
+        for (auto p = 0; p < 4; p++) {
+            producers.emplace_back("TestProducer", [&commandThread, &value]() -> void {
+                for (auto i = 0; i < 1000; i++) {
+                    commandThread.EmplaceTask([&value]() -> void { value.fetch_add(1, std::memory_order_relaxed); });
+                }
+                commandThread.Flush();
+            });
+        }
+        for (auto& producer : producers) {
+            producer.Join();
+        }
+        ASSERT_EQ(value, 4000);
+
+        // commands still queued when the thread is destroyed are drained before joining
+        for (auto i = 0; i < 10; i++) {
+            commandThread.EmplaceTask([&value]() -> void { value.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    ASSERT_EQ(value, 4010);
+}
@@ -28,3 +28,29 @@ TEST(FileTest, ReadMissingJsonFileTest)
     const auto readResult = Common::FileUtils::ReadJsonFile("../Test/Generated/Common/DoesNotExist.json");
     ASSERT_TRUE(readResult.IsErr());
 }
+
+TEST(FileTest, MappedFileTest)
+{
+    static Common::Path file = "../Test/Generated/Common/MappedFileTest.txt";
+
+    ASSERT_TRUE(Common::FileUtils::WriteTextFile(file.Absolute().String(), "hello").IsOk());
+    const Common::MappedFile mappedFile(file.Absolute().String());
+    ASSERT_TRUE(mappedFile.IsMapped());
+    ASSERT_EQ(mappedFile.Size(), 5);
+    ASSERT_EQ(std::string(reinterpret_cast<const char*>(mappedFile.Data()), mappedFile.Size()), "hello");
+    mappedFile.Advise(Common::MappedFileAccess::sequential);
+    mappedFile.Prefetch(1, 3);
+
+    ASSERT_FALSE(Common::MappedFile("../Test/Generated/Common/DoesNotExist.txt").IsMapped());
+}
+
+TEST(FileTest, MappedEmptyFileTest)
+{
+    static Common::Path file = "../Test/Generated/Common/MappedEmptyFileTest.txt";
+
+    ASSERT_TRUE(Common::FileUtils::WriteTextFile(file.Absolute().String(), "").IsOk());
+    const Common::MappedFile mappedFile(file.Absolute().String());
+    ASSERT_TRUE(mappedFile.IsMapped());
+    ASSERT_EQ(mappedFile.Size(), 0);
+    ASSERT_EQ(mappedFile.Data(), nullptr);
+}
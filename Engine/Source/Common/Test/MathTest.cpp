@@ -1523,6 +1523,12 @@ TEST(MathTest, SerializationTest)
     PerformTypedSerializationTest(IMat3x4(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12));
     PerformTypedSerializationTest(FMat4x4(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f));
 
+    // bulk serialized containers
+    PerformTypedSerializationTest(std::vector<HFloat> { HFloat(1.0f), HFloat(2.0f) });
+    PerformTypedSerializationTest(std::vector<FVec3> { FVec3(1.0f, 2.0f, 3.0f), FVec3(4.0f, 5.0f, 6.0f) });
+    PerformTypedSerializationTest(std::vector<HVec2> { HVec2(2.0f, 3.0f), HVec2(4.0f, 5.0f) });
+    PerformTypedSerializationTest(std::vector<IMat3x4> { IMat3x4(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12) });
+
     // angle/radian
     PerformTypedSerializationTest(FAngle(67.0f));
     PerformTypedSerializationTest(FRadian(1.5f * pi));
@@ -2,6 +2,8 @@
 // Created by johnk on 2023/7/13.
 //
 
+#include <array>
+
 #include <Common/Memory.h>
 #include <SerializationTest.h>
 
@@ -47,6 +49,85 @@ TEST(SerializationTest, ByteStreamTest)
     }
 }
 
+TEST(SerializationTest, MappedFileStreamTest)
+{
+    static Common::Path fileName = "../Test/Generated/Common/SerializationTest.MappedFileStreamTest.bin";
+    {
+        BinaryFileSerializeStream stream(fileName.String());
+        stream.Write<uint32_t>(5);
+        const std::array<uint8_t, 3> payload = { 1, 2, 3 };
+        stream.Write<uint8_t>(payload.data(), payload.size());
+    }
+
+    MappedFileDeserializeStream stream(fileName.String());
+    ASSERT_TRUE(stream.IsMapped());
+    uint32_t value;
+    stream.Read<uint32_t>(value);
+    ASSERT_EQ(value, 5);
+
+    const auto view = stream.ReadView(3);
+    ASSERT_TRUE(view.has_value());
+    ASSERT_EQ(view->size(), 3);
+    ASSERT_EQ((*view)[2], 3);
+    ASSERT_EQ(stream.Loc(), sizeof(uint32_t) + 3);
+
+    std::vector<uint8_t> memory = { 1, 2 };
+    MemoryDeserializeStream memoryStream(memory);
+    ASSERT_EQ(memoryStream.ReadView(2)->data(), memory.data());
+}
+
+TEST(SerializationTest, MappedBulkContainerTest)
+{
+    static Common::Path fileName = "../Test/Generated/Common/SerializationTest.MappedBulkContainerTest.bin";
+    const std::vector<uint8_t> pixels = { 1, 2, 3, 4, 5 };
+    const std::vector<uint32_t> indices = { 7, 8, 9 };
+    {
+        BinaryFileSerializeStream stream(fileName.String());
+        Serializer<std::vector<uint8_t>>::Serialize(stream, pixels);
+        Serializer<std::vector<uint32_t>>::Serialize(stream, indices);
+    }
+
+    MappedFileDeserializeStream stream(fileName.String());
+    std::vector<uint8_t> restoredPixels;
+    std::vector<uint32_t> restoredIndices;
+    Serializer<std::vector<uint8_t>>::Deserialize(stream, restoredPixels);
+    Serializer<std::vector<uint32_t>>::Deserialize(stream, restoredIndices);
+    ASSERT_EQ(restoredPixels, pixels);
+    ASSERT_EQ(restoredIndices, indices);
+    ASSERT_EQ(stream.Loc(), sizeof(uint64_t) * 2 + pixels.size() + indices.size() * sizeof(uint32_t));
+}
+
+TEST(SerializationTest, BoundedStreamTest)
+{
+    std::vector<uint8_t> memory;
+    {
+        MemorySerializeStream stream(memory);
+        stream.Write<uint32_t>(5);
+        stream.Write<uint64_t>(3);
+        const std::array<uint8_t, 3> payload = { 1, 2, 3 };
+        stream.Write<uint8_t>(payload.data(), payload.size());
+        stream.Write<uint64_t>(UINT64_MAX);
+    }
+
+    BoundedDeserializeStream stream(memory);
+    uint32_t value;
+    stream.Read<uint32_t>(value);
+    ASSERT_EQ(value, 5);
+
+    uint64_t length;
+    ASSERT_TRUE(stream.ReadLength(length));
+    ASSERT_EQ(length, 3);
+    ASSERT_EQ((*stream.ReadView(length))[2], 3);
+
+    // a length beyond the rest fails the stream instead of asserting, so does every later read
+    ASSERT_FALSE(stream.ReadLength(length));
+    ASSERT_EQ(length, 0);
+    ASSERT_TRUE(stream.Failed());
+    stream.Read<uint32_t>(value);
+    ASSERT_EQ(value, 0);
+    ASSERT_FALSE(stream.ReadView(1).has_value());
+}
+
 TEST(SerializationTest, TypedSerializationTest)
 {
     PerformTypedSerializationTest<bool>(false);
@@ -68,6 +149,10 @@ TEST(SerializationTest, TypedSerializationTest)
     PerformTypedSerializationTest<std::pair<int, bool>>({ 1, false });
     PerformTypedSerializationTest<std::array<int, 3>>({ 1, 2, 3 });
     PerformTypedSerializationTest<std::vector<int>>({ 1, 2, 3 });
+    PerformTypedSerializationTest<std::vector<uint8_t>>({ 1, 2, 3 });
+    PerformTypedSerializationTest<std::vector<double>>({ 1.0, 2.0, 3.0 });
+    PerformTypedSerializationTest<std::vector<bool>>({ true, false, true });
+    PerformTypedSerializationTest<std::vector<std::string>>({ "hello", "world" });
     PerformTypedSerializationTest<std::list<int>>({ 1, 2, 3 });
     PerformTypedSerializationTest<std::unordered_set<int>>({ 1, 2, 3 });
     PerformTypedSerializationTest<std::set<int>>({ 1, 2, 3 });
@@ -77,6 +162,24 @@ TEST(SerializationTest, TypedSerializationTest)
     PerformTypedSerializationTest<std::variant<int, bool, float>>({ true });
 }
 
+TEST(SerializationTest, BulkVectorLayoutTest)
+{
+    // bulk written vectors keep the per element layout, elements swapped one by one to the stream endian
+    const std::vector<uint16_t> value = { 0x0102, 0x0304 };
+    std::vector<uint8_t> memory;
+    {
+        MemorySerializeStream<std::endian::big> stream(memory);
+        ASSERT_EQ(Serializer<std::vector<uint16_t>>::Serialize(stream, value), sizeof(uint64_t) + 2 * sizeof(uint16_t));
+    }
+    const std::vector<uint8_t> expected = { 0, 0, 0, 0, 0, 0, 0, 2, 0x01, 0x02, 0x03, 0x04 };
+    ASSERT_EQ(memory, expected);
+
+    std::vector<uint16_t> deserialized = { 5 };
+    MemoryDeserializeStream<std::endian::big> stream(memory);
+    ASSERT_EQ(Serializer<std::vector<uint16_t>>::Deserialize(stream, deserialized), memory.size());
+    ASSERT_EQ(deserialized, value);
+}
+
 TEST(SerializationTest, TypedSerializationWithFileTest)
 {
     static std::string fileName = "../Test/Generated/Common/SerializationTest.TypedSerializationWithFileTest.bin";
@@ -51,6 +51,11 @@ void PerformTypedSerializationTestWithEndian(const T& inValue)
         []() -> Common::UniquePtr<Common::BinaryDeserializeStream> { return {new Common::BinaryFileDeserializeStream<E>(fileName.String()) }; },
         inValue);
 
+    PerformTypedSerializationTestWithStream<T>(
+        []() -> Common::UniquePtr<Common::BinarySerializeStream> { return {new Common::BinaryFileSerializeStream<E>(fileName.String()) }; },
+        []() -> Common::UniquePtr<Common::BinaryDeserializeStream> { return {new Common::MappedFileDeserializeStream<E>(fileName.String()) }; },
+        inValue);
+
     std::vector<uint8_t> buffer;
     PerformTypedSerializationTestWithStream<T>(
         [&]() -> Common::UniquePtr<Common::BinarySerializeStream> { return {new Common::MemorySerializeStream<E>(buffer) }; },
@@ -0,0 +1,115 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <atomic>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <taskflow/taskflow.hpp>
+
+#include <Core/JobSystem.h>
+
+namespace Core::JobSystemBenchmark::Internal {
+    // mirrors the shapes SystemPipeline builds from a SystemGraph: one concurrent group, or one sequential group
+    enum class GraphShape : uint8_t {
+        concurrent,
+        sequential,
+        max
+    };
+
+    static void SimulateSystem(std::atomic<uint64_t>& inCounter)
+    {
+        inCounter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // the previous SystemPipeline path, a new taskflow and a new executor (spawning and joining all workers) per tick
+    template <GraphShape Shape>
+    static void TransientExecutorTick(benchmark::State& state)
+    {
+        const auto systemCount = state.range(0);
+        std::atomic<uint64_t> counter = 0;
+
+        for (auto _ : state) {
+            tf::Taskflow taskflow;
+            auto lastTask = taskflow.emplace([]() -> void {});
+            auto barrier = taskflow.emplace([]() -> void {});
+            for (int64_t i = 0; i < systemCount; i++) {
+                auto task = taskflow.emplace([&]() -> void { SimulateSystem(counter); });
+                task.succeed(lastTask);
+                if constexpr (Shape == GraphShape::sequential) {
+                    lastTask = task;
+                } else {
+                    barrier.succeed(task);
+                }
+            }
+            if constexpr (Shape == GraphShape::sequential) {
+                barrier.succeed(lastTask);
+            }
+
+            tf::Executor executor;
+            executor.run(taskflow).wait();
+        }
+
+        benchmark::DoNotOptimize(counter.load());
+        state.SetItemsProcessed(state.iterations() * systemCount);
+    }
+
+    // the current SystemPipeline path, the graph is compiled once and only re-executed on the long-lived job system
+    template <GraphShape Shape>
+    static void CachedJobGraphTick(benchmark::State& state)
+    {
+        const auto systemCount = state.range(0);
+        std::atomic<uint64_t> counter = 0;
+
+        JobGraph graph;
+        std::optional<JobId> lastJob;
+        const auto barrier = graph.EmplaceBarrier();
+        for (int64_t i = 0; i < systemCount; i++) {
+            const auto job = graph.Emplace([&]() -> void { SimulateSystem(counter); });
+            if constexpr (Shape == GraphShape::sequential) {
+                if (lastJob.has_value()) {
+                    graph.Precede(*lastJob, job);
+                }
+                lastJob = job;
+            } else {
+                graph.Precede(job, barrier);
+            }
+        }
+        if constexpr (Shape == GraphShape::sequential) {
+            graph.Precede(*lastJob, barrier);
+        }
+
+        auto& jobSystem = JobSystem::Get();
+        jobSystem.Run(graph);
+        for (auto _ : state) {
+            jobSystem.Run(graph);
+        }
+
+        benchmark::DoNotOptimize(counter.load());
+        state.SetItemsProcessed(state.iterations() * systemCount);
+    }
+
+    static void RegisterBenchmarkCase(std::string_view inCaseName, void (*inFunction)(benchmark::State&))
+    {
+        std::string name = "Core::JobSystemBenchmark::";
+        name.append(inCaseName);
+
+        benchmark::RegisterBenchmark(name.c_str(), inFunction)
+            ->Arg(1)
+            ->Arg(16)
+            ->Arg(256)
+            ->UseRealTime();
+    }
+
+    const bool benchmarksRegistered = []() -> bool {
+        RegisterBenchmarkCase("TransientExecutorTick/Concurrent", &TransientExecutorTick<GraphShape::concurrent>);
+        RegisterBenchmarkCase("TransientExecutorTick/Sequential", &TransientExecutorTick<GraphShape::sequential>);
+        RegisterBenchmarkCase("CachedJobGraphTick/Concurrent", &CachedJobGraphTick<GraphShape::concurrent>);
+        RegisterBenchmarkCase("CachedJobGraphTick/Sequential", &CachedJobGraphTick<GraphShape::sequential>);
+        return true;
+    }();
+}
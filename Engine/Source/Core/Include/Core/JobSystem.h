@@ -0,0 +1,140 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Common/Debug.h>
+#include <Common/Memory.h>
+#include <Common/Utility.h>
+#include <Core/Thread.h>
+#include <Core/Api.h>
+
+namespace tf {
+    class Executor;
+    class Taskflow;
+}
+
+namespace Core {
+    using JobFunc = std::function<void()>;
+    using JobId = size_t;
+
+    // jobs submitted from game side threads run as gameWorker, jobs submitted from render side threads run as renderWorker
+    CORE_API ThreadTag GetJobThreadTag(ThreadTag inSubmitterTag);
+
+    // a reusable dependency graph of jobs, nodes and edges are recorded once and compiled into the job system's native
+    // graph on the first run, later runs only re-execute the compiled graph until the topology is modified again
+    class CORE_API JobGraph {
+    public:
+        JobGraph();
+        ~JobGraph();
+
+        NonCopyable(JobGraph)
+        NonMovable(JobGraph)
+
+        JobId Emplace(JobFunc inFunc);
+        JobId EmplaceBarrier();
+        void Precede(JobId inBefore, JobId inAfter);
+        void Clear();
+        size_t Count() const;
+        bool Empty() const;
+        bool Compiled() const;
+
+    private:
+        friend class JobSystem;
+
+        void Compile();
+
+        std::vector<JobFunc> jobs;
+        std::vector<std::pair<JobId, JobId>> edges;
+        ThreadTag runTag;
+        bool dirty;
+        Common::UniquePtr<tf::Taskflow> compiled;
+    };
+
+    // engine-wide long-lived work-stealing job system, every worker owns a task deque and steals from the others when
+    // idle, blocking waits issued from a worker help executing other jobs instead of sleeping, so nested parallelism
+    // (e.g. a parallel query inside a system job) never deadlocks the pool
+    class CORE_API JobSystem {
+    public:
+        static JobSystem& Get();
+
+        ~JobSystem();
+
+        NonCopyable(JobSystem)
+        NonMovable(JobSystem)
+
+        size_t WorkerNum() const;
+        bool IsWorkerThread() const;
+        void Run(JobGraph& inGraph);
+        template <typename F> auto EmplaceTask(F&& inTask);
+        template <typename F> void ExecuteTasks(size_t inTaskNum, F&& inTask);
+        // inMaxTaskNum bounds the number of threads working on the loop, 0 means every worker plus the calling thread
+        template <typename F> void ParallelFor(size_t inNum, size_t inGrainSize, F&& inFunc, size_t inMaxTaskNum = 0);
+
+    private:
+        JobSystem();
+
+        void Submit(JobFunc inFunc);
+        void ExecuteTasksInternal(size_t inTaskNum, const std::function<void(size_t)>& inTask);
+
+        Common::UniquePtr<tf::Executor> executor;
+    };
+}
+
+namespace Core {
+    template <typename F>
+    auto JobSystem::EmplaceTask(F&& inTask)
+    {
+        using RetType = std::invoke_result_t<F>;
+        auto packagedTask = Common::MakeShared<std::packaged_task<RetType()>>(std::forward<F>(inTask));
+        auto result = packagedTask->get_future();
+        Submit([packagedTask, tag = GetJobThreadTag(ThreadContext::Tag())]() -> void {
+            ScopedThreadTag threadTag(tag);
+            (*packagedTask)();
+        });
+        return result;
+    }
+
+    template <typename F>
+    void JobSystem::ExecuteTasks(size_t inTaskNum, F&& inTask)
+    {
+        if (inTaskNum == 0) {
+            return;
+        }
+        ExecuteTasksInternal(inTaskNum, [&inTask](size_t inIndex) -> void { inTask(inIndex); });
+    }
+
+    template <typename F>
+    void JobSystem::ParallelFor(size_t inNum, size_t inGrainSize, F&& inFunc, size_t inMaxTaskNum)
+    {
+        Assert(inGrainSize > 0);
+        if (inNum == 0) {
+            return;
+        }
+
+        const size_t chunkNum = (inNum + inGrainSize - 1) / inGrainSize;
+        if (chunkNum == 1) {
+            inFunc(static_cast<size_t>(0), inNum);
+            return;
+        }
+
+        // chunks are claimed dynamically so that uneven chunk costs are balanced between workers
+        std::atomic<size_t> nextChunk = 0;
+        ExecuteTasksInternal(std::min(chunkNum, inMaxTaskNum == 0 ? WorkerNum() + 1 : inMaxTaskNum), [&](size_t) -> void {
+            for (size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed); chunk < chunkNum; chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) {
+                const size_t begin = chunk * inGrainSize;
+                inFunc(begin, std::min(begin + inGrainSize, inNum));
+            }
+        });
+    }
+}
@@ -0,0 +1,180 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <thread>
+
+#include <taskflow/taskflow.hpp>
+
+#include <Core/JobSystem.h>
+
+namespace Core::Internal {
+    class JobWorkerInterface final : public tf::WorkerInterface {
+    public:
+        void scheduler_prologue(tf::Worker& inWorker) override
+        {
+            ThreadContext::SetTag(ThreadTag::gameWorker);
+        }
+
+        void scheduler_epilogue(tf::Worker& inWorker, std::exception_ptr inException) override {}
+    };
+
+    static size_t GetDefaultJobWorkerNum()
+    {
+        // leave one hardware thread for the render thread, the waiting thread always helps when it is a worker itself
+        const size_t hardwareThreadNum = std::thread::hardware_concurrency();
+        return hardwareThreadNum > 1 ? hardwareThreadNum - 1 : 1;
+    }
+}
+
+namespace Core {
+    ThreadTag GetJobThreadTag(ThreadTag inSubmitterTag)
+    {
+        return inSubmitterTag == ThreadTag::render || inSubmitterTag == ThreadTag::renderWorker ? ThreadTag::renderWorker : ThreadTag::gameWorker;
+    }
+
+    JobGraph::JobGraph()
+        : runTag(ThreadTag::gameWorker)
+        , dirty(true)
+    {
+    }
+
+    JobGraph::~JobGraph() = default;
+
+    JobId JobGraph::Emplace(JobFunc inFunc)
+    {
+        dirty = true;
+        jobs.emplace_back(std::move(inFunc));
+        return jobs.size() - 1;
+    }
+
+    JobId JobGraph::EmplaceBarrier()
+    {
+        return Emplace(nullptr);
+    }
+
+    void JobGraph::Precede(JobId inBefore, JobId inAfter)
+    {
+        Assert(inBefore < jobs.size() && inAfter < jobs.size() && inBefore != inAfter);
+        dirty = true;
+        edges.emplace_back(inBefore, inAfter);
+    }
+
+    void JobGraph::Clear()
+    {
+        dirty = true;
+        jobs.clear();
+        edges.clear();
+        compiled = nullptr;
+    }
+
+    size_t JobGraph::Count() const
+    {
+        return jobs.size();
+    }
+
+    bool JobGraph::Empty() const
+    {
+        return jobs.empty();
+    }
+
+    bool JobGraph::Compiled() const
+    {
+        return !dirty;
+    }
+
+    void JobGraph::Compile()
+    {
+        compiled = Common::MakeUnique<tf::Taskflow>();
+
+        std::vector<tf::Task> tasks;
+        tasks.reserve(jobs.size());
+        for (const auto& job : jobs) {
+            if (job == nullptr) {
+                tasks.emplace_back(compiled->emplace([]() -> void {}));
+                continue;
+            }
+            tasks.emplace_back(compiled->emplace([this, &job]() -> void {
+                ScopedThreadTag threadTag(runTag);
+                job();
+            }));
+        }
+        for (const auto& [before, after] : edges) {
+            tasks[before].precede(tasks[after]);
+        }
+        dirty = false;
+    }
+
+    JobSystem& JobSystem::Get()
+    {
+        static JobSystem instance;
+        return instance;
+    }
+
+    JobSystem::JobSystem()
+        : executor(Common::MakeUnique<tf::Executor>(Internal::GetDefaultJobWorkerNum(), tf::make_worker_interface<Internal::JobWorkerInterface>()))
+    {
+    }
+
+    JobSystem::~JobSystem() = default;
+
+    size_t JobSystem::WorkerNum() const
+    {
+        return executor->num_workers();
+    }
+
+    bool JobSystem::IsWorkerThread() const
+    {
+        return executor->this_worker_id() >= 0;
+    }
+
+    void JobSystem::Run(JobGraph& inGraph)
+    {
+        if (inGraph.Empty()) {
+            return;
+        }
+        if (inGraph.dirty) {
+            inGraph.Compile();
+        }
+
+        inGraph.runTag = GetJobThreadTag(ThreadContext::Tag());
+        if (IsWorkerThread()) {
+            executor->corun(*inGraph.compiled);
+        } else {
+            executor->run(*inGraph.compiled).wait();
+        }
+    }
+
+    void JobSystem::Submit(JobFunc inFunc)
+    {
+        executor->silent_async(std::move(inFunc));
+    }
+
+    void JobSystem::ExecuteTasksInternal(size_t inTaskNum, const std::function<void(size_t)>& inTask)
+    {
+        Assert(inTaskNum > 0);
+        if (inTaskNum == 1) {
+            inTask(0);
+            return;
+        }
+
+        const ThreadTag tag = GetJobThreadTag(ThreadContext::Tag());
+        tf::Taskflow taskflow;
+        for (size_t i = 1; i < inTaskNum; i++) {
+            taskflow.emplace([&inTask, tag, i]() -> void {
+                ScopedThreadTag threadTag(tag);
+                inTask(i);
+            });
+        }
+
+        // the calling thread takes the first task itself instead of sleeping until the workers are done
+        if (IsWorkerThread()) {
+            inTask(0);
+            executor->corun(taskflow);
+        } else {
+            auto future = executor->run(taskflow);
+            inTask(0);
+            future.wait();
+        }
+    }
+}
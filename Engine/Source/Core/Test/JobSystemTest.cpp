@@ -0,0 +1,84 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <Test/Test.h>
+#include <Core/JobSystem.h>
+
+TEST(JobSystemTest, EmplaceTaskTest)
+{
+    auto future = Core::JobSystem::Get().EmplaceTask([]() -> uint32_t { return Core::ThreadContext::IsGameWorkerThread() ? 1 : 0; });
+    ASSERT_EQ(future.get(), 1);
+}
+
+TEST(JobSystemTest, ExecuteTasksTest)
+{
+    std::atomic<uint32_t> count = 0;
+    Core::JobSystem::Get().ExecuteTasks(64, [&](size_t) -> void { ++count; });
+    ASSERT_EQ(count, 64);
+}
+
+TEST(JobSystemTest, ParallelForTest)
+{
+    std::vector<uint32_t> values(10000, 0);
+    Core::JobSystem::Get().ParallelFor(values.size(), 128, [&](size_t inBegin, size_t inEnd) -> void {
+        for (auto i = inBegin; i < inEnd; i++) {
+            values[i]++;
+        }
+    });
+    for (const auto value : values) {
+        ASSERT_EQ(value, 1);
+    }
+}
+
+TEST(JobSystemTest, ParallelForMaxTaskNumTest)
+{
+    const auto callingThread = std::this_thread::get_id();
+    std::atomic<uint32_t> foreignChunkNum = 0;
+    Core::JobSystem::Get().ParallelFor(64, 1, [&](size_t, size_t) -> void {
+        if (std::this_thread::get_id() != callingThread) {
+            ++foreignChunkNum;
+        }
+    }, 1);
+    ASSERT_EQ(foreignChunkNum, 0);
+}
+
+TEST(JobSystemTest, JobGraphTest)
+{
+    std::vector<uint32_t> order;
+    std::atomic<uint32_t> concurrentCount = 0;
+
+    Core::JobGraph graph;
+    const auto first = graph.Emplace([&]() -> void { order.emplace_back(0); });
+    const auto barrier = graph.EmplaceBarrier();
+    for (auto i = 0; i < 16; i++) {
+        const auto job = graph.Emplace([&]() -> void { ++concurrentCount; });
+        graph.Precede(first, job);
+        graph.Precede(job, barrier);
+    }
+    const auto last = graph.Emplace([&]() -> void { order.emplace_back(concurrentCount.load()); });
+    graph.Precede(barrier, last);
+    ASSERT_FALSE(graph.Compiled());
+
+    Core::JobSystem::Get().Run(graph);
+    ASSERT_TRUE(graph.Compiled());
+    ASSERT_EQ(order, (std::vector<uint32_t> { 0, 16 }));
+
+    Core::JobSystem::Get().Run(graph);
+    ASSERT_EQ(order, (std::vector<uint32_t> { 0, 16, 0, 32 }));
+}
+
+TEST(JobSystemTest, NestedParallelForTest)
+{
+    std::atomic<uint32_t> count = 0;
+    Core::JobSystem::Get().ExecuteTasks(8, [&](size_t) -> void {
+        Core::JobSystem::Get().ParallelFor(256, 16, [&](size_t inBegin, size_t inEnd) -> void {
+            count += static_cast<uint32_t>(inEnd - inBegin);
+        });
+    });
+    ASSERT_EQ(count, 8 * 256);
+}
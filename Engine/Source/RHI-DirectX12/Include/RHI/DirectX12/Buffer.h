@@ -22,6 +22,8 @@ namespace RHI::DirectX12 {
 
         void* Map(MapMode inMapMode, size_t inOffset, size_t inLength) override;
         void Unmap() override;
+        void Flush(size_t inOffset, size_t inLength) override;
+        uint64_t GetAllocatedSize() const override;
 
         ID3D12Resource* GetNative() const;
         DX12Device& GetDevice() const;
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <deque>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -20,6 +22,8 @@ using Microsoft::WRL::ComPtr;
 namespace RHI::DirectX12 {
     class DX12Queue;
     class DX12Device;
+    class DX12CommandBuffer;
+    class DX12Fence;
 
     class DescriptorHeapNode;
 
@@ -89,6 +93,8 @@ namespace RHI::DirectX12 {
         Common::UniquePtr<ComputePipeline> CreateComputePipeline(const ComputePipelineCreateInfo& inCreateInfo) override;
         Common::UniquePtr<RasterPipeline> CreateRasterPipeline(const RasterPipelineCreateInfo& inCreateInfo) override;
         Common::UniquePtr<CommandBuffer> CreateCommandBuffer(QueueType inQueueType) override;
+        CommandBuffer* AcquireTransientCommandBuffer(QueueType inQueueType) override;
+        void BeginFrame() override;
         Common::UniquePtr<Fence> CreateFence(bool inInitAsSignaled) override;
         Common::UniquePtr<Semaphore> CreateSemaphore() override;
         Common::UniquePtr<QuerySet> CreateQuerySet(const QuerySetCreateInfo& inCreateInfo) override;
@@ -106,11 +112,23 @@ namespace RHI::DirectX12 {
         Common::UniquePtr<DescriptorAllocation> AllocateDsvDescriptor() const;
 
     private:
+        struct TransientFrame {
+            std::vector<Common::UniquePtr<DX12CommandBuffer>> cmdBuffers;
+            // signaled by an empty submission to every queue the command buffers may have been submitted to
+            std::vector<Common::UniquePtr<DX12Fence>> fences;
+
+            TransientFrame();
+            TransientFrame(TransientFrame&& inOther) noexcept;
+            ~TransientFrame();
+            TransientFrame& operator=(TransientFrame&& inOther) noexcept;
+        };
+
         void CreateNativeDevice();
         void CreateNativeQueues(const DeviceCreateInfo& inCreateInfo);
         void QueryNativeDescriptorSize();
         void CreateDescriptorPools();
         void CreateIndirectCommandSignatures();
+        void RecycleTransientFrames(bool inWait);
 #if BUILD_CONFIG_DEBUG
         void RegisterNativeDebugLayerExceptionHandler();
         void UnregisterNativeDebugLayerExceptionHandler();
@@ -131,5 +149,12 @@ namespace RHI::DirectX12 {
         ComPtr<ID3D12CommandSignature> drawIndirectCommandSignature;
         ComPtr<ID3D12CommandSignature> drawIndexedIndirectCommandSignature;
         ComPtr<ID3D12CommandSignature> dispatchIndirectCommandSignature;
+        // command allocators are reset when a command buffer begins, transient ones are only handed out again once the
+        // gpu finished their frame
+        std::mutex transientCmdBuffersMutex;
+        TransientFrame currentTransientFrame;
+        std::deque<TransientFrame> retiringTransientFrames;
+        std::unordered_map<QueueType, std::vector<Common::UniquePtr<DX12CommandBuffer>>> freeTransientCmdBuffers;
+        std::vector<Common::UniquePtr<DX12Fence>> freeTransientFences;
     };
 }
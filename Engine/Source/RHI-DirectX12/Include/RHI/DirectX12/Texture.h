@@ -19,6 +19,8 @@ namespace RHI::DirectX12 {
         DX12Texture(DX12Device& inDevice, const TextureCreateInfo& inCreateInfo, ComPtr<ID3D12Resource>&& nativeResource);
         ~DX12Texture() override;
 
+        uint64_t GetAllocatedSize() const override;
+
         ID3D12Resource* GetNative() const;
 
     private:
@@ -89,6 +89,12 @@ namespace RHI::DirectX12 {
         nativeResource->Unmap(0, nullptr);
     }
 
+    void DX12Buffer::Flush(const size_t inOffset, const size_t inLength)
+    {
+        // upload heaps are write combined and coherent, writes are visible without a flush
+        Assert(mapMode == MapMode::write);
+    }
+
     Common::UniquePtr<BufferView> DX12Buffer::CreateBufferViewInternal(const BufferViewCreateInfo& inCreateInfo)
     {
         return Common::UniquePtr<BufferView>(new DX12BufferView(*this, inCreateInfo));
@@ -99,6 +105,12 @@ namespace RHI::DirectX12 {
         return nativeResource.Get();
     }
 
+    uint64_t DX12Buffer::GetAllocatedSize() const
+    {
+        const D3D12_RESOURCE_DESC desc = nativeResource->GetDesc();
+        return device.GetNative()->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+    }
+
     BufferUsageFlags DX12Buffer::GetUsages() const
     {
         return usages;
@@ -164,8 +164,22 @@ namespace RHI::DirectX12 {
 #endif
     }
 
+    DX12Device::TransientFrame::TransientFrame() = default;
+
+    DX12Device::TransientFrame::TransientFrame(TransientFrame&& inOther) noexcept = default;
+
+    DX12Device::TransientFrame::~TransientFrame() = default;
+
+    DX12Device::TransientFrame& DX12Device::TransientFrame::operator=(TransientFrame&& inOther) noexcept = default;
+
     DX12Device::~DX12Device()
     {
+        // transient command buffers still in flight are waited so they are not destroyed while executing
+        BeginFrame();
+        RecycleTransientFrames(true);
+        freeTransientCmdBuffers.clear();
+        freeTransientFences.clear();
+
 #if BUILD_CONFIG_DEBUG
         if (gpu.GetInstance().GetCreateInfo().gpuDebug) {
             UnregisterNativeDebugLayerExceptionHandler();
@@ -251,6 +265,48 @@ namespace RHI::DirectX12 {
         return { new DX12CommandBuffer(*this, inQueueType) };
     }
 
+    CommandBuffer* DX12Device::AcquireTransientCommandBuffer(const QueueType inQueueType)
+    {
+        Assert(queues.contains(inQueueType));
+        std::unique_lock lock(transientCmdBuffersMutex);
+        auto& freeCmdBuffers = freeTransientCmdBuffers[inQueueType];
+        if (freeCmdBuffers.empty()) {
+            return currentTransientFrame.cmdBuffers.emplace_back(new DX12CommandBuffer(*this, inQueueType)).Get();
+        }
+        auto& result = currentTransientFrame.cmdBuffers.emplace_back(std::move(freeCmdBuffers.back()));
+        freeCmdBuffers.pop_back();
+        return result.Get();
+    }
+
+    void DX12Device::BeginFrame()
+    {
+        {
+            std::unique_lock lock(transientCmdBuffersMutex);
+            if (!currentTransientFrame.cmdBuffers.empty()) {
+                std::unordered_set<QueueType> queueTypes;
+                for (const auto& cmdBuffer : currentTransientFrame.cmdBuffers) {
+                    queueTypes.emplace(cmdBuffer->GetQueueType());
+                }
+                for (const auto queueType : queueTypes) {
+                    for (const auto& queue : queues.at(queueType)) {
+                        Common::UniquePtr<DX12Fence> fence;
+                        if (freeTransientFences.empty()) {
+                            fence = new DX12Fence(*this, false);
+                        } else {
+                            fence = std::move(freeTransientFences.back());
+                            freeTransientFences.pop_back();
+                        }
+                        queue->Flush(fence.Get());
+                        currentTransientFrame.fences.emplace_back(std::move(fence));
+                    }
+                }
+                retiringTransientFrames.emplace_back(std::move(currentTransientFrame));
+                currentTransientFrame = TransientFrame();
+            }
+        }
+        RecycleTransientFrames(false);
+    }
+
     Common::UniquePtr<Fence> DX12Device::CreateFence(const bool inInitAsSignaled)
     {
         return { new DX12Fence(*this, inInitAsSignaled) };
@@ -354,6 +410,31 @@ namespace RHI::DirectX12 {
         return dsvDescriptorPool->Allocate();
     }
 
+    void DX12Device::RecycleTransientFrames(const bool inWait)
+    {
+        std::unique_lock lock(transientCmdBuffersMutex);
+        while (!retiringTransientFrames.empty()) {
+            auto& frame = retiringTransientFrames.front();
+            for (const auto& fence : frame.fences) {
+                if (inWait) {
+                    fence->Wait();
+                } else if (!fence->IsSignaled()) {
+                    return;
+                }
+            }
+
+            for (auto& cmdBuffer : frame.cmdBuffers) {
+                const auto queueType = cmdBuffer->GetQueueType();
+                freeTransientCmdBuffers[queueType].emplace_back(std::move(cmdBuffer));
+            }
+            for (auto& fence : frame.fences) {
+                fence->Reset();
+                freeTransientFences.emplace_back(std::move(fence));
+            }
+            retiringTransientFrames.pop_front();
+        }
+    }
+
     void DX12Device::CreateNativeDevice()
     {
         Assert(SUCCEEDED(D3D12CreateDevice(gpu.GetNative(), D3D_FEATURE_LEVEL_12_1, IID_PPV_ARGS(&nativeDevice))));
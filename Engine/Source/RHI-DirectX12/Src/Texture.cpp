@@ -32,6 +32,12 @@ namespace RHI::DirectX12 {
         return Common::UniquePtr<TextureView>(new DX12TextureView(static_cast<DX12Device&>(device), *this, inCreateInfo));
     }
 
+    uint64_t DX12Texture::GetAllocatedSize() const
+    {
+        const D3D12_RESOURCE_DESC desc = nativeResource->GetDesc();
+        return device.GetNative()->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+    }
+
     ID3D12Resource* DX12Texture::GetNative() const
     {
         return nativeResource.Get();
@@ -16,6 +16,8 @@ namespace RHI::Dummy {
 
         void* Map(MapMode mapMode, size_t offset, size_t length) override;
         void Unmap() override;
+        void Flush(size_t offset, size_t length) override;
+        uint64_t GetAllocatedSize() const override;
     private:
         Common::UniquePtr<BufferView> CreateBufferViewInternal(const BufferViewCreateInfo& createInfo) override;
 
@@ -4,11 +4,15 @@
 
 #pragma once
 
+#include <mutex>
+#include <vector>
+
 #include <RHI/Device.h>
 #include <RHI/Dummy/Gpu.h>
 
 namespace RHI::Dummy {
     class DummyQueue;
+    class DummyCommandBuffer;
 
     class DummyDevice final : public Device {
     public:
@@ -32,6 +36,8 @@ namespace RHI::Dummy {
         Common::UniquePtr<ComputePipeline> CreateComputePipeline(const ComputePipelineCreateInfo& createInfo) override;
         Common::UniquePtr<RasterPipeline> CreateRasterPipeline(const RasterPipelineCreateInfo& createInfo) override;
         Common::UniquePtr<CommandBuffer> CreateCommandBuffer(QueueType queueType) override;
+        CommandBuffer* AcquireTransientCommandBuffer(QueueType queueType) override;
+        void BeginFrame() override;
         Common::UniquePtr<Fence> CreateFence(bool bInitAsSignaled) override;
         Common::UniquePtr<Semaphore> CreateSemaphore() override;
         Common::UniquePtr<QuerySet> CreateQuerySet(const QuerySetCreateInfo& createInfo) override;
@@ -42,5 +48,9 @@ namespace RHI::Dummy {
     private:
         DummyGpu& gpu;
         Common::UniquePtr<DummyQueue> dummyQueue;
+        // nothing executes on a gpu, transient command buffers are reusable as soon as the next frame begins
+        std::mutex transientCmdBuffersMutex;
+        std::vector<Common::UniquePtr<DummyCommandBuffer>> transientCmdBuffers;
+        size_t usedTransientCmdBufferNum;
     };
 }
@@ -13,6 +13,8 @@ namespace RHI::Dummy {
         explicit DummyTexture(const TextureCreateInfo& createInfo);
         ~DummyTexture() override;
 
+        uint64_t GetAllocatedSize() const override;
+
     private:
         Common::UniquePtr<TextureView> CreateTextureViewInternal(const TextureViewCreateInfo& createInfo) override;
     };
@@ -26,6 +26,17 @@ namespace RHI::Dummy {
     {
     }
 
+    void DummyBuffer::Flush(size_t offset, size_t length)
+    {
+        Assert(offset <= dummyData.size());
+        Assert(length <= dummyData.size() - offset);
+    }
+
+    uint64_t DummyBuffer::GetAllocatedSize() const
+    {
+        return dummyData.size();
+    }
+
     Common::UniquePtr<BufferView> DummyBuffer::CreateBufferViewInternal(const BufferViewCreateInfo& createInfo)
     {
         return Common::UniquePtr<BufferView>(new DummyBufferView(createInfo));
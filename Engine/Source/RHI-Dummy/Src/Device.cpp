@@ -27,6 +27,7 @@ namespace RHI::Dummy {
         : Device(createInfo)
         , gpu(gpu)
         , dummyQueue(Common::MakeUnique<DummyQueue>())
+        , usedTransientCmdBufferNum(0)
     {
     }
 
@@ -109,6 +110,22 @@ namespace RHI::Dummy {
         return { new DummyCommandBuffer(queueType) };
     }
 
+    CommandBuffer* DummyDevice::AcquireTransientCommandBuffer(const QueueType queueType)
+    {
+        Assert(queueType == QueueType::graphics);
+        std::unique_lock lock(transientCmdBuffersMutex);
+        if (usedTransientCmdBufferNum == transientCmdBuffers.size()) {
+            transientCmdBuffers.emplace_back(new DummyCommandBuffer(queueType));
+        }
+        return transientCmdBuffers[usedTransientCmdBufferNum++].Get();
+    }
+
+    void DummyDevice::BeginFrame()
+    {
+        std::unique_lock lock(transientCmdBuffersMutex);
+        usedTransientCmdBufferNum = 0;
+    }
+
     Common::UniquePtr<Fence> DummyDevice::CreateFence(const bool bInitAsSignaled)
     {
         return { new DummyFence(*this, bInitAsSignaled) };
@@ -2,6 +2,8 @@
 // Created by johnk on 2023/3/21.
 //
 
+#include <algorithm>
+
 #include <RHI/Dummy/Texture.h>
 #include <RHI/Dummy/TextureView.h>
 
@@ -13,6 +15,24 @@ namespace RHI::Dummy {
 
     DummyTexture::~DummyTexture() = default;
 
+    uint64_t DummyTexture::GetAllocatedSize() const
+    {
+        // tightly packed full mip chain, enough for the render side to budget and account textures without a gpu
+        const uint64_t layers = createInfo.type == TextureType::t3D ? 1 : createInfo.depthOrArraySize;
+        uint64_t width = createInfo.width;
+        uint64_t height = createInfo.height;
+        uint64_t depth = createInfo.type == TextureType::t3D ? createInfo.depthOrArraySize : 1;
+
+        uint64_t result = 0;
+        for (uint8_t mip = 0; mip < createInfo.mipLevels; mip++) {
+            result += width * height * depth;
+            width = std::max<uint64_t>(width / 2, 1);
+            height = std::max<uint64_t>(height / 2, 1);
+            depth = std::max<uint64_t>(depth / 2, 1);
+        }
+        return result * layers * createInfo.samples * GetBytesPerPixel(createInfo.format);
+    }
+
     Common::UniquePtr<TextureView> DummyTexture::CreateTextureViewInternal(const TextureViewCreateInfo& createInfo)
     {
         return Common::UniquePtr<TextureView>(new DummyTextureView(createInfo));
@@ -8,6 +8,7 @@
 #include <vulkan/vulkan.h>
 
 #include <RHI/BindGroup.h>
+#include <RHI/Vulkan/DescriptorAllocator.h>
 
 namespace RHI::Vulkan {
     class VulkanDevice;
@@ -21,11 +22,10 @@ namespace RHI::Vulkan {
         VkDescriptorSet GetNative() const;
 
     private:
-        void CreateNativeDescriptorPool(const BindGroupCreateInfo& inCreateInfo);
-        void CreateNativeDescriptorSet(const BindGroupCreateInfo& inCreateInfo);
+        void AllocateNativeDescriptorSet(const BindGroupCreateInfo& inCreateInfo);
+        void UpdateNativeDescriptorSet(const BindGroupCreateInfo& inCreateInfo);
 
         VulkanDevice& device;
-        VkDescriptorSet nativeDescriptorSet;
-        VkDescriptorPool nativeDescriptorPool;
+        VulkanDescriptorAllocation descriptorAllocation;
     };
 }
\ No newline at end of file
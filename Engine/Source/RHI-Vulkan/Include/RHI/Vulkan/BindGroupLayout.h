@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <vulkan/vulkan.h>
 
 #include <RHI/BindGroupLayout.h>
@@ -19,11 +21,14 @@ namespace RHI::Vulkan {
         ~VulkanBindGroupLayout() override;
 
         VkDescriptorSetLayout GetNative() const;
+        // number of descriptors of each type a set of this layout holds
+        const std::vector<VkDescriptorPoolSize>& GetDescriptorCounts() const;
 
     private:
         void CreateNativeDescriptorSetLayout(const BindGroupLayoutCreateInfo& inCreateInfo);
 
         VulkanDevice& device;
         VkDescriptorSetLayout nativeDescriptorSetLayout;
+        std::vector<VkDescriptorPoolSize> descriptorCounts;
     };
 }
\ No newline at end of file
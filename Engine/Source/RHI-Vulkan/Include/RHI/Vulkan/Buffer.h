@@ -21,6 +21,8 @@ namespace RHI::Vulkan {
 
         void* Map(MapMode inMapMode, size_t inOffset, size_t inLength) override;
         void Unmap() override;
+        void Flush(size_t inOffset, size_t inLength) override;
+        uint64_t GetAllocatedSize() const override;
 
         VkBuffer GetNative() const;
         BufferUsageFlags GetUsages() const;
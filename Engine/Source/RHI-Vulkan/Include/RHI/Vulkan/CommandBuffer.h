@@ -9,6 +9,7 @@
 #include <vulkan/vulkan.h>
 
 #include <RHI/CommandBuffer.h>
+#include <Common/Memory.h>
 
 namespace RHI::Vulkan {
     class VulkanDevice;
@@ -31,4 +32,23 @@ namespace RHI::Vulkan {
         VkCommandBuffer nativeCmdBuffer;
     };
 
+    // pool of transient command buffers, recorded by one thread at a time and reset as a whole once the gpu finished
+    // every submission of them, the command buffers are kept and handed out again after the reset
+    class VulkanCommandPool {
+    public:
+        NonCopyable(VulkanCommandPool)
+        VulkanCommandPool(VulkanDevice& inDevice, QueueType inQueueType, uint32_t inFamilyIndex);
+        ~VulkanCommandPool();
+
+        QueueType GetQueueType() const;
+        VulkanCommandBuffer* Acquire();
+        void Reset();
+
+    private:
+        VulkanDevice& device;
+        QueueType queueType;
+        VkCommandPool nativeCmdPool;
+        std::vector<Common::UniquePtr<VulkanCommandBuffer>> cmdBuffers;
+        size_t usedCount;
+    };
 }
@@ -0,0 +1,104 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include <Common/Memory.h>
+#include <Common/Utility.h>
+
+namespace RHI::Vulkan::Internal {
+    constexpr uint32_t transientDescriptorPoolMaxSets = 1024;
+    constexpr uint32_t persistentDescriptorPoolMaxSets = 256;
+    // lower bound of every descriptor type in a new pool, keeps a pool usable by layouts the statistics have not seen
+    constexpr uint32_t descriptorPoolMinDescriptorsPerType = 16;
+    // descriptor types a bind group can hold, indexed by VulkanDescriptorAllocator::GetTypeIndex
+    constexpr std::array descriptorPoolTypes = {
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        VK_DESCRIPTOR_TYPE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+    };
+}
+
+namespace RHI::Vulkan {
+    class VulkanDevice;
+    class VulkanBindGroupLayout;
+    struct VulkanDescriptorPool;
+
+    struct VulkanDescriptorAllocation {
+        VkDescriptorSet nativeSet;
+        VulkanDescriptorPool* pool;
+
+        VulkanDescriptorAllocation();
+    };
+
+    struct VulkanDescriptorAllocatorStats {
+        uint64_t setsAllocated;
+        uint64_t setsReleased;
+        uint64_t poolsCreated;
+        uint64_t poolResets;
+        // allocations that found their pool exhausted and moved on to another one
+        uint64_t poolOverflows;
+
+        VulkanDescriptorAllocatorStats();
+    };
+
+    // allocates the descriptor sets of bind groups from shared pools instead of one pool per bind group. transient sets
+    // are bumped out of large pools that are reset as a whole once every set allocated from them is released, which
+    // happens when the frames that used them have been retired by the gpu. persistent sets come from pools created
+    // with free descriptor set support and are returned to their pool one by one. new pools are sized by the average
+    // descriptor counts of the sets allocated so far.
+    class VulkanDescriptorAllocator {
+    public:
+        NonCopyable(VulkanDescriptorAllocator)
+        explicit VulkanDescriptorAllocator(VulkanDevice& inDevice);
+        ~VulkanDescriptorAllocator();
+
+        VulkanDescriptorAllocation Allocate(const VulkanBindGroupLayout& inLayout, bool inTransient);
+        void Release(const VulkanDescriptorAllocation& inAllocation);
+        size_t GetPoolCount() const;
+        VulkanDescriptorAllocatorStats GetStats() const;
+        void ResetCounters();
+
+    private:
+        using DescriptorCounts = std::array<uint64_t, Internal::descriptorPoolTypes.size()>;
+
+        struct PoolStatistics {
+            uint64_t sets;
+            DescriptorCounts descriptors;
+
+            PoolStatistics();
+        };
+
+        static size_t GetTypeIndex(VkDescriptorType inType);
+
+        VulkanDescriptorPool* CreatePool(const VulkanBindGroupLayout& inLayout, bool inTransient);
+        VulkanDescriptorPool* AcquireTransientPool(const VulkanBindGroupLayout& inLayout);
+        VulkanDescriptorPool* AcquirePersistentPool(const VulkanBindGroupLayout& inLayout);
+        bool TryAllocate(VulkanDescriptorPool& inPool, const VulkanBindGroupLayout& inLayout, VkDescriptorSet& outSet);
+        void ResetPool(VulkanDescriptorPool& inPool);
+        void Record(const VulkanBindGroupLayout& inLayout, bool inTransient);
+
+        VulkanDevice& device;
+        mutable std::mutex mutex;
+        std::deque<Common::UniquePtr<VulkanDescriptorPool>> pools;
+        // pool transient sets are currently bumped from, retired pools are reset by the release of their last set
+        VulkanDescriptorPool* currentTransientPool;
+        std::vector<VulkanDescriptorPool*> freeTransientPools;
+        // persistent pools that have room for at least one more set as far as known
+        std::vector<VulkanDescriptorPool*> availablePersistentPools;
+        PoolStatistics transientStatistics;
+        PoolStatistics persistentStatistics;
+        VulkanDescriptorAllocatorStats stats;
+    };
+}
@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <deque>
+#include <map>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -13,9 +17,12 @@
 
 #include <RHI/Device.h>
 #include <RHI/Vulkan/Gpu.h>
+#include <RHI/Vulkan/DescriptorAllocator.h>
 
 namespace RHI::Vulkan {
     class VulkanQueue;
+    class VulkanCommandPool;
+    class VulkanFence;
 
     class VulkanDevice final : public Device {
     public:
@@ -39,6 +46,8 @@ namespace RHI::Vulkan {
         Common::UniquePtr<ComputePipeline> CreateComputePipeline(const ComputePipelineCreateInfo& inCreateInfo) override;
         Common::UniquePtr<RasterPipeline> CreateRasterPipeline(const RasterPipelineCreateInfo& inCreateInfo) override;
         Common::UniquePtr<CommandBuffer> CreateCommandBuffer(QueueType inQueueType) override;
+        CommandBuffer* AcquireTransientCommandBuffer(QueueType inQueueType) override;
+        void BeginFrame() override;
         Common::UniquePtr<Fence> CreateFence(bool initAsSignaled) override;
         Common::UniquePtr<Semaphore> CreateSemaphore() override;
         Common::UniquePtr<QuerySet> CreateQuerySet(const QuerySetCreateInfo& inCreateInfo) override;
@@ -50,6 +59,7 @@ namespace RHI::Vulkan {
         VmaAllocator& GetNativeAllocator();
         const std::vector<uint32_t>& GetActiveQueueFamilyIndices() const;
         const VkPhysicalDeviceFeatures& GetEnabledFeatures() const;
+        VulkanDescriptorAllocator& GetDescriptorAllocator();
 
 #if BUILD_CONFIG_DEBUG
         void SetObjectName(VkObjectType inObjectType, uint64_t inObjectHandle, const char* inObjectName) const;
@@ -61,9 +71,22 @@ namespace RHI::Vulkan {
             std::vector<uint32_t> queueIndices;
         };
 
+        struct TransientFrame {
+            std::vector<Common::UniquePtr<VulkanCommandPool>> cmdPools;
+            // signaled by an empty submission to every queue the command buffers may have been submitted to
+            std::vector<Common::UniquePtr<VulkanFence>> fences;
+
+            TransientFrame();
+            TransientFrame(TransientFrame&& inOther) noexcept;
+            ~TransientFrame();
+            TransientFrame& operator=(TransientFrame&& inOther) noexcept;
+        };
+
         void CreateNativeDevice(const DeviceCreateInfo& inCreateInfo);
         void GetQueues();
         void CreateNativeVmaAllocator();
+        VkCommandPool GetOrCreateThreadCommandPool(QueueType inQueueType);
+        void RecycleTransientFrames(bool inWait);
 
         VulkanGpu& gpu;
         VkDevice nativeDevice;
@@ -72,6 +95,15 @@ namespace RHI::Vulkan {
         std::vector<uint32_t> activeQueueFamilyIndices;
         std::unordered_map<QueueType, QueueFamilyMapping> queueFamilyMappings;
         std::unordered_map<QueueType, std::vector<Common::UniquePtr<VulkanQueue>>> queues;
-        std::unordered_map<QueueType, VkCommandPool> nativeCmdPools;
+        std::mutex nativeCmdPoolsMutex;
+        std::map<std::pair<std::thread::id, QueueType>, VkCommandPool> nativeCmdPools;
+        std::mutex transientCmdPoolsMutex;
+        // pools of the current frame, one per recording thread and queue type
+        std::map<std::pair<std::thread::id, QueueType>, VulkanCommandPool*> frameTransientCmdPools;
+        TransientFrame currentTransientFrame;
+        std::deque<TransientFrame> retiringTransientFrames;
+        std::vector<Common::UniquePtr<VulkanCommandPool>> freeTransientCmdPools;
+        std::vector<Common::UniquePtr<VulkanFence>> freeTransientFences;
+        Common::UniquePtr<VulkanDescriptorAllocator> descriptorAllocator;
     };
 }
@@ -23,6 +23,8 @@ namespace RHI::Vulkan {
         VulkanTexture(VulkanDevice& inDevice, const TextureCreateInfo& inCreateInfo);
         ~VulkanTexture() override;
 
+        uint64_t GetAllocatedSize() const override;
+
         VkImage GetNative() const;
         VkImageSubresourceRange GetNativeSubResourceFullRange() const;
 
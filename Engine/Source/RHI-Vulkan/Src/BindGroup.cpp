@@ -16,61 +16,36 @@ namespace RHI::Vulkan {
         : BindGroup(inCreateInfo)
         , device(inDevice)
     {
-        CreateNativeDescriptorPool(inCreateInfo);
-        CreateNativeDescriptorSet(inCreateInfo);
+        AllocateNativeDescriptorSet(inCreateInfo);
+        UpdateNativeDescriptorSet(inCreateInfo);
     }
 
     VulkanBindGroup::~VulkanBindGroup() noexcept
     {
-        if (nativeDescriptorPool != VK_NULL_HANDLE) {
-            vkDestroyDescriptorPool(device.GetNative(), nativeDescriptorPool, nullptr);
+        if (descriptorAllocation.nativeSet != VK_NULL_HANDLE) {
+            device.GetDescriptorAllocator().Release(descriptorAllocation);
         }
     }
 
     VkDescriptorSet VulkanBindGroup::GetNative() const
     {
-        return nativeDescriptorSet;
+        return descriptorAllocation.nativeSet;
     }
 
-    void VulkanBindGroup::CreateNativeDescriptorPool(const BindGroupCreateInfo& inCreateInfo)
+    void VulkanBindGroup::AllocateNativeDescriptorSet(const BindGroupCreateInfo& inCreateInfo)
     {
-        const auto entryCount = inCreateInfo.entries.size();
-
-        std::vector<VkDescriptorPoolSize> poolSizes(entryCount);
-        for (auto i = 0; i < entryCount; i++) {
-            const auto& entry = inCreateInfo.entries[i];
-
-            poolSizes[i].type = EnumCast<BindingType, VkDescriptorType>(entry.binding.type);
-            poolSizes[i].descriptorCount = 1;
-        }
-
-        VkDescriptorPoolCreateInfo poolInfo {};
-        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        poolInfo.pPoolSizes = poolSizes.data();
-        poolInfo.poolSizeCount = poolSizes.size();
-        poolInfo.maxSets = 1;
-
-        Assert(vkCreateDescriptorPool(device.GetNative(), &poolInfo, nullptr, &nativeDescriptorPool) == VK_SUCCESS);
-    }
-
-    void VulkanBindGroup::CreateNativeDescriptorSet(const BindGroupCreateInfo& inCreateInfo)
-    {
-        const VkDescriptorSetLayout layout = static_cast<VulkanBindGroupLayout*>(inCreateInfo.layout)->GetNative();
-
-        VkDescriptorSetAllocateInfo allocInfo {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorSetCount = 1;
-        allocInfo.pSetLayouts = &layout;
-        allocInfo.descriptorPool = nativeDescriptorPool;
-
-        Assert(vkAllocateDescriptorSets(device.GetNative(), &allocInfo, &nativeDescriptorSet) == VK_SUCCESS);
+        const auto* layout = static_cast<VulkanBindGroupLayout*>(inCreateInfo.layout);
+        descriptorAllocation = device.GetDescriptorAllocator().Allocate(*layout, inCreateInfo.transient);
 
 #if BUILD_CONFIG_DEBUG
         if (!inCreateInfo.debugName.empty()) {
-            device.SetObjectName(VK_OBJECT_TYPE_DESCRIPTOR_SET, reinterpret_cast<uint64_t>(nativeDescriptorSet), inCreateInfo.debugName.c_str());
+            device.SetObjectName(VK_OBJECT_TYPE_DESCRIPTOR_SET, reinterpret_cast<uint64_t>(descriptorAllocation.nativeSet), inCreateInfo.debugName.c_str());
         }
 #endif
+    }
 
+    void VulkanBindGroup::UpdateNativeDescriptorSet(const BindGroupCreateInfo& inCreateInfo)
+    {
         const auto entryCount = inCreateInfo.entries.size();
 
         std::vector<VkWriteDescriptorSet> descriptorWrites(entryCount);
@@ -99,7 +74,7 @@ namespace RHI::Vulkan {
             const auto& entry = inCreateInfo.entries[i];
 
             descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrites[i].dstSet = nativeDescriptorSet;
+            descriptorWrites[i].dstSet = descriptorAllocation.nativeSet;
             descriptorWrites[i].dstBinding = std::get<GlslBinding>(entry.binding.platformBinding).index;
             descriptorWrites[i].descriptorCount = 1;
             descriptorWrites[i].descriptorType = EnumCast<BindingType, VkDescriptorType>(entry.binding.type);
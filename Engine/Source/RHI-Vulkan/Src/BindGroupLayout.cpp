@@ -5,6 +5,7 @@
 #include <RHI/Vulkan/BindGroupLayout.h>
 #include <RHI/Vulkan/Device.h>
 #include <RHI/Vulkan/Common.h>
+#include <algorithm>
 #include <vector>
 
 namespace RHI::Vulkan {
@@ -27,6 +28,11 @@ namespace RHI::Vulkan {
         return nativeDescriptorSetLayout;
     }
 
+    const std::vector<VkDescriptorPoolSize>& VulkanBindGroupLayout::GetDescriptorCounts() const
+    {
+        return descriptorCounts;
+    }
+
     void VulkanBindGroupLayout::CreateNativeDescriptorSetLayout(const BindGroupLayoutCreateInfo& inCreateInfo)
     {
         VkDescriptorSetLayoutCreateInfo layoutInfo = {};
@@ -40,6 +46,15 @@ namespace RHI::Vulkan {
             bindings[i].descriptorCount = 1;
             bindings[i].binding = std::get<GlslBinding>(entry.binding.platformBinding).index;
             bindings[i].stageFlags = FlagsCast<ShaderStageFlags, VkShaderStageFlags>(entry.shaderVisibility);
+
+            const auto iter = std::ranges::find_if(descriptorCounts, [&](const VkDescriptorPoolSize& inSize) -> bool {
+                return inSize.type == bindings[i].descriptorType;
+            });
+            if (iter == descriptorCounts.end()) {
+                descriptorCounts.emplace_back(VkDescriptorPoolSize { bindings[i].descriptorType, bindings[i].descriptorCount });
+            } else {
+                iter->descriptorCount += bindings[i].descriptorCount;
+            }
         }
 
         layoutInfo.pBindings = bindings.data();
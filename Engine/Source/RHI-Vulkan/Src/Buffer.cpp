@@ -53,6 +53,12 @@ namespace RHI::Vulkan {
         vmaUnmapMemory(device.GetNativeAllocator(), nativeAllocation);
     }
 
+    void VulkanBuffer::Flush(const size_t inOffset, const size_t inLength)
+    {
+        Assert(mapMode == MapMode::write);
+        Assert(vmaFlushAllocation(device.GetNativeAllocator(), nativeAllocation, inOffset, inLength) == VK_SUCCESS);
+    }
+
     Common::UniquePtr<BufferView> VulkanBuffer::CreateBufferViewInternal(const BufferViewCreateInfo& inCreateInfo)
     {
         return Common::UniquePtr<BufferView>(new VulkanBufferView(*this, inCreateInfo));
@@ -115,6 +121,13 @@ namespace RHI::Vulkan {
         return nativeBuffer;
     }
 
+    uint64_t VulkanBuffer::GetAllocatedSize() const
+    {
+        VmaAllocationInfo allocationInfo;
+        vmaGetAllocationInfo(device.GetNativeAllocator(), nativeAllocation, &allocationInfo);
+        return allocationInfo.size;
+    }
+
     BufferUsageFlags VulkanBuffer::GetUsages() const
     {
         return usages;
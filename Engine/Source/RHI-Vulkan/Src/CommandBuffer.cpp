@@ -28,8 +28,8 @@ namespace RHI::Vulkan {
     {
         VkCommandBufferBeginInfo beginInfo = {};
         beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        // TODO maybe expose this to create info ?
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+        // every recording is submitted once, resubmitting needs a new Begin()
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
         vkBeginCommandBuffer(nativeCmdBuffer, &beginInfo);
         return { new VulkanCommandRecorder(device, *this) };
@@ -50,4 +50,45 @@ namespace RHI::Vulkan {
 
         Assert(vkAllocateCommandBuffers(device.GetNative(), &cmdInfo, &nativeCmdBuffer) == VK_SUCCESS);
     }
+
+    VulkanCommandPool::VulkanCommandPool(VulkanDevice& inDevice, QueueType inQueueType, uint32_t inFamilyIndex)
+        : device(inDevice)
+        , queueType(inQueueType)
+        , nativeCmdPool(VK_NULL_HANDLE)
+        , usedCount(0)
+    {
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = inFamilyIndex;
+
+        Assert(vkCreateCommandPool(device.GetNative(), &poolInfo, nullptr, &nativeCmdPool) == VK_SUCCESS);
+    }
+
+    VulkanCommandPool::~VulkanCommandPool()
+    {
+        cmdBuffers.clear();
+        if (nativeCmdPool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(device.GetNative(), nativeCmdPool, nullptr);
+        }
+    }
+
+    QueueType VulkanCommandPool::GetQueueType() const
+    {
+        return queueType;
+    }
+
+    VulkanCommandBuffer* VulkanCommandPool::Acquire()
+    {
+        if (usedCount == cmdBuffers.size()) {
+            cmdBuffers.emplace_back(new VulkanCommandBuffer(device, queueType, nativeCmdPool));
+        }
+        return cmdBuffers[usedCount++].Get();
+    }
+
+    void VulkanCommandPool::Reset()
+    {
+        Assert(vkResetCommandPool(device.GetNative(), nativeCmdPool, 0) == VK_SUCCESS);
+        usedCount = 0;
+    }
 }
@@ -0,0 +1,225 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <algorithm>
+
+#include <RHI/Vulkan/DescriptorAllocator.h>
+#include <RHI/Vulkan/BindGroupLayout.h>
+#include <RHI/Vulkan/Device.h>
+#include <Common/Debug.h>
+
+namespace RHI::Vulkan {
+    struct VulkanDescriptorPool {
+        VkDescriptorPool nativePool;
+        bool transient;
+        // set once an allocation failed, cleared when a set is given back
+        bool exhausted;
+        uint32_t liveSets;
+    };
+
+    VulkanDescriptorAllocation::VulkanDescriptorAllocation()
+        : nativeSet(VK_NULL_HANDLE)
+        , pool(nullptr)
+    {
+    }
+
+    VulkanDescriptorAllocatorStats::VulkanDescriptorAllocatorStats()
+        : setsAllocated(0)
+        , setsReleased(0)
+        , poolsCreated(0)
+        , poolResets(0)
+        , poolOverflows(0)
+    {
+    }
+
+    VulkanDescriptorAllocator::PoolStatistics::PoolStatistics()
+        : sets(0)
+        , descriptors()
+    {
+    }
+
+    VulkanDescriptorAllocator::VulkanDescriptorAllocator(VulkanDevice& inDevice)
+        : device(inDevice)
+        , currentTransientPool(nullptr)
+    {
+    }
+
+    VulkanDescriptorAllocator::~VulkanDescriptorAllocator()
+    {
+        for (const auto& pool : pools) {
+            vkDestroyDescriptorPool(device.GetNative(), pool->nativePool, nullptr);
+        }
+    }
+
+    VulkanDescriptorAllocation VulkanDescriptorAllocator::Allocate(const VulkanBindGroupLayout& inLayout, bool inTransient)
+    {
+        std::unique_lock lock(mutex);
+        Record(inLayout, inTransient);
+
+        VulkanDescriptorAllocation result;
+        while (result.pool == nullptr) {
+            auto* pool = inTransient ? AcquireTransientPool(inLayout) : AcquirePersistentPool(inLayout);
+            if (TryAllocate(*pool, inLayout, result.nativeSet)) {
+                result.pool = pool;
+            } else {
+                // a freshly created or reset pool is sized to hold at least one set of the layout
+                Assert(pool->liveSets > 0);
+                pool->exhausted = true;
+                stats.poolOverflows++;
+            }
+        }
+        result.pool->liveSets++;
+        stats.setsAllocated++;
+        return result;
+    }
+
+    void VulkanDescriptorAllocator::Release(const VulkanDescriptorAllocation& inAllocation)
+    {
+        Assert(inAllocation.pool != nullptr);
+        auto& pool = *inAllocation.pool;
+
+        std::unique_lock lock(mutex);
+        Assert(pool.liveSets > 0);
+        pool.liveSets--;
+        stats.setsReleased++;
+
+        if (pool.transient) {
+            if (pool.liveSets == 0) {
+                ResetPool(pool);
+                if (&pool != currentTransientPool) {
+                    freeTransientPools.emplace_back(&pool);
+                }
+            }
+        } else {
+            vkFreeDescriptorSets(device.GetNative(), pool.nativePool, 1, &inAllocation.nativeSet);
+            if (pool.exhausted) {
+                pool.exhausted = false;
+                availablePersistentPools.emplace_back(&pool);
+            }
+        }
+    }
+
+    size_t VulkanDescriptorAllocator::GetPoolCount() const
+    {
+        std::unique_lock lock(mutex);
+        return pools.size();
+    }
+
+    VulkanDescriptorAllocatorStats VulkanDescriptorAllocator::GetStats() const
+    {
+        std::unique_lock lock(mutex);
+        return stats;
+    }
+
+    void VulkanDescriptorAllocator::ResetCounters()
+    {
+        std::unique_lock lock(mutex);
+        stats = VulkanDescriptorAllocatorStats();
+    }
+
+    size_t VulkanDescriptorAllocator::GetTypeIndex(VkDescriptorType inType)
+    {
+        const auto iter = std::ranges::find(Internal::descriptorPoolTypes, inType);
+        Assert(iter != Internal::descriptorPoolTypes.end());
+        return iter - Internal::descriptorPoolTypes.begin();
+    }
+
+    VulkanDescriptorPool* VulkanDescriptorAllocator::CreatePool(const VulkanBindGroupLayout& inLayout, bool inTransient)
+    {
+        const auto& statistics = inTransient ? transientStatistics : persistentStatistics;
+        const auto maxSets = inTransient ? Internal::transientDescriptorPoolMaxSets : Internal::persistentDescriptorPoolMaxSets;
+
+        DescriptorCounts layoutCounts {};
+        for (const auto& [type, count] : inLayout.GetDescriptorCounts()) {
+            layoutCounts[GetTypeIndex(type)] += count;
+        }
+
+        std::vector<VkDescriptorPoolSize> poolSizes(Internal::descriptorPoolTypes.size());
+        for (auto i = 0; i < poolSizes.size(); i++) {
+            const auto average = (statistics.descriptors[i] * maxSets + statistics.sets - 1) / statistics.sets;
+            poolSizes[i].type = Internal::descriptorPoolTypes[i];
+            poolSizes[i].descriptorCount = static_cast<uint32_t>(std::max({ average, layoutCounts[i], static_cast<uint64_t>(Internal::descriptorPoolMinDescriptorsPerType) }));
+        }
+
+        VkDescriptorPoolCreateInfo poolInfo {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = inTransient ? 0 : VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+        poolInfo.pPoolSizes = poolSizes.data();
+        poolInfo.poolSizeCount = poolSizes.size();
+        poolInfo.maxSets = maxSets;
+
+        auto& pool = pools.emplace_back(new VulkanDescriptorPool());
+        pool->transient = inTransient;
+        pool->exhausted = false;
+        pool->liveSets = 0;
+        Assert(vkCreateDescriptorPool(device.GetNative(), &poolInfo, nullptr, &pool->nativePool) == VK_SUCCESS);
+        stats.poolsCreated++;
+        return pool.Get();
+    }
+
+    VulkanDescriptorPool* VulkanDescriptorAllocator::AcquireTransientPool(const VulkanBindGroupLayout& inLayout)
+    {
+        if (currentTransientPool != nullptr && !currentTransientPool->exhausted) {
+            return currentTransientPool;
+        }
+
+        // the retired pool stays untouched until its last set is released
+        if (currentTransientPool != nullptr && currentTransientPool->liveSets == 0) {
+            ResetPool(*currentTransientPool);
+            return currentTransientPool;
+        }
+
+        if (freeTransientPools.empty()) {
+            currentTransientPool = CreatePool(inLayout, true);
+        } else {
+            currentTransientPool = freeTransientPools.back();
+            freeTransientPools.pop_back();
+        }
+        return currentTransientPool;
+    }
+
+    VulkanDescriptorPool* VulkanDescriptorAllocator::AcquirePersistentPool(const VulkanBindGroupLayout& inLayout)
+    {
+        while (!availablePersistentPools.empty()) {
+            auto* pool = availablePersistentPools.back();
+            if (!pool->exhausted) {
+                return pool;
+            }
+            availablePersistentPools.pop_back();
+        }
+        return availablePersistentPools.emplace_back(CreatePool(inLayout, false));
+    }
+
+    bool VulkanDescriptorAllocator::TryAllocate(VulkanDescriptorPool& inPool, const VulkanBindGroupLayout& inLayout, VkDescriptorSet& outSet)
+    {
+        const VkDescriptorSetLayout layout = inLayout.GetNative();
+
+        VkDescriptorSetAllocateInfo allocInfo {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+        allocInfo.descriptorPool = inPool.nativePool;
+
+        const auto result = vkAllocateDescriptorSets(device.GetNative(), &allocInfo, &outSet);
+        Assert(result == VK_SUCCESS || result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL);
+        return result == VK_SUCCESS;
+    }
+
+    void VulkanDescriptorAllocator::ResetPool(VulkanDescriptorPool& inPool)
+    {
+        Assert(inPool.transient && inPool.liveSets == 0);
+        vkResetDescriptorPool(device.GetNative(), inPool.nativePool, 0);
+        inPool.exhausted = false;
+        stats.poolResets++;
+    }
+
+    void VulkanDescriptorAllocator::Record(const VulkanBindGroupLayout& inLayout, bool inTransient)
+    {
+        auto& statistics = inTransient ? transientStatistics : persistentStatistics;
+        statistics.sets++;
+        for (const auto& [type, count] : inLayout.GetDescriptorCounts()) {
+            statistics.descriptors[GetTypeIndex(type)] += count;
+        }
+    }
+}
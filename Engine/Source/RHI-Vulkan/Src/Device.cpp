@@ -7,7 +7,10 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <ranges>
 #include <span>
+#include <thread>
+#include <unordered_set>
 
 #include <RHI/Vulkan/Common.h>
 #include <RHI/Vulkan/Instance.h>
@@ -102,13 +105,28 @@ namespace RHI::Vulkan {
         CreateNativeDevice(inCreateInfo);
         GetQueues();
         CreateNativeVmaAllocator();
+        descriptorAllocator = new VulkanDescriptorAllocator(*this);
     }
 
+    VulkanDevice::TransientFrame::TransientFrame() = default;
+
+    VulkanDevice::TransientFrame::TransientFrame(TransientFrame&& inOther) noexcept = default;
+
+    VulkanDevice::TransientFrame::~TransientFrame() = default;
+
+    VulkanDevice::TransientFrame& VulkanDevice::TransientFrame::operator=(TransientFrame&& inOther) noexcept = default;
+
     VulkanDevice::~VulkanDevice()
     {
+        // transient command buffers still in flight are waited so they are not destroyed while executing
+        BeginFrame();
+        RecycleTransientFrames(true);
+        freeTransientCmdPools.clear();
+        freeTransientFences.clear();
+        descriptorAllocator.Reset();
         vmaDestroyAllocator(nativeAllocator);
 
-        for (auto& [queue, pool] : nativeCmdPools) {
+        for (auto& pool : nativeCmdPools | std::views::values) {
             vkDestroyCommandPool(nativeDevice, pool, nullptr);
         }
         vkDestroyDevice(nativeDevice, nullptr);
@@ -188,8 +206,62 @@ namespace RHI::Vulkan {
 
     Common::UniquePtr<CommandBuffer> VulkanDevice::CreateCommandBuffer(const QueueType inQueueType)
     {
-        Assert(nativeCmdPools.contains(inQueueType));
-        return { new VulkanCommandBuffer(*this, inQueueType, nativeCmdPools.at(inQueueType)) };
+        return { new VulkanCommandBuffer(*this, inQueueType, GetOrCreateThreadCommandPool(inQueueType)) };
+    }
+
+    CommandBuffer* VulkanDevice::AcquireTransientCommandBuffer(const QueueType inQueueType)
+    {
+        const auto key = std::make_pair(std::this_thread::get_id(), inQueueType);
+        std::unique_lock lock(transientCmdPoolsMutex);
+        if (const auto iter = frameTransientCmdPools.find(key);
+            iter != frameTransientCmdPools.end()) {
+            return iter->second->Acquire();
+        }
+
+        Common::UniquePtr<VulkanCommandPool> cmdPool;
+        if (const auto iter = std::ranges::find_if(freeTransientCmdPools, [&](const Common::UniquePtr<VulkanCommandPool>& inPool) -> bool { return inPool->GetQueueType() == inQueueType; });
+            iter != freeTransientCmdPools.end()) {
+            cmdPool = std::move(*iter);
+            freeTransientCmdPools.erase(iter);
+        } else {
+            Assert(queueFamilyMappings.contains(inQueueType));
+            cmdPool = new VulkanCommandPool(*this, inQueueType, queueFamilyMappings.at(inQueueType).familyIndex);
+        }
+
+        auto* result = cmdPool.Get();
+        frameTransientCmdPools.emplace(key, result);
+        currentTransientFrame.cmdPools.emplace_back(std::move(cmdPool));
+        return result->Acquire();
+    }
+
+    void VulkanDevice::BeginFrame()
+    {
+        {
+            std::unique_lock lock(transientCmdPoolsMutex);
+            if (!currentTransientFrame.cmdPools.empty()) {
+                std::unordered_set<QueueType> queueTypes;
+                for (const auto& cmdPool : currentTransientFrame.cmdPools) {
+                    queueTypes.emplace(cmdPool->GetQueueType());
+                }
+                for (const auto queueType : queueTypes) {
+                    for (const auto& queue : queues.at(queueType)) {
+                        Common::UniquePtr<VulkanFence> fence;
+                        if (freeTransientFences.empty()) {
+                            fence = new VulkanFence(*this, false);
+                        } else {
+                            fence = std::move(freeTransientFences.back());
+                            freeTransientFences.pop_back();
+                        }
+                        queue->Flush(fence.Get());
+                        currentTransientFrame.fences.emplace_back(std::move(fence));
+                    }
+                }
+                retiringTransientFrames.emplace_back(std::move(currentTransientFrame));
+                currentTransientFrame = TransientFrame();
+                frameTransientCmdPools.clear();
+            }
+        }
+        RecycleTransientFrames(false);
     }
 
     Common::UniquePtr<Fence> VulkanDevice::CreateFence(const bool initAsSignaled)
@@ -273,6 +345,11 @@ namespace RHI::Vulkan {
         return enabledFeatures;
     }
 
+    VulkanDescriptorAllocator& VulkanDevice::GetDescriptorAllocator()
+    {
+        return *descriptorAllocator;
+    }
+
     void VulkanDevice::CreateNativeDevice(const DeviceCreateInfo& inCreateInfo)
     {
         uint32_t queueFamilyPropertyCnt = 0;
@@ -408,10 +485,6 @@ namespace RHI::Vulkan {
     {
         std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<std::mutex>> nativeQueueMutexes;
 
-        VkCommandPoolCreateInfo poolInfo = {};
-        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-
         for (const auto& [queueType, queueFamilyInfo] : queueFamilyMappings) {
             const auto queueFamilyIndex = queueFamilyInfo.familyIndex;
             const auto& queueIndices = queueFamilyInfo.queueIndices;
@@ -429,12 +502,54 @@ namespace RHI::Vulkan {
                 tempQueues[i] = Common::MakeUnique<VulkanQueue>(*this, queueType, queueFamilyIndex, queue, queueMutex);
             }
             queues[queueType] = std::move(tempQueues);
+        }
+    }
+
+    VkCommandPool VulkanDevice::GetOrCreateThreadCommandPool(QueueType inQueueType)
+    {
+        // command pools are externally synchronized, each recording thread allocates from its own pool so command
+        // buffers can be recorded in parallel, they must be freed when their owner thread is not recording
+        const auto key = std::make_pair(std::this_thread::get_id(), inQueueType);
+        std::unique_lock lock(nativeCmdPoolsMutex);
+        if (const auto iter = nativeCmdPools.find(key);
+            iter != nativeCmdPools.end()) {
+            return iter->second;
+        }
+
+        Assert(queueFamilyMappings.contains(inQueueType));
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = queueFamilyMappings.at(inQueueType).familyIndex;
+
+        VkCommandPool pool;
+        Assert(vkCreateCommandPool(nativeDevice, &poolInfo, nullptr, &pool) == VK_SUCCESS);
+        nativeCmdPools.emplace(key, pool);
+        return pool;
+    }
 
-            poolInfo.queueFamilyIndex = queueFamilyIndex;
+    void VulkanDevice::RecycleTransientFrames(const bool inWait)
+    {
+        std::unique_lock lock(transientCmdPoolsMutex);
+        while (!retiringTransientFrames.empty()) {
+            auto& frame = retiringTransientFrames.front();
+            for (const auto& fence : frame.fences) {
+                if (inWait) {
+                    fence->Wait();
+                } else if (!fence->IsSignaled()) {
+                    return;
+                }
+            }
 
-            VkCommandPool pool;
-            Assert(vkCreateCommandPool(nativeDevice, &poolInfo, nullptr, &pool) == VK_SUCCESS);
-            nativeCmdPools.emplace(queueType, pool);
+            for (auto& cmdPool : frame.cmdPools) {
+                cmdPool->Reset();
+                freeTransientCmdPools.emplace_back(std::move(cmdPool));
+            }
+            for (auto& fence : frame.fences) {
+                fence->Reset();
+                freeTransientFences.emplace_back(std::move(fence));
+            }
+            retiringTransientFrames.pop_front();
         }
     }
 
@@ -56,6 +56,16 @@ namespace RHI::Vulkan {
         return nativeImage;
     }
 
+    uint64_t VulkanTexture::GetAllocatedSize() const
+    {
+        if (!ownMemory) {
+            return 0;
+        }
+        VmaAllocationInfo allocationInfo;
+        vmaGetAllocationInfo(device.GetNativeAllocator(), nativeAllocation, &allocationInfo);
+        return allocationInfo.size;
+    }
+
     VkImageSubresourceRange VulkanTexture::GetNativeSubResourceFullRange() const
     {
         if (createInfo.type == TextureType::t3D) {
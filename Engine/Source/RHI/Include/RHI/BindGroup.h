@@ -31,9 +31,13 @@ namespace RHI {
         BindGroupLayout* layout;
         std::vector<BindGroupEntry> entries;
         std::string debugName;
+        // transient bind groups are only used by the frames being recorded and destroyed once the gpu retired them,
+        // backends may suballocate them from memory that is recycled as a whole
+        bool transient;
 
         explicit BindGroupCreateInfo(BindGroupLayout* inLayout, std::string inDebugName = "");
         BindGroupCreateInfo& AddEntry(const BindGroupEntry& inEntry);
+        BindGroupCreateInfo& SetTransient(bool inTransient);
     };
 
     class BindGroup {
@@ -37,6 +37,10 @@ namespace RHI {
         const BufferCreateInfo& GetCreateInfo() const;
         virtual void* Map(MapMode mapMode, size_t offset, size_t length) = 0;
         virtual void Unmap() = 0;
+        // makes cpu writes to a range of a buffer that stays mapped visible to the gpu, the buffer must be mapped for write
+        virtual void Flush(size_t offset, size_t length) = 0;
+        // bytes of device memory backing the buffer, may exceed the requested size because of alignment
+        virtual uint64_t GetAllocatedSize() const = 0;
         Common::UniquePtr<BufferView> CreateBufferView(const BufferViewCreateInfo& createInfo);
 
     protected:
@@ -83,6 +83,12 @@ namespace RHI {
         virtual Common::UniquePtr<ComputePipeline> CreateComputePipeline(const ComputePipelineCreateInfo& createInfo) = 0;
         virtual Common::UniquePtr<RasterPipeline> CreateRasterPipeline(const RasterPipelineCreateInfo& createInfo) = 0;
         virtual Common::UniquePtr<CommandBuffer> CreateCommandBuffer(QueueType queueType) = 0;
+        // transient command buffers are owned by the device and recycled once the gpu finished the frame they were
+        // acquired in, acquire them on the thread recording them and submit them before the frame ends
+        virtual CommandBuffer* AcquireTransientCommandBuffer(QueueType queueType) = 0;
+        // starts a new frame of transient command buffers, the ones acquired before are recycled once all work
+        // submitted to the device until now has finished
+        virtual void BeginFrame() = 0;
         virtual Common::UniquePtr<Fence> CreateFence(bool bInitAsSignaled) = 0;
         virtual Common::UniquePtr<Semaphore> CreateSemaphore() = 0;
         virtual Common::UniquePtr<QuerySet> CreateQuerySet(const QuerySetCreateInfo& createInfo) = 0;
@@ -46,6 +46,8 @@ namespace RHI {
         virtual ~Texture();
 
         const TextureCreateInfo& GetCreateInfo() const;
+        // bytes of device memory backing the texture, 0 for textures not owning their memory (e.g. swap chain images)
+        virtual uint64_t GetAllocatedSize() const = 0;
         Common::UniquePtr<TextureView> CreateTextureView(const TextureViewCreateInfo& createInfo);
 
     protected:
@@ -20,6 +20,7 @@ namespace RHI {
     BindGroupCreateInfo::BindGroupCreateInfo(BindGroupLayout* inLayout, std::string inDebugName)
         : layout(inLayout)
         , debugName(std::move(inDebugName))
+        , transient(false)
     {
     }
 
@@ -29,6 +30,12 @@ namespace RHI {
         return *this;
     }
 
+    BindGroupCreateInfo& BindGroupCreateInfo::SetTransient(bool inTransient)
+    {
+        transient = inTransient;
+        return *this;
+    }
+
     BindGroup::BindGroup(const BindGroupCreateInfo&) {}
 
     BindGroup::~BindGroup() = default;
@@ -0,0 +1,98 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include <RHI/RHI.h>
+#include <Render/RenderCache.h>
+#include <Render/RenderGraph.h>
+#include <Render/RenderThread.h>
+
+namespace Render::RenderGraphBenchmark::Internal {
+    static constexpr size_t drawNum = 50000;
+
+    static Common::UniquePtr<RHI::Device> CreateDummyDevice()
+    {
+        return RHI::Instance::GetByType(RHI::RHIType::dummy)->GetGpu(0)->RequestDevice(
+            RHI::DeviceCreateInfo()
+                .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::graphics, 1)));
+    }
+
+    // stands in for the cpu side of one mesh draw, resolving per draw state before the draw call is recorded
+    static uint32_t SimulateDrawSetup(size_t inDrawIndex, int64_t inWorkNum)
+    {
+        auto hash = static_cast<uint32_t>(inDrawIndex) * 2654435761u;
+        for (int64_t i = 0; i < inWorkNum; i++) {
+            hash ^= hash >> 15;
+            hash *= 2246822519u;
+        }
+        return hash;
+    }
+
+    // one scene raster pass of 50k draws, executed with serial or parallel command recording
+    template <bool ParallelRecord>
+    static void RecordDraws(benchmark::State& state)
+    {
+        const auto device = CreateDummyDevice();
+        const auto workNum = state.range(0);
+        RenderWorkerThreads::Get().Start();
+
+        for (auto _ : state) {
+            RGBuilder builder(*device, ParallelRecord);
+            auto* texture = builder.CreateTexture(
+                RGTextureDesc()
+                    .SetType(RHI::TextureType::t2D)
+                    .SetWidth(1024)
+                    .SetHeight(1024)
+                    .SetDepthOrArraySize(1)
+                    .SetFormat(RHI::PixelFormat::rgba8Unorm)
+                    .SetUsages(RHI::TextureUsageBits::renderAttachment)
+                    .SetMipLevels(1)
+                    .SetSamples(1)
+                    .SetInitialState(RHI::TextureState::renderTarget));
+            auto* view = builder.CreateTextureView(
+                texture,
+                RGTextureViewDesc(RHI::TextureViewType::colorAttachment, RHI::TextureViewDimension::tv2D));
+            texture->MaskAsUsed();
+
+            builder.AddParallelRasterPass(
+                "SceneDraws",
+                RGRasterPassDesc().AddColorAttachment(RGColorAttachment(view, RHI::LoadOp::clear, RHI::StoreOp::store)),
+                {},
+                drawNum,
+                [workNum](const RGBuilder&, RHI::RasterPassCommandRecorder& inRecoder, size_t inDrawBegin, size_t inDrawEnd) -> void {
+                    for (auto i = inDrawBegin; i < inDrawEnd; i++) {
+                        const auto vertexCount = SimulateDrawSetup(i, workNum) % 3 + 3;
+                        inRecoder.Draw(vertexCount, 1, 0, 0);
+                    }
+                });
+            builder.Execute({});
+        }
+
+        RenderWorkerThreads::Get().Stop();
+        DestroyDeviceResources(*device);
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(drawNum));
+    }
+
+    static void RegisterBenchmarkCase(std::string_view inCaseName, void (*inFunction)(benchmark::State&))
+    {
+        std::string name = "Render::RenderGraphBenchmark::";
+        name.append(inCaseName);
+
+        benchmark::RegisterBenchmark(name.c_str(), inFunction)
+            ->Arg(16)
+            ->Arg(256)
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    }
+
+    const bool benchmarksRegistered = []() -> bool {
+        RegisterBenchmarkCase("SerialRecordDraws", &RecordDraws<false>);
+        RegisterBenchmarkCase("ParallelRecordDraws", &RecordDraws<true>);
+        return true;
+    }();
+}
@@ -0,0 +1,108 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <RHI/RHI.h>
+#include <Render/RenderCache.h>
+#include <Render/ResourcePool.h>
+
+namespace Render::ResourcePoolBenchmark::Internal {
+    static Common::UniquePtr<RHI::Device> CreateDummyDevice()
+    {
+        return RHI::Instance::GetByType(RHI::RHIType::dummy)->GetGpu(0)->RequestDevice(
+            RHI::DeviceCreateInfo()
+                .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::graphics, 1)));
+    }
+
+    // one render target description per distinct shape, similar to the transient textures of a frame with many passes
+    static std::vector<PooledTextureDesc> MakeTextureDescs(size_t inCount)
+    {
+        std::vector<PooledTextureDesc> result;
+        result.reserve(inCount);
+        for (size_t i = 0; i < inCount; i++) {
+            result.emplace_back(PooledTextureDesc()
+                .SetType(RHI::TextureType::t2D)
+                .SetWidth(static_cast<uint32_t>(64 + i))
+                .SetHeight(64)
+                .SetDepthOrArraySize(1)
+                .SetFormat(RHI::PixelFormat::rgba8Unorm)
+                .SetUsages(RHI::TextureUsageBits::renderAttachment | RHI::TextureUsageBits::textureBinding)
+                .SetMipLevels(1)
+                .SetSamples(1)
+                .SetInitialState(RHI::TextureState::undefined));
+        }
+        return result;
+    }
+
+    // the previous ResourcePool lookup, a linear scan over every pooled resource comparing full descriptors
+    static void LinearScanAllocate(benchmark::State& state)
+    {
+        const auto device = CreateDummyDevice();
+        const auto descs = MakeTextureDescs(state.range(0));
+        std::vector<PooledTextureRef> pooled;
+        for (const auto& desc : descs) {
+            pooled.emplace_back(new PooledTexture(device->CreateTexture(desc), desc));
+        }
+
+        std::vector<PooledTextureRef> allocated;
+        allocated.reserve(descs.size());
+        for (auto _ : state) {
+            for (const auto& desc : descs) {
+                for (auto& pooledTexture : pooled) {
+                    if (pooledTexture.RefCount() == 1 && desc == pooledTexture->GetDesc()) {
+                        allocated.emplace_back(pooledTexture);
+                        break;
+                    }
+                }
+            }
+            allocated.clear();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // the current ResourcePool lookup, descriptor hash buckets with free lists rebuilt on forfeit
+    static void BucketedAllocate(benchmark::State& state)
+    {
+        const auto device = CreateDummyDevice();
+        const auto descs = MakeTextureDescs(state.range(0));
+        auto& pool = TexturePool::Get(*device);
+
+        std::vector<PooledTextureRef> allocated;
+        allocated.reserve(descs.size());
+        for (auto _ : state) {
+            for (const auto& desc : descs) {
+                allocated.emplace_back(pool.Allocate(desc));
+            }
+            allocated.clear();
+            pool.Forfeit();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        state.counters["hitRate"] = static_cast<double>(pool.GetStats().hits) / static_cast<double>(pool.GetStats().hits + pool.GetStats().misses);
+
+        DestroyDeviceResources(*device);
+    }
+
+    static void RegisterBenchmarkCase(std::string_view inCaseName, void (*inFunction)(benchmark::State&))
+    {
+        std::string name = "Render::ResourcePoolBenchmark::";
+        name.append(inCaseName);
+
+        benchmark::RegisterBenchmark(name.c_str(), inFunction)
+            ->Arg(16)
+            ->Arg(128)
+            ->Arg(1024)
+            ->Unit(benchmark::kMicrosecond);
+    }
+
+    const bool benchmarksRegistered = []() -> bool {
+        RegisterBenchmarkCase("LinearScanAllocate", &LinearScanAllocate);
+        RegisterBenchmarkCase("BucketedAllocate", &BucketedAllocate);
+        return true;
+    }();
+}
@@ -0,0 +1,127 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Core/Thread.h>
+#include <Render/RenderThread.h>
+#include <Render/Scene.h>
+
+namespace Render::SceneBenchmark::Internal {
+    // the per-proxy work of uniform packing, reads the transform and the base color of every drawable primitive
+    static float PackUniform(const Common::FMat4x4& inLocalToWorld, const Common::FVec4& inBaseColor)
+    {
+        return inLocalToWorld.At(0, 3) + inLocalToWorld.At(1, 3) + inLocalToWorld.At(2, 3) + inBaseColor.x;
+    }
+
+    static StaticPrimitiveSceneProxy MakeProxy(uint32_t inIndex)
+    {
+        StaticPrimitiveSceneProxy proxy;
+        proxy.localToWorld.At(0, 3) = static_cast<float>(inIndex);
+        proxy.baseColor = Common::FVec4(0.5f, 0.5f, 0.5f, 1.0f);
+        return proxy;
+    }
+
+    // the previous Render::Scene storage, proxies walked in hash bucket order
+    static void MapIterate(benchmark::State& state)
+    {
+        const auto proxyCount = static_cast<uint32_t>(state.range(0));
+        std::unordered_map<uint32_t, StaticPrimitiveSceneProxy> proxies;
+        proxies.reserve(proxyCount);
+        for (uint32_t i = 0; i < proxyCount; i++) {
+            proxies.emplace(i, MakeProxy(i));
+        }
+
+        for (auto _ : state) {
+            float sum = 0.0f;
+            for (const auto& [entity, proxy] : proxies) {
+                sum += PackUniform(proxy.localToWorld, proxy.baseColor);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    static void FillScene(Scene& outScene, uint32_t inProxyCount)
+    {
+        for (uint32_t i = 0; i < inProxyCount; i++) {
+            outScene.Add<StaticPrimitiveSceneProxy>(i, MakeProxy(i));
+        }
+    }
+
+    // the current Render::Scene storage, only the columns being read are touched
+    static void PoolIterate(benchmark::State& state)
+    {
+        Core::ScopedThreadTag threadTag(Core::ThreadTag::render);
+        Scene scene;
+        FillScene(scene, static_cast<uint32_t>(state.range(0)));
+
+        const auto& primitives = scene.All<StaticPrimitiveSceneProxy>();
+        for (auto _ : state) {
+            const auto localToWorlds = primitives.Column<&StaticPrimitiveSceneProxy::localToWorld>();
+            const auto baseColors = primitives.Column<&StaticPrimitiveSceneProxy::baseColor>();
+            float sum = 0.0f;
+            for (size_t i = 0; i < primitives.Size(); i++) {
+                sum += PackUniform(localToWorlds[i], baseColors[i]);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // the current Render::Scene storage split into ranges across the render worker threads
+    static void PoolParallelIterate(benchmark::State& state)
+    {
+        Core::ScopedThreadTag threadTag(Core::ThreadTag::render);
+        Scene scene;
+        FillScene(scene, static_cast<uint32_t>(state.range(0)));
+
+        auto& workers = RenderWorkerThreads::Get();
+        workers.Start();
+        const auto& primitives = scene.All<StaticPrimitiveSceneProxy>();
+        const auto ranges = primitives.Split(8, 4096);
+        std::vector<float> sums(ranges.size());
+        for (auto _ : state) {
+            const auto localToWorlds = primitives.Column<&StaticPrimitiveSceneProxy::localToWorld>();
+            const auto baseColors = primitives.Column<&StaticPrimitiveSceneProxy::baseColor>();
+            workers.ExecuteTasks(ranges.size(), [&](size_t inRangeIndex) -> void {
+                const auto& range = ranges[inRangeIndex];
+                float sum = 0.0f;
+                for (size_t i = range.begin; i < range.end; i++) {
+                    sum += PackUniform(localToWorlds[i], baseColors[i]);
+                }
+                sums[inRangeIndex] = sum;
+            });
+            benchmark::DoNotOptimize(sums.data());
+        }
+        workers.Stop();
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    static void RegisterBenchmarkCase(std::string_view inCaseName, void (*inFunction)(benchmark::State&))
+    {
+        std::string name = "Render::SceneBenchmark::";
+        name.append(inCaseName);
+
+        benchmark::RegisterBenchmark(name.c_str(), inFunction)
+            ->Arg(10000)
+            ->Arg(100000)
+            ->Arg(1000000)
+            ->Unit(benchmark::kMicrosecond)
+            ->UseRealTime();
+    }
+
+    const bool benchmarksRegistered = []() -> bool {
+        RegisterBenchmarkCase("MapIterate", &MapIterate);
+        RegisterBenchmarkCase("PoolIterate", &PoolIterate);
+        RegisterBenchmarkCase("PoolParallelIterate", &PoolParallelIterate);
+        return true;
+    }();
+}
@@ -0,0 +1,71 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <Common/Math/Matrix.h>
+#include <Common/Math/Sphere.h>
+#include <Common/Math/Vector.h>
+
+namespace Render {
+    // six normalized world space planes (xyz normal pointing inside, w distance), extracted from a reversed-z clip matrix
+    struct Frustum {
+        enum class Plane : uint8_t {
+            left,
+            right,
+            bottom,
+            top,
+            zNear,
+            zFar,
+            max
+        };
+
+        static Frustum FromWorldToClip(const Common::FMat4x4& inWorldToClip);
+
+        Frustum();
+
+        bool Intersects(const Common::FSphere& inSphere) const;
+
+        Common::FVec4 planes[static_cast<uint8_t>(Plane::max)];
+    };
+
+    // one visibility bit per primitive, packed in 64 bit words so that culling tasks over 64 aligned ranges never share a word
+    class VisibilityMask {
+    public:
+        static constexpr size_t wordBits = 64;
+
+        VisibilityMask();
+
+        void Resize(size_t inSize);
+        void Set(size_t inIndex, bool inVisible);
+        bool Test(size_t inIndex) const;
+        size_t Size() const;
+        size_t VisibleNum() const;
+        uint64_t* Words();
+        const uint64_t* Words() const;
+
+    private:
+        size_t size;
+        std::vector<uint64_t> words;
+    };
+
+    class FrustumCulling {
+    public:
+        // spheres processed by one task when culling in parallel, a multiple of VisibilityMask::wordBits
+        static constexpr size_t parallelChunkSize = 4096;
+
+        // tests the spheres 4 at a time against all planes, outMask is resized to inSpheres.size()
+        static void Cull(const Frustum& inFrustum, std::span<const Common::FSphere> inSpheres, VisibilityMask& outMask);
+        // same as Cull() but splits the spheres in chunks executed on the render worker threads
+        static void CullParallel(const Frustum& inFrustum, std::span<const Common::FSphere> inSpheres, VisibilityMask& outMask);
+
+    private:
+        static void CullRange(const Frustum& inFrustum, std::span<const Common::FSphere> inSpheres, size_t inBegin, size_t inEnd, VisibilityMask& outMask);
+    };
+}
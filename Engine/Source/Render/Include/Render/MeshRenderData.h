@@ -10,10 +10,12 @@
 #include <Common/Memory.h>
 #include <Common/Utility.h>
 #include <RHI/RHI.h>
+#include <Render/UploadManager.h>
 
 namespace Render {
     // gpu geometry for a single static mesh lod, vertex layout matches StaticMeshVertexFactory (position + uv0
-    // interleaved), created and destroyed on the render thread and shared between scene proxies
+    // interleaved), created and destroyed on the render thread and shared between scene proxies. the buffers live in
+    // device local memory and are filled through the UploadManager, draw only once the upload is submitted
     class MeshRenderData {
     public:
         struct Vertex {
@@ -23,7 +25,7 @@ namespace Render {
 
         static constexpr size_t vertexStride = sizeof(Vertex);
 
-        MeshRenderData(RHI::Device& inDevice, const std::vector<Vertex>& inVertices, const std::vector<uint32_t>& inIndices);
+        MeshRenderData(RHI::Device& inDevice, std::vector<Vertex>&& inVertices, std::vector<uint32_t>&& inIndices);
         ~MeshRenderData();
 
         NonCopyable(MeshRenderData)
@@ -32,10 +34,13 @@ namespace Render {
         RHI::Buffer* GetVertexBuffer() const;
         RHI::Buffer* GetIndexBuffer() const;
         uint32_t GetIndexCount() const;
+        UploadTicket GetUploadTicket() const;
 
     private:
+        RHI::Device& device;
         Common::UniquePtr<RHI::Buffer> vertexBuffer;
         Common::UniquePtr<RHI::Buffer> indexBuffer;
         uint32_t indexCount;
+        UploadTicket uploadTicket;
     };
 }
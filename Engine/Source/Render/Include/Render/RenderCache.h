@@ -4,11 +4,25 @@
 
 #pragma once
 
+#include <array>
+#include <future>
+#include <optional>
 #include <unordered_map>
 
+#include <Common/FileSystem.h>
 #include <RHI/RHI.h>
 #include <Render/Shader.h>
 
+namespace Render::Internal {
+    // bump when the pipeline cache file layout or the precache record encoding changes
+    constexpr uint32_t pipelineCacheFormatVersion = 2;
+    // pipelines warmed on the render workers at the same time, keeps warm up from starving frame recording
+    constexpr size_t pipelinePrecacheMaxInFlight = 4;
+    // frames a precache record waits for its shaders before it is dropped, records of shaders that no longer exist would
+    // otherwise be retried every frame and saved again forever
+    constexpr uint32_t pipelinePrecacheMaxPendingFrames = 1800;
+}
+
 namespace Render {
     class PipelineLayout;
     class ComputePipelineState;
@@ -201,7 +215,7 @@ namespace Render {
     private:
         friend class PipelineCache;
 
-        ComputePipelineState(RHI::Device& inDevice, const ComputePipelineStateDesc& inDesc, size_t inHash);
+        ComputePipelineState(RHI::Device& inDevice, const ComputePipelineStateDesc& inDesc, size_t inHash, RHI::PipelineCache* inRhiCache);
 
         size_t hash;
         PipelineLayout* pipelineLayout;
@@ -219,7 +233,7 @@ namespace Render {
     private:
         friend class PipelineCache;
 
-        RasterPipelineState(RHI::Device& inDevice, const RasterPipelineStateDesc& inDesc, size_t inHash);
+        RasterPipelineState(RHI::Device& inDevice, const RasterPipelineStateDesc& inDesc, size_t inHash, RHI::PipelineCache* inRhiCache);
 
         size_t hash;
         PipelineLayout* pipelineLayout;
@@ -249,7 +263,15 @@ namespace Render {
         static void Destroy(RHI::Device& device);
         ~PipelineCache();
 
-        // TODO offline pipeline cache
+        // restores the driver pipeline cache and the precache records of a previous session, a file written with another
+        // rhi, gpu or driver is ignored, so is a truncated or corrupt one. call before the first pipeline is created
+        bool Load(const Common::Path& inFile);
+        // records still waiting for their shaders are left out, only pipelines this session could create are kept
+        void Save(const Common::Path& inFile);
+        // render thread, starts creating precached pipelines whose shaders have landed on the render workers and adopts
+        // the finished ones, call once per frame
+        void WarmUp();
+        size_t PendingPrecacheCount() const;
         void Invalidate();
         ComputePipelineState* GetOrCreate(const ComputePipelineStateDesc& desc);
         RasterPipelineState* GetOrCreate(const RasterPipelineStateDesc& desc);
@@ -257,11 +279,31 @@ namespace Render {
     private:
         static std::mutex mutex;
 
+        // portable form of a pipeline desc, shaders are referenced by type and variant key and resolved once they land
+        struct PrecacheRecord {
+            size_t hash;
+            bool raster;
+            // compute shader, or vertex, pixel, geometry, domain and hull shader
+            std::array<std::optional<std::pair<ShaderTypeKey, ShaderVariantKey>>, 5> shaders;
+            RasterPipelineStateDesc rasterDesc;
+            uint32_t pendingFrames;
+        };
+
         explicit PipelineCache(RHI::Device& inDevice);
 
+        void WaitWarmUp();
+        void Record(size_t inHash, const ComputePipelineStateDesc& inDesc);
+        void Record(size_t inHash, const RasterPipelineStateDesc& inDesc);
+
         RHI::Device& device;
+        Common::UniquePtr<RHI::PipelineCache> rhiCache;
         std::unordered_map<size_t, Common::UniquePtr<ComputePipelineState>> computePipelines;
         std::unordered_map<size_t, Common::UniquePtr<RasterPipelineState>> rasterPipelines;
+        // encoded precache records of every pipeline created or still pending, saved for the next session
+        std::unordered_map<size_t, std::vector<uint8_t>> precacheRecords;
+        std::vector<PrecacheRecord> pendingPrecache;
+        std::unordered_map<size_t, std::future<Common::UniquePtr<ComputePipelineState>>> warmingComputePipelines;
+        std::unordered_map<size_t, std::future<Common::UniquePtr<RasterPipelineState>>> warmingRasterPipelines;
     };
 
     class ResourceViewCache {
@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <functional>
 #include <future>
+#include <mutex>
 #include <optional>
 #include <variant>
 
@@ -15,6 +16,14 @@
 #include <Render/ResourcePool.h>
 #include <Render/RenderCache.h>
 
+namespace Render::Internal {
+    constexpr uint64_t rgCompileCacheReleaseFrameLatency = 60;
+    // below these amounts a worker task costs more than the recording it takes off the render thread
+    constexpr size_t rgMinPassesPerRecordTask = 4;
+    constexpr size_t rgMinDrawsPerRecordTask = 1024;
+    constexpr size_t rgMaxRecordTaskNum = 8;
+}
+
 namespace Render {
     class RGBuilder;
 
@@ -274,6 +283,8 @@ namespace Render {
     using RGComputePassExecuteFunc = std::function<void(const RGBuilder&, RHI::ComputePassCommandRecorder&)>;
     using RGRasterPassExecuteFunc = std::function<void(const RGBuilder&, RHI::RasterPassCommandRecorder&)>;
     using RGCommonPassExecuteFunc = std::function<void(const RGBuilder&, RHI::CommandRecorder&)>;
+    // records the draws in [inDrawBegin, inDrawEnd), called concurrently from render worker threads for disjoint ranges
+    using RGParallelRasterPassExecuteFunc = std::function<void(const RGBuilder&, RHI::RasterPassCommandRecorder&, size_t inDrawBegin, size_t inDrawEnd)>;
 
     class RGCopyPass final : public RGPass {
     public:
@@ -329,13 +340,86 @@ namespace Render {
             RGCommonPassExecuteFunc inPreExecuteFunc = {},
             RGCommonPassExecuteFunc inPostExecuteFunc = {});
 
+        RGRasterPass(
+            std::string inName, RGRasterPassDesc inPassDesc,
+            std::vector<RGBindGroupRef> inBindGroups,
+            size_t inDrawNum,
+            RGParallelRasterPassExecuteFunc inFunc,
+            RGCommonPassExecuteFunc inPreExecuteFunc = {},
+            RGCommonPassExecuteFunc inPostExecuteFunc = {});
+
         RGRasterPassDesc passDesc;
         RGRasterPassExecuteFunc passFunc;
+        size_t parallelDrawNum;
+        RGParallelRasterPassExecuteFunc parallelPassFunc;
         RGCommonPassExecuteFunc prePassFunc;
         RGCommonPassExecuteFunc postPassFunc;
         std::vector<RGBindGroupRef> bindGroups;
     };
 
+    struct RGTransientMemoryStats {
+        uint32_t transientResourceNum;
+        uint32_t physicalResourceNum;
+        uint64_t bytesWithoutAliasing;
+        uint64_t bytesAllocated;
+
+        RGTransientMemoryStats();
+    };
+
+    // compilation result of a graph topology, every resource and pass is referenced by its declaration index
+    struct RGCompiledGraph {
+        struct TransientSlot {
+            std::variant<RGBufferDesc, RGTextureDesc> desc;
+            std::vector<uint32_t> occupants;
+            uint32_t lastUse;
+        };
+
+        std::vector<uint64_t> key;
+        std::vector<uint32_t> culledPasses;
+        std::vector<uint32_t> culledResources;
+        std::vector<uint32_t> resourceUseCounts;
+        std::vector<std::variant<RHI::BufferState, RHI::TextureState>> resourceStates;
+        std::vector<TransientSlot> transientSlots;
+        uint64_t lastUsedFrame;
+    };
+
+    struct RGCompileStats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t hitCompileTimeUs;
+        uint64_t missCompileTimeUs;
+
+        RGCompileStats();
+    };
+
+    // graphs rebuilt every frame mostly declare the same passes and resources, so the cull set, use counts, initial
+    // states and transient aliasing computed for a topology are kept here and reused by the next builder declaring it
+    class RGCompileCache {
+    public:
+        static RGCompileCache& Get(RHI::Device& device);
+        static void Destroy(RHI::Device& device);
+
+        ~RGCompileCache();
+
+        Common::SharedPtr<RGCompiledGraph> Find(const std::vector<uint64_t>& inKey);
+        void Emplace(RGCompiledGraph&& inCompiledGraph);
+        void RecordCompile(bool inHit, uint64_t inCompileTimeUs);
+        size_t Size() const;
+        // a copy taken under the lock, compiles may be recorded concurrently
+        RGCompileStats GetStats() const;
+        void ResetCounters();
+        void Invalidate();
+        void Forfeit();
+
+    private:
+        explicit RGCompileCache(RHI::Device& inDevice);
+
+        RHI::Device& device;
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, Common::SharedPtr<RGCompiledGraph>> compiledGraphs;
+        RGCompileStats stats;
+    };
+
     struct RGExecuteInfo {
         std::vector<RHI::Semaphore*> semaphoresToWait;
         std::vector<RHI::Semaphore*> semaphoresToSignal;
@@ -346,7 +430,9 @@ namespace Render {
     public:
         NonCopyable(RGBuilder);
         NonMovable(RGBuilder);
-        explicit RGBuilder(RHI::Device& inDevice);
+        // with parallel recording, runs of passes and the draw ranges of parallel raster passes are recorded into separate
+        // command buffers on render worker threads, and submitted in graph order
+        explicit RGBuilder(RHI::Device& inDevice, bool inParallelRecord = true);
         ~RGBuilder();
 
         // setup
@@ -357,10 +443,16 @@ namespace Render {
         RGBufferRef ImportBuffer(RHI::Buffer* inBuffer, RHI::BufferState inInitialState);
         RGTextureRef ImportTexture(RHI::Texture* inTexture, RHI::TextureState inInitialState);
         RGBindGroupRef AllocateBindGroup(const RGBindGroupDesc& inDesc);
+        // transient uniform data, copied into the per-frame uniform ring right away instead of a pooled buffer upload
+        RGBufferViewRef AllocateUniformBuffer(const void* inData, size_t inSize);
+        template <typename T> RGBufferViewRef AllocateUniformBuffer(const T& inValue);
         void QueueBufferUpload(RGBufferRef inBuffer, RGBufferUploadInfo inUploadInfo);
         void AddCopyPass(const std::string& inName, const RGCopyPassDesc& inPassDesc, const RGCopyPassExecuteFunc& inFunc, bool inAsyncCopy = false, const RGCommonPassExecuteFunc& inPreExecuteFunc = {}, const RGCommonPassExecuteFunc& inPostExecuteFunc = {});
         void AddComputePass(const std::string& inName, const std::vector<RGBindGroupRef>& inBindGroups, const RGComputePassExecuteFunc& inFunc, bool inAsyncCompute = false, const RGCommonPassExecuteFunc& inPreExecuteFunc = {}, const RGCommonPassExecuteFunc& inPostExecuteFunc = {});
         void AddRasterPass(const std::string& inName, const RGRasterPassDesc& inPassDesc, const std::vector<RGBindGroupRef>& inBindGroups, const RGRasterPassExecuteFunc& inFunc, const RGCommonPassExecuteFunc& inPreExecuteFunc = {}, const RGCommonPassExecuteFunc& inPostExecuteFunc = {});
+        // a raster pass whose draw list may be split into ranges recorded concurrently, each range is its own rhi raster
+        // pass continuing the attachments of the previous one, so only the first range clears and only the last may discard
+        void AddParallelRasterPass(const std::string& inName, const RGRasterPassDesc& inPassDesc, const std::vector<RGBindGroupRef>& inBindGroups, size_t inDrawNum, const RGParallelRasterPassExecuteFunc& inFunc, const RGCommonPassExecuteFunc& inPreExecuteFunc = {}, const RGCommonPassExecuteFunc& inPostExecuteFunc = {});
         void AddSyncPoint();
 
         // execute
@@ -370,18 +462,43 @@ namespace Render {
         RHI::BufferView* GetRHI(RGBufferViewRef inBufferView) const;
         RHI::TextureView* GetRHI(RGTextureViewRef inTextureView) const;
         RHI::BindGroup* GetRHI(RGBindGroupRef inBindGroup) const;
+        // physical memory taken by transient resources after aliasing, compared with one allocation per transient resource
+        RGTransientMemoryStats GetTransientMemoryStats() const;
 
     private:
         struct AsyncTimelineExecuteContext {
-            std::unordered_map<RGQueueType, Common::UniquePtr<RHI::CommandBuffer>> queueCmdBufferMap;
+            std::unordered_map<RGQueueType, std::vector<RHI::CommandBuffer*>> queueCmdBufferMap;
             std::unordered_map<RGQueueType, Common::UniquePtr<RHI::Semaphore>> queueSemaphoreToSignalMap;
 
             AsyncTimelineExecuteContext();
             AsyncTimelineExecuteContext(AsyncTimelineExecuteContext&& inOther) noexcept;
         };
 
+        // part of a pass recorded into one command buffer, barriers and the pre pass function go with the first part of a
+        // pass, the post pass function with the last one
+        struct RecordUnit {
+            RGPassRef pass;
+            size_t preparedIndex;
+            bool first;
+            bool last;
+            size_t drawBegin;
+            size_t drawEnd;
+        };
+
+        // transient resources with compatible descriptors and non-overlapping lifetimes, ordered by first use and all
+        // bound to one pooled resource
+        struct TransientSlot {
+            std::variant<RGBufferDesc, RGTextureDesc> desc;
+            std::vector<RGResourceRef> occupants;
+            uint32_t lastUse;
+            std::variant<std::monostate, PooledBufferRef, PooledTextureRef> pooledResource;
+        };
+
         void Compile();
         void ExecuteInternal(const RGExecuteInfo& inExecuteInfo);
+        std::vector<uint64_t> ComputeCompileKey() const;
+        void RestoreCompiledGraph(const RGCompiledGraph& inCompiledGraph);
+        RGCompiledGraph SaveCompiledGraph(std::vector<uint64_t>&& inKey) const;
 
         void CompilePassReadWrites();
         void CompileResourceUseCounts();
@@ -389,25 +506,31 @@ namespace Render {
         void PerformCull();
         // TODO resource states check inside pass (e.g. read/write a resource within a pass)
         void ComputeResourcesInitialState();
-        void ExecuteCopyPass(RHI::CommandRecorder& inRecoder, RGCopyPass* inCopyPass);
-        void ExecuteComputePass(RHI::CommandRecorder& inRecoder, RGComputePass* inComputePass);
-        void ExecuteRasterPass(RHI::CommandRecorder& inRecoder, RGRasterPass* inRasterPass);
+        void PerformTransientAliasing();
+        void PreparePass(RGPassRef inPass, std::vector<RHI::Barrier>& outBarriers);
+        std::vector<std::vector<RecordUnit>> BuildRecordTasks(const std::vector<RGPassRef>& inPasses) const;
+        void RecordPassUnit(RHI::CommandRecorder& inRecoder, const RecordUnit& inUnit, const std::vector<RHI::Barrier>& inBarriers) const;
+        void FinalizePass(RGPassRef inPass);
         void PerformBufferUploads();
+        void FinalizeUniformRingBuffers();
         void WaitBufferUploadsFinish();
         void DevirtualizeViewsCreatedOnImportedResources();
-        void DevirtualizeResource(RGResourceRef inResource);
-        void DevirtualizeResources(const std::unordered_set<RGResourceRef>& inResources);
+        RHI::BufferView* DevirtualizeBufferView(RGBufferViewRef inView);
+        void DevirtualizeResource(RGResourceRef inResource, std::vector<RHI::Barrier>* outBarriers = nullptr);
+        void DevirtualizeResources(std::vector<RHI::Barrier>& outBarriers, const std::unordered_set<RGResourceRef>& inResources);
         void DevirtualizeBindGroupsAndViews(const std::vector<RGBindGroupRef>& inBindGroups);
         void DevirtualizeAttachmentViews(const RGRasterPassDesc& inDesc);
         void FinalizePassResources(RGPassRef inPass);
         void FinalizePassBindGroups(const std::vector<RGBindGroupRef>& inBindGroups);
-        void TransitionResourcesForCopyPassDesc(RHI::CommonCommandRecorder& inRecoder, const RGCopyPassDesc& inDesc);
-        void TransitionResourcesForRasterPassDesc(RHI::CommonCommandRecorder& inRecoder, const RGRasterPassDesc& inDesc);
-        void TransitionResourcesForBindGroups(RHI::CommonCommandRecorder& inRecoder, const std::vector<RGBindGroupRef>& inBindGroups);
-        void TransitionBuffer(RHI::CommonCommandRecorder& inRecoder, RGBufferRef inBuffer, RHI::BufferState inState);
-        void TransitionTexture(RHI::CommonCommandRecorder& inRecoder, RGTextureRef inTexture, RHI::TextureState inState);
+        void TransitionResourcesForCopyPassDesc(std::vector<RHI::Barrier>& outBarriers, const RGCopyPassDesc& inDesc);
+        void TransitionResourcesForRasterPassDesc(std::vector<RHI::Barrier>& outBarriers, const RGRasterPassDesc& inDesc);
+        void TransitionResourcesForBindGroups(std::vector<RHI::Barrier>& outBarriers, const std::vector<RGBindGroupRef>& inBindGroups);
+        void TransitionBuffer(std::vector<RHI::Barrier>& outBarriers, RGBufferRef inBuffer, RHI::BufferState inState);
+        void TransitionTexture(std::vector<RHI::Barrier>& outBarriers, RGTextureRef inTexture, RHI::TextureState inState);
+        void TransitionAliasedResource(std::vector<RHI::Barrier>& outBarriers, RGResourceRef inPrevious, RGResourceRef inResource);
 
         bool executed;
+        bool parallelRecord;
         RHI::Device& device;
         std::vector<Common::UniquePtr<RGResource>> resources;
         std::vector<Common::UniquePtr<RGResourceView>> views;
@@ -416,6 +539,7 @@ namespace Render {
         std::unordered_map<RGQueueType, std::vector<RGPassRef>> recordingAsyncTimeline;
         std::vector<std::unordered_map<RGQueueType, std::vector<RGPassRef>>> asyncTimelines;
         std::unordered_map<RGBufferRef, std::vector<RGBufferUploadInfo>> bufferUploads;
+        std::unordered_map<RHI::Buffer*, RGBufferRef> uniformRingBuffers;
 
         // execute context
         std::unordered_map<RGResourceRef, uint32_t> resourceUseCounts;
@@ -424,6 +548,9 @@ namespace Render {
         std::unordered_set<RGResourceRef> culledResources;
         std::unordered_set<RGPassRef> culledPasses;
         std::unordered_map<RGResourceRef, std::variant<RHI::BufferState, RHI::TextureState>> resourceStates;
+        std::vector<TransientSlot> transientSlots;
+        // slot index and occupant index inside the slot
+        std::unordered_map<RGResourceRef, std::pair<size_t, size_t>> resourceSlots;
         std::vector<AsyncTimelineExecuteContext> asyncTimelineExecuteContexts;
         std::unordered_map<RGResourceRef, std::variant<PooledBufferRef, PooledTextureRef>> devirtualizedResources;
         std::unordered_map<RGResourceViewRef, std::variant<RHI::BufferView*, RHI::TextureView*>> devirtualizedResourceViews;
@@ -431,3 +558,11 @@ namespace Render {
         std::vector<std::future<void>> bufferUploadTasks;
     };
 }
+
+namespace Render {
+    template <typename T>
+    RGBufferViewRef RGBuilder::AllocateUniformBuffer(const T& inValue)
+    {
+        return AllocateUniformBuffer(&inValue, sizeof(T));
+    }
+}
@@ -11,6 +11,8 @@
 namespace Render {
     class RenderThread {
     public:
+        using Fence = Common::CommandThread::Fence;
+
         static RenderThread& Get();
 
         ~RenderThread();
@@ -18,12 +20,16 @@ namespace Render {
         void Start();
         void Stop();
         void Flush() const;
-        template <typename F> auto EmplaceTask(F&& inTask);
+        Fence EmplaceFence() const;
+        bool IsFenceCompleted(Fence inFence) const;
+        void WaitFence(Fence inFence) const;
+        template <typename F> void EmplaceTask(F&& inTask);
+        template <typename F> auto EmplaceTaskWithFuture(F&& inTask);
 
     private:
         RenderThread();
 
-        Common::UniquePtr<Common::WorkerThread> thread;
+        Common::UniquePtr<Common::CommandThread> thread;
     };
 
     class RenderWorkerThreads {
@@ -46,10 +52,17 @@ namespace Render {
 
 namespace Render {
     template <typename F>
-    auto RenderThread::EmplaceTask(F&& inTask)
+    void RenderThread::EmplaceTask(F&& inTask)
+    {
+        Assert(thread != nullptr);
+        thread->EmplaceTask(std::forward<F>(inTask));
+    }
+
+    template <typename F>
+    auto RenderThread::EmplaceTaskWithFuture(F&& inTask)
     {
         Assert(thread != nullptr);
-        return thread->EmplaceTask(std::forward<F>(inTask));
+        return thread->EmplaceTaskWithFuture(std::forward<F>(inTask));
     }
 
     template <typename F>
@@ -4,10 +4,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <ranges>
 #include <unordered_map>
 
 #include <Common/Memory.h>
 #include <Common/Container.h>
+#include <Common/Hash.h>
 #include <Core/Thread.h>
 #include <RHI/RHI.h>
 
@@ -29,12 +33,14 @@ namespace Render {
 
         RHIRes* GetRHI() const;
         const DescType& GetDesc() const;
+        uint64_t GetAllocatedSize() const;
         uint64_t LastUsedFrame() const;
         void MarkUsedThisFrame();
 
     private:
         Common::UniquePtr<RHIRes> rhiHandle;
         DescType desc;
+        uint64_t allocatedSize;
         uint64_t lastUsedFrame;
     };
 
@@ -48,6 +54,15 @@ namespace Render {
     template <typename PooledRes>
     struct PooledResTraits {};
 
+    struct ResourcePoolStats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t bytesResident;
+        uint64_t bytesEvicted;
+
+        ResourcePoolStats();
+    };
+
     template <typename PooledRes>
     class ResourcePool {
     public:
@@ -61,15 +76,33 @@ namespace Render {
         size_t Size() const;
         void Forfeit();
         void Invalidate();
+        // 0 means unlimited, unused resources are evicted in least recently used order when resident bytes exceed the budget
+        void SetBudget(uint64_t inBudgetBytes);
+        uint64_t GetBudget() const;
+        const ResourcePoolStats& GetStats() const;
+        void ResetCounters();
 
     private:
         using DeviceMap = std::unordered_map<RHI::Device*, Common::UniquePtr<ResourcePool>>;
 
+        // resources with equal descriptor hash, free holds indices of resources that were unreferenced at the last forfeit
+        struct Bucket {
+            std::vector<ResRefType> resources;
+            std::vector<size_t> free;
+        };
+
         explicit ResourcePool(RHI::Device& inDevice);
         static DeviceMap& GetDeviceMap();
 
+        ResRefType AllocateFromBucket(Bucket& inBucket, const DescType& inDesc);
+        void Release(Bucket& inBucket, size_t inIndex);
+        void EvictOverBudget(uint64_t inCurrentFrame);
+
         RHI::Device& device;
-        std::vector<ResRefType> pooledResources;
+        std::unordered_map<size_t, Bucket> buckets;
+        size_t resourceNum;
+        uint64_t budget;
+        ResourcePoolStats stats;
     };
 
     using BufferPool = ResourcePool<PooledBuffer>;
@@ -91,6 +124,7 @@ namespace Render {
     PooledResource<RHIResource>::PooledResource(Common::UniquePtr<RHIResource>&& inRhiHandle, DescType inDesc)
         : rhiHandle(std::move(inRhiHandle))
         , desc(std::move(inDesc))
+        , allocatedSize(rhiHandle->GetAllocatedSize())
         , lastUsedFrame(Core::ThreadContext::FrameNumber())
     {
     }
@@ -110,6 +144,12 @@ namespace Render {
         return desc;
     }
 
+    template <typename RHIRes>
+    uint64_t PooledResource<RHIRes>::GetAllocatedSize() const
+    {
+        return allocatedSize;
+    }
+
     template <typename RHIRes>
     uint64_t PooledResource<RHIRes>::LastUsedFrame() const
     {
@@ -132,6 +172,17 @@ namespace Render {
         {
             return { new ResType(device.CreateBuffer(desc), desc) };
         }
+
+        // must cover exactly the fields compared by BufferCreateInfo::operator==, debug name is not a part of identity
+        static size_t HashDesc(const DescType& desc)
+        {
+            const std::array<uint64_t, 3> values = {
+                desc.size,
+                desc.usages.Value(),
+                static_cast<uint64_t>(desc.initialState)
+            };
+            return Common::HashUtils::CityHash(values.data(), sizeof(values));
+        }
     };
 
     template <>
@@ -144,8 +195,33 @@ namespace Render {
         {
             return { new ResType(device.CreateTexture(desc), desc) };
         }
+
+        // must cover exactly the fields compared by TextureCreateInfo::operator==, debug name is not a part of identity
+        static size_t HashDesc(const DescType& desc)
+        {
+            const std::array<uint64_t, 9> values = {
+                static_cast<uint64_t>(desc.type),
+                desc.width,
+                desc.height,
+                desc.depthOrArraySize,
+                static_cast<uint64_t>(desc.format),
+                desc.usages.Value(),
+                desc.mipLevels,
+                desc.samples,
+                static_cast<uint64_t>(desc.initialState)
+            };
+            return Common::HashUtils::CityHash(values.data(), sizeof(values));
+        }
     };
 
+    inline ResourcePoolStats::ResourcePoolStats()
+        : hits(0)
+        , misses(0)
+        , bytesResident(0)
+        , bytesEvicted(0)
+    {
+    }
+
     template <typename PooledResource>
     ResourcePool<PooledResource>& ResourcePool<PooledResource>::Get(RHI::Device& device)
     {
@@ -176,27 +252,66 @@ namespace Render {
     template <typename PooledResource>
     ResourcePool<PooledResource>::ResourcePool(RHI::Device& inDevice)
         : device(inDevice)
+        , resourceNum(0)
+        , budget(0)
     {
     }
 
     template <typename PooledResource>
     typename ResourcePool<PooledResource>::ResRefType ResourcePool<PooledResource>::Allocate(const DescType& desc)
     {
-        for (auto& pooledResource : pooledResources) {
-            if (pooledResource.RefCount() == 1 && desc == pooledResource->GetDesc()) {
-                pooledResource->MarkUsedThisFrame();
-                return pooledResource;
-            }
+        auto& bucket = buckets[PooledResTraits<PooledResource>::HashDesc(desc)];
+        if (auto result = AllocateFromBucket(bucket, desc); result != nullptr) {
+            stats.hits++;
+            result->MarkUsedThisFrame();
+            return result;
         }
+
         auto result = PooledResTraits<PooledResource>::CreateResource(device, desc);
-        pooledResources.emplace_back(result);
+        bucket.resources.emplace_back(result);
+        resourceNum++;
+        stats.misses++;
+        stats.bytesResident += result->GetAllocatedSize();
         return result;
     }
 
+    template <typename PooledRes>
+    typename ResourcePool<PooledRes>::ResRefType ResourcePool<PooledRes>::AllocateFromBucket(Bucket& inBucket, const DescType& inDesc)
+    {
+        // free list entries may have been picked up already this frame, so references are re-checked before reuse
+        while (!inBucket.free.empty()) {
+            auto& candidate = inBucket.resources[inBucket.free.back()];
+            inBucket.free.pop_back();
+            if (candidate.RefCount() == 1 && candidate->GetDesc() == inDesc) {
+                return candidate;
+            }
+        }
+
+        // resources released after the last forfeit are not in the free list yet
+        for (auto& pooledResource : inBucket.resources) {
+            if (pooledResource.RefCount() == 1 && pooledResource->GetDesc() == inDesc) {
+                return pooledResource;
+            }
+        }
+        return nullptr;
+    }
+
     template <typename PooledRes>
     size_t ResourcePool<PooledRes>::Size() const
     {
-        return pooledResources.size();
+        return resourceNum;
+    }
+
+    template <typename PooledRes>
+    void ResourcePool<PooledRes>::Release(Bucket& inBucket, size_t inIndex)
+    {
+        auto& resources = inBucket.resources;
+        stats.bytesResident -= resources[inIndex]->GetAllocatedSize();
+        if (inIndex != resources.size() - 1) {
+            std::swap(resources[inIndex], resources.back());
+        }
+        resources.pop_back();
+        resourceNum--;
     }
 
     template <typename PooledRes>
@@ -204,20 +319,78 @@ namespace Render {
     {
         const auto currentFrame = Core::ThreadContext::FrameNumber();
 
-        for (auto i = 0; i < pooledResources.size();) {
-            bool needRelease = false;
-            auto& pooledResource = pooledResources[i];
+        for (auto iter = buckets.begin(); iter != buckets.end();) {
+            auto& bucket = iter->second;
+            bucket.free.clear();
+
+            for (size_t i = 0; i < bucket.resources.size();) {
+                bool needRelease = false;
+                auto& pooledResource = bucket.resources[i];
+
+                if (pooledResource.RefCount() <= 1) {
+                    needRelease = currentFrame - pooledResource->LastUsedFrame() > Internal::pooledResourceReleaseFrameLatency;
+                } else {
+                    pooledResource->MarkUsedThisFrame();
+                }
+
+                if (needRelease) { // NOLINT
+                    Release(bucket, i);
+                } else {
+                    i++;
+                }
+            }
 
-            if (pooledResource.RefCount() <= 1) {
-                needRelease = currentFrame - pooledResource->LastUsedFrame() > Internal::pooledResourceReleaseFrameLatency;
+            if (bucket.resources.empty()) {
+                iter = buckets.erase(iter);
             } else {
-                pooledResource->MarkUsedThisFrame();
+                iter++;
             }
+        }
 
-            if (needRelease) { // NOLINT
-                pooledResources.erase(pooledResources.begin() + i);
-            } else {
-                i++;
+        EvictOverBudget(currentFrame);
+
+        for (auto& bucket : buckets | std::views::values) {
+            for (size_t i = 0; i < bucket.resources.size(); i++) {
+                if (bucket.resources[i].RefCount() == 1) {
+                    bucket.free.emplace_back(i);
+                }
+            }
+        }
+    }
+
+    template <typename PooledRes>
+    void ResourcePool<PooledRes>::EvictOverBudget(uint64_t inCurrentFrame)
+    {
+        if (budget == 0 || stats.bytesResident <= budget) {
+            return;
+        }
+
+        // resources used this frame may still be referenced by recorded commands, they are never evicted
+        std::vector<std::pair<uint64_t, PooledRes*>> candidates;
+        for (const auto& bucket : buckets | std::views::values) {
+            for (const auto& pooledResource : bucket.resources) {
+                if (pooledResource.RefCount() == 1 && pooledResource->LastUsedFrame() < inCurrentFrame) {
+                    candidates.emplace_back(pooledResource->LastUsedFrame(), pooledResource.Get());
+                }
+            }
+        }
+        std::ranges::sort(candidates, [](const auto& lhs, const auto& rhs) -> bool { return lhs.first < rhs.first; });
+
+        for (const auto& candidate : candidates | std::views::values) {
+            if (stats.bytesResident <= budget) {
+                break;
+            }
+
+            const auto bucketIter = buckets.find(PooledResTraits<PooledRes>::HashDesc(candidate->GetDesc()));
+            Assert(bucketIter != buckets.end());
+            auto& resources = bucketIter->second.resources;
+            const auto resIter = std::ranges::find_if(resources, [&](const ResRefType& ref) -> bool { return ref.Get() == candidate; });
+            Assert(resIter != resources.end());
+
+            stats.bytesEvicted += candidate->GetAllocatedSize();
+            Release(bucketIter->second, resIter - resources.begin());
+            if (resources.empty()) {
+                buckets.erase(bucketIter);
             }
         }
     }
@@ -225,9 +398,39 @@ namespace Render {
     template <typename PooledRes>
     void ResourcePool<PooledRes>::Invalidate()
     {
-        for (const auto& pooledResource : pooledResources) {
-            Assert(pooledResource.RefCount() == 1);
+        for (const auto& bucket : buckets | std::views::values) {
+            for (const auto& pooledResource : bucket.resources) {
+                Assert(pooledResource.RefCount() == 1);
+            }
         }
-        pooledResources.clear();
+        buckets.clear();
+        resourceNum = 0;
+        stats.bytesResident = 0;
+    }
+
+    template <typename PooledRes>
+    void ResourcePool<PooledRes>::SetBudget(uint64_t inBudgetBytes)
+    {
+        budget = inBudgetBytes;
+    }
+
+    template <typename PooledRes>
+    uint64_t ResourcePool<PooledRes>::GetBudget() const
+    {
+        return budget;
+    }
+
+    template <typename PooledRes>
+    const ResourcePoolStats& ResourcePool<PooledRes>::GetStats() const
+    {
+        return stats;
+    }
+
+    template <typename PooledRes>
+    void ResourcePool<PooledRes>::ResetCounters()
+    {
+        stats.hits = 0;
+        stats.misses = 0;
+        stats.bytesEvicted = 0;
     }
 } // namespace Render
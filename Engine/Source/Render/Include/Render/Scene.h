@@ -4,18 +4,146 @@
 
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include <Common/Debug.h>
 #include <Core/Thread.h>
 #include <Render/SceneProxy/Light.h>
 #include <Render/SceneProxy/Primitive.h>
 
 namespace Render {
+    // stable reference to a proxy in a SceneProxyPool, survives swap-removes of other proxies, the generation makes
+    // handles of removed proxies invalid even if the handle index is reused
+    struct SceneProxyHandle {
+        static constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+        SceneProxyHandle();
+        SceneProxyHandle(uint32_t inIndex, uint32_t inGeneration);
+
+        bool operator==(const SceneProxyHandle& inRhs) const;
+
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    // contiguous part of a pool's dense arrays, used to split proxy iteration across render worker threads
+    struct SceneProxyRange {
+        size_t Size() const;
+
+        size_t begin;
+        size_t end;
+    };
+
+    // the fields of a scene proxy type stored in a SceneProxyPool, every field lives in its own contiguous array,
+    // specializations must list all fields of the proxy, value is a tuple of member pointers
+    template <typename SP> struct SceneProxyFields {};
+
+    // proxies carrying world space bounds, the pool refreshes them whenever localToWorld or the local bounds change
+    template <typename SP> concept SceneProxyWithBounds = requires(SP inProxy) {
+        { inProxy.localBoundingSphere } -> std::convertible_to<Common::FSphere>;
+        { inProxy.worldBoundingSphere } -> std::convertible_to<Common::FSphere>;
+    };
+
+    // structure-of-arrays storage of one scene proxy type, proxies are packed densely and removed by swap-with-last,
+    // entity ids are small dense indices (see Runtime::Internal::EntityPool) so the entity index is a plain array
+    template <typename SP>
+    class SceneProxyPool {
+    public:
+        using EntityId = uint32_t;
+
+        SceneProxyPool();
+
+        SceneProxyHandle Add(EntityId inEntity, SP&& inSceneProxy);
+        bool Contains(EntityId inEntity) const;
+        bool Valid(SceneProxyHandle inHandle) const;
+        SceneProxyHandle Find(EntityId inEntity) const;
+        SP Get(EntityId inEntity) const;
+        SP Get(SceneProxyHandle inHandle) const;
+        void Set(EntityId inEntity, SP&& inSceneProxy);
+        void Remove(EntityId inEntity);
+        // batched localToWorld write, entities without a proxy of this type are skipped
+        void UpdateTransforms(const EntityId* inEntities, const Common::FMat4x4* inLocalToWorlds, size_t inCount);
+        size_t Size() const;
+        bool Empty() const;
+        const std::vector<EntityId>& Entities() const;
+        template <auto Field> auto Column() const;
+        template <auto Field> auto Column();
+        // splits the dense range into at most inMaxRangeNum ranges of at least inMinRangeSize proxies
+        std::vector<SceneProxyRange> Split(size_t inMaxRangeNum, size_t inMinRangeSize = 1) const;
+
+    private:
+        static constexpr uint32_t invalidSlot = std::numeric_limits<uint32_t>::max();
+
+        struct HandleEntry {
+            uint32_t slot;
+            uint32_t generation;
+        };
+
+        template <typename T> struct MemberPointerTraits {};
+        template <typename C, typename T> struct MemberPointerTraits<T C::*> { using Type = T; };
+
+        using FieldTuple = std::remove_const_t<decltype(SceneProxyFields<SP>::value)>;
+        static constexpr size_t fieldNum = std::tuple_size_v<FieldTuple>;
+        template <typename Tuple> struct ColumnsOf {};
+        template <typename... P> struct ColumnsOf<std::tuple<P...>> { using Type = std::tuple<std::vector<typename MemberPointerTraits<P>::Type>...>; };
+        using Columns = typename ColumnsOf<FieldTuple>::Type;
+
+        template <auto Field, size_t I = 0> static consteval size_t FieldIndex();
+        uint32_t GetSlot(EntityId inEntity) const;
+        template <size_t... I> void PushColumns(SP&& inSceneProxy, std::index_sequence<I...>);
+        template <size_t... I> void WriteColumns(uint32_t inSlot, SP&& inSceneProxy, std::index_sequence<I...>);
+        template <size_t... I> SP ReadColumns(uint32_t inSlot, std::index_sequence<I...>) const;
+        template <size_t... I> void SwapRemoveColumns(uint32_t inSlot, std::index_sequence<I...>);
+        void UpdateWorldBounds(uint32_t inSlot);
+
+        Columns columns;
+        std::vector<EntityId> entities;
+        std::vector<uint32_t> denseHandles;
+        std::vector<HandleEntry> handleEntries;
+        std::vector<uint32_t> freeHandles;
+        std::vector<uint32_t> entityHandles;
+    };
+
+    template <>
+    struct SceneProxyFields<DirectionalLightSceneProxy> {
+        static constexpr auto value = std::make_tuple(&DirectionalLightSceneProxy::localToWorld, &DirectionalLightSceneProxy::color, &DirectionalLightSceneProxy::intensity);
+    };
+
+    template <>
+    struct SceneProxyFields<PointLightSceneProxy> {
+        static constexpr auto value = std::make_tuple(&PointLightSceneProxy::localToWorld, &PointLightSceneProxy::color, &PointLightSceneProxy::intensity, &PointLightSceneProxy::radius);
+    };
+
+    template <>
+    struct SceneProxyFields<SpotLightSceneProxy> {
+        static constexpr auto value = std::make_tuple(&SpotLightSceneProxy::localToWorld, &SpotLightSceneProxy::color, &SpotLightSceneProxy::intensity);
+    };
+
+    template <>
+    struct SceneProxyFields<StaticPrimitiveSceneProxy> {
+        static constexpr auto value = std::make_tuple(
+            &StaticPrimitiveSceneProxy::localToWorld,
+            &StaticPrimitiveSceneProxy::localBoundingSphere,
+            &StaticPrimitiveSceneProxy::worldBoundingSphere,
+            &StaticPrimitiveSceneProxy::mesh,
+            &StaticPrimitiveSceneProxy::vertexFactoryType,
+            &StaticPrimitiveSceneProxy::vertexShaderType,
+            &StaticPrimitiveSceneProxy::pixelShaderType,
+            &StaticPrimitiveSceneProxy::baseColor);
+    };
+
     // Render::Scene is a container of render-thread world data copy.
     // Notice all operations to scene need be down in render-thread.
     class Scene final {
     public:
         using EntityId = uint32_t;
-        template <typename SP> using SceneProxyContainer = std::unordered_map<EntityId, SP>;
 
         Scene();
         ~Scene();
@@ -23,119 +151,398 @@ namespace Render {
         NonCopyable(Scene)
         NonMovable(Scene)
 
-        template <typename SP> void Add(EntityId inEntity, SP&& inSceneProxy);
-        template <typename SP> SP& Get(EntityId inEntity);
-        template <typename SP> const SP& Get(EntityId inEntity) const;
+        template <typename SP> SceneProxyHandle Add(EntityId inEntity, SP&& inSceneProxy);
+        template <typename SP> SP Get(EntityId inEntity) const;
+        template <typename SP> void Set(EntityId inEntity, SP&& inSceneProxy);
         template <typename SP> void Remove(EntityId inEntity);
-        template <typename SP> const SceneProxyContainer<SP>& All() const;
+        template <typename SP> void UpdateTransforms(const EntityId* inEntities, const Common::FMat4x4* inLocalToWorlds, size_t inCount);
+        template <typename SP> const SceneProxyPool<SP>& All() const;
 
     private:
-        template <typename SP> SceneProxyContainer<SP>& GetSceneProxyContainer();
-        template <typename SP> const SceneProxyContainer<SP>& GetSceneProxyContainer() const;
+        template <typename SP> SceneProxyPool<SP>& GetSceneProxyPool();
+        template <typename SP> const SceneProxyPool<SP>& GetSceneProxyPool() const;
 
-        SceneProxyContainer<DirectionalLightSceneProxy> directionalLightSceneProxies;
-        SceneProxyContainer<PointLightSceneProxy> pointLightSceneProxies;
-        SceneProxyContainer<SpotLightSceneProxy> spotLightSceneProxies;
-        SceneProxyContainer<StaticPrimitiveSceneProxy> staticPrimitiveSceneProxies;
+        SceneProxyPool<DirectionalLightSceneProxy> directionalLightSceneProxies;
+        SceneProxyPool<PointLightSceneProxy> pointLightSceneProxies;
+        SceneProxyPool<SpotLightSceneProxy> spotLightSceneProxies;
+        SceneProxyPool<StaticPrimitiveSceneProxy> staticPrimitiveSceneProxies;
     };
 }
 
 namespace Render {
+    inline SceneProxyHandle::SceneProxyHandle()
+        : index(invalidIndex)
+        , generation(0)
+    {
+    }
+
+    inline SceneProxyHandle::SceneProxyHandle(uint32_t inIndex, uint32_t inGeneration)
+        : index(inIndex)
+        , generation(inGeneration)
+    {
+    }
+
+    inline bool SceneProxyHandle::operator==(const SceneProxyHandle& inRhs) const
+    {
+        return index == inRhs.index && generation == inRhs.generation;
+    }
+
+    inline size_t SceneProxyRange::Size() const
+    {
+        return end - begin;
+    }
+
+    template <typename SP>
+    SceneProxyPool<SP>::SceneProxyPool() = default;
+
+    template <typename SP>
+    SceneProxyHandle SceneProxyPool<SP>::Add(EntityId inEntity, SP&& inSceneProxy)
+    {
+        // same as the previous map emplace, adding an existing entity keeps the old proxy
+        if (Contains(inEntity)) {
+            return Find(inEntity);
+        }
+
+        uint32_t handleIndex;
+        if (freeHandles.empty()) {
+            handleIndex = static_cast<uint32_t>(handleEntries.size());
+            handleEntries.emplace_back(HandleEntry { invalidSlot, 0 });
+        } else {
+            handleIndex = freeHandles.back();
+            freeHandles.pop_back();
+        }
+        if (inEntity >= entityHandles.size()) {
+            entityHandles.resize(inEntity + 1, SceneProxyHandle::invalidIndex);
+        }
+
+        handleEntries[handleIndex].slot = static_cast<uint32_t>(entities.size());
+        entityHandles[inEntity] = handleIndex;
+        entities.emplace_back(inEntity);
+        denseHandles.emplace_back(handleIndex);
+        PushColumns(std::move(inSceneProxy), std::make_index_sequence<fieldNum>());
+        UpdateWorldBounds(handleEntries[handleIndex].slot);
+        return { handleIndex, handleEntries[handleIndex].generation };
+    }
+
     template <typename SP>
-    void Scene::Add(EntityId inEntity, SP&& inSceneProxy)
+    bool SceneProxyPool<SP>::Contains(EntityId inEntity) const
+    {
+        return inEntity < entityHandles.size() && entityHandles[inEntity] != SceneProxyHandle::invalidIndex;
+    }
+
+    template <typename SP>
+    bool SceneProxyPool<SP>::Valid(SceneProxyHandle inHandle) const
+    {
+        return inHandle.index < handleEntries.size()
+            && handleEntries[inHandle.index].generation == inHandle.generation
+            && handleEntries[inHandle.index].slot != invalidSlot;
+    }
+
+    template <typename SP>
+    SceneProxyHandle SceneProxyPool<SP>::Find(EntityId inEntity) const
+    {
+        if (!Contains(inEntity)) {
+            return {};
+        }
+        const uint32_t handleIndex = entityHandles[inEntity];
+        return { handleIndex, handleEntries[handleIndex].generation };
+    }
+
+    template <typename SP>
+    SP SceneProxyPool<SP>::Get(EntityId inEntity) const
+    {
+        return ReadColumns(GetSlot(inEntity), std::make_index_sequence<fieldNum>());
+    }
+
+    template <typename SP>
+    SP SceneProxyPool<SP>::Get(SceneProxyHandle inHandle) const
+    {
+        Assert(Valid(inHandle));
+        return ReadColumns(handleEntries[inHandle.index].slot, std::make_index_sequence<fieldNum>());
+    }
+
+    template <typename SP>
+    void SceneProxyPool<SP>::Set(EntityId inEntity, SP&& inSceneProxy)
+    {
+        const uint32_t slot = GetSlot(inEntity);
+        WriteColumns(slot, std::move(inSceneProxy), std::make_index_sequence<fieldNum>());
+        UpdateWorldBounds(slot);
+    }
+
+    template <typename SP>
+    void SceneProxyPool<SP>::Remove(EntityId inEntity)
+    {
+        if (!Contains(inEntity)) {
+            return;
+        }
+        const uint32_t handleIndex = entityHandles[inEntity];
+        const uint32_t slot = handleEntries[handleIndex].slot;
+        const auto lastSlot = static_cast<uint32_t>(entities.size() - 1);
+
+        SwapRemoveColumns(slot, std::make_index_sequence<fieldNum>());
+        if (slot != lastSlot) {
+            entities[slot] = entities[lastSlot];
+            denseHandles[slot] = denseHandles[lastSlot];
+            handleEntries[denseHandles[slot]].slot = slot;
+        }
+        entities.pop_back();
+        denseHandles.pop_back();
+
+        handleEntries[handleIndex].slot = invalidSlot;
+        handleEntries[handleIndex].generation++;
+        freeHandles.emplace_back(handleIndex);
+        entityHandles[inEntity] = SceneProxyHandle::invalidIndex;
+    }
+
+    template <typename SP>
+    void SceneProxyPool<SP>::UpdateTransforms(const EntityId* inEntities, const Common::FMat4x4* inLocalToWorlds, size_t inCount)
+    {
+        auto localToWorlds = Column<&SP::localToWorld>();
+        const auto entityNum = static_cast<EntityId>(entityHandles.size());
+        for (size_t i = 0; i < inCount; i++) {
+            const EntityId entity = inEntities[i];
+            if (entity >= entityNum || entityHandles[entity] == SceneProxyHandle::invalidIndex) {
+                continue;
+            }
+            const uint32_t slot = handleEntries[entityHandles[entity]].slot;
+            localToWorlds[slot] = inLocalToWorlds[i];
+            UpdateWorldBounds(slot);
+        }
+    }
+
+    template <typename SP>
+    size_t SceneProxyPool<SP>::Size() const
+    {
+        return entities.size();
+    }
+
+    template <typename SP>
+    bool SceneProxyPool<SP>::Empty() const
+    {
+        return entities.empty();
+    }
+
+    template <typename SP>
+    const std::vector<typename SceneProxyPool<SP>::EntityId>& SceneProxyPool<SP>::Entities() const
+    {
+        return entities;
+    }
+
+    template <typename SP>
+    template <auto Field>
+    auto SceneProxyPool<SP>::Column() const
+    {
+        constexpr size_t index = FieldIndex<Field>();
+        static_assert(index < fieldNum, "field is not stored in this scene proxy pool");
+        const auto& column = std::get<index>(columns);
+        return std::span(column.data(), column.size());
+    }
+
+    template <typename SP>
+    template <auto Field>
+    auto SceneProxyPool<SP>::Column()
+    {
+        constexpr size_t index = FieldIndex<Field>();
+        static_assert(index < fieldNum, "field is not stored in this scene proxy pool");
+        auto& column = std::get<index>(columns);
+        return std::span(column.data(), column.size());
+    }
+
+    template <typename SP>
+    std::vector<SceneProxyRange> SceneProxyPool<SP>::Split(size_t inMaxRangeNum, size_t inMinRangeSize) const
+    {
+        Assert(inMaxRangeNum > 0 && inMinRangeSize > 0);
+        const size_t total = Size();
+        if (total == 0) {
+            return {};
+        }
+
+        const size_t rangeNum = std::max<size_t>(1, std::min(inMaxRangeNum, total / inMinRangeSize));
+        const size_t baseSize = total / rangeNum;
+        const size_t remainder = total % rangeNum;
+
+        std::vector<SceneProxyRange> result;
+        result.reserve(rangeNum);
+        size_t begin = 0;
+        for (size_t i = 0; i < rangeNum; i++) {
+            const size_t size = baseSize + (i < remainder ? 1 : 0);
+            result.emplace_back(SceneProxyRange { begin, begin + size });
+            begin += size;
+        }
+        return result;
+    }
+
+    template <typename SP>
+    template <auto Field, size_t I>
+    consteval size_t SceneProxyPool<SP>::FieldIndex()
+    {
+        if constexpr (I >= fieldNum) {
+            return fieldNum;
+        } else {
+            if constexpr (std::is_same_v<std::tuple_element_t<I, FieldTuple>, decltype(Field)>) {
+                if (std::get<I>(SceneProxyFields<SP>::value) == Field) {
+                    return I;
+                }
+            }
+            return FieldIndex<Field, I + 1>();
+        }
+    }
+
+    template <typename SP>
+    uint32_t SceneProxyPool<SP>::GetSlot(EntityId inEntity) const
+    {
+        Assert(Contains(inEntity));
+        return handleEntries[entityHandles[inEntity]].slot;
+    }
+
+    template <typename SP>
+    template <size_t... I>
+    void SceneProxyPool<SP>::PushColumns(SP&& inSceneProxy, std::index_sequence<I...>)
+    {
+        (std::get<I>(columns).emplace_back(std::move(inSceneProxy.*std::get<I>(SceneProxyFields<SP>::value))), ...);
+    }
+
+    template <typename SP>
+    template <size_t... I>
+    void SceneProxyPool<SP>::WriteColumns(uint32_t inSlot, SP&& inSceneProxy, std::index_sequence<I...>)
+    {
+        ((std::get<I>(columns)[inSlot] = std::move(inSceneProxy.*std::get<I>(SceneProxyFields<SP>::value))), ...);
+    }
+
+    template <typename SP>
+    template <size_t... I>
+    SP SceneProxyPool<SP>::ReadColumns(uint32_t inSlot, std::index_sequence<I...>) const
+    {
+        SP result;
+        ((result.*std::get<I>(SceneProxyFields<SP>::value) = std::get<I>(columns)[inSlot]), ...);
+        return result;
+    }
+
+    template <typename SP>
+    void SceneProxyPool<SP>::UpdateWorldBounds(uint32_t inSlot)
+    {
+        if constexpr (SceneProxyWithBounds<SP>) {
+            Column<&SP::worldBoundingSphere>()[inSlot] = TransformBoundingSphere(Column<&SP::localBoundingSphere>()[inSlot], Column<&SP::localToWorld>()[inSlot]);
+        }
+    }
+
+    template <typename SP>
+    template <size_t... I>
+    void SceneProxyPool<SP>::SwapRemoveColumns(uint32_t inSlot, std::index_sequence<I...>)
+    {
+        const auto swapRemove = [inSlot](auto& column) -> void {
+            if (inSlot != column.size() - 1) {
+                column[inSlot] = std::move(column.back());
+            }
+            column.pop_back();
+        };
+        (swapRemove(std::get<I>(columns)), ...);
+    }
+}
+
+namespace Render {
+    template <typename SP>
+    SceneProxyHandle Scene::Add(EntityId inEntity, SP&& inSceneProxy)
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        GetSceneProxyContainer<SP>().emplace(inEntity, std::move(inSceneProxy)); // NOLINT
+        return GetSceneProxyPool<SP>().Add(inEntity, std::move(inSceneProxy)); // NOLINT
     }
 
     template <typename SP>
-    SP& Scene::Get(EntityId inEntity)
+    SP Scene::Get(EntityId inEntity) const
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        return GetSceneProxyContainer<SP>().at(inEntity);
+        return GetSceneProxyPool<SP>().Get(inEntity);
     }
 
     template <typename SP>
-    const SP& Scene::Get(EntityId inEntity) const
+    void Scene::Set(EntityId inEntity, SP&& inSceneProxy)
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        return GetSceneProxyContainer<SP>().at(inEntity);
+        GetSceneProxyPool<SP>().Set(inEntity, std::move(inSceneProxy)); // NOLINT
     }
 
     template <typename SP>
     void Scene::Remove(EntityId inEntity)
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        GetSceneProxyContainer<SP>().erase(inEntity);
+        GetSceneProxyPool<SP>().Remove(inEntity);
+    }
+
+    template <typename SP>
+    void Scene::UpdateTransforms(const EntityId* inEntities, const Common::FMat4x4* inLocalToWorlds, size_t inCount)
+    {
+        Assert(Core::ThreadContext::IsRenderThread());
+        GetSceneProxyPool<SP>().UpdateTransforms(inEntities, inLocalToWorlds, inCount);
     }
 
     template <typename SP>
-    const Scene::SceneProxyContainer<SP>& Scene::All() const
+    const SceneProxyPool<SP>& Scene::All() const
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        return GetSceneProxyContainer<SP>();
+        return GetSceneProxyPool<SP>();
     }
 
     template <typename SP>
-    Scene::SceneProxyContainer<SP>& Scene::GetSceneProxyContainer()
+    SceneProxyPool<SP>& Scene::GetSceneProxyPool()
     {
         Unimplement();
-        return *static_cast<SceneProxyContainer<SP>*>(nullptr); // NOLINT
+        return *static_cast<SceneProxyPool<SP>*>(nullptr); // NOLINT
     }
 
     template <typename SP>
-    const Scene::SceneProxyContainer<SP>& Scene::GetSceneProxyContainer() const
+    const SceneProxyPool<SP>& Scene::GetSceneProxyPool() const
     {
         Unimplement();
-        return *static_cast<const SceneProxyContainer<SP>*>(nullptr); // NOLINT
+        return *static_cast<const SceneProxyPool<SP>*>(nullptr); // NOLINT
     }
 }
 
 namespace Render {
     template <>
-    inline Scene::SceneProxyContainer<DirectionalLightSceneProxy>& Scene::GetSceneProxyContainer<DirectionalLightSceneProxy>()
+    inline SceneProxyPool<DirectionalLightSceneProxy>& Scene::GetSceneProxyPool<DirectionalLightSceneProxy>()
     {
         return directionalLightSceneProxies;
     }
 
     template <>
-    inline const Scene::SceneProxyContainer<DirectionalLightSceneProxy>& Scene::GetSceneProxyContainer<DirectionalLightSceneProxy>() const
+    inline const SceneProxyPool<DirectionalLightSceneProxy>& Scene::GetSceneProxyPool<DirectionalLightSceneProxy>() const
     {
         return directionalLightSceneProxies;
     }
 
     template <>
-    inline Scene::SceneProxyContainer<PointLightSceneProxy>& Scene::GetSceneProxyContainer<PointLightSceneProxy>()
+    inline SceneProxyPool<PointLightSceneProxy>& Scene::GetSceneProxyPool<PointLightSceneProxy>()
     {
         return pointLightSceneProxies;
     }
 
     template <>
-    inline const Scene::SceneProxyContainer<PointLightSceneProxy>& Scene::GetSceneProxyContainer<PointLightSceneProxy>() const
+    inline const SceneProxyPool<PointLightSceneProxy>& Scene::GetSceneProxyPool<PointLightSceneProxy>() const
     {
         return pointLightSceneProxies;
     }
 
     template <>
-    inline Scene::SceneProxyContainer<SpotLightSceneProxy>& Scene::GetSceneProxyContainer<SpotLightSceneProxy>()
+    inline SceneProxyPool<SpotLightSceneProxy>& Scene::GetSceneProxyPool<SpotLightSceneProxy>()
     {
         return spotLightSceneProxies;
     }
 
     template <>
-    inline const Scene::SceneProxyContainer<SpotLightSceneProxy>& Scene::GetSceneProxyContainer<SpotLightSceneProxy>() const
+    inline const SceneProxyPool<SpotLightSceneProxy>& Scene::GetSceneProxyPool<SpotLightSceneProxy>() const
     {
         return spotLightSceneProxies;
     }
 
     template <>
-    inline Scene::SceneProxyContainer<StaticPrimitiveSceneProxy>& Scene::GetSceneProxyContainer<StaticPrimitiveSceneProxy>()
+    inline SceneProxyPool<StaticPrimitiveSceneProxy>& Scene::GetSceneProxyPool<StaticPrimitiveSceneProxy>()
     {
         return staticPrimitiveSceneProxies;
     }
 
     template <>
-    inline const Scene::SceneProxyContainer<StaticPrimitiveSceneProxy>& Scene::GetSceneProxyContainer<StaticPrimitiveSceneProxy>() const
+    inline const SceneProxyPool<StaticPrimitiveSceneProxy>& Scene::GetSceneProxyPool<StaticPrimitiveSceneProxy>() const
     {
         return staticPrimitiveSceneProxies;
     }
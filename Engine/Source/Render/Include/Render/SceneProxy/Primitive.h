@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+
 #include <Common/Math/Matrix.h>
+#include <Common/Math/Sphere.h>
 #include <Common/Math/Vector.h>
 #include <Common/Memory.h>
 #include <Render/MeshRenderData.h>
@@ -13,10 +17,16 @@ namespace Render {
     class MaterialShaderType;
     class VertexFactoryType;
 
+    // conservative world space bounds of a local space sphere, the radius grows with the largest axis scale
+    Common::FSphere TransformBoundingSphere(const Common::FSphere& inLocalSphere, const Common::FMat4x4& inLocalToWorld);
+
     struct PrimitiveSceneProxy {
         PrimitiveSceneProxy();
 
         Common::FMat4x4 localToWorld;
+        Common::FSphere localBoundingSphere;
+        // kept in sync with localToWorld by the scene, read by the culling kernel
+        Common::FSphere worldBoundingSphere;
     };
 
     struct StaticPrimitiveSceneProxy final : PrimitiveSceneProxy {
@@ -31,6 +41,17 @@ namespace Render {
 }
 
 namespace Render {
+    inline Common::FSphere TransformBoundingSphere(const Common::FSphere& inLocalSphere, const Common::FMat4x4& inLocalToWorld)
+    {
+        const Common::FVec4 center = inLocalToWorld * Common::FVec4(inLocalSphere.center.x, inLocalSphere.center.y, inLocalSphere.center.z, 1.0f);
+        float maxScaleSquared = 0.0f;
+        for (uint8_t col = 0; col < 3; col++) {
+            const Common::FVec3 axis(inLocalToWorld.At(0, col), inLocalToWorld.At(1, col), inLocalToWorld.At(2, col));
+            maxScaleSquared = std::max(maxScaleSquared, axis.ModelSquared());
+        }
+        return { Common::FVec3(center.x, center.y, center.z), inLocalSphere.radius * std::sqrt(maxScaleSquared) };
+    }
+
     inline PrimitiveSceneProxy::PrimitiveSceneProxy()
         : localToWorld(Common::FMat4x4Consts::identity)
     {
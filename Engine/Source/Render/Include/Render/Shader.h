@@ -9,6 +9,8 @@
 #include <utility>
 #include <tuple>
 #include <array>
+#include <mutex>
+#include <unordered_set>
 
 #include <Common/Hash.h>
 #include <RHI/RHI.h>
@@ -310,9 +312,12 @@ namespace Render {
         ShaderReflectionData reflectionData;
     };
 
+    using ShaderVariantArtifactRef = Common::SharedPtr<const ShaderVariantArtifact>;
+
     struct ShaderTypeArtifact {
+        // hash of the last fully compiled source, variants of a newer compile may land before it is updated
         ShaderSourceHash sourceHash;
-        std::unordered_map<ShaderVariantKey, ShaderVariantArtifact> variantArtifacts;
+        std::unordered_map<ShaderVariantKey, ShaderVariantArtifactRef> variantArtifacts;
     };
 
     struct ShaderInstance {
@@ -351,6 +356,7 @@ namespace Render {
 
         ~ShaderArtifactRegistry();
 
+        // render thread, picks up the artifacts published since the last copy
         void PerformThreadCopy();
 
     private:
@@ -359,8 +365,18 @@ namespace Render {
 
         ShaderArtifactRegistry();
 
-        std::mutex mutexGT;
-        std::unordered_map<ShaderTypeKey, ShaderTypeArtifact> typeArtifactsGT;
+        // any thread, variants the renderer is waiting for are compiled before the rest of their type, the compiler checks
+        // the requests each time it takes the next variant, so this also works while the type is already compiling
+        void RequestVariant(ShaderTypeKey inTypeKey, ShaderVariantKey inVariantKey);
+
+        // guards everything but typeArtifactsRT, only held to read or publish, never across a compilation
+        std::mutex mutex;
+        uint64_t version;
+        uint64_t versionRT;
+        std::unordered_map<ShaderTypeKey, ShaderTypeArtifact> typeArtifacts;
+        // source hash being compiled per type, a newer compile of the same type supersedes an older one
+        std::unordered_map<ShaderTypeKey, ShaderSourceHash> compilingHashes;
+        std::unordered_map<ShaderTypeKey, std::unordered_set<ShaderVariantKey>> requestedVariants;
         std::unordered_map<ShaderTypeKey, ShaderTypeArtifact> typeArtifactsRT;
     };
 
@@ -373,7 +389,9 @@ namespace Render {
 
         // render thread
         bool HasShaderInstance(const ShaderType& inShaderType, const ShaderVariantValueMap& inShaderVariants) const;
+        bool HasShaderInstance(ShaderTypeKey inTypeKey, ShaderVariantKey inVariantKey) const;
         ShaderInstance GetShaderInstance(const ShaderType& inShaderType, const ShaderVariantValueMap& inShaderVariants);
+        ShaderInstance GetShaderInstance(ShaderTypeKey inTypeKey, ShaderVariantKey inVariantKey);
         void Invalidate();
 
     private:
@@ -0,0 +1,65 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include <Common/FileSystem.h>
+#include <Render/ShaderCompiler.h>
+
+namespace Render::Internal {
+    // bump when the entry layout or the key composition changes, old entries then miss and are rewritten
+    constexpr uint32_t shaderCacheFormatVersion = 2;
+}
+
+namespace Render {
+    using ShaderCacheKey = uint64_t;
+
+    struct ShaderCacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t writes;
+
+        ShaderCacheStats();
+    };
+
+    // content addressed disk cache of compiled shader variants, one file per variant named by the hash of everything
+    // the byte code depends on, holding the byte code and the reflection data. lookups and stores run on the shader
+    // compiler threads, entries are written to a temporary file and renamed so concurrent processes never read a torn
+    // entry.
+    class ShaderCache {
+    public:
+        static ShaderCache& Get();
+        static ShaderCacheKey ComputeKey(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions, uint64_t inCompilerVersion);
+
+        ~ShaderCache();
+
+        // defaults to Shader under the game cache directory, or the engine cache directory when no game is set
+        void SetDirectory(const Common::Path& inDirectory);
+        Common::Path GetDirectory() const;
+        void SetEnabled(bool inEnabled);
+        bool IsEnabled() const;
+        bool Load(ShaderCacheKey inKey, ShaderCompileOutput& outOutput);
+        void Store(ShaderCacheKey inKey, const ShaderCompileOutput& inOutput);
+        // removes the least recently used entries until the cache fits in inMaxBytes, returns the number of removed entries
+        size_t Prune(uint64_t inMaxBytes);
+        ShaderCacheStats GetStats() const;
+        void ResetCounters();
+
+    private:
+        ShaderCache();
+
+        Common::Path GetEntryPath(ShaderCacheKey inKey) const;
+
+        mutable std::mutex mutex;
+        mutable Common::Path directory;
+        std::atomic<bool> enabled;
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> writes;
+    };
+}
@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <string>
+#include <functional>
 
 #include <RHI/Common.h>
 #include <Render/Shader.h>
@@ -24,6 +25,8 @@ namespace Render {
         RHI::ShaderStageBits stage = RHI::ShaderStageBits::max;
         std::vector<std::string> definitions;
         std::vector<std::string> includeDirectories;
+        // hash of the source and every include it resolves, inputs with a hash are looked up in the disk shader cache
+        ShaderSourceHash sourceHash = shaderSourceHashNotCompiled;
     };
 
     struct ShaderCompileOptions {
@@ -51,13 +54,19 @@ namespace Render {
 
     class ShaderCompiler {
     public:
+        using OnCompiled = std::function<void(ShaderCompileOutput&&)>;
+
         static ShaderCompiler& Get();
         ~ShaderCompiler();
         std::future<ShaderCompileOutput> Compile(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions);
+        // hands the output to inOnCompiled on the compiler thread that produced it
+        void Compile(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions, OnCompiled inOnCompiled);
+        uint64_t GetCompilerVersion() const;
 
     private:
         ShaderCompiler();
 
+        uint64_t compilerVersion;
         Common::ThreadPool threadPool;
     };
 
@@ -0,0 +1,110 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <Common/Memory.h>
+#include <RHI/RHI.h>
+
+namespace Render::Internal {
+    // frames whose uniform data may still be read by the gpu, pages of a frame slot are rewritten only after it
+    constexpr uint8_t uniformBufferRingFrameLatency = 3;
+    constexpr size_t uniformBufferRingPageSize = 4 * 1024 * 1024;
+    // constant buffer placement alignment of dx12, also covers every vulkan minUniformBufferOffsetAlignment
+    constexpr size_t uniformBufferRingMinAlignment = 256;
+}
+
+namespace Render {
+    struct UniformAllocation {
+        RHI::Buffer* buffer;
+        size_t offset;
+        size_t size;
+        void* mappedData;
+    };
+
+    // per frame linear allocator for transient uniform data, each frame in flight owns a set of large mapWrite pages
+    // which are mapped once at creation and bump allocated, so a draw constant costs a pointer bump and a memcpy,
+    // not a pooled buffer and a map job. the rhi has no dynamic offsets, so allocations are bound through views at
+    // their offset, pages keep those views and the frame slot keeps the bind groups built only from them, frames
+    // replaying the same allocations then reuse both. views and bind groups a frame slot did not use for a whole turn
+    // are destroyed when it is recycled. only used from the render thread.
+    class UniformBufferRing {
+    public:
+        static UniformBufferRing& Get(RHI::Device& device);
+        static void Destroy(RHI::Device& device);
+
+        ~UniformBufferRing();
+
+        // switch to the frame slot of the current frame number and rewind its pages
+        void Recycle();
+        UniformAllocation Allocate(size_t inSize);
+        // flush the data written to the pages this frame, must happen before the frame is submitted
+        void Flush();
+        bool Contains(RHI::Buffer* inBuffer) const;
+        RHI::BufferView* GetView(RHI::Buffer* inBuffer, const RHI::BufferViewCreateInfo& inCreateInfo);
+        // bind groups whose entries are all views of ring pages, the create info is made persistent
+        RHI::BindGroup* GetBindGroup(const RHI::BindGroupCreateInfo& inCreateInfo);
+        size_t GetAlignment() const;
+        RHI::BufferState GetState(RHI::Buffer* inBuffer) const;
+        void SetState(RHI::Buffer* inBuffer, RHI::BufferState inState);
+
+    private:
+        struct CachedView {
+            Common::UniquePtr<RHI::BufferView> view;
+            uint64_t lastUsedFrame;
+        };
+
+        struct Page {
+            Common::UniquePtr<RHI::Buffer> buffer;
+            size_t size;
+            size_t offset;
+            size_t flushedOffset;
+            uint8_t* mappedData;
+            RHI::BufferState state;
+            std::unordered_map<uint64_t, CachedView> views;
+        };
+
+        // the whole create info that matters for ring bind groups, compared on lookup, not only hashed
+        struct BindGroupKey {
+            struct Hash {
+                size_t operator()(const BindGroupKey& inKey) const;
+            };
+
+            bool operator==(const BindGroupKey& inRhs) const;
+
+            const RHI::BindGroupLayout* layout;
+            std::vector<std::pair<const RHI::BufferView*, RHI::ShaderStageFlags::UnderlyingType>> entries;
+        };
+
+        struct CachedBindGroup {
+            Common::UniquePtr<RHI::BindGroup> bindGroup;
+            uint64_t lastUsedFrame;
+        };
+
+        struct Frame {
+            std::vector<Page> pages;
+            size_t currentPage;
+            // declared after the pages, bind groups are destroyed before the views they reference
+            std::unordered_map<BindGroupKey, CachedBindGroup, BindGroupKey::Hash> bindGroups;
+        };
+
+        explicit UniformBufferRing(RHI::Device& inDevice);
+
+        Page CreatePage(size_t inSize) const;
+        Page* FindPage(RHI::Buffer* inBuffer);
+        const Page* FindPage(RHI::Buffer* inBuffer) const;
+
+        RHI::Device& device;
+        size_t alignment;
+        uint8_t currentFrame;
+        Frame frames[Internal::uniformBufferRingFrameLatency];
+        // filled by every bind group lookup, keeps its capacity so that hits do not allocate
+        BindGroupKey lookupKey;
+    };
+}
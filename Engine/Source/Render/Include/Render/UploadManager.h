@@ -0,0 +1,149 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include <Common/Debug.h>
+#include <Common/Memory.h>
+#include <RHI/RHI.h>
+
+namespace Render::Internal {
+    constexpr size_t uploadRingSize = 64 * 1024 * 1024;
+    // placement alignment of dx12 texture copies, also covers every vulkan optimalBufferCopyOffsetAlignment
+    constexpr size_t uploadRingMinAlignment = 512;
+}
+
+namespace Render {
+    // monotonically increasing id of an upload request, requests are submitted in the order they are queued
+    using UploadTicket = uint64_t;
+
+    // writes a sub resource into its staging slice, for sub resources whose staging layout is not a plain row copy
+    // (e.g. the separate depth and stencil planes of a combined depth stencil copy)
+    using TextureSubResourceWriter = std::function<void(const std::vector<uint8_t>& inPixels, uint8_t* outData, const RHI::TextureSubResourceCopyFootprint& inFootprint)>;
+
+    struct UploadStats {
+        uint64_t uploads;
+        uint64_t bytesUploaded;
+        uint64_t submissions;
+        uint64_t stalls;
+
+        UploadStats();
+    };
+
+    // uploads buffer and texture content into device local resources. payloads are moved into the manager and copied
+    // into one shared staging ring when submitted, every frame's uploads are recorded into one transfer command buffer
+    // and ring space is reclaimed once the fence of that submission signals. only used from the render thread.
+    class UploadManager {
+    public:
+        static UploadManager& Get(RHI::Device& device);
+        static void Destroy(RHI::Device& device);
+
+        ~UploadManager();
+
+        // the buffer must have copyDst usage, it is in inBeforeState now and in inAfterState once the upload is submitted.
+        // elements are copied bytewise, T must be laid out as the gpu reads it
+        template <typename T>
+        UploadTicket UploadBuffer(RHI::Buffer* inBuffer, RHI::BufferState inBeforeState, RHI::BufferState inAfterState, std::vector<T>&& inData, size_t inDstOffset = 0);
+        // sub resources are ordered mip major (mipLevel * arraySize + arrayLayer) and tightly packed, the texture must
+        // have copyDst usage
+        UploadTicket UploadTexture(
+            RHI::Texture* inTexture,
+            RHI::TextureAspect inAspect,
+            RHI::TextureState inBeforeState,
+            RHI::TextureState inAfterState,
+            std::vector<std::vector<uint8_t>>&& inSubResourcePixels,
+            TextureSubResourceWriter&& inWriter = {});
+        // records pending uploads into one transfer submission until the frame budget is used up, returns the semaphore
+        // the first submission reading the uploaded resources must wait on, or nullptr when nothing was submitted
+        RHI::Semaphore* Submit();
+        // the upload is recorded into a submission whose semaphore has been returned by Submit()
+        bool IsSubmitted(UploadTicket inTicket) const;
+        // drops pending uploads into the resource and waits for in flight ones, call before destroying the resource
+        void Discard(RHI::Buffer* inBuffer);
+        void Discard(RHI::Texture* inTexture);
+        // 0 means unlimited, a request larger than the budget is still submitted alone to guarantee progress
+        void SetBudget(uint64_t inBytes);
+        size_t PendingCount() const;
+        const UploadStats& GetStats() const;
+        void ResetCounters();
+
+    private:
+        struct Request {
+            UploadTicket ticket;
+            RHI::Buffer* buffer;
+            RHI::BufferState bufferBeforeState;
+            RHI::BufferState bufferAfterState;
+            size_t bufferDstOffset;
+            RHI::Texture* texture;
+            RHI::TextureState textureBeforeState;
+            RHI::TextureState textureAfterState;
+            std::vector<RHI::TextureSubResourceInfo> subResources;
+            std::vector<RHI::TextureSubResourceCopyFootprint> footprints;
+            std::vector<size_t> subResourceOffsets;
+            size_t size;
+            std::function<void(uint8_t* outData)> writer;
+        };
+
+        struct Submission {
+            RHI::CommandBuffer* cmdBuffer;
+            Common::UniquePtr<RHI::Fence> fence;
+            Common::UniquePtr<RHI::Semaphore> semaphore;
+            // staging buffers of requests larger than the ring
+            std::vector<Common::UniquePtr<RHI::Buffer>> dedicatedBuffers;
+            std::vector<const void*> dstResources;
+            size_t ringBytes;
+            size_t ringEnd;
+        };
+
+        explicit UploadManager(RHI::Device& inDevice);
+
+        UploadTicket Enqueue(Request&& inRequest);
+        void DiscardInternal(const void* inResource);
+        void Reclaim(bool inWaitOldest);
+        bool TryAllocate(size_t inSize, size_t& outOffset, size_t& outConsumed);
+        void RecordRequest(RHI::CopyPassCommandRecorder& inRecorder, RHI::Buffer* inStagingBuffer, size_t inStagingOffset, const Request& inRequest) const;
+
+        RHI::Device& device;
+        RHI::QueueType queueType;
+        size_t alignment;
+        uint64_t budget;
+        Common::UniquePtr<RHI::Buffer> ringBuffer;
+        // head is where the next allocation starts, tail is the oldest byte still read by an in flight submission
+        size_t ringHead;
+        size_t ringTail;
+        size_t ringUsed;
+        std::deque<Request> pendingRequests;
+        std::deque<Submission> inFlightSubmissions;
+        UploadTicket nextTicket;
+        UploadTicket submittedTicket;
+        UploadStats stats;
+    };
+}
+
+namespace Render {
+    template <typename T>
+    UploadTicket UploadManager::UploadBuffer(RHI::Buffer* inBuffer, RHI::BufferState inBeforeState, RHI::BufferState inAfterState, std::vector<T>&& inData, size_t inDstOffset)
+    {
+        Assert(inBuffer != nullptr && !inData.empty());
+
+        Request request {};
+        request.buffer = inBuffer;
+        request.bufferBeforeState = inBeforeState;
+        request.bufferAfterState = inAfterState;
+        request.bufferDstOffset = inDstOffset;
+        request.texture = nullptr;
+        request.size = inData.size() * sizeof(T);
+        request.writer = [data = std::move(inData)](uint8_t* outData) -> void {
+            std::memcpy(outData, data.data(), data.size() * sizeof(T));
+        };
+        return Enqueue(std::move(request));
+    }
+}
@@ -2,13 +2,147 @@
 // Created by johnk on 2023/8/4.
 //
 
+#include <Core/Console.h>
+#include <Core/Log.h>
+#include <Core/Paths.h>
 #include <Core/Thread.h>
 #include <Render/RenderCache.h>
+#include <Render/RenderGraph.h>
 #include <Render/RenderModule.h>
 #include <Render/ResourcePool.h>
 #include <Render/Scene.h>
+#include <Render/ShaderCache.h>
+#include <Render/UniformBufferRing.h>
+#include <Render/UploadManager.h>
 
 namespace Render {
+    static Core::ConsoleSettingValue<uint32_t> csBufferPoolBudgetMB(
+        "r.resourcePool.bufferBudgetMB",
+        "memory budget of pooled buffers in megabytes, unused buffers are evicted in least recently used order once exceeded, 0 means unlimited",
+        0,
+        Core::CSFlagBits::configOverridable);
+
+    static Core::ConsoleSettingValue<uint32_t> csTexturePoolBudgetMB(
+        "r.resourcePool.textureBudgetMB",
+        "memory budget of pooled textures in megabytes, unused textures are evicted in least recently used order once exceeded, 0 means unlimited",
+        0,
+        Core::CSFlagBits::configOverridable);
+
+    static Core::ConsoleSettingValue<bool> csLogResourcePoolStats(
+        "r.resourcePool.logStats",
+        "log hits, misses, resident bytes and evicted bytes of the resource pools every frame",
+        false);
+
+    static Core::ConsoleSettingValue<uint32_t> csUploadFrameBudgetMB(
+        "r.upload.frameBudgetMB",
+        "bytes of buffer and texture uploads submitted per frame in megabytes, the rest waits for later frames, 0 means unlimited",
+        32,
+        Core::CSFlagBits::configOverridable);
+
+    static Core::ConsoleSettingValue<bool> csLogUploadStats(
+        "r.upload.logStats",
+        "log uploads, uploaded bytes, submissions and ring stalls of the upload manager every frame",
+        false);
+
+    static Core::ConsoleSettingValue<bool> csLogRenderGraphCompileStats(
+        "r.renderGraph.logCompileStats",
+        "log render graph compile cache hits and misses with the compile time spent on each every frame",
+        false);
+
+    static Core::ConsoleSettingValue<bool> csShaderCacheEnabled(
+        "r.shaderCache.enabled",
+        "load compiled shader variants from the disk shader cache and store newly compiled ones into it",
+        true,
+        Core::CSFlagBits::configOverridable);
+
+    static Core::ConsoleSettingValue<uint32_t> csShaderCacheMaxSizeMB(
+        "r.shaderCache.maxSizeMB",
+        "size limit of the disk shader cache in megabytes, least recently used entries are pruned on startup once exceeded, 0 means unlimited",
+        512,
+        Core::CSFlagBits::configOverridable);
+
+    static Core::ConsoleSettingValue<bool> csLogShaderCacheStats(
+        "r.shaderCache.logStats",
+        "log disk shader cache hits, misses and writes every frame shaders were compiled",
+        false);
+
+    static Core::ConsoleSettingValue<bool> csPipelineCacheEnabled(
+        "r.pipelineCache.enabled",
+        "load the driver pipeline cache and the pipeline precache list of the previous session on startup and save them on shutdown",
+        true,
+        Core::CSFlagBits::configOverridable);
+
+    static Core::ConsoleSettingValue<bool> csPipelinePrecache(
+        "r.pipelineCache.precache",
+        "create the pipelines recorded by previous sessions on the render workers as soon as their shaders are compiled",
+        true,
+        Core::CSFlagBits::configOverridable);
+
+    template <typename PooledRes>
+    static void ForfeitResourcePool(ResourcePool<PooledRes>& inPool, uint32_t inBudgetMB, const char* inName)
+    {
+        inPool.SetBudget(static_cast<uint64_t>(inBudgetMB) * 1024 * 1024);
+        inPool.Forfeit();
+
+        if (csLogResourcePoolStats.GetRT()) {
+            const auto& stats = inPool.GetStats();
+            LogInfo(Render, "{} pool: {} resources, {} hits, {} misses, {} bytes resident, {} bytes evicted", inName, inPool.Size(), stats.hits, stats.misses, stats.bytesResident, stats.bytesEvicted);
+            inPool.ResetCounters();
+        }
+    }
+
+    static void ForfeitRenderGraphCompileCache(RGCompileCache& inCache)
+    {
+        inCache.Forfeit();
+
+        if (csLogRenderGraphCompileStats.GetRT()) {
+            const auto stats = inCache.GetStats();
+            LogInfo(Render, "render graph compile: {} hits in {}us, {} misses in {}us, {} cached graphs", stats.hits, stats.hitCompileTimeUs, stats.misses, stats.missCompileTimeUs, inCache.Size());
+            inCache.ResetCounters();
+        }
+    }
+
+    static void UpdateUploadManager(UploadManager& inUploadManager)
+    {
+        inUploadManager.SetBudget(static_cast<uint64_t>(csUploadFrameBudgetMB.GetRT()) * 1024 * 1024);
+
+        if (csLogUploadStats.GetRT()) {
+            const auto& stats = inUploadManager.GetStats();
+            LogInfo(Render, "upload: {} uploads, {} bytes, {} submissions, {} stalls, {} pending", stats.uploads, stats.bytesUploaded, stats.submissions, stats.stalls, inUploadManager.PendingCount());
+            inUploadManager.ResetCounters();
+        }
+    }
+
+    static void InitShaderCache(ShaderCache& inShaderCache)
+    {
+        inShaderCache.SetEnabled(csShaderCacheEnabled.GetGT());
+        if (const uint32_t maxSizeMB = csShaderCacheMaxSizeMB.GetGT();
+            inShaderCache.IsEnabled() && maxSizeMB > 0) {
+            if (const auto removed = inShaderCache.Prune(static_cast<uint64_t>(maxSizeMB) * 1024 * 1024);
+                removed > 0) {
+                LogInfo(Render, "shader cache: pruned {} entries from {}", removed, inShaderCache.GetDirectory().String());
+            }
+        }
+    }
+
+    static void LogShaderCacheStats(ShaderCache& inShaderCache)
+    {
+        if (!csLogShaderCacheStats.GetRT()) {
+            return;
+        }
+        const auto stats = inShaderCache.GetStats();
+        if (stats.hits + stats.misses + stats.writes > 0) {
+            LogInfo(Render, "shader cache: {} hits, {} misses, {} writes", stats.hits, stats.misses, stats.writes);
+            inShaderCache.ResetCounters();
+        }
+    }
+
+    static Common::Path GetPipelineCacheFile(RHI::Device& inDevice)
+    {
+        const auto cacheDir = Core::Paths::HasSetGameRoot() ? Core::Paths::GameCacheDir() : Core::Paths::EngineCacheDir();
+        return cacheDir / "Pipeline" / (RHI::GetAbbrStringByType(inDevice.GetGpu().GetInstance().GetRHIType()) + ".bin");
+    }
+
     RenderModule::RenderModule()
         : initialized(false)
         , rhiInstance(nullptr)
@@ -38,6 +172,7 @@ namespace Render {
 
         RenderThread::Get().Start();
         RenderWorkerThreads::Get().Start();
+        InitShaderCache(ShaderCache::Get());
 
         rhiInstance = RHI::Instance::GetByType(inParams.rhiType, inParams.instanceCreateInfo);
         AssertWithReason(rhiInstance->GetGpuNum() > 0, "no compatible GPU was found");
@@ -48,6 +183,14 @@ namespace Render {
                 .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::compute, 1))
                 .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::transfer, 1)));
 
+        if (csPipelineCacheEnabled.GetGT()) {
+            const auto pipelineCacheFile = GetPipelineCacheFile(*rhiDevice);
+            if (auto& pipelineCache = PipelineCache::Get(*rhiDevice);
+                pipelineCache.Load(pipelineCacheFile)) {
+                LogInfo(Render, "pipeline cache: loaded {} with {} precached pipelines", pipelineCacheFile.String(), pipelineCache.PendingPrecacheCount());
+            }
+        }
+
         initialized = true;
     }
 
@@ -56,6 +199,9 @@ namespace Render {
         RenderThread::Get().Stop();
         RenderWorkerThreads::Get().Stop();
 
+        if (csPipelineCacheEnabled.GetGT()) {
+            PipelineCache::Get(*rhiDevice).Save(GetPipelineCacheFile(*rhiDevice));
+        }
         DestroyDeviceResources(*rhiDevice);
 
         rhiInstance = nullptr;
@@ -75,11 +221,19 @@ namespace Render {
 
     void RenderModule::BeginFrame() const // NOLINT
     {
+        rhiDevice->BeginFrame();
         ShaderArtifactRegistry::Get().PerformThreadCopy();
-        BufferPool::Get(*rhiDevice).Forfeit();
-        TexturePool::Get(*rhiDevice).Forfeit();
+        ForfeitResourcePool(BufferPool::Get(*rhiDevice), csBufferPoolBudgetMB.GetRT(), "buffer");
+        ForfeitResourcePool(TexturePool::Get(*rhiDevice), csTexturePoolBudgetMB.GetRT(), "texture");
         ResourceViewCache::Get(*rhiDevice).Forfeit();
         BindGroupCache::Get(*rhiDevice).Forfeit();
+        ForfeitRenderGraphCompileCache(RGCompileCache::Get(*rhiDevice));
+        UniformBufferRing::Get(*rhiDevice).Recycle();
+        UpdateUploadManager(UploadManager::Get(*rhiDevice));
+        LogShaderCacheStats(ShaderCache::Get());
+        if (csPipelinePrecache.GetRT()) {
+            PipelineCache::Get(*rhiDevice).WarmUp();
+        }
     }
 
     Scene* RenderModule::NewScene() const // NOLINT
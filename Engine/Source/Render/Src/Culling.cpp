@@ -0,0 +1,178 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <bit>
+
+#include <Common/Debug.h>
+#include <Common/Math/Simd.h>
+#include <Render/Culling.h>
+#include <Render/RenderThread.h>
+
+namespace Render::Internal {
+    static_assert(sizeof(Common::FSphere) == 4 * sizeof(float), "the culling kernel loads a sphere as one (x, y, z, radius) register");
+
+    static Common::FVec4 NormalizePlane(const Common::FVec4& inPlane)
+    {
+        const float length = std::sqrt(inPlane.x * inPlane.x + inPlane.y * inPlane.y + inPlane.z * inPlane.z);
+        return length > 0.0f ? inPlane / length : inPlane;
+    }
+
+    static Common::FVec4 GetRow(const Common::FMat4x4& inMatrix, uint8_t inRow)
+    {
+        return { inMatrix.At(inRow, 0), inMatrix.At(inRow, 1), inMatrix.At(inRow, 2), inMatrix.At(inRow, 3) };
+    }
+
+    // 4 spheres against all planes, bit i of the result is set when sphere i is not fully outside any plane
+    static uint64_t CullSpheres4(const Common::Simd::F32x4 (&inPlanes)[6][4], const Common::FSphere* inSpheres)
+    {
+        using namespace Common::Simd; // NOLINT
+
+        F32x4 x = LoadU(&inSpheres[0].center.x);
+        F32x4 y = LoadU(&inSpheres[1].center.x);
+        F32x4 z = LoadU(&inSpheres[2].center.x);
+        F32x4 r = LoadU(&inSpheres[3].center.x);
+        Transpose4(x, y, z, r);
+
+        const F32x4 zero = Set1(0.0f);
+        F32x4 inside = CmpGe(zero, zero);
+        for (const auto& plane : inPlanes) {
+            F32x4 distance = Add(plane[3], r);
+            distance = MulAdd(distance, plane[0], x);
+            distance = MulAdd(distance, plane[1], y);
+            distance = MulAdd(distance, plane[2], z);
+            inside = And(inside, CmpGe(distance, zero));
+        }
+        return static_cast<uint64_t>(MoveMask(inside));
+    }
+}
+
+namespace Render {
+    Frustum Frustum::FromWorldToClip(const Common::FMat4x4& inWorldToClip)
+    {
+        const Common::FVec4 row0 = Internal::GetRow(inWorldToClip, 0);
+        const Common::FVec4 row1 = Internal::GetRow(inWorldToClip, 1);
+        const Common::FVec4 row2 = Internal::GetRow(inWorldToClip, 2);
+        const Common::FVec4 row3 = Internal::GetRow(inWorldToClip, 3);
+
+        // clip space volume is -w <= x, y <= w and 0 <= z <= w, reversed-z only swaps which of the depth planes is near
+        Frustum result;
+        result.planes[static_cast<uint8_t>(Plane::left)] = Internal::NormalizePlane(row3 + row0);
+        result.planes[static_cast<uint8_t>(Plane::right)] = Internal::NormalizePlane(row3 - row0);
+        result.planes[static_cast<uint8_t>(Plane::bottom)] = Internal::NormalizePlane(row3 + row1);
+        result.planes[static_cast<uint8_t>(Plane::top)] = Internal::NormalizePlane(row3 - row1);
+        result.planes[static_cast<uint8_t>(Plane::zNear)] = Internal::NormalizePlane(row3 - row2);
+        result.planes[static_cast<uint8_t>(Plane::zFar)] = Internal::NormalizePlane(row2);
+        return result;
+    }
+
+    Frustum::Frustum() = default;
+
+    bool Frustum::Intersects(const Common::FSphere& inSphere) const
+    {
+        for (const auto& plane : planes) {
+            const float distance = plane.x * inSphere.center.x + plane.y * inSphere.center.y + plane.z * inSphere.center.z + plane.w;
+            if (distance + inSphere.radius < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    VisibilityMask::VisibilityMask()
+        : size(0)
+    {
+    }
+
+    void VisibilityMask::Resize(size_t inSize)
+    {
+        size = inSize;
+        words.assign((inSize + wordBits - 1) / wordBits, 0);
+    }
+
+    void VisibilityMask::Set(size_t inIndex, bool inVisible)
+    {
+        Assert(inIndex < size);
+        const uint64_t bit = 1ull << (inIndex % wordBits);
+        auto& word = words[inIndex / wordBits];
+        word = inVisible ? word | bit : word & ~bit;
+    }
+
+    bool VisibilityMask::Test(size_t inIndex) const
+    {
+        Assert(inIndex < size);
+        return (words[inIndex / wordBits] >> (inIndex % wordBits) & 1) != 0;
+    }
+
+    size_t VisibilityMask::Size() const
+    {
+        return size;
+    }
+
+    size_t VisibilityMask::VisibleNum() const
+    {
+        size_t result = 0;
+        for (const auto word : words) {
+            result += std::popcount(word);
+        }
+        return result;
+    }
+
+    uint64_t* VisibilityMask::Words()
+    {
+        return words.data();
+    }
+
+    const uint64_t* VisibilityMask::Words() const
+    {
+        return words.data();
+    }
+
+    void FrustumCulling::Cull(const Frustum& inFrustum, std::span<const Common::FSphere> inSpheres, VisibilityMask& outMask)
+    {
+        outMask.Resize(inSpheres.size());
+        CullRange(inFrustum, inSpheres, 0, inSpheres.size(), outMask);
+    }
+
+    void FrustumCulling::CullParallel(const Frustum& inFrustum, std::span<const Common::FSphere> inSpheres, VisibilityMask& outMask)
+    {
+        static_assert(parallelChunkSize % VisibilityMask::wordBits == 0);
+
+        outMask.Resize(inSpheres.size());
+        const size_t chunkNum = (inSpheres.size() + parallelChunkSize - 1) / parallelChunkSize;
+        if (chunkNum <= 1) {
+            CullRange(inFrustum, inSpheres, 0, inSpheres.size(), outMask);
+            return;
+        }
+        RenderWorkerThreads::Get().ExecuteTasks(chunkNum, [&](size_t inChunkIndex) -> void {
+            const size_t begin = inChunkIndex * parallelChunkSize;
+            CullRange(inFrustum, inSpheres, begin, std::min(begin + parallelChunkSize, inSpheres.size()), outMask);
+        });
+    }
+
+    void FrustumCulling::CullRange(const Frustum& inFrustum, std::span<const Common::FSphere> inSpheres, size_t inBegin, size_t inEnd, VisibilityMask& outMask)
+    {
+        Assert(inBegin % VisibilityMask::wordBits == 0 && inEnd <= inSpheres.size());
+
+        // splat every plane component once, the kernel then only does multiply-adds against the transposed spheres
+        Common::Simd::F32x4 planes[6][4];
+        for (uint8_t i = 0; i < 6; i++) {
+            const auto& plane = inFrustum.planes[i];
+            planes[i][0] = Common::Simd::Set1(plane.x);
+            planes[i][1] = Common::Simd::Set1(plane.y);
+            planes[i][2] = Common::Simd::Set1(plane.z);
+            planes[i][3] = Common::Simd::Set1(plane.w);
+        }
+
+        uint64_t* words = outMask.Words();
+        size_t i = inBegin;
+        for (; i + 4 <= inEnd; i += 4) {
+            words[i / VisibilityMask::wordBits] |= Internal::CullSpheres4(planes, &inSpheres[i]) << (i % VisibilityMask::wordBits);
+        }
+        for (; i < inEnd; i++) {
+            if (inFrustum.Intersects(inSpheres[i])) {
+                words[i / VisibilityMask::wordBits] |= 1ull << (i % VisibilityMask::wordBits);
+            }
+        }
+    }
+}
@@ -2,37 +2,43 @@
 // Created by johnk on 2026/7/5.
 //
 
-#include <cstring>
-
 #include <Render/MeshRenderData.h>
 
 namespace Render::Internal {
-    static Common::UniquePtr<RHI::Buffer> CreateUploadedBuffer(RHI::Device& inDevice, const void* inData, size_t inSize, RHI::BufferUsageBits inUsage, const std::string& inDebugName)
+    static Common::UniquePtr<RHI::Buffer> CreateDeviceLocalBuffer(RHI::Device& inDevice, size_t inSize, RHI::BufferUsageBits inUsage, const std::string& inDebugName)
     {
         const RHI::BufferCreateInfo createInfo = RHI::BufferCreateInfo()
-            .SetSize(inSize)
-            .SetUsages(inUsage | RHI::BufferUsageBits::mapWrite | RHI::BufferUsageBits::copySrc)
-            .SetInitialState(RHI::BufferState::staging)
+            .SetSize(static_cast<uint32_t>(inSize))
+            .SetUsages(inUsage | RHI::BufferUsageBits::copyDst)
+            .SetInitialState(RHI::BufferState::undefined)
             .SetDebugName(inDebugName);
 
         Common::UniquePtr<RHI::Buffer> result = inDevice.CreateBuffer(createInfo);
         Assert(result.Valid());
-        auto* data = result->Map(RHI::MapMode::write, 0, inSize);
-        std::memcpy(data, inData, inSize);
-        result->Unmap();
         return result;
     }
 }
 
 namespace Render {
-    MeshRenderData::MeshRenderData(RHI::Device& inDevice, const std::vector<Vertex>& inVertices, const std::vector<uint32_t>& inIndices)
-        : vertexBuffer(Internal::CreateUploadedBuffer(inDevice, inVertices.data(), inVertices.size() * sizeof(Vertex), RHI::BufferUsageBits::vertex, "meshVertexBuffer"))
-        , indexBuffer(Internal::CreateUploadedBuffer(inDevice, inIndices.data(), inIndices.size() * sizeof(uint32_t), RHI::BufferUsageBits::index, "meshIndexBuffer"))
+    MeshRenderData::MeshRenderData(RHI::Device& inDevice, std::vector<Vertex>&& inVertices, std::vector<uint32_t>&& inIndices)
+        : device(inDevice)
+        , vertexBuffer(Internal::CreateDeviceLocalBuffer(inDevice, inVertices.size() * sizeof(Vertex), RHI::BufferUsageBits::vertex, "meshVertexBuffer"))
+        , indexBuffer(Internal::CreateDeviceLocalBuffer(inDevice, inIndices.size() * sizeof(uint32_t), RHI::BufferUsageBits::index, "meshIndexBuffer"))
         , indexCount(static_cast<uint32_t>(inIndices.size()))
+        , uploadTicket(0)
     {
+        // the renderer imports mesh buffers as shaderReadOnly, the index upload is queued last so its ticket covers both
+        auto& uploadManager = UploadManager::Get(inDevice);
+        uploadManager.UploadBuffer(vertexBuffer.Get(), RHI::BufferState::undefined, RHI::BufferState::shaderReadOnly, std::move(inVertices));
+        uploadTicket = uploadManager.UploadBuffer(indexBuffer.Get(), RHI::BufferState::undefined, RHI::BufferState::shaderReadOnly, std::move(inIndices));
     }
 
-    MeshRenderData::~MeshRenderData() = default;
+    MeshRenderData::~MeshRenderData()
+    {
+        auto& uploadManager = UploadManager::Get(device);
+        uploadManager.Discard(vertexBuffer.Get());
+        uploadManager.Discard(indexBuffer.Get());
+    }
 
     RHI::Buffer* MeshRenderData::GetVertexBuffer() const
     {
@@ -48,4 +54,9 @@ namespace Render {
     {
         return indexCount;
     }
+
+    UploadTicket MeshRenderData::GetUploadTicket() const
+    {
+        return uploadTicket;
+    }
 }
@@ -4,13 +4,20 @@
 
 #include <Render/RenderCache.h>
 
+#include <chrono>
+#include <optional>
 #include <utility>
 #include <variant>
 
 #include <Common/Hash.h>
 #include <Common/IO.h>
+#include <Common/Serialization.h>
 #include <Core/Thread.h>
+#include <Render/RenderGraph.h>
+#include <Render/RenderThread.h>
 #include <Render/ResourcePool.h>
+#include <Render/UniformBufferRing.h>
+#include <Render/UploadManager.h>
 
 namespace Render::Internal {
     constexpr uint64_t resourceViewCacheReleaseFrameLatency = 2;
@@ -116,6 +123,259 @@ namespace Render::Internal {
     }
 }
 
+namespace Render::Internal {
+    struct PipelineCacheFile {
+        uint8_t rhiType;
+        uint32_t vendorId;
+        uint32_t deviceId;
+        uint32_t driverVersion;
+        std::vector<uint8_t> rhiCacheData;
+        std::unordered_map<uint64_t, std::vector<uint8_t>> precacheRecords;
+    };
+
+    using PipelineCacheDeserializeStream = Common::BoundedDeserializeStream<>;
+
+    // smallest encodings of the variable length parts of a precache record, used to bound the counts read from it
+    constexpr size_t minVertexBufferLayoutSize = sizeof(uint32_t) + sizeof(uint64_t) * 2;
+    constexpr size_t minVertexAttributeSize = sizeof(uint32_t) + sizeof(uint64_t) * 2 + sizeof(uint8_t);
+    constexpr size_t minColorTargetSize = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(bool);
+
+    static bool ReadString(PipelineCacheDeserializeStream& inStream, std::string& outString)
+    {
+        uint64_t size;
+        if (!inStream.ReadLength(size)) {
+            return false;
+        }
+        outString.resize(size);
+        inStream.Read<uint8_t>(reinterpret_cast<uint8_t*>(outString.data()), size);
+        return !inStream.Failed();
+    }
+
+    static PipelineCacheFile MakePipelineCacheFile(RHI::Device& inDevice)
+    {
+        const auto property = inDevice.GetGpu().GetProperty();
+
+        PipelineCacheFile result {};
+        result.rhiType = static_cast<uint8_t>(inDevice.GetGpu().GetInstance().GetRHIType());
+        result.vendorId = property.vendorId;
+        result.deviceId = property.deviceId;
+        result.driverVersion = property.driverVersion;
+        return result;
+    }
+
+    static bool IsPipelineCacheFileCompatible(const PipelineCacheFile& inFile, RHI::Device& inDevice)
+    {
+        const auto expected = MakePipelineCacheFile(inDevice);
+        return inFile.rhiType == expected.rhiType
+            && inFile.vendorId == expected.vendorId
+            && inFile.deviceId == expected.deviceId
+            && inFile.driverVersion == expected.driverVersion;
+    }
+
+    // flat rhi states are plain enums and numbers, the file never leaves the machine that wrote it so they are stored as is
+    template <typename T>
+    static void WriteRhiState(Common::BinarySerializeStream& inStream, const T& inState)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        inStream.Write<uint8_t>(reinterpret_cast<const uint8_t*>(&inState), sizeof(T));
+    }
+
+    template <typename T>
+    static void ReadRhiState(Common::BinaryDeserializeStream& inStream, T& outState)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        inStream.Read<uint8_t>(reinterpret_cast<uint8_t*>(&outState), sizeof(T));
+    }
+
+    static void WriteShaderKeys(Common::BinarySerializeStream& inStream, const ShaderInstance& inShader)
+    {
+        inStream.Write<bool>(inShader.Valid());
+        inStream.Write<uint64_t>(inShader.typeKey);
+        inStream.Write<uint64_t>(inShader.variantKey);
+    }
+
+    static std::optional<std::pair<ShaderTypeKey, ShaderVariantKey>> ReadShaderKeys(Common::BinaryDeserializeStream& inStream)
+    {
+        bool valid;
+        uint64_t typeKey;
+        uint64_t variantKey;
+        inStream.Read<bool>(valid);
+        inStream.Read<uint64_t>(typeKey);
+        inStream.Read<uint64_t>(variantKey);
+        return valid ? std::optional(std::make_pair(typeKey, variantKey)) : std::nullopt;
+    }
+
+    static std::vector<uint8_t> EncodePrecacheRecord(const ComputePipelineStateDesc& inDesc)
+    {
+        std::vector<uint8_t> result;
+        Common::MemorySerializeStream stream(result);
+        stream.Write<bool>(false);
+        WriteShaderKeys(stream, inDesc.shaders.computeShader);
+        return result;
+    }
+
+    static std::vector<uint8_t> EncodePrecacheRecord(const RasterPipelineStateDesc& inDesc)
+    {
+        std::vector<uint8_t> result;
+        Common::MemorySerializeStream stream(result);
+        stream.Write<bool>(true);
+        WriteShaderKeys(stream, inDesc.shaders.vertexShader);
+        WriteShaderKeys(stream, inDesc.shaders.pixelShader);
+        WriteShaderKeys(stream, inDesc.shaders.geometryShader);
+        WriteShaderKeys(stream, inDesc.shaders.domainShader);
+        WriteShaderKeys(stream, inDesc.shaders.hullShader);
+
+        stream.Write<uint64_t>(inDesc.vertexState.bufferLayouts.size());
+        for (const auto& layout : inDesc.vertexState.bufferLayouts) {
+            stream.Write<uint32_t>(static_cast<uint32_t>(layout.stepMode));
+            stream.Write<uint64_t>(layout.stride);
+            stream.Write<uint64_t>(layout.attributes.size());
+            for (const auto& attribute : layout.attributes) {
+                stream.Write<uint32_t>(static_cast<uint32_t>(attribute.format));
+                stream.Write<uint64_t>(attribute.offset);
+                Common::Serializer<std::string>::Serialize(stream, attribute.binding.semanticName);
+                stream.Write<uint8_t>(attribute.binding.semanticIndex);
+            }
+        }
+        WriteRhiState(stream, inDesc.primitiveState);
+        WriteRhiState(stream, inDesc.depthStencilState);
+        WriteRhiState(stream, inDesc.multiSampleState);
+        stream.Write<uint64_t>(inDesc.fragmentState.colorTargets.size());
+        for (const auto& colorTarget : inDesc.fragmentState.colorTargets) {
+            stream.Write<uint32_t>(static_cast<uint32_t>(colorTarget.format));
+            stream.Write<uint64_t>(static_cast<uint64_t>(colorTarget.writeFlags.Value()));
+            stream.Write<bool>(colorTarget.blendEnabled);
+            WriteRhiState(stream, colorTarget.colorBlend);
+            WriteRhiState(stream, colorTarget.alphaBlend);
+        }
+        return result;
+    }
+
+    static bool DecodePrecacheRecord(const std::vector<uint8_t>& inBytes, bool& outRaster, std::array<std::optional<std::pair<ShaderTypeKey, ShaderVariantKey>>, 5>& outShaders, RasterPipelineStateDesc& outRasterDesc)
+    {
+        if (inBytes.empty()) {
+            return false;
+        }
+
+        PipelineCacheDeserializeStream stream(inBytes);
+        stream.Read<bool>(outRaster);
+        if (!outRaster) {
+            outShaders[0] = ReadShaderKeys(stream);
+            return !stream.Failed() && outShaders[0].has_value();
+        }
+
+        for (auto& shader : outShaders) {
+            shader = ReadShaderKeys(stream);
+        }
+
+        uint64_t layoutNum;
+        if (!stream.ReadLength(layoutNum, minVertexBufferLayoutSize)) {
+            return false;
+        }
+        for (auto i = 0; i < layoutNum && !stream.Failed(); i++) {
+            uint32_t stepMode;
+            uint64_t stride;
+            uint64_t attributeNum;
+            stream.Read<uint32_t>(stepMode);
+            stream.Read<uint64_t>(stride);
+            if (!stream.ReadLength(attributeNum, minVertexAttributeSize)) {
+                return false;
+            }
+
+            RVertexBufferLayout layout(static_cast<RHI::VertexStepMode>(stepMode), stride);
+            for (auto j = 0; j < attributeNum; j++) {
+                uint32_t format;
+                uint64_t offset;
+                RVertexBinding binding;
+                stream.Read<uint32_t>(format);
+                stream.Read<uint64_t>(offset);
+                ReadString(stream, binding.semanticName);
+                stream.Read<uint8_t>(binding.semanticIndex);
+                layout.AddAttribute(RVertexAttribute(binding, static_cast<RHI::VertexFormat>(format), offset));
+            }
+            outRasterDesc.vertexState.AddVertexBufferLayout(layout);
+        }
+        ReadRhiState(stream, outRasterDesc.primitiveState);
+        ReadRhiState(stream, outRasterDesc.depthStencilState);
+        ReadRhiState(stream, outRasterDesc.multiSampleState);
+
+        uint64_t colorTargetNum;
+        if (!stream.ReadLength(colorTargetNum, minColorTargetSize)) {
+            return false;
+        }
+        for (auto i = 0; i < colorTargetNum && !stream.Failed(); i++) {
+            uint32_t format;
+            uint64_t writeFlags;
+            RHI::ColorTargetState colorTarget;
+            stream.Read<uint32_t>(format);
+            stream.Read<uint64_t>(writeFlags);
+            stream.Read<bool>(colorTarget.blendEnabled);
+            ReadRhiState(stream, colorTarget.colorBlend);
+            ReadRhiState(stream, colorTarget.alphaBlend);
+            colorTarget.format = static_cast<RHI::PixelFormat>(format);
+            colorTarget.writeFlags = static_cast<RHI::ColorWriteFlags::UnderlyingType>(writeFlags);
+            outRasterDesc.fragmentState.AddColorTarget(colorTarget);
+        }
+        return !stream.Failed() && stream.Remaining() == 0 && outShaders[0].has_value();
+    }
+
+    static void WritePipelineCacheFile(Common::BinarySerializeStream& inStream, const PipelineCacheFile& inFile)
+    {
+        inStream.Write<uint32_t>(pipelineCacheFormatVersion);
+        inStream.Write<uint8_t>(inFile.rhiType);
+        inStream.Write<uint32_t>(inFile.vendorId);
+        inStream.Write<uint32_t>(inFile.deviceId);
+        inStream.Write<uint32_t>(inFile.driverVersion);
+        inStream.Write<uint64_t>(inFile.rhiCacheData.size());
+        inStream.Write<uint8_t>(inFile.rhiCacheData.data(), inFile.rhiCacheData.size());
+        inStream.Write<uint64_t>(inFile.precacheRecords.size());
+        for (const auto& [hash, bytes] : inFile.precacheRecords) {
+            inStream.Write<uint64_t>(hash);
+            inStream.Write<uint64_t>(bytes.size());
+            inStream.Write<uint8_t>(bytes.data(), bytes.size());
+        }
+    }
+
+    // the file may be truncated or corrupt, every length is checked against the bytes left and a failed file is ignored
+    static bool ReadPipelineCacheFile(PipelineCacheDeserializeStream& inStream, PipelineCacheFile& outFile)
+    {
+        uint32_t formatVersion;
+        inStream.Read<uint32_t>(formatVersion);
+        if (formatVersion != pipelineCacheFormatVersion) {
+            return false;
+        }
+        inStream.Read<uint8_t>(outFile.rhiType);
+        inStream.Read<uint32_t>(outFile.vendorId);
+        inStream.Read<uint32_t>(outFile.deviceId);
+        inStream.Read<uint32_t>(outFile.driverVersion);
+
+        uint64_t rhiCacheDataSize;
+        if (!inStream.ReadLength(rhiCacheDataSize)) {
+            return false;
+        }
+        const auto rhiCacheData = inStream.ReadView(rhiCacheDataSize);
+        outFile.rhiCacheData.assign(rhiCacheData->begin(), rhiCacheData->end());
+
+        // a record is at least its hash and its length
+        uint64_t recordNum;
+        if (!inStream.ReadLength(recordNum, sizeof(uint64_t) * 2)) {
+            return false;
+        }
+        outFile.precacheRecords.reserve(recordNum);
+        for (auto i = 0; i < recordNum; i++) {
+            uint64_t hash;
+            uint64_t recordSize;
+            inStream.Read<uint64_t>(hash);
+            if (!inStream.ReadLength(recordSize)) {
+                return false;
+            }
+            const auto record = inStream.ReadView(recordSize);
+            outFile.precacheRecords.emplace(hash, std::vector<uint8_t>(record->begin(), record->end()));
+        }
+        return !inStream.Failed() && inStream.Remaining() == 0;
+    }
+}
+
 namespace Render {
     class PipelineLayoutCache {
     public:
@@ -125,10 +385,12 @@ namespace Render {
 
         void Invalidate();
 
+        // any thread, precached pipelines are created on the render workers
         template <AnyPipelineLayoutDesc D>
         PipelineLayout* GetLayout(const D& desc)
         {
             auto hash = desc.Hash();
+            std::unique_lock lock(layoutMutex);
             auto iter = pipelineLayouts.find(hash);
             if (iter == pipelineLayouts.end()) {
                 pipelineLayouts[hash] = Common::UniquePtr<PipelineLayout>(new PipelineLayout(device, desc, hash));
@@ -137,16 +399,22 @@ namespace Render {
         }
 
     private:
+        static std::mutex mutex;
+
         explicit PipelineLayoutCache(RHI::Device& inDevice);
 
         RHI::Device& device;
+        std::mutex layoutMutex;
         std::unordered_map<size_t, Common::UniquePtr<PipelineLayout>> pipelineLayouts;
     };
 
+    std::mutex PipelineLayoutCache::mutex = std::mutex();
+
     PipelineLayoutCache& PipelineLayoutCache::Get(RHI::Device& device)
     {
         auto& map = Internal::GetDeviceCacheMap<PipelineLayoutCache>();
 
+        std::unique_lock lock(mutex);
         if (const auto iter = map.find(&device);
             iter == map.end()) {
             map[&device] = Common::UniquePtr(new PipelineLayoutCache(device));
@@ -168,6 +436,7 @@ namespace Render {
 
     void PipelineLayoutCache::Invalidate()
     {
+        std::unique_lock lock(layoutMutex);
         pipelineLayouts.clear();
     }
 }
@@ -551,7 +820,7 @@ namespace Render {
         return hash;
     }
 
-    ComputePipelineState::ComputePipelineState(RHI::Device& inDevice, const ComputePipelineStateDesc& inDesc, const size_t inHash)
+    ComputePipelineState::ComputePipelineState(RHI::Device& inDevice, const ComputePipelineStateDesc& inDesc, const size_t inHash, RHI::PipelineCache* inRhiCache)
         : hash(inHash)
     {
         const ComputePipelineLayoutDesc desc = { inDesc.shaders };
@@ -560,6 +829,7 @@ namespace Render {
         RHI::ComputePipelineCreateInfo createInfo;
         createInfo.layout = pipelineLayout->GetRHI();
         createInfo.computeShader = inDesc.shaders.computeShader.rhiHandle;
+        createInfo.pipelineCache = inRhiCache;
         rhiHandle = inDevice.CreateComputePipeline(createInfo);
     }
 
@@ -585,7 +855,7 @@ namespace Render {
         return hash;
     }
 
-    RasterPipelineState::RasterPipelineState(RHI::Device& inDevice, const RasterPipelineStateDesc& inDesc, size_t inHash)
+    RasterPipelineState::RasterPipelineState(RHI::Device& inDevice, const RasterPipelineStateDesc& inDesc, size_t inHash, RHI::PipelineCache* inRhiCache)
         : hash(inHash)
     {
         RasterPipelineLayoutDesc desc = { inDesc.shaders };
@@ -605,6 +875,7 @@ namespace Render {
         createInfo.depthStencilState = inDesc.depthStencilState;
         createInfo.multiSampleState = inDesc.multiSampleState;
         createInfo.fragmentState = inDesc.fragmentState;
+        createInfo.pipelineCache = inRhiCache;
         rhiHandle = inDevice.CreateRasterPipeline(createInfo);
     }
 
@@ -687,13 +958,139 @@ namespace Render {
 
     PipelineCache::PipelineCache(RHI::Device& inDevice)
         : device(inDevice)
+        , rhiCache(inDevice.CreatePipelineCache(RHI::PipelineCacheCreateInfo().SetDebugName("PipelineCache")))
     {
     }
 
     PipelineCache::~PipelineCache() = default;
 
+    bool PipelineCache::Load(const Common::Path& inFile)
+    {
+        Assert(computePipelines.empty() && rasterPipelines.empty());
+
+        Internal::PipelineCacheFile file {};
+        {
+            const Common::MappedFile mappedFile(inFile.String());
+            if (!mappedFile.IsMapped()) {
+                return false;
+            }
+            Internal::PipelineCacheDeserializeStream stream(std::span(mappedFile.Data(), mappedFile.Size()));
+            if (!Internal::ReadPipelineCacheFile(stream, file)) {
+                return false;
+            }
+        }
+        // driver caches are only valid for the gpu and driver that wrote them, precache records reference shader
+        // variants of this rhi's byte code type
+        if (!Internal::IsPipelineCacheFileCompatible(file, device)) {
+            return false;
+        }
+
+        rhiCache = device.CreatePipelineCache(RHI::PipelineCacheCreateInfo(file.rhiCacheData, "PipelineCache"));
+        for (auto& [hash, bytes] : file.precacheRecords) {
+            PrecacheRecord record;
+            record.hash = hash;
+            record.pendingFrames = 0;
+            if (!Internal::DecodePrecacheRecord(bytes, record.raster, record.shaders, record.rasterDesc)) {
+                continue;
+            }
+            pendingPrecache.emplace_back(std::move(record));
+            precacheRecords.emplace(hash, std::move(bytes));
+        }
+        return true;
+    }
+
+    void PipelineCache::Save(const Common::Path& inFile)
+    {
+        WaitWarmUp();
+
+        Internal::PipelineCacheFile file = Internal::MakePipelineCacheFile(device);
+        file.rhiCacheData = rhiCache->GetData();
+        file.precacheRecords.reserve(precacheRecords.size());
+        for (const auto& [hash, bytes] : precacheRecords) {
+            file.precacheRecords.emplace(hash, bytes);
+        }
+        for (const auto& record : pendingPrecache) {
+            if (!computePipelines.contains(record.hash) && !rasterPipelines.contains(record.hash)) {
+                file.precacheRecords.erase(record.hash);
+            }
+        }
+
+        Common::BinaryFileSerializeStream stream(inFile.String());
+        Internal::WritePipelineCacheFile(stream, file);
+    }
+
+    void PipelineCache::WarmUp()
+    {
+        for (auto iter = warmingComputePipelines.begin(); iter != warmingComputePipelines.end();) {
+            if (iter->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++iter;
+                continue;
+            }
+            computePipelines.emplace(iter->first, iter->second.get());
+            iter = warmingComputePipelines.erase(iter);
+        }
+        for (auto iter = warmingRasterPipelines.begin(); iter != warmingRasterPipelines.end();) {
+            if (iter->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++iter;
+                continue;
+            }
+            rasterPipelines.emplace(iter->first, iter->second.get());
+            iter = warmingRasterPipelines.erase(iter);
+        }
+
+        auto& shaderMap = ShaderMap::Get(device);
+        std::vector<PrecacheRecord> stillPending;
+        for (auto& record : pendingPrecache) {
+            if (computePipelines.contains(record.hash) || rasterPipelines.contains(record.hash)) {
+                continue;
+            }
+            // asking for a missing shader requests its variant, the shader compiler takes requested variants before the
+            // rest of their type the next time it picks a variant, also when the type is already compiling
+            const bool shadersReady = std::ranges::all_of(record.shaders, [&](const auto& inShader) -> bool {
+                return !inShader.has_value() || shaderMap.HasShaderInstance(inShader->first, inShader->second);
+            });
+            if (!shadersReady && ++record.pendingFrames >= Internal::pipelinePrecacheMaxPendingFrames) {
+                precacheRecords.erase(record.hash);
+                continue;
+            }
+            if (!shadersReady || warmingComputePipelines.size() + warmingRasterPipelines.size() >= Internal::pipelinePrecacheMaxInFlight) {
+                stillPending.emplace_back(std::move(record));
+                continue;
+            }
+
+            std::array<ShaderInstance, 5> shaders;
+            for (auto i = 0; i < shaders.size(); i++) {
+                if (record.shaders[i].has_value()) {
+                    shaders[i] = shaderMap.GetShaderInstance(record.shaders[i]->first, record.shaders[i]->second);
+                }
+            }
+
+            if (record.raster) {
+                RasterPipelineStateDesc desc = std::move(record.rasterDesc);
+                desc.shaders = { shaders[0], shaders[1], shaders[2], shaders[3], shaders[4] };
+                const auto hash = desc.Hash();
+                warmingRasterPipelines.emplace(hash, RenderWorkerThreads::Get().EmplaceTask([this, desc, hash]() -> Common::UniquePtr<RasterPipelineState> {
+                    return Common::UniquePtr<RasterPipelineState>(new RasterPipelineState(device, desc, hash, rhiCache.Get()));
+                }));
+            } else {
+                const ComputePipelineStateDesc desc = { { shaders[0] } };
+                const auto hash = desc.Hash();
+                warmingComputePipelines.emplace(hash, RenderWorkerThreads::Get().EmplaceTask([this, desc, hash]() -> Common::UniquePtr<ComputePipelineState> {
+                    return Common::UniquePtr<ComputePipelineState>(new ComputePipelineState(device, desc, hash, rhiCache.Get()));
+                }));
+            }
+        }
+        pendingPrecache = std::move(stillPending);
+    }
+
+    size_t PipelineCache::PendingPrecacheCount() const
+    {
+        return pendingPrecache.size() + warmingComputePipelines.size() + warmingRasterPipelines.size();
+    }
+
     void PipelineCache::Invalidate()
     {
+        WaitWarmUp();
         computePipelines.clear();
         rasterPipelines.clear();
         PipelineLayoutCache::Get(device).Invalidate();
@@ -704,7 +1101,14 @@ namespace Render {
         const auto hash = desc.Hash();
         if (const auto iter = computePipelines.find(hash);
             iter == computePipelines.end()) {
-            computePipelines[hash] = Common::UniquePtr(new ComputePipelineState(device, desc, hash));
+            if (const auto warmingIter = warmingComputePipelines.find(hash);
+                warmingIter != warmingComputePipelines.end()) {
+                computePipelines[hash] = warmingIter->second.get();
+                warmingComputePipelines.erase(warmingIter);
+            } else {
+                computePipelines[hash] = Common::UniquePtr(new ComputePipelineState(device, desc, hash, rhiCache.Get()));
+                Record(hash, desc);
+            }
         }
         return computePipelines[hash].Get();
     }
@@ -714,11 +1118,44 @@ namespace Render {
         const auto hash = desc.Hash();
         if (const auto iter = rasterPipelines.find(hash);
             iter == rasterPipelines.end()) {
-            rasterPipelines[hash] = Common::UniquePtr(new RasterPipelineState(device, desc, hash));
+            if (const auto warmingIter = warmingRasterPipelines.find(hash);
+                warmingIter != warmingRasterPipelines.end()) {
+                rasterPipelines[hash] = warmingIter->second.get();
+                warmingRasterPipelines.erase(warmingIter);
+            } else {
+                rasterPipelines[hash] = Common::UniquePtr(new RasterPipelineState(device, desc, hash, rhiCache.Get()));
+                Record(hash, desc);
+            }
         }
         return rasterPipelines[hash].Get();
     }
 
+    void PipelineCache::WaitWarmUp()
+    {
+        for (auto& [hash, future] : warmingComputePipelines) {
+            computePipelines.emplace(hash, future.get());
+        }
+        for (auto& [hash, future] : warmingRasterPipelines) {
+            rasterPipelines.emplace(hash, future.get());
+        }
+        warmingComputePipelines.clear();
+        warmingRasterPipelines.clear();
+    }
+
+    void PipelineCache::Record(size_t inHash, const ComputePipelineStateDesc& inDesc)
+    {
+        if (!precacheRecords.contains(inHash)) {
+            precacheRecords.emplace(inHash, Internal::EncodePrecacheRecord(inDesc));
+        }
+    }
+
+    void PipelineCache::Record(size_t inHash, const RasterPipelineStateDesc& inDesc)
+    {
+        if (!precacheRecords.contains(inHash)) {
+            precacheRecords.emplace(inHash, Internal::EncodePrecacheRecord(inDesc));
+        }
+    }
+
     std::mutex ResourceViewCache::mutex = std::mutex();
 
     ResourceViewCache& ResourceViewCache::Get(RHI::Device& device)
@@ -833,6 +1270,8 @@ namespace Render {
 
     RHI::BindGroup* BindGroupCache::Allocate(const RHI::BindGroupCreateInfo& inCreateInfo)
     {
+        // bind groups are released frames after their last use, which the backends rely on for transient ones only
+        Assert(inCreateInfo.transient);
         const auto& [ptr, frameNumber] = bindGroups.emplace_back(device.CreateBindGroup(inCreateInfo), Core::ThreadContext::FrameNumber());
         return ptr.Get();
     }
@@ -863,6 +1302,9 @@ namespace Render {
 
     void DestroyDeviceResources(RHI::Device& device)
     {
+        UploadManager::Destroy(device);
+        UniformBufferRing::Destroy(device);
+        RGCompileCache::Destroy(device);
         BindGroupCache::Destroy(device);
         PipelineCache::Destroy(device);
         SamplerCache::Destroy(device);
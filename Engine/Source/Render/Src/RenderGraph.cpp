@@ -3,12 +3,16 @@
 //
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <limits>
 #include <ranges>
 
 #include <Render/RenderGraph.h>
 #include <Render/RenderThread.h>
+#include <Render/UniformBufferRing.h>
 #include <Common/Container.h>
+#include <Common/Hash.h>
 
 namespace Render::Internal {
     static std::pair<const uint8_t*, size_t> GetBufferUploadSource(const RGBufferUploadInfo& inUploadInfo)
@@ -65,7 +69,58 @@ namespace Render::Internal {
         return {};
     }
 
-    static RHI::RasterPassBeginInfo GetRHIRasterPassBeginInfo(RGBuilder& builder, const RGRasterPassDesc& inDesc)
+    // buffers only share memory with buffers of the same usages, the slot grows to the largest occupant
+    static bool CanAlias(const RGBufferDesc& inSlotDesc, const RGBufferDesc& inDesc)
+    {
+        return inSlotDesc.usages == inDesc.usages;
+    }
+
+    // textures need an identical layout to share one pooled texture, only initial state and debug name may differ
+    static bool CanAlias(const RGTextureDesc& inSlotDesc, const RGTextureDesc& inDesc)
+    {
+        return inSlotDesc.type == inDesc.type
+            && inSlotDesc.width == inDesc.width
+            && inSlotDesc.height == inDesc.height
+            && inSlotDesc.depthOrArraySize == inDesc.depthOrArraySize
+            && inSlotDesc.format == inDesc.format
+            && inSlotDesc.usages == inDesc.usages
+            && inSlotDesc.mipLevels == inDesc.mipLevels
+            && inSlotDesc.samples == inDesc.samples;
+    }
+
+    // a draw range continues the attachments of the previous range, only the first one may clear and only the last may discard
+    static RGRasterPassDesc GetRasterPassDescForDrawRange(const RGRasterPassDesc& inDesc, bool inFirst, bool inLast)
+    {
+        RGRasterPassDesc result = inDesc;
+        for (auto& colorAttachment : result.colorAttachments) {
+            if (!inFirst) {
+                colorAttachment.loadOp = RHI::LoadOp::load;
+            }
+            if (!inLast) {
+                colorAttachment.storeOp = RHI::StoreOp::store;
+            }
+        }
+        if (result.depthStencilAttachment.has_value()) {
+            auto& depthStencilAttachment = result.depthStencilAttachment.value();
+            if (!inFirst) {
+                depthStencilAttachment.depthLoadOp = RHI::LoadOp::load;
+                depthStencilAttachment.stencilLoadOp = RHI::LoadOp::load;
+            }
+            if (!inLast) {
+                depthStencilAttachment.depthStoreOp = RHI::StoreOp::store;
+                depthStencilAttachment.stencilStoreOp = RHI::StoreOp::store;
+            }
+        }
+        return result;
+    }
+
+    static void SplitRange(size_t inNum, size_t inPartNum, size_t inPartIndex, size_t& outBegin, size_t& outEnd)
+    {
+        outBegin = inNum * inPartIndex / inPartNum;
+        outEnd = inNum * (inPartIndex + 1) / inPartNum;
+    }
+
+    static RHI::RasterPassBeginInfo GetRHIRasterPassBeginInfo(const RGBuilder& builder, const RGRasterPassDesc& inDesc)
     {
         RHI::RasterPassBeginInfo result;
         if (inDesc.depthStencilAttachment.has_value()) {
@@ -79,6 +134,24 @@ namespace Render::Internal {
     }
 }
 
+namespace Render::Internal {
+    static std::unordered_map<RHI::Device*, Common::UniquePtr<RGCompileCache>>& GetRGCompileCacheMap()
+    {
+        static std::unordered_map<RHI::Device*, Common::UniquePtr<RGCompileCache>> map;
+        return map;
+    }
+
+    static void AppendSortedIndices(std::vector<uint64_t>& outKey, const std::unordered_set<RGResourceRef>& inResources, const std::unordered_map<RGResourceRef, uint64_t>& inIndices)
+    {
+        const auto begin = outKey.size();
+        outKey.emplace_back(inResources.size());
+        for (auto* resource : inResources) {
+            outKey.emplace_back(inIndices.at(resource));
+        }
+        std::sort(outKey.begin() + static_cast<int64_t>(begin) + 1, outKey.end());
+    }
+}
+
 namespace Render {
     RGResource::RGResource(const RGResType inType)
         : type(inType)
@@ -408,6 +481,18 @@ namespace Render {
         : RGPass(std::move(inName), RGPassType::raster)
         , passDesc(std::move(inPassDesc))
         , passFunc(std::move(inFunc))
+        , parallelDrawNum(0)
+        , prePassFunc(std::move(inPreExecuteFunc))
+        , postPassFunc(std::move(inPostExecuteFunc))
+        , bindGroups(std::move(inBindGroups))
+    {
+    }
+
+    RGRasterPass::RGRasterPass(std::string inName, RGRasterPassDesc inPassDesc, std::vector<RGBindGroupRef> inBindGroups, size_t inDrawNum, RGParallelRasterPassExecuteFunc inFunc, RGCommonPassExecuteFunc inPreExecuteFunc, RGCommonPassExecuteFunc inPostExecuteFunc)
+        : RGPass(std::move(inName), RGPassType::raster)
+        , passDesc(std::move(inPassDesc))
+        , parallelDrawNum(inDrawNum)
+        , parallelPassFunc(std::move(inFunc))
         , prePassFunc(std::move(inPreExecuteFunc))
         , postPassFunc(std::move(inPostExecuteFunc))
         , bindGroups(std::move(inBindGroups))
@@ -416,8 +501,118 @@ namespace Render {
 
     RGRasterPass::~RGRasterPass() = default;
 
-    RGBuilder::RGBuilder(RHI::Device& inDevice)
+    RGCompileStats::RGCompileStats()
+        : hits(0)
+        , misses(0)
+        , hitCompileTimeUs(0)
+        , missCompileTimeUs(0)
+    {
+    }
+
+    RGCompileCache& RGCompileCache::Get(RHI::Device& device)
+    {
+        auto& map = Internal::GetRGCompileCacheMap();
+        if (!map.contains(&device)) {
+            map.emplace(std::make_pair(&device, Common::UniquePtr<RGCompileCache>(new RGCompileCache(device))));
+        }
+        return *map.at(&device);
+    }
+
+    void RGCompileCache::Destroy(RHI::Device& device)
+    {
+        Internal::GetRGCompileCacheMap().erase(&device);
+    }
+
+    RGCompileCache::RGCompileCache(RHI::Device& inDevice)
+        : device(inDevice)
+    {
+    }
+
+    RGCompileCache::~RGCompileCache() = default;
+
+    Common::SharedPtr<RGCompiledGraph> RGCompileCache::Find(const std::vector<uint64_t>& inKey)
+    {
+        const auto hash = Common::HashUtils::CityHash(inKey.data(), inKey.size() * sizeof(uint64_t));
+
+        std::unique_lock lock(mutex);
+        const auto iter = compiledGraphs.find(hash);
+        if (iter == compiledGraphs.end() || iter->second->key != inKey) {
+            return nullptr;
+        }
+        iter->second->lastUsedFrame = Core::ThreadContext::FrameNumber();
+        return iter->second;
+    }
+
+    void RGCompileCache::Emplace(RGCompiledGraph&& inCompiledGraph)
+    {
+        const auto hash = Common::HashUtils::CityHash(inCompiledGraph.key.data(), inCompiledGraph.key.size() * sizeof(uint64_t));
+        inCompiledGraph.lastUsedFrame = Core::ThreadContext::FrameNumber();
+
+        std::unique_lock lock(mutex);
+        compiledGraphs[hash] = Common::SharedPtr<RGCompiledGraph>(new RGCompiledGraph(std::move(inCompiledGraph)));
+    }
+
+    void RGCompileCache::RecordCompile(bool inHit, uint64_t inCompileTimeUs)
+    {
+        std::unique_lock lock(mutex);
+        if (inHit) {
+            stats.hits++;
+            stats.hitCompileTimeUs += inCompileTimeUs;
+        } else {
+            stats.misses++;
+            stats.missCompileTimeUs += inCompileTimeUs;
+        }
+    }
+
+    size_t RGCompileCache::Size() const
+    {
+        std::unique_lock lock(mutex);
+        return compiledGraphs.size();
+    }
+
+    RGCompileStats RGCompileCache::GetStats() const
+    {
+        std::unique_lock lock(mutex);
+        return stats;
+    }
+
+    void RGCompileCache::ResetCounters()
+    {
+        std::unique_lock lock(mutex);
+        stats = RGCompileStats();
+    }
+
+    void RGCompileCache::Invalidate()
+    {
+        std::unique_lock lock(mutex);
+        compiledGraphs.clear();
+    }
+
+    void RGCompileCache::Forfeit()
+    {
+        const auto currentFrame = Core::ThreadContext::FrameNumber();
+
+        std::unique_lock lock(mutex);
+        for (auto iter = compiledGraphs.begin(); iter != compiledGraphs.end();) {
+            if (currentFrame - iter->second->lastUsedFrame > Internal::rgCompileCacheReleaseFrameLatency) {
+                iter = compiledGraphs.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    RGTransientMemoryStats::RGTransientMemoryStats()
+        : transientResourceNum(0)
+        , physicalResourceNum(0)
+        , bytesWithoutAliasing(0)
+        , bytesAllocated(0)
+    {
+    }
+
+    RGBuilder::RGBuilder(RHI::Device& inDevice, bool inParallelRecord)
         : executed(false)
+        , parallelRecord(inParallelRecord)
         , device(inDevice)
     {
     }
@@ -479,6 +674,23 @@ namespace Render {
         return bindGroups.back().Get();
     }
 
+    RGBufferViewRef RGBuilder::AllocateUniformBuffer(const void* inData, size_t inSize)
+    {
+        Assert(!executed);
+        Assert(inData != nullptr && inSize > 0);
+
+        auto& uniformBufferRing = UniformBufferRing::Get(device);
+        const auto [buffer, offset, size, mappedData] = uniformBufferRing.Allocate(inSize);
+        std::memcpy(mappedData, inData, inSize);
+
+        // every ring page is imported once per builder, allocations become views at different offsets of it
+        auto iter = uniformRingBuffers.find(buffer);
+        if (iter == uniformRingBuffers.end()) {
+            iter = uniformRingBuffers.emplace(buffer, ImportBuffer(buffer, uniformBufferRing.GetState(buffer))).first;
+        }
+        return CreateBufferView(iter->second, RGBufferViewDesc(RHI::BufferViewType::uniformBinding, static_cast<uint32_t>(size), static_cast<uint32_t>(offset)));
+    }
+
     void RGBuilder::QueueBufferUpload(RGBufferRef inBuffer, RGBufferUploadInfo inUploadInfo)
     {
         Assert(!executed);
@@ -516,6 +728,13 @@ namespace Render {
         recordingAsyncTimeline[RGQueueType::main].emplace_back(pass.Get());
     }
 
+    void RGBuilder::AddParallelRasterPass(const std::string& inName, const RGRasterPassDesc& inPassDesc, const std::vector<RGBindGroupRef>& inBindGroups, size_t inDrawNum, const RGParallelRasterPassExecuteFunc& inFunc, const RGCommonPassExecuteFunc& inPreExecuteFunc, const RGCommonPassExecuteFunc& inPostExecuteFunc)
+    {
+        Assert(!executed);
+        const auto& pass = passes.emplace_back(new RGRasterPass(inName, inPassDesc, inBindGroups, inDrawNum, inFunc, inPreExecuteFunc, inPostExecuteFunc));
+        recordingAsyncTimeline[RGQueueType::main].emplace_back(pass.Get());
+    }
+
     void RGBuilder::AddSyncPoint()
     {
         Assert(!executed);
@@ -533,6 +752,7 @@ namespace Render {
         executed = true;
         Compile();
         ExecuteInternal(inExecuteInfo);
+        FinalizeUniformRingBuffers();
     }
 
     RHI::Buffer* RGBuilder::GetRHI(RGBufferRef inBuffer) const
@@ -579,6 +799,28 @@ namespace Render {
         return devirtualizedBindGroups.at(inBindGroup);
     }
 
+    RGTransientMemoryStats RGBuilder::GetTransientMemoryStats() const
+    {
+        Assert(executed);
+        RGTransientMemoryStats result;
+        result.transientResourceNum = static_cast<uint32_t>(resourceSlots.size());
+        for (const auto& slot : transientSlots) {
+            if (const auto* pooledBuffer = std::get_if<PooledBufferRef>(&slot.pooledResource)) {
+                result.physicalResourceNum++;
+                result.bytesAllocated += (*pooledBuffer)->GetAllocatedSize();
+                // a buffer occupant only needs its own size, which is what it would have taken from the pool alone
+                for (auto* occupant : slot.occupants) {
+                    result.bytesWithoutAliasing += static_cast<RGBufferRef>(occupant)->desc.size;
+                }
+            } else if (const auto* pooledTexture = std::get_if<PooledTextureRef>(&slot.pooledResource)) {
+                result.physicalResourceNum++;
+                result.bytesAllocated += (*pooledTexture)->GetAllocatedSize();
+                result.bytesWithoutAliasing += (*pooledTexture)->GetAllocatedSize() * slot.occupants.size();
+            }
+        }
+        return result;
+    }
+
     RGBuilder::AsyncTimelineExecuteContext::AsyncTimelineExecuteContext() = default;
 
     RGBuilder::AsyncTimelineExecuteContext::AsyncTimelineExecuteContext(AsyncTimelineExecuteContext&& inOther) noexcept // NOLINT
@@ -589,16 +831,161 @@ namespace Render {
 
     void RGBuilder::Compile()
     {
+        const auto compileBegin = std::chrono::steady_clock::now();
+
+        // reads and writes are both needed by the execution and the topology key, everything derived from them is cached
         CompilePassReadWrites();
-        PerformCull();
-        CompileResourceUseCounts();
-        PerformSyncCheck();
-        ComputeResourcesInitialState();
+        auto& compileCache = RGCompileCache::Get(device);
+        auto key = ComputeCompileKey();
+        const auto compiledGraph = compileCache.Find(key);
+        if (compiledGraph != nullptr) {
+            RestoreCompiledGraph(*compiledGraph);
+        } else {
+            PerformCull();
+            CompileResourceUseCounts();
+            PerformSyncCheck();
+            ComputeResourcesInitialState();
+            PerformTransientAliasing();
+            compileCache.Emplace(SaveCompiledGraph(std::move(key)));
+        }
+
+        const auto compileTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - compileBegin);
+        compileCache.RecordCompile(compiledGraph != nullptr, compileTime.count());
+    }
+
+    std::vector<uint64_t> RGBuilder::ComputeCompileKey() const
+    {
+        // imported handles and uploaded data are re-bound every frame, only their declaration takes part in the key
+        std::unordered_map<RGResourceRef, uint64_t> resourceIndices;
+        resourceIndices.reserve(resources.size());
+
+        std::vector<uint64_t> result;
+        result.reserve(resources.size() * 5 + passes.size() * 8);
+        result.emplace_back(resources.size());
+        for (auto i = 0; i < resources.size(); i++) {
+            auto* resource = resources[i].Get();
+            resourceIndices.emplace(resource, i);
+
+            result.emplace_back(static_cast<uint64_t>(resource->type));
+            result.emplace_back(static_cast<uint64_t>(resource->imported) | static_cast<uint64_t>(resource->forceUsed) << 1);
+            if (resource->type == RGResType::buffer) {
+                auto* buffer = static_cast<RGBufferRef>(resource);
+                result.emplace_back(bufferUploads.contains(buffer));
+                result.emplace_back(PooledResTraits<PooledBuffer>::HashDesc(buffer->desc));
+            } else if (resource->type == RGResType::texture) {
+                result.emplace_back(0);
+                result.emplace_back(PooledResTraits<PooledTexture>::HashDesc(static_cast<RGTextureRef>(resource)->desc));
+            } else {
+                Unimplement();
+            }
+        }
+
+        std::unordered_map<RGPassRef, uint64_t> passIndices;
+        passIndices.reserve(passes.size());
+        result.emplace_back(passes.size());
+        for (auto i = 0; i < passes.size(); i++) {
+            auto* pass = passes[i].Get();
+            passIndices.emplace(pass, i);
+
+            result.emplace_back(static_cast<uint64_t>(pass->type));
+            Internal::AppendSortedIndices(result, passReadsMap.at(pass), resourceIndices);
+            Internal::AppendSortedIndices(result, passWritesMap.at(pass), resourceIndices);
+        }
+
+        result.emplace_back(asyncTimelines.size());
+        for (const auto& queuePasses : asyncTimelines) {
+            result.emplace_back(queuePasses.size());
+            for (auto queueType = 0; queueType < static_cast<uint8_t>(RGQueueType::max); queueType++) {
+                const auto iter = queuePasses.find(static_cast<RGQueueType>(queueType));
+                if (iter == queuePasses.end()) {
+                    continue;
+                }
+                result.emplace_back(queueType);
+                result.emplace_back(iter->second.size());
+                for (auto* pass : iter->second) {
+                    result.emplace_back(passIndices.at(pass));
+                }
+            }
+        }
+        return result;
+    }
+
+    void RGBuilder::RestoreCompiledGraph(const RGCompiledGraph& inCompiledGraph)
+    {
+        for (const auto passIndex : inCompiledGraph.culledPasses) {
+            culledPasses.emplace(passes[passIndex].Get());
+        }
+        for (const auto resourceIndex : inCompiledGraph.culledResources) {
+            culledResources.emplace(resources[resourceIndex].Get());
+        }
+        for (auto i = 0; i < resources.size(); i++) {
+            auto* resource = resources[i].Get();
+            resourceUseCounts[resource] = inCompiledGraph.resourceUseCounts[i];
+            if (!culledResources.contains(resource)) {
+                resourceStates[resource] = inCompiledGraph.resourceStates[i];
+            }
+        }
+
+        transientSlots.reserve(inCompiledGraph.transientSlots.size());
+        for (const auto& [desc, occupants, lastUse] : inCompiledGraph.transientSlots) {
+            const auto slotIndex = transientSlots.size();
+            auto& slot = transientSlots.emplace_back();
+            slot.desc = desc;
+            slot.lastUse = lastUse;
+            slot.occupants.reserve(occupants.size());
+            for (const auto resourceIndex : occupants) {
+                auto* resource = resources[resourceIndex].Get();
+                resourceSlots.emplace(resource, std::make_pair(slotIndex, slot.occupants.size()));
+                slot.occupants.emplace_back(resource);
+            }
+        }
+    }
+
+    RGCompiledGraph RGBuilder::SaveCompiledGraph(std::vector<uint64_t>&& inKey) const
+    {
+        std::unordered_map<RGResourceRef, uint32_t> resourceIndices;
+        resourceIndices.reserve(resources.size());
+
+        RGCompiledGraph result;
+        result.key = std::move(inKey);
+        result.resourceUseCounts.reserve(resources.size());
+        result.resourceStates.reserve(resources.size());
+        for (auto i = 0; i < resources.size(); i++) {
+            auto* resource = resources[i].Get();
+            resourceIndices.emplace(resource, i);
+            if (culledResources.contains(resource)) {
+                result.culledResources.emplace_back(i);
+            }
+            result.resourceUseCounts.emplace_back(resourceUseCounts.at(resource));
+            const auto stateIter = resourceStates.find(resource);
+            result.resourceStates.emplace_back(stateIter != resourceStates.end() ? stateIter->second : std::variant<RHI::BufferState, RHI::TextureState> {});
+        }
+        for (auto i = 0; i < passes.size(); i++) {
+            if (culledPasses.contains(passes[i].Get())) {
+                result.culledPasses.emplace_back(i);
+            }
+        }
+
+        result.transientSlots.reserve(transientSlots.size());
+        for (const auto& slot : transientSlots) {
+            auto& compiledSlot = result.transientSlots.emplace_back();
+            compiledSlot.desc = slot.desc;
+            compiledSlot.lastUse = slot.lastUse;
+            compiledSlot.occupants.reserve(slot.occupants.size());
+            for (auto* occupant : slot.occupants) {
+                compiledSlot.occupants.emplace_back(resourceIndices.at(occupant));
+            }
+        }
+        return result;
     }
 
     void RGBuilder::ExecuteInternal(const RGExecuteInfo& inExecuteInfo) // NOLINT
     {
         PerformBufferUploads();
+        // uniform data was written at allocation time, only the flush of the mapped pages is left
+        if (!uniformRingBuffers.empty()) {
+            UniformBufferRing::Get(device).Flush();
+        }
         DevirtualizeViewsCreatedOnImportedResources();
 
         const auto asyncTimelineNum = asyncTimelines.size();
@@ -631,51 +1018,74 @@ namespace Render {
 
             for (const auto& [queueType, passes] : queuePasses) {
                 const auto [rhiQueueType, rhiQueueIndex] = Internal::GetRHIQueueTypeAndIndex(queueType);
-                commandBufferMap.emplace(queueType, device.CreateCommandBuffer(rhiQueueType));
                 semaphoreMap.emplace(queueType, isLastAsyncTimeline ? nullptr : device.CreateSemaphore());
-
-                auto& commandBufferToRecord = commandBufferMap.at(queueType);
                 auto& semaphoreToSignal = semaphoreMap.at(queueType);
 
-                {
-                    auto commandRecorder = commandBufferToRecord->Begin();
-                    for (auto* pass : passes) {
-                        if (culledPasses.contains(pass)) {
-                            continue;
-                        }
-
-                        if (pass->type == RGPassType::copy) {
-                            ExecuteCopyPass(*commandRecorder, static_cast<RGCopyPass*>(pass));
-                        } else if (pass->type == RGPassType::compute) {
-                            ExecuteComputePass(*commandRecorder, static_cast<RGComputePass*>(pass));
-                        } else if (pass->type == RGPassType::raster) {
-                            ExecuteRasterPass(*commandRecorder, static_cast<RGRasterPass*>(pass));
-                        } else {
-                            Unimplement();
-                        }
+                // devirtualization and state tracking walk the passes in order on this thread, recording only reads
+                // the devirtualized handles, and resources are released after every command buffer was recorded
+                std::vector<RGPassRef> livePasses;
+                livePasses.reserve(passes.size());
+                for (auto* pass : passes) {
+                    if (!culledPasses.contains(pass)) {
+                        livePasses.emplace_back(pass);
                     }
-                    commandRecorder->End();
+                }
+                std::vector<std::vector<RHI::Barrier>> passBarriers(livePasses.size());
+                for (auto i = 0; i < livePasses.size(); i++) {
+                    PreparePass(livePasses[i], passBarriers[i]);
                 }
 
-                auto submitInfo = RHI::QueueSubmitInfo()
-                    .SetWaitSemaphores(semaphoresToWait);
-                if (isLastAsyncTimeline) {
-                    // if is last async timeline, need notify all commands inside build has been executed
-                    for (auto* finalSignalSemaphore : inExecuteInfo.semaphoresToSignal) {
-                        submitInfo.AddSignalSemaphore(finalSignalSemaphore);
+                const auto recordTasks = BuildRecordTasks(livePasses);
+                auto& commandBuffers = commandBufferMap[queueType];
+                commandBuffers.resize(recordTasks.size());
+                const auto recordTask = [&](size_t inTaskIndex) -> void {
+                    // acquired on the recording thread, backends keep their command pools per thread
+                    auto*& commandBuffer = commandBuffers[inTaskIndex];
+                    commandBuffer = device.AcquireTransientCommandBuffer(rhiQueueType);
+                    const auto commandRecorder = commandBuffer->Begin();
+                    for (const auto& unit : recordTasks[inTaskIndex]) {
+                        RecordPassUnit(*commandRecorder, unit, passBarriers[unit.preparedIndex]);
                     }
+                    commandRecorder->End();
+                };
+                if (recordTasks.size() > 1) {
+                    RenderWorkerThreads::Get().ExecuteTasks(recordTasks.size(), recordTask);
                 } else {
-                    // if within the builder, just wait last async timeline commands executed
-                    submitInfo.AddSignalSemaphore(semaphoreToSignal.Get());
+                    recordTask(0);
                 }
-                if (queueType == RGQueueType::main && isLastAsyncTimeline && inExecuteInfo.inFenceToSignal != nullptr) {
-                    // if is last async timeline, also need signal fence to notify CPU if needed
-                    submitInfo.SetSignalFence(inExecuteInfo.inFenceToSignal);
+
+                for (auto* pass : livePasses) {
+                    FinalizePass(pass);
                 }
 
-                device
-                    .GetQueue(rhiQueueType, rhiQueueIndex)
-                    ->Submit(commandBufferToRecord.Get(), submitInfo);
+                for (auto i = 0; i < commandBuffers.size(); i++) {
+                    const bool isFirstCommandBuffer = i == 0;
+                    const bool isLastCommandBuffer = i + 1 == commandBuffers.size();
+
+                    RHI::QueueSubmitInfo submitInfo;
+                    if (isFirstCommandBuffer) {
+                        submitInfo.SetWaitSemaphores(semaphoresToWait);
+                    }
+                    if (isLastCommandBuffer && isLastAsyncTimeline) {
+                        // if is last async timeline, need notify all commands inside build has been executed
+                        for (auto* finalSignalSemaphore : inExecuteInfo.semaphoresToSignal) {
+                            submitInfo.AddSignalSemaphore(finalSignalSemaphore);
+                        }
+                    } else if (isLastCommandBuffer) {
+                        // if within the builder, just wait last async timeline commands executed
+                        submitInfo.AddSignalSemaphore(semaphoreToSignal.Get());
+                    }
+                    if (isLastCommandBuffer && queueType == RGQueueType::main && isLastAsyncTimeline && inExecuteInfo.inFenceToSignal != nullptr) {
+                        // if is last async timeline, also need signal fence to notify CPU if needed
+                        submitInfo.SetSignalFence(inExecuteInfo.inFenceToSignal);
+                    }
+
+                    // command buffers of one queue are submitted in graph order, barriers recorded in later ones
+                    // synchronize with the earlier submissions
+                    device
+                        .GetQueue(rhiQueueType, rhiQueueIndex)
+                        ->Submit(commandBuffers[i], submitInfo);
+                }
             }
         }
     }
@@ -876,73 +1286,260 @@ namespace Render {
         }
     }
 
-    void RGBuilder::ExecuteCopyPass(RHI::CommandRecorder& inRecoder, RGCopyPass* inCopyPass)
+    void RGBuilder::PerformTransientAliasing()
     {
-        RHI_SCOPED_MARKER(inRecoder, inCopyPass->name);
-        DevirtualizeResources(passWritesMap.at(inCopyPass));
-        {
-            TransitionResourcesForCopyPassDesc(inRecoder, inCopyPass->passDesc);
-            if (inCopyPass->prePassFunc) {
-                inCopyPass->prePassFunc(*this, inRecoder);
+        // passes on different queues of one async timeline may overlap on the gpu, so they all take the whole range of
+        // the timeline, passes of a single queue timeline are ordered and take one position each
+        std::unordered_map<RGPassRef, std::pair<uint32_t, uint32_t>> passRanges;
+        uint32_t position = 0;
+        for (const auto& queuePasses : asyncTimelines) {
+            uint32_t passNum = 0;
+            for (const auto& passes : queuePasses | std::views::values) {
+                passNum += static_cast<uint32_t>(std::ranges::count_if(passes, [this](RGPassRef pass) -> bool { return !culledPasses.contains(pass); }));
             }
-            {
-                const auto copyPassRecoder = inRecoder.BeginCopyPass();
-                inCopyPass->passFunc(*this, *copyPassRecoder);
-                copyPassRecoder->EndPass();
+
+            const bool concurrent = queuePasses.size() > 1;
+            const uint32_t timelineBegin = position;
+            for (const auto& passes : queuePasses | std::views::values) {
+                for (auto* pass : passes) {
+                    if (culledPasses.contains(pass)) {
+                        continue;
+                    }
+                    passRanges.emplace(pass, concurrent ? std::make_pair(timelineBegin, timelineBegin + passNum - 1) : std::make_pair(position, position));
+                    position++;
+                }
+            }
+        }
+
+        std::unordered_map<RGResourceRef, std::pair<uint32_t, uint32_t>> lifetimes;
+        const auto extendLifetime = [&](RGResourceRef resource, uint32_t first, uint32_t last) -> void {
+            if (resource->imported || culledResources.contains(resource)) {
+                return;
+            }
+            if (const auto iter = lifetimes.find(resource); iter != lifetimes.end()) {
+                iter->second.first = std::min(iter->second.first, first);
+                iter->second.second = std::max(iter->second.second, last);
+            } else {
+                lifetimes.emplace(resource, std::make_pair(first, last));
             }
-            if (inCopyPass->postPassFunc) {
-                inCopyPass->postPassFunc(*this, inRecoder);
+        };
+        for (const auto& [pass, range] : passRanges) {
+            for (auto* resource : passReadsMap.at(pass)) {
+                extendLifetime(resource, range.first, range.second);
+            }
+            for (auto* resource : passWritesMap.at(pass)) {
+                extendLifetime(resource, range.first, range.second);
+            }
+        }
+        // uploads are written by the cpu before any pass, resources used by the outside live till the builder dies
+        for (auto* buffer : bufferUploads | std::views::keys) {
+            extendLifetime(buffer, 0, 0);
+        }
+        for (const auto& resource : resources) {
+            if (resource->forceUsed) {
+                extendLifetime(resource.Get(), 0, std::numeric_limits<uint32_t>::max());
+            }
+        }
+
+        std::vector<RGResourceRef> transients;
+        transients.reserve(lifetimes.size());
+        for (const auto& resource : resources) {
+            if (lifetimes.contains(resource.Get())) {
+                transients.emplace_back(resource.Get());
+            }
+        }
+        std::ranges::stable_sort(transients, [&](RGResourceRef lhs, RGResourceRef rhs) -> bool { return lifetimes.at(lhs).first < lifetimes.at(rhs).first; });
+
+        // first fit, a transient joins the first slot with a compatible descriptor that is free before its first use
+        for (auto* resource : transients) {
+            const auto [first, last] = lifetimes.at(resource);
+
+            size_t slotIndex = 0;
+            for (; slotIndex < transientSlots.size(); slotIndex++) {
+                auto& slot = transientSlots[slotIndex];
+                if (slot.lastUse >= first) {
+                    continue;
+                }
+                if (resource->type == RGResType::buffer) {
+                    auto* slotDesc = std::get_if<RGBufferDesc>(&slot.desc);
+                    const auto& desc = static_cast<RGBufferRef>(resource)->desc;
+                    if (slotDesc != nullptr && Internal::CanAlias(*slotDesc, desc)) {
+                        slotDesc->size = std::max(slotDesc->size, desc.size);
+                        break;
+                    }
+                } else if (resource->type == RGResType::texture) {
+                    const auto* slotDesc = std::get_if<RGTextureDesc>(&slot.desc);
+                    if (slotDesc != nullptr && Internal::CanAlias(*slotDesc, static_cast<RGTextureRef>(resource)->desc)) {
+                        break;
+                    }
+                } else {
+                    Unimplement();
+                }
+            }
+
+            if (slotIndex == transientSlots.size()) {
+                auto& slot = transientSlots.emplace_back();
+                if (resource->type == RGResType::buffer) {
+                    slot.desc = static_cast<RGBufferRef>(resource)->desc;
+                } else {
+                    slot.desc = static_cast<RGTextureRef>(resource)->desc;
+                }
             }
+
+            auto& slot = transientSlots[slotIndex];
+            resourceSlots.emplace(resource, std::make_pair(slotIndex, slot.occupants.size()));
+            slot.occupants.emplace_back(resource);
+            slot.lastUse = last;
         }
-        FinalizePassResources(inCopyPass);
     }
 
-    void RGBuilder::ExecuteComputePass(RHI::CommandRecorder& inRecoder, RGComputePass* inComputePass)
+    void RGBuilder::PreparePass(RGPassRef inPass, std::vector<RHI::Barrier>& outBarriers)
+    {
+        DevirtualizeResources(outBarriers, passWritesMap.at(inPass));
+        if (inPass->type == RGPassType::copy) {
+            const auto* copyPass = static_cast<RGCopyPass*>(inPass);
+            TransitionResourcesForCopyPassDesc(outBarriers, copyPass->passDesc);
+        } else if (inPass->type == RGPassType::compute) {
+            const auto* computePass = static_cast<RGComputePass*>(inPass);
+            DevirtualizeBindGroupsAndViews(computePass->bindGroups);
+            TransitionResourcesForBindGroups(outBarriers, computePass->bindGroups);
+        } else if (inPass->type == RGPassType::raster) {
+            const auto* rasterPass = static_cast<RGRasterPass*>(inPass);
+            DevirtualizeAttachmentViews(rasterPass->passDesc);
+            DevirtualizeBindGroupsAndViews(rasterPass->bindGroups);
+            TransitionResourcesForBindGroups(outBarriers, rasterPass->bindGroups);
+            TransitionResourcesForRasterPassDesc(outBarriers, rasterPass->passDesc);
+        } else {
+            Unimplement();
+        }
+    }
+
+    std::vector<std::vector<RGBuilder::RecordUnit>> RGBuilder::BuildRecordTasks(const std::vector<RGPassRef>& inPasses) const
     {
-        RHI_SCOPED_MARKER(inRecoder, inComputePass->name);
-        DevirtualizeResources(passWritesMap.at(inComputePass));
-        DevirtualizeBindGroupsAndViews(inComputePass->bindGroups);
-        {
-            TransitionResourcesForBindGroups(inRecoder, inComputePass->bindGroups);
-            if (inComputePass->prePassFunc) {
-                inComputePass->prePassFunc(*this, inRecoder);
+        std::vector<std::vector<RecordUnit>> result;
+        std::vector<RecordUnit> run;
+
+        // a run of passes is split into contiguous groups, so each command buffer still holds passes in graph order
+        const auto flushRun = [&]() -> void {
+            if (run.empty()) {
+                return;
             }
-            {
-                const auto computePassRecoder = inRecoder.BeginComputePass();
-                inComputePass->passFunc(*this, *computePassRecoder);
-                computePassRecoder->EndPass();
+            const size_t taskNum = parallelRecord ? std::clamp<size_t>(run.size() / Internal::rgMinPassesPerRecordTask, 1, Internal::rgMaxRecordTaskNum) : 1;
+            for (size_t i = 0; i < taskNum; i++) {
+                size_t begin;
+                size_t end;
+                Internal::SplitRange(run.size(), taskNum, i, begin, end);
+                result.emplace_back(run.begin() + static_cast<int64_t>(begin), run.begin() + static_cast<int64_t>(end));
             }
-            if (inComputePass->postPassFunc) {
-                inComputePass->postPassFunc(*this, inRecoder);
+            run.clear();
+        };
+
+        for (auto i = 0; i < inPasses.size(); i++) {
+            auto* pass = inPasses[i];
+            const size_t drawNum = pass->type == RGPassType::raster ? static_cast<RGRasterPass*>(pass)->parallelDrawNum : 0;
+            if (!parallelRecord || drawNum < Internal::rgMinDrawsPerRecordTask * 2) {
+                run.emplace_back(RecordUnit { pass, static_cast<size_t>(i), true, true, 0, drawNum });
+                continue;
+            }
+
+            flushRun();
+            const size_t taskNum = std::min(drawNum / Internal::rgMinDrawsPerRecordTask, Internal::rgMaxRecordTaskNum);
+            for (size_t t = 0; t < taskNum; t++) {
+                size_t drawBegin;
+                size_t drawEnd;
+                Internal::SplitRange(drawNum, taskNum, t, drawBegin, drawEnd);
+                result.emplace_back().emplace_back(RecordUnit { pass, static_cast<size_t>(i), t == 0, t + 1 == taskNum, drawBegin, drawEnd });
             }
         }
-        FinalizePassResources(inComputePass);
-        FinalizePassBindGroups(inComputePass->bindGroups);
+        flushRun();
+
+        // a queue with no live pass still submits an empty command buffer to wait and signal for the timeline
+        if (result.empty()) {
+            result.emplace_back();
+        }
+        return result;
     }
 
-    void RGBuilder::ExecuteRasterPass(RHI::CommandRecorder& inRecoder, RGRasterPass* inRasterPass)
+    void RGBuilder::RecordPassUnit(RHI::CommandRecorder& inRecoder, const RecordUnit& inUnit, const std::vector<RHI::Barrier>& inBarriers) const
     {
-        RHI_SCOPED_MARKER(inRecoder, inRasterPass->name);
-        DevirtualizeResources(passWritesMap.at(inRasterPass));
-        DevirtualizeAttachmentViews(inRasterPass->passDesc);
-        DevirtualizeBindGroupsAndViews(inRasterPass->bindGroups);
-        {
-            TransitionResourcesForBindGroups(inRecoder, inRasterPass->bindGroups);
-            TransitionResourcesForRasterPassDesc(inRecoder, inRasterPass->passDesc);
-            if (inRasterPass->prePassFunc) {
-                inRasterPass->prePassFunc(*this, inRecoder);
+        auto* pass = inUnit.pass;
+        RHI_SCOPED_MARKER(inRecoder, pass->name);
+        if (inUnit.first) {
+            for (const auto& barrier : inBarriers) {
+                inRecoder.ResourceBarrier(barrier);
+            }
+        }
+
+        if (pass->type == RGPassType::copy) {
+            const auto* copyPass = static_cast<RGCopyPass*>(pass);
+            if (copyPass->prePassFunc) {
+                copyPass->prePassFunc(*this, inRecoder);
+            }
+            {
+                const auto copyPassRecoder = inRecoder.BeginCopyPass();
+                copyPass->passFunc(*this, *copyPassRecoder);
+                copyPassRecoder->EndPass();
+            }
+            if (copyPass->postPassFunc) {
+                copyPass->postPassFunc(*this, inRecoder);
+            }
+        } else if (pass->type == RGPassType::compute) {
+            const auto* computePass = static_cast<RGComputePass*>(pass);
+            if (computePass->prePassFunc) {
+                computePass->prePassFunc(*this, inRecoder);
+            }
+            {
+                const auto computePassRecoder = inRecoder.BeginComputePass();
+                computePass->passFunc(*this, *computePassRecoder);
+                computePassRecoder->EndPass();
+            }
+            if (computePass->postPassFunc) {
+                computePass->postPassFunc(*this, inRecoder);
+            }
+        } else if (pass->type == RGPassType::raster) {
+            const auto* rasterPass = static_cast<RGRasterPass*>(pass);
+            if (inUnit.first && rasterPass->prePassFunc) {
+                rasterPass->prePassFunc(*this, inRecoder);
+            }
+            if (!inUnit.first) {
+                // attachment writes of the previous draw range happened in another rhi raster pass
+                const auto& [colorAttachments, depthStencilAttachment] = rasterPass->passDesc;
+                if (depthStencilAttachment.has_value()) {
+                    const auto& dsa = depthStencilAttachment.value();
+                    const auto state = RHI::GetDepthStencilTextureState(dsa.view->GetDesc().aspect, dsa.depthReadOnly, dsa.stencilReadOnly);
+                    inRecoder.ResourceBarrier(RHI::Barrier::Transition(GetRHI(dsa.view->GetTexture()), state, state));
+                }
+                for (const auto& ca : colorAttachments) {
+                    inRecoder.ResourceBarrier(RHI::Barrier::Transition(GetRHI(ca.view->GetTexture()), RHI::TextureState::renderTarget, RHI::TextureState::renderTarget));
+                }
             }
             {
-                const auto rasterPassRecoder = inRecoder.BeginRasterPass(Internal::GetRHIRasterPassBeginInfo(*this, inRasterPass->passDesc));
-                inRasterPass->passFunc(*this, *rasterPassRecoder);
+                const bool split = !inUnit.first || !inUnit.last;
+                const auto beginInfo = Internal::GetRHIRasterPassBeginInfo(*this, split ? Internal::GetRasterPassDescForDrawRange(rasterPass->passDesc, inUnit.first, inUnit.last) : rasterPass->passDesc);
+                const auto rasterPassRecoder = inRecoder.BeginRasterPass(beginInfo);
+                if (rasterPass->parallelPassFunc) {
+                    rasterPass->parallelPassFunc(*this, *rasterPassRecoder, inUnit.drawBegin, inUnit.drawEnd);
+                } else {
+                    rasterPass->passFunc(*this, *rasterPassRecoder);
+                }
                 rasterPassRecoder->EndPass();
             }
-            if (inRasterPass->postPassFunc) {
-                inRasterPass->postPassFunc(*this, inRecoder);
+            if (inUnit.last && rasterPass->postPassFunc) {
+                rasterPass->postPassFunc(*this, inRecoder);
             }
+        } else {
+            Unimplement();
+        }
+    }
+
+    void RGBuilder::FinalizePass(RGPassRef inPass)
+    {
+        FinalizePassResources(inPass);
+        if (inPass->type == RGPassType::compute) {
+            FinalizePassBindGroups(static_cast<RGComputePass*>(inPass)->bindGroups);
+        } else if (inPass->type == RGPassType::raster) {
+            FinalizePassBindGroups(static_cast<RGRasterPass*>(inPass)->bindGroups);
         }
-        FinalizePassResources(inRasterPass);
-        FinalizePassBindGroups(inRasterPass->bindGroups);
     }
 
     void RGBuilder::PerformBufferUploads()
@@ -980,6 +1577,15 @@ namespace Render {
         }
     }
 
+    void RGBuilder::FinalizeUniformRingBuffers()
+    {
+        // ring pages stay in the state the graph left them in, the next builder importing them starts from there
+        auto& uniformBufferRing = UniformBufferRing::Get(device);
+        for (const auto& [buffer, bufferRef] : uniformRingBuffers) {
+            uniformBufferRing.SetState(buffer, std::get<RHI::BufferState>(resourceStates.at(bufferRef)));
+        }
+    }
+
     void RGBuilder::WaitBufferUploadsFinish()
     {
         for (auto& task : bufferUploadTasks) {
@@ -996,9 +1602,7 @@ namespace Render {
 
             if (auto* viewRef = view.Get();
                 viewRef->Type() == RGResViewType::bufferView) {
-                const auto* bufferView = static_cast<RGBufferViewRef>(viewRef);
-                auto* buffer = bufferView->GetBuffer();
-                devirtualizedResourceViews.emplace(std::make_pair(viewRef, ResourceViewCache::Get(device).GetOrCreate(GetRHI(buffer), bufferView->desc)));
+                devirtualizedResourceViews.emplace(std::make_pair(viewRef, DevirtualizeBufferView(static_cast<RGBufferViewRef>(viewRef))));
             } else if (viewRef->Type() == RGResViewType::textureView) {
                 const auto* textureView = static_cast<RGTextureViewRef>(viewRef);
                 auto* texture = textureView->GetTexture();
@@ -1009,7 +1613,17 @@ namespace Render {
         }
     }
 
-    void RGBuilder::DevirtualizeResource(RGResourceRef inResource)
+    RHI::BufferView* RGBuilder::DevirtualizeBufferView(RGBufferViewRef inView)
+    {
+        // views of uniform ring pages are kept by the ring, the pages are never invalidated like pooled buffers
+        auto* buffer = GetRHI(inView->GetBuffer());
+        if (uniformRingBuffers.contains(buffer)) {
+            return UniformBufferRing::Get(device).GetView(buffer, inView->desc);
+        }
+        return ResourceViewCache::Get(device).GetOrCreate(buffer, inView->desc);
+    }
+
+    void RGBuilder::DevirtualizeResource(RGResourceRef inResource, std::vector<RHI::Barrier>* outBarriers)
     {
         if (inResource->imported
             || culledResources.contains(inResource)
@@ -1017,19 +1631,32 @@ namespace Render {
             return;
         }
 
+        const auto [slotIndex, occupantIndex] = resourceSlots.at(inResource);
+        auto& slot = transientSlots[slotIndex];
         if (inResource->type == RGResType::buffer) {
-            devirtualizedResources.emplace(std::make_pair(inResource, BufferPool::Get(device).Allocate(static_cast<RGBufferRef>(inResource)->desc)));
+            if (std::holds_alternative<std::monostate>(slot.pooledResource)) {
+                slot.pooledResource = BufferPool::Get(device).Allocate(std::get<RGBufferDesc>(slot.desc));
+            }
+            devirtualizedResources.emplace(std::make_pair(inResource, std::get<PooledBufferRef>(slot.pooledResource)));
         } else if (inResource->type == RGResType::texture) {
-            devirtualizedResources.emplace(std::make_pair(inResource, TexturePool::Get(device).Allocate(static_cast<RGTextureRef>(inResource)->desc)));
+            if (std::holds_alternative<std::monostate>(slot.pooledResource)) {
+                slot.pooledResource = TexturePool::Get(device).Allocate(std::get<RGTextureDesc>(slot.desc));
+            }
+            devirtualizedResources.emplace(std::make_pair(inResource, std::get<PooledTextureRef>(slot.pooledResource)));
         } else {
             Unimplement();
         }
+
+        if (occupantIndex > 0) {
+            AssertWithReason(outBarriers != nullptr, "aliased resource must be devirtualized inside a pass");
+            TransitionAliasedResource(*outBarriers, slot.occupants[occupantIndex - 1], inResource);
+        }
     }
 
-    void RGBuilder::DevirtualizeResources(const std::unordered_set<RGResourceRef>& inResources)
+    void RGBuilder::DevirtualizeResources(std::vector<RHI::Barrier>& outBarriers, const std::unordered_set<RGResourceRef>& inResources)
     {
         for (auto* resource : inResources) {
-            DevirtualizeResource(resource);
+            DevirtualizeResource(resource, &outBarriers);
         }
     }
 
@@ -1038,6 +1665,8 @@ namespace Render {
         for (auto* bindGroup : inBindGroups) {
             const auto& [layout, items] = bindGroup->desc;
             RHI::BindGroupCreateInfo createInfo(layout->GetRHI());
+            createInfo.SetTransient(true);
+            bool uniformRingOnly = !items.empty();
 
             for (const auto& [name, item] : items) {
                 const auto* bindingInfo = layout->GetBindingInfo(name);
@@ -1047,22 +1676,27 @@ namespace Render {
                 if (item.type == RHI::BindingType::uniformBuffer || item.type == RHI::BindingType::storageBuffer || item.type == RHI::BindingType::rwStorageBuffer) {
                     auto* bufferView = std::get<RGBufferViewRef>(item.view);
                     if (!devirtualizedResourceViews.contains(bufferView)) {
-                        devirtualizedResourceViews.emplace(std::make_pair(bufferView, ResourceViewCache::Get(device).GetOrCreate(GetRHI(bufferView->GetBuffer()), bufferView->desc)));
+                        devirtualizedResourceViews.emplace(std::make_pair(bufferView, DevirtualizeBufferView(bufferView)));
                     }
+                    uniformRingOnly = uniformRingOnly && uniformRingBuffers.contains(GetRHI(bufferView->GetBuffer()));
                     createInfo.AddEntry(RHI::BindGroupEntry(binding, shaderVisibility, GetRHI(bufferView)));
                 } else if (item.type == RHI::BindingType::texture || item.type == RHI::BindingType::storageTexture || item.type == RHI::BindingType::rwStorageTexture) {
                     auto* textureView = std::get<RGTextureViewRef>(item.view);
+                    uniformRingOnly = false;
                     if (!devirtualizedResourceViews.contains(textureView)) {
                         devirtualizedResourceViews.emplace(std::make_pair(textureView, ResourceViewCache::Get(device).GetOrCreate(GetRHI(textureView->GetTexture()), textureView->desc)));
                     }
                     createInfo.AddEntry(RHI::BindGroupEntry(binding, shaderVisibility, GetRHI(textureView)));
                 } else if (item.type == RHI::BindingType::sampler) {
+                    uniformRingOnly = false;
                     createInfo.AddEntry(RHI::BindGroupEntry(binding, shaderVisibility, std::get<RHI::Sampler*>(item.view)));
                 } else {
                     Unimplement();
                 }
             }
-            devirtualizedBindGroups.emplace(std::make_pair(bindGroup, BindGroupCache::Get(device).Allocate(createInfo)));
+            // bind groups of ring views only are kept by the ring and reused by every frame binding the same ranges
+            auto* rhiBindGroup = uniformRingOnly ? UniformBufferRing::Get(device).GetBindGroup(createInfo) : BindGroupCache::Get(device).Allocate(createInfo);
+            devirtualizedBindGroups.emplace(std::make_pair(bindGroup, rhiBindGroup));
         }
     }
 
@@ -1116,55 +1750,55 @@ namespace Render {
         }
     }
 
-    void RGBuilder::TransitionResourcesForCopyPassDesc(RHI::CommonCommandRecorder& inRecoder, const RGCopyPassDesc& inDesc)
+    void RGBuilder::TransitionResourcesForCopyPassDesc(std::vector<RHI::Barrier>& outBarriers, const RGCopyPassDesc& inDesc)
     {
         for (auto* copySrc : inDesc.copySrcs) {
             if (copySrc->type == RGResType::buffer) {
-                TransitionBuffer(inRecoder, static_cast<RGBufferRef>(copySrc), RHI::BufferState::copySrc);
+                TransitionBuffer(outBarriers, static_cast<RGBufferRef>(copySrc), RHI::BufferState::copySrc);
             } else if (copySrc->type == RGResType::texture) {
-                TransitionTexture(inRecoder, static_cast<RGTextureRef>(copySrc), RHI::TextureState::copySrc);
+                TransitionTexture(outBarriers, static_cast<RGTextureRef>(copySrc), RHI::TextureState::copySrc);
             } else {
                 Unimplement();
             }
         }
         for (auto* copyDst : inDesc.copyDsts) {
             if (copyDst->type == RGResType::buffer) {
-                TransitionBuffer(inRecoder, static_cast<RGBufferRef>(copyDst), RHI::BufferState::copyDst);
+                TransitionBuffer(outBarriers, static_cast<RGBufferRef>(copyDst), RHI::BufferState::copyDst);
             } else if (copyDst->type == RGResType::texture) {
-                TransitionTexture(inRecoder, static_cast<RGTextureRef>(copyDst), RHI::TextureState::copyDst);
+                TransitionTexture(outBarriers, static_cast<RGTextureRef>(copyDst), RHI::TextureState::copyDst);
             } else {
                 Unimplement();
             }
         }
     }
 
-    void RGBuilder::TransitionResourcesForRasterPassDesc(RHI::CommonCommandRecorder& inRecoder, const RGRasterPassDesc& inDesc)
+    void RGBuilder::TransitionResourcesForRasterPassDesc(std::vector<RHI::Barrier>& outBarriers, const RGRasterPassDesc& inDesc)
     {
         if (inDesc.depthStencilAttachment.has_value()) {
             const auto& dsa = inDesc.depthStencilAttachment.value();
-            TransitionTexture(inRecoder, dsa.view->GetTexture(), RHI::GetDepthStencilTextureState(dsa.view->GetDesc().aspect, dsa.depthReadOnly, dsa.stencilReadOnly));
+            TransitionTexture(outBarriers, dsa.view->GetTexture(), RHI::GetDepthStencilTextureState(dsa.view->GetDesc().aspect, dsa.depthReadOnly, dsa.stencilReadOnly));
         }
         for (const auto& ca : inDesc.colorAttachments) {
-            TransitionTexture(inRecoder, ca.view->GetTexture(), RHI::TextureState::renderTarget);
+            TransitionTexture(outBarriers, ca.view->GetTexture(), RHI::TextureState::renderTarget);
         }
     }
 
-    void RGBuilder::TransitionResourcesForBindGroups(RHI::CommonCommandRecorder& inRecoder, const std::vector<RGBindGroupRef>& inBindGroups)
+    void RGBuilder::TransitionResourcesForBindGroups(std::vector<RHI::Barrier>& outBarriers, const std::vector<RGBindGroupRef>& inBindGroups)
     {
         for (auto* bindGroup : inBindGroups) {
             for (const auto& [type, view] : bindGroup->desc.items | std::views::values) {
                 if (type == RHI::BindingType::uniformBuffer) {
-                    TransitionBuffer(inRecoder, std::get<RGBufferViewRef>(view)->GetBuffer(), RHI::BufferState::shaderReadOnly);
+                    TransitionBuffer(outBarriers, std::get<RGBufferViewRef>(view)->GetBuffer(), RHI::BufferState::shaderReadOnly);
                 } else if (type == RHI::BindingType::storageBuffer) {
-                    TransitionBuffer(inRecoder, std::get<RGBufferViewRef>(view)->GetBuffer(), RHI::BufferState::storage);
+                    TransitionBuffer(outBarriers, std::get<RGBufferViewRef>(view)->GetBuffer(), RHI::BufferState::storage);
                 } else if (type == RHI::BindingType::rwStorageBuffer) {
-                    TransitionBuffer(inRecoder, std::get<RGBufferViewRef>(view)->GetBuffer(), RHI::BufferState::rwStorage);
+                    TransitionBuffer(outBarriers, std::get<RGBufferViewRef>(view)->GetBuffer(), RHI::BufferState::rwStorage);
                 } else if (type == RHI::BindingType::texture) {
-                    TransitionTexture(inRecoder, std::get<RGTextureViewRef>(view)->GetTexture(), RHI::TextureState::shaderReadOnly);
+                    TransitionTexture(outBarriers, std::get<RGTextureViewRef>(view)->GetTexture(), RHI::TextureState::shaderReadOnly);
                 } else if (type == RHI::BindingType::storageTexture) {
-                    TransitionTexture(inRecoder, std::get<RGTextureViewRef>(view)->GetTexture(), RHI::TextureState::storage);
+                    TransitionTexture(outBarriers, std::get<RGTextureViewRef>(view)->GetTexture(), RHI::TextureState::storage);
                 } else if (type == RHI::BindingType::rwStorageTexture) {
-                    TransitionTexture(inRecoder, std::get<RGTextureViewRef>(view)->GetTexture(), RHI::TextureState::rwStorage);
+                    TransitionTexture(outBarriers, std::get<RGTextureViewRef>(view)->GetTexture(), RHI::TextureState::rwStorage);
                 } else if (type == RHI::BindingType::sampler) {} else {
                     Unimplement();
                 }
@@ -1172,23 +1806,46 @@ namespace Render {
         }
     }
 
-    void RGBuilder::TransitionBuffer(RHI::CommonCommandRecorder& inRecoder, RGBufferRef inBuffer, RHI::BufferState inState)
+    void RGBuilder::TransitionBuffer(std::vector<RHI::Barrier>& outBarriers, RGBufferRef inBuffer, RHI::BufferState inState)
     {
         auto& currentState = std::get<RHI::BufferState>(resourceStates.at(inBuffer));
         if (currentState == inState) {
             return;
         }
-        inRecoder.ResourceBarrier(RHI::Barrier::Transition(GetRHI(inBuffer), currentState, inState));
+        outBarriers.emplace_back(RHI::Barrier::Transition(GetRHI(inBuffer), currentState, inState));
         currentState = inState;
     }
 
-    void RGBuilder::TransitionTexture(RHI::CommonCommandRecorder& inRecoder, RGTextureRef inTexture, RHI::TextureState inState)
+    void RGBuilder::TransitionTexture(std::vector<RHI::Barrier>& outBarriers, RGTextureRef inTexture, RHI::TextureState inState)
     {
         auto& currentState = std::get<RHI::TextureState>(resourceStates.at(inTexture));
         if (currentState == inState) {
             return;
         }
-        inRecoder.ResourceBarrier(RHI::Barrier::Transition(GetRHI(inTexture), currentState, inState));
+        outBarriers.emplace_back(RHI::Barrier::Transition(GetRHI(inTexture), currentState, inState));
         currentState = inState;
     }
+
+    void RGBuilder::TransitionAliasedResource(std::vector<RHI::Barrier>& outBarriers, RGResourceRef inPrevious, RGResourceRef inResource)
+    {
+        // the memory is still in the state the previous occupant left it, an undefined initial state keeps tracking from
+        // there (texture layouts may be discarded from undefined directly), otherwise barrier into the declared state
+        if (inResource->type == RGResType::buffer) {
+            const auto previousState = std::get<RHI::BufferState>(resourceStates.at(inPrevious));
+            auto& currentState = std::get<RHI::BufferState>(resourceStates.at(inResource));
+            if (currentState == RHI::BufferState::undefined) {
+                currentState = previousState;
+            } else if (currentState != previousState) {
+                outBarriers.emplace_back(RHI::Barrier::Transition(GetRHI(static_cast<RGBufferRef>(inResource)), previousState, currentState));
+            }
+        } else if (inResource->type == RGResType::texture) {
+            const auto previousState = std::get<RHI::TextureState>(resourceStates.at(inPrevious));
+            if (const auto currentState = std::get<RHI::TextureState>(resourceStates.at(inResource));
+                currentState != RHI::TextureState::undefined && currentState != previousState) {
+                outBarriers.emplace_back(RHI::Barrier::Transition(GetRHI(static_cast<RGTextureRef>(inResource)), previousState, currentState));
+            }
+        } else {
+            Unimplement();
+        }
+    }
 }
@@ -4,6 +4,11 @@
 
 #include <Render/RenderThread.h>
 
+namespace Render::Internal {
+    // enough for every render command a few frames in flight can emit, producers only spin when it overflows
+    static constexpr size_t renderCommandQueueCapacity = 1 << 16;
+}
+
 namespace Render {
     RenderThread& RenderThread::Get()
     {
@@ -18,7 +23,7 @@ namespace Render {
     void RenderThread::Start()
     {
         Assert(thread == nullptr);
-        thread = Common::MakeUnique<Common::WorkerThread>("RenderingThread");
+        thread = Common::MakeUnique<Common::CommandThread>("RenderingThread", Internal::renderCommandQueueCapacity);
         thread->EmplaceTask([]() -> void { Core::ThreadContext::SetTag(Core::ThreadTag::render); });
     }
 
@@ -34,6 +39,24 @@ namespace Render {
         thread->Flush();
     }
 
+    RenderThread::Fence RenderThread::EmplaceFence() const
+    {
+        Assert(thread != nullptr);
+        return thread->EmplaceFence();
+    }
+
+    bool RenderThread::IsFenceCompleted(Fence inFence) const
+    {
+        Assert(thread != nullptr);
+        return thread->IsFenceCompleted(inFence);
+    }
+
+    void RenderThread::WaitFence(Fence inFence) const
+    {
+        Assert(thread != nullptr);
+        thread->WaitFence(inFence);
+    }
+
     RenderWorkerThreads& RenderWorkerThreads::Get()
     {
         static RenderWorkerThreads instance;
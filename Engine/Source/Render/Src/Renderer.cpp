@@ -2,13 +2,16 @@
 // Created by johnk on 2022/8/3.
 //
 
-#include <format>
+#include <algorithm>
+#include <vector>
 
+#include <Render/Culling.h>
 #include <Render/MeshRenderData.h>
 #include <Render/RenderCache.h>
 #include <Render/Renderer.h>
 #include <Render/SceneProxy/Primitive.h>
 #include <Render/Shader.h>
+#include <Render/UploadManager.h>
 
 namespace Render::Internal {
     const Common::LinearColor surfaceClearColor = { 0.1f, 0.1f, 0.12f, 1.0f };
@@ -69,6 +72,9 @@ namespace Render {
     void StandardRenderer::Render(float inDeltaTimeSeconds)
     {
         const RHI::PixelFormat colorFormat = surface->GetCreateInfo().format;
+        // uploads queued since the last frame go out first, meshes whose uploads did not fit the budget are skipped
+        auto& uploadManager = UploadManager::Get(*device);
+        RHI::Semaphore* uploadSemaphore = uploadManager.Submit();
 
         auto* backTexture = rgBuilder.ImportTexture(surface, surfaceBeforeRenderState);
         auto* backTextureView = rgBuilder.CreateTextureView(backTexture, RGTextureViewDesc(RHI::TextureViewType::colorAttachment, RHI::TextureViewDimension::tv2D));
@@ -92,24 +98,53 @@ namespace Render {
         std::vector<RGBindGroupRef> passBindGroups;
         if (scene != nullptr) {
             ShaderMap& shaderMap = ShaderMap::Get(*device);
-            size_t drawIndex = 0;
 
-            for (const auto& [entity, proxy] : scene->All<StaticPrimitiveSceneProxy>()) {
-                if (!proxy.mesh.Valid() || proxy.vertexFactoryType == nullptr || proxy.vertexShaderType == nullptr || proxy.pixelShaderType == nullptr) {
+            // walk the proxy columns linearly, each field of the primitives lives in its own contiguous array
+            const auto& primitives = scene->All<StaticPrimitiveSceneProxy>();
+            const auto localToWorlds = primitives.Column<&StaticPrimitiveSceneProxy::localToWorld>();
+            const auto meshes = primitives.Column<&StaticPrimitiveSceneProxy::mesh>();
+            const auto vertexFactoryTypes = primitives.Column<&StaticPrimitiveSceneProxy::vertexFactoryType>();
+            const auto vertexShaderTypes = primitives.Column<&StaticPrimitiveSceneProxy::vertexShaderType>();
+            const auto pixelShaderTypes = primitives.Column<&StaticPrimitiveSceneProxy::pixelShaderType>();
+            const auto baseColors = primitives.Column<&StaticPrimitiveSceneProxy::baseColor>();
+            const auto worldBoundingSpheres = primitives.Column<&StaticPrimitiveSceneProxy::worldBoundingSphere>();
+
+            // frustum cull every view up front, primitives outside all views skip pipeline and buffer setup entirely
+            std::vector<VisibilityMask> viewVisibilities(views.size());
+            for (size_t viewIndex = 0; viewIndex < views.size(); viewIndex++) {
+                const auto& viewData = views[viewIndex].data;
+                FrustumCulling::CullParallel(Frustum::FromWorldToClip(viewData.projectionMatrix * viewData.viewMatrix), worldBoundingSpheres, viewVisibilities[viewIndex]);
+            }
+            const auto isVisibleInAnyView = [&](size_t inIndex) -> bool {
+                return std::ranges::any_of(viewVisibilities, [&](const VisibilityMask& inMask) -> bool { return inMask.Test(inIndex); });
+            };
+
+            for (size_t i = 0; i < primitives.Size(); i++) {
+                if (!isVisibleInAnyView(i)) {
+                    continue;
+                }
+                const auto& mesh = meshes[i];
+                const auto* vertexFactoryType = vertexFactoryTypes[i];
+                const auto* vertexShaderType = vertexShaderTypes[i];
+                const auto* pixelShaderType = pixelShaderTypes[i];
+                if (!mesh.Valid() || vertexFactoryType == nullptr || vertexShaderType == nullptr || pixelShaderType == nullptr) {
+                    continue;
+                }
+                if (!uploadManager.IsSubmitted(mesh->GetUploadTicket())) {
                     continue;
                 }
                 // material shaders compile asynchronously, primitives simply do not draw until artifacts arrive
-                if (!shaderMap.HasShaderInstance(*proxy.vertexShaderType, {}) || !shaderMap.HasShaderInstance(*proxy.pixelShaderType, {})) {
+                if (!shaderMap.HasShaderInstance(*vertexShaderType, {}) || !shaderMap.HasShaderInstance(*pixelShaderType, {})) {
                     continue;
                 }
 
-                const ShaderInstance vertexShader = shaderMap.GetShaderInstance(*proxy.vertexShaderType, {});
-                const ShaderInstance pixelShader = shaderMap.GetShaderInstance(*proxy.pixelShaderType, {});
+                const ShaderInstance vertexShader = shaderMap.GetShaderInstance(*vertexShaderType, {});
+                const ShaderInstance pixelShader = shaderMap.GetShaderInstance(*pixelShaderType, {});
                 auto* pipeline = PipelineCache::Get(*device).GetOrCreate(
                     RasterPipelineStateDesc()
                         .SetVertexShader(vertexShader)
                         .SetPixelShader(pixelShader)
-                        .SetVertexState(Internal::BuildVertexState(*proxy.vertexFactoryType))
+                        .SetVertexState(Internal::BuildVertexState(*vertexFactoryType))
                         .SetPrimitiveState(RPrimitiveState().SetCullMode(RHI::CullMode::none))
                         .SetDepthStencilState(
                             RDepthStencilState()
@@ -118,32 +153,28 @@ namespace Render {
                                 .SetDepthCompareFunc(RHI::CompareFunc::greaterEqual))
                         .SetFragmentState(RFragmentState().AddColorTarget(RHI::ColorTargetState(colorFormat, RHI::ColorWriteBits::all, false))));
 
-                auto* vertexBuffer = rgBuilder.ImportBuffer(proxy.mesh->GetVertexBuffer(), RHI::BufferState::shaderReadOnly);
+                auto* vertexBuffer = rgBuilder.ImportBuffer(mesh->GetVertexBuffer(), RHI::BufferState::shaderReadOnly);
                 auto* vertexBufferView = rgBuilder.CreateBufferView(
                     vertexBuffer, RGBufferViewDesc(RHI::BufferViewType::vertex, vertexBuffer->GetDesc().size, 0, RHI::VertexBufferViewInfo(MeshRenderData::vertexStride)));
-                auto* indexBuffer = rgBuilder.ImportBuffer(proxy.mesh->GetIndexBuffer(), RHI::BufferState::shaderReadOnly);
+                auto* indexBuffer = rgBuilder.ImportBuffer(mesh->GetIndexBuffer(), RHI::BufferState::shaderReadOnly);
                 auto* indexBufferView = rgBuilder.CreateBufferView(
                     indexBuffer, RGBufferViewDesc(RHI::BufferViewType::index, indexBuffer->GetDesc().size, 0, RHI::IndexBufferViewInfo(RHI::IndexFormat::uint32)));
 
                 for (size_t viewIndex = 0; viewIndex < views.size(); viewIndex++) {
+                    if (!viewVisibilities[viewIndex].Test(i)) {
+                        continue;
+                    }
                     const View& view = views[viewIndex];
 
                     Internal::BasePassVsUniform vsUniform {};
-                    vsUniform.localToWorld = proxy.localToWorld;
+                    vsUniform.localToWorld = localToWorlds[i];
                     vsUniform.worldToClip = view.data.projectionMatrix * view.data.viewMatrix;
 
                     Internal::BasePassPsUniform psUniform {};
-                    psUniform.baseColor = proxy.baseColor;
+                    psUniform.baseColor = baseColors[i];
 
-                    auto* vsUniformBuffer = rgBuilder.CreateBuffer(
-                        RGBufferDesc(sizeof(Internal::BasePassVsUniform), RHI::BufferUsageBits::uniform | RHI::BufferUsageBits::mapWrite, RHI::BufferState::staging, std::format("basePassVsUniform{}", drawIndex)));
-                    auto* vsUniformBufferView = rgBuilder.CreateBufferView(vsUniformBuffer, RGBufferViewDesc(RHI::BufferViewType::uniformBinding, sizeof(Internal::BasePassVsUniform)));
-                    rgBuilder.QueueBufferUpload(vsUniformBuffer, RGBufferUploadInfo(&vsUniform, sizeof(Internal::BasePassVsUniform), 0, 0, true));
-
-                    auto* psUniformBuffer = rgBuilder.CreateBuffer(
-                        RGBufferDesc(sizeof(Internal::BasePassPsUniform), RHI::BufferUsageBits::uniform | RHI::BufferUsageBits::mapWrite, RHI::BufferState::staging, std::format("basePassPsUniform{}", drawIndex)));
-                    auto* psUniformBufferView = rgBuilder.CreateBufferView(psUniformBuffer, RGBufferViewDesc(RHI::BufferViewType::uniformBinding, sizeof(Internal::BasePassPsUniform)));
-                    rgBuilder.QueueBufferUpload(psUniformBuffer, RGBufferUploadInfo(&psUniform, sizeof(Internal::BasePassPsUniform), 0, 0, true));
+                    auto* vsUniformBufferView = rgBuilder.AllocateUniformBuffer(vsUniform);
+                    auto* psUniformBufferView = rgBuilder.AllocateUniformBuffer(psUniform);
 
                     auto* bindGroup = rgBuilder.AllocateBindGroup(
                         RGBindGroupDesc::Create(pipeline->GetPipelineLayout()->GetBindGroupLayout(0))
@@ -156,10 +187,9 @@ namespace Render {
                     draw.bindGroup = bindGroup;
                     draw.vertexBufferView = vertexBufferView;
                     draw.indexBufferView = indexBufferView;
-                    draw.indexCount = proxy.mesh->GetIndexCount();
+                    draw.indexCount = mesh->GetIndexCount();
                     draws.emplace_back(draw);
                     passBindGroups.emplace_back(bindGroup);
-                    drawIndex++;
                 }
             }
         }
@@ -200,6 +230,9 @@ namespace Render {
         if (waitSemaphore != nullptr) {
             executeInfo.semaphoresToWait.emplace_back(waitSemaphore);
         }
+        if (uploadSemaphore != nullptr) {
+            executeInfo.semaphoresToWait.emplace_back(uploadSemaphore);
+        }
         if (signalSemaphore != nullptr) {
             executeInfo.semaphoresToSignal.emplace_back(signalSemaphore);
         }
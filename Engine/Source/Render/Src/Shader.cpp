@@ -2,6 +2,7 @@
 // Created by johnk on 2022/7/24.
 //
 
+#include <algorithm>
 #include <ranges>
 
 #include <Render/Shader.h>
@@ -139,9 +140,17 @@ namespace Render {
         std::unordered_map<std::string, std::string> relativeFileAndSources;
         GatherShaderSources(relativeFileAndSources, inSourceFile, inIncludeDirectories);
 
+        // sorted by file so the hash is stable across runs, the disk shader cache is keyed by it
+        std::vector<const std::string*> files;
+        files.reserve(relativeFileAndSources.size());
+        for (const auto& file : relativeFileAndSources | std::views::keys) {
+            files.emplace_back(&file);
+        }
+        std::ranges::sort(files, [](const std::string* inLhs, const std::string* inRhs) -> bool { return *inLhs < *inRhs; });
+
         std::string finalString;
-        for (const auto& source : relativeFileAndSources | std::views::values) {
-            finalString += source;
+        for (const auto* file : files) {
+            finalString += relativeFileAndSources.at(*file);
         }
         return Common::HashUtils::CityHash(finalString.data(), finalString.size());
     }
@@ -416,13 +425,29 @@ namespace Render {
         return instance;
     }
 
-    ShaderArtifactRegistry::ShaderArtifactRegistry() = default;
+    ShaderArtifactRegistry::ShaderArtifactRegistry()
+        : version(0)
+        , versionRT(0)
+    {
+    }
 
     ShaderArtifactRegistry::~ShaderArtifactRegistry() = default;
 
     void ShaderArtifactRegistry::PerformThreadCopy()
     {
-        typeArtifactsRT = typeArtifactsGT;
+        std::unique_lock lock(mutex);
+        if (versionRT == version) {
+            return;
+        }
+        // variant artifacts are shared, the copy only duplicates the maps
+        typeArtifactsRT = typeArtifacts;
+        versionRT = version;
+    }
+
+    void ShaderArtifactRegistry::RequestVariant(ShaderTypeKey inTypeKey, ShaderVariantKey inVariantKey)
+    {
+        std::unique_lock lock(mutex);
+        requestedVariants[inTypeKey].emplace(inVariantKey);
     }
 
     ShaderMap& ShaderMap::Get(RHI::Device& inDevice)
@@ -447,41 +472,48 @@ namespace Render {
     ShaderMap::~ShaderMap() = default;
 
     bool ShaderMap::HasShaderInstance(const ShaderType& inShaderType, const ShaderVariantValueMap& inShaderVariants) const // NOLINT
+    {
+        return HasShaderInstance(inShaderType.GetKey(), ShaderUtils::ComputeVariantKey(inShaderType.GetVariantFields(), inShaderVariants));
+    }
+
+    bool ShaderMap::HasShaderInstance(ShaderTypeKey inTypeKey, ShaderVariantKey inVariantKey) const // NOLINT
     {
         Assert(Core::ThreadContext::IsRenderThread());
 
-        const ShaderArtifactRegistry& registry = ShaderArtifactRegistry::Get();
-        const auto typeIter = registry.typeArtifactsRT.find(inShaderType.GetKey());
-        if (typeIter == registry.typeArtifactsRT.end()) {
-            return false;
+        ShaderArtifactRegistry& registry = ShaderArtifactRegistry::Get();
+        if (const auto typeIter = registry.typeArtifactsRT.find(inTypeKey);
+            typeIter != registry.typeArtifactsRT.end() && typeIter->second.variantArtifacts.contains(inVariantKey)) {
+            return true;
         }
-        const ShaderVariantKey variantKey = ShaderUtils::ComputeVariantKey(inShaderType.GetVariantFields(), inShaderVariants);
-        return typeIter->second.variantArtifacts.contains(variantKey);
+        registry.RequestVariant(inTypeKey, inVariantKey);
+        return false;
     }
 
     ShaderInstance ShaderMap::GetShaderInstance(const ShaderType& inShaderType, const ShaderVariantValueMap& inShaderVariants)
+    {
+        return GetShaderInstance(inShaderType.GetKey(), ShaderUtils::ComputeVariantKey(inShaderType.GetVariantFields(), inShaderVariants));
+    }
+
+    ShaderInstance ShaderMap::GetShaderInstance(ShaderTypeKey inTypeKey, ShaderVariantKey inVariantKey)
     {
         Assert(Core::ThreadContext::IsRenderThread());
 
         const ShaderArtifactRegistry& registry = ShaderArtifactRegistry::Get();
-        const auto typeKey = inShaderType.GetKey();
-
-        const ShaderTypeArtifact& typeArtifact = registry.typeArtifactsRT.at(typeKey); // NOLINT
-        const ShaderVariantKey variantKey = ShaderUtils::ComputeVariantKey(inShaderType.GetVariantFields(), inShaderVariants);
-        const auto& [entryPoint, byteCode, reflectionData] = typeArtifact.variantArtifacts.at(variantKey);
+        const ShaderTypeArtifact& typeArtifact = registry.typeArtifactsRT.at(inTypeKey); // NOLINT
+        const auto& [entryPoint, byteCode, reflectionData] = *typeArtifact.variantArtifacts.at(inVariantKey);
 
-        if (!shaderModules.contains(typeKey)) {
-            shaderModules.emplace(typeKey, VariantsShaderModules {});
+        if (!shaderModules.contains(inTypeKey)) {
+            shaderModules.emplace(inTypeKey, VariantsShaderModules {});
         }
-        VariantsShaderModules& variantShaderModules = shaderModules.at(typeKey);
-        if (!variantShaderModules.contains(variantKey)) {
-            variantShaderModules.emplace(variantKey, device.CreateShaderModule(RHI::ShaderModuleCreateInfo(entryPoint, byteCode)));
+        VariantsShaderModules& variantShaderModules = shaderModules.at(inTypeKey);
+        if (!variantShaderModules.contains(inVariantKey)) {
+            variantShaderModules.emplace(inVariantKey, device.CreateShaderModule(RHI::ShaderModuleCreateInfo(entryPoint, byteCode)));
         }
 
         ShaderInstance result;
-        result.typeKey = typeKey;
-        result.variantKey = variantKey;
-        result.rhiHandle = variantShaderModules.at(variantKey).Get();
+        result.typeKey = inTypeKey;
+        result.variantKey = inVariantKey;
+        result.rhiHandle = variantShaderModules.at(inVariantKey).Get();
         result.reflectionData = &reflectionData;
         return result;
     }
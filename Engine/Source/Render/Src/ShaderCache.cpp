@@ -0,0 +1,353 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <sstream>
+#include <thread>
+
+#include <Common/Hash.h>
+#include <Common/Serialization.h>
+#include <Core/Paths.h>
+#include <Render/ShaderCache.h>
+
+namespace Render::Internal {
+    using EntryDeserializeStream = Common::BoundedDeserializeStream<>;
+
+    struct ShaderCacheEntry {
+        ShaderCacheKey key;
+        std::string entryPoint;
+        RHI::ShaderByteCodeRef byteCode;
+        ShaderReflectionData reflectionData;
+    };
+
+    static void SerializeString(Common::BinarySerializeStream& inStream, const std::string& inString)
+    {
+        inStream.Write<uint64_t>(inString.size());
+        inStream.Write<uint8_t>(reinterpret_cast<const uint8_t*>(inString.data()), inString.size());
+    }
+
+    static bool DeserializeString(EntryDeserializeStream& inStream, std::string& outString)
+    {
+        uint64_t size;
+        if (!inStream.ReadLength(size)) {
+            return false;
+        }
+        outString.resize(size);
+        inStream.Read<uint8_t>(reinterpret_cast<uint8_t*>(outString.data()), size);
+        return !inStream.Failed();
+    }
+
+    static void SerializeVertexBinding(Common::BinarySerializeStream& inStream, const RHI::PlatformVertexBinding& inBinding)
+    {
+        inStream.Write<uint8_t>(static_cast<uint8_t>(inBinding.index()));
+        if (const auto* hlsl = std::get_if<RHI::HlslVertexBinding>(&inBinding)) {
+            SerializeString(inStream, hlsl->semanticName);
+            inStream.Write<uint8_t>(hlsl->semanticIndex);
+        } else {
+            inStream.Write<uint8_t>(std::get<RHI::GlslVertexBinding>(inBinding).location);
+        }
+    }
+
+    static RHI::PlatformVertexBinding DeserializeVertexBinding(EntryDeserializeStream& inStream)
+    {
+        uint8_t index;
+        inStream.Read<uint8_t>(index);
+        if (index == 0) {
+            std::string semanticName;
+            uint8_t semanticIndex;
+            DeserializeString(inStream, semanticName);
+            inStream.Read<uint8_t>(semanticIndex);
+            return RHI::HlslVertexBinding(std::move(semanticName), semanticIndex);
+        }
+        uint8_t location;
+        inStream.Read<uint8_t>(location);
+        return RHI::GlslVertexBinding(location);
+    }
+
+    static void SerializeResourceBinding(Common::BinarySerializeStream& inStream, const RHI::ResourceBinding& inBinding)
+    {
+        inStream.Write<uint8_t>(static_cast<uint8_t>(inBinding.type));
+        inStream.Write<uint8_t>(static_cast<uint8_t>(inBinding.platformBinding.index()));
+        if (const auto* hlsl = std::get_if<RHI::HlslBinding>(&inBinding.platformBinding)) {
+            inStream.Write<uint8_t>(static_cast<uint8_t>(hlsl->rangeType));
+            inStream.Write<uint8_t>(hlsl->index);
+        } else {
+            inStream.Write<uint8_t>(std::get<RHI::GlslBinding>(inBinding.platformBinding).index);
+        }
+    }
+
+    static RHI::ResourceBinding DeserializeResourceBinding(EntryDeserializeStream& inStream)
+    {
+        uint8_t type;
+        uint8_t index;
+        inStream.Read<uint8_t>(type);
+        inStream.Read<uint8_t>(index);
+        if (index == 0) {
+            uint8_t rangeType;
+            uint8_t bindingIndex;
+            inStream.Read<uint8_t>(rangeType);
+            inStream.Read<uint8_t>(bindingIndex);
+            return { static_cast<RHI::BindingType>(type), RHI::HlslBinding(static_cast<RHI::HlslBindingRangeType>(rangeType), bindingIndex) };
+        }
+        uint8_t bindingIndex;
+        inStream.Read<uint8_t>(bindingIndex);
+        return { static_cast<RHI::BindingType>(type), RHI::GlslBinding(bindingIndex) };
+    }
+
+    static void SerializeEntry(Common::BinarySerializeStream& inStream, const ShaderCacheEntry& inEntry)
+    {
+        inStream.Write<uint64_t>(inEntry.key);
+        SerializeString(inStream, inEntry.entryPoint);
+        inStream.Write<uint64_t>(inEntry.byteCode->GetSize());
+        inStream.Write<uint8_t>(static_cast<const uint8_t*>(inEntry.byteCode->GetData()), inEntry.byteCode->GetSize());
+
+        inStream.Write<uint64_t>(inEntry.reflectionData.vertexBindings.size());
+        for (const auto& [semantic, binding] : inEntry.reflectionData.vertexBindings) {
+            SerializeString(inStream, semantic);
+            SerializeVertexBinding(inStream, binding);
+        }
+        inStream.Write<uint64_t>(inEntry.reflectionData.resourceBindings.size());
+        for (const auto& [name, layoutAndBinding] : inEntry.reflectionData.resourceBindings) {
+            SerializeString(inStream, name);
+            inStream.Write<uint8_t>(layoutAndBinding.first);
+            SerializeResourceBinding(inStream, layoutAndBinding.second);
+        }
+    }
+
+    // entries may be truncated or corrupt, e.g. by a crash while an older version wrote them or by disk errors, every
+    // length is checked against the bytes left, a failed entry reads as a miss
+    static bool DeserializeEntry(EntryDeserializeStream& inStream, ShaderCacheEntry& outEntry)
+    {
+        inStream.Read<uint64_t>(outEntry.key);
+        if (!DeserializeString(inStream, outEntry.entryPoint)) {
+            return false;
+        }
+
+        uint64_t byteCodeSize;
+        if (!inStream.ReadLength(byteCodeSize)) {
+            return false;
+        }
+        const auto byteCode = inStream.ReadView(byteCodeSize);
+        outEntry.byteCode = Common::MakeShared<const RHI::ShaderByteCode>(byteCode->data(), byteCode->size());
+
+        // smallest encodings, a vertex binding is an empty semantic and a glsl location, a resource binding an empty
+        // name, the layout index and a glsl binding
+        constexpr size_t minVertexBindingSize = sizeof(uint64_t) + 2;
+        constexpr size_t minResourceBindingSize = sizeof(uint64_t) + 4;
+
+        uint64_t vertexBindingNum;
+        if (!inStream.ReadLength(vertexBindingNum, minVertexBindingSize)) {
+            return false;
+        }
+        for (auto i = 0; i < vertexBindingNum && !inStream.Failed(); i++) {
+            std::string semantic;
+            DeserializeString(inStream, semantic);
+            outEntry.reflectionData.vertexBindings.emplace(std::move(semantic), DeserializeVertexBinding(inStream));
+        }
+        uint64_t resourceBindingNum;
+        if (!inStream.ReadLength(resourceBindingNum, minResourceBindingSize)) {
+            return false;
+        }
+        for (auto i = 0; i < resourceBindingNum && !inStream.Failed(); i++) {
+            std::string name;
+            uint8_t layoutIndex;
+            DeserializeString(inStream, name);
+            inStream.Read<uint8_t>(layoutIndex);
+            outEntry.reflectionData.resourceBindings.emplace(std::move(name), std::make_pair(layoutIndex, DeserializeResourceBinding(inStream)));
+        }
+        return !inStream.Failed() && inStream.Remaining() == 0;
+    }
+}
+
+namespace Render {
+    ShaderCacheStats::ShaderCacheStats()
+        : hits(0)
+        , misses(0)
+        , writes(0)
+    {
+    }
+
+    ShaderCache& ShaderCache::Get()
+    {
+        static ShaderCache instance;
+        return instance;
+    }
+
+    ShaderCacheKey ShaderCache::ComputeKey(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions, uint64_t inCompilerVersion)
+    {
+        // include directories are left out, the source hash already covers the content of every resolved include
+        std::vector<uint8_t> bytes;
+        Common::MemorySerializeStream stream(bytes);
+        stream.Write<uint32_t>(Internal::shaderCacheFormatVersion);
+        stream.Write<uint64_t>(inCompilerVersion);
+        stream.Write<uint64_t>(inInput.sourceHash);
+        Common::Serializer<std::string>::Serialize(stream, inInput.entryPoint);
+        stream.Write<uint8_t>(static_cast<uint8_t>(inInput.stage));
+        Common::Serializer<std::vector<std::string>>::Serialize(stream, inInput.definitions);
+        stream.Write<uint8_t>(static_cast<uint8_t>(inOptions.byteCodeType));
+        stream.Write<bool>(inOptions.withDebugInfo);
+        return Common::HashUtils::CityHash(bytes.data(), bytes.size());
+    }
+
+    ShaderCache::ShaderCache()
+        : enabled(true)
+        , hits(0)
+        , misses(0)
+        , writes(0)
+    {
+    }
+
+    ShaderCache::~ShaderCache() = default;
+
+    void ShaderCache::SetDirectory(const Common::Path& inDirectory)
+    {
+        std::unique_lock lock(mutex);
+        directory = inDirectory;
+    }
+
+    Common::Path ShaderCache::GetDirectory() const
+    {
+        std::unique_lock lock(mutex);
+        if (directory.Empty()) {
+            directory = (Core::Paths::HasSetGameRoot() ? Core::Paths::GameCacheDir() : Core::Paths::EngineCacheDir()) / "Shader";
+        }
+        return directory;
+    }
+
+    void ShaderCache::SetEnabled(bool inEnabled)
+    {
+        enabled.store(inEnabled, std::memory_order_relaxed);
+    }
+
+    bool ShaderCache::IsEnabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    bool ShaderCache::Load(ShaderCacheKey inKey, ShaderCompileOutput& outOutput)
+    {
+        const auto path = GetEntryPath(inKey);
+        Internal::ShaderCacheEntry entry {};
+        bool valid;
+        {
+            const Common::MappedFile file(path.String());
+            if (!file.IsMapped()) {
+                misses.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            Internal::EntryDeserializeStream stream(std::span(file.Data(), file.Size()));
+            valid = Internal::DeserializeEntry(stream, entry) && entry.key == inKey;
+        }
+
+        std::error_code errorCode;
+        if (!valid) {
+            // the file is unmapped by now, a broken entry is dropped so the recompiled variant can take its place
+            std::filesystem::remove(path.String(), errorCode);
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // hits refresh the write time, pruning evicts by it
+        std::filesystem::last_write_time(path.String(), std::filesystem::file_time_type::clock::now(), errorCode);
+
+        outOutput.success = true;
+        outOutput.entryPoint = std::move(entry.entryPoint);
+        outOutput.byteCode = std::move(entry.byteCode);
+        outOutput.reflectionData = std::move(entry.reflectionData);
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void ShaderCache::Store(ShaderCacheKey inKey, const ShaderCompileOutput& inOutput)
+    {
+        Assert(inOutput.success);
+        const auto path = GetEntryPath(inKey);
+        path.Parent().MakeDir();
+
+        std::stringstream threadId;
+        threadId << std::this_thread::get_id();
+        const auto tempPath = path + std::format(".{}.tmp", threadId.str());
+        {
+            Internal::ShaderCacheEntry entry {};
+            entry.key = inKey;
+            entry.entryPoint = inOutput.entryPoint;
+            entry.byteCode = inOutput.byteCode;
+            entry.reflectionData = inOutput.reflectionData;
+
+            Common::BinaryFileSerializeStream stream(tempPath.String());
+            Internal::SerializeEntry(stream, entry);
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(tempPath.String(), path.String(), errorCode);
+        if (errorCode) {
+            std::filesystem::remove(tempPath.String(), errorCode);
+            return;
+        }
+        writes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t ShaderCache::Prune(uint64_t inMaxBytes)
+    {
+        struct EntryFile {
+            std::filesystem::path path;
+            uint64_t size;
+            std::filesystem::file_time_type lastWriteTime;
+        };
+
+        std::error_code errorCode;
+        std::vector<EntryFile> entryFiles;
+        uint64_t totalBytes = 0;
+        for (const auto& dirEntry : std::filesystem::directory_iterator(GetDirectory().String(), errorCode)) {
+            if (!dirEntry.is_regular_file() || dirEntry.path().extension() != ".bin") {
+                continue;
+            }
+            EntryFile entryFile;
+            entryFile.path = dirEntry.path();
+            entryFile.size = dirEntry.file_size(errorCode);
+            entryFile.lastWriteTime = dirEntry.last_write_time(errorCode);
+            totalBytes += entryFile.size;
+            entryFiles.emplace_back(std::move(entryFile));
+        }
+
+        std::ranges::sort(entryFiles, [](const EntryFile& inLhs, const EntryFile& inRhs) -> bool {
+            return inLhs.lastWriteTime < inRhs.lastWriteTime;
+        });
+
+        size_t removed = 0;
+        for (const auto& entryFile : entryFiles) {
+            if (totalBytes <= inMaxBytes) {
+                break;
+            }
+            if (std::filesystem::remove(entryFile.path, errorCode)) {
+                totalBytes -= entryFile.size;
+                removed++;
+            }
+        }
+        return removed;
+    }
+
+    ShaderCacheStats ShaderCache::GetStats() const
+    {
+        ShaderCacheStats result;
+        result.hits = hits.load(std::memory_order_relaxed);
+        result.misses = misses.load(std::memory_order_relaxed);
+        result.writes = writes.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void ShaderCache::ResetCounters()
+    {
+        hits.store(0, std::memory_order_relaxed);
+        misses.store(0, std::memory_order_relaxed);
+        writes.store(0, std::memory_order_relaxed);
+    }
+
+    Common::Path ShaderCache::GetEntryPath(ShaderCacheKey inKey) const
+    {
+        return GetDirectory() / std::format("{:016x}.bin", inKey);
+    }
+}
@@ -2,7 +2,13 @@
 // Created by johnk on 2022/7/16.
 //
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
+#include <ranges>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <format>
@@ -29,6 +35,7 @@ using namespace Microsoft::WRL;
 #include <spirv_cross/spirv_cross.hpp>
 #include <spirv_cross/spirv_msl.hpp>
 
+#include <Render/ShaderCache.h>
 #include <Render/ShaderCompiler.h>
 #include <Common/Debug.h>
 #include <Common/Container.h>
@@ -45,6 +52,12 @@ namespace Render::Internal {
         return result;
     }
 
+    static uint8_t GetShaderCompileThreadNum()
+    {
+        // one dxc invocation keeps one core busy, type compile tasks mostly wait on their variants
+        return static_cast<uint8_t>(std::clamp(std::thread::hardware_concurrency(), 1u, 255u));
+    }
+
     static std::vector<std::string> TranslateIncludeDirectories(const std::vector<std::string>& inDir)
     {
         std::vector<std::string> result;
@@ -345,9 +358,37 @@ namespace Render {
 
         output.byteCode = Common::MakeShared<const RHI::ShaderByteCode>(std::move(byteCode));
     }
+
+    static uint64_t QueryDxcVersion()
+    {
+        ComPtr<IDxcVersionInfo> versionInfo;
+        Assert(SUCCEEDED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&versionInfo))));
+
+        uint32_t major = 0;
+        uint32_t minor = 0;
+        Assert(SUCCEEDED(versionInfo->GetVersion(&major, &minor)));
+        return static_cast<uint64_t>(major) << 32 | minor;
+    }
 }
 
 namespace Render {
+    static ShaderCompileOutput CompileWithShaderCache(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions, uint64_t inCompilerVersion)
+    {
+        auto& shaderCache = ShaderCache::Get();
+        const bool cacheable = inInput.sourceHash != shaderSourceHashNotCompiled && shaderCache.IsEnabled();
+        const auto cacheKey = cacheable ? ShaderCache::ComputeKey(inInput, inOptions, inCompilerVersion) : 0;
+
+        ShaderCompileOutput output;
+        if (cacheable && shaderCache.Load(cacheKey, output)) {
+            return output;
+        }
+        CompileDxilOrSpriv(inInput, inOptions, output);
+        if (cacheable && output.success) {
+            shaderCache.Store(cacheKey, output);
+        }
+        return output;
+    }
+
     size_t ShaderTypeAndVariantHashProvider::operator()(const std::pair<ShaderTypeKey, ShaderVariantKey>& value) const
     {
         return Common::HashUtils::CityHash(&value, sizeof(std::pair<ShaderTypeKey, ShaderVariantKey>));
@@ -359,7 +400,9 @@ namespace Render {
         return instance;
     }
 
-    ShaderCompiler::ShaderCompiler() : threadPool("ShaderCompiler", 4)
+    ShaderCompiler::ShaderCompiler()
+        : compilerVersion(QueryDxcVersion())
+        , threadPool("ShaderCompiler", Internal::GetShaderCompileThreadNum())
     {
     }
 
@@ -367,13 +410,23 @@ namespace Render {
 
     std::future<ShaderCompileOutput> ShaderCompiler::Compile(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions)
     {
-        return threadPool.EmplaceTask([inInput, inOptions]() -> ShaderCompileOutput {
-            ShaderCompileOutput output;
-            CompileDxilOrSpriv(inInput, inOptions, output);
-            return output;
+        return threadPool.EmplaceTask([inInput, inOptions, version = compilerVersion]() -> ShaderCompileOutput {
+            return CompileWithShaderCache(inInput, inOptions, version);
+        });
+    }
+
+    void ShaderCompiler::Compile(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions, OnCompiled inOnCompiled)
+    {
+        threadPool.EmplaceTask([inInput, inOptions, version = compilerVersion, onCompiled = std::move(inOnCompiled)]() -> void {
+            onCompiled(CompileWithShaderCache(inInput, inOptions, version));
         });
     }
 
+    uint64_t ShaderCompiler::GetCompilerVersion() const
+    {
+        return compilerVersion;
+    }
+
     ShaderTypeCompiler& ShaderTypeCompiler::Get()
     {
         static ShaderTypeCompiler instance;
@@ -381,7 +434,7 @@ namespace Render {
     }
 
     ShaderTypeCompiler::ShaderTypeCompiler()
-        : threadPool("ShaderTypeCompiler", 4)
+        : threadPool("ShaderTypeCompiler", Internal::GetShaderCompileThreadNum())
     {
     }
 
@@ -392,68 +445,185 @@ namespace Render {
         Assert(Core::ThreadContext::IsGameThread());
 
         return threadPool.EmplaceTask([inShaderTypes, inOptions]() -> ShaderTypeCompileResult {
-            ShaderArtifactRegistry& artifactRegistry = ShaderArtifactRegistry::Get();
-
-            std::unique_lock lock(artifactRegistry.mutexGT);
-            auto& typeArtifactGT = artifactRegistry.typeArtifactsGT;
+            struct TypeJob {
+                ShaderTypeKey typeKey;
+                ShaderSourceHash sourceHash;
+                size_t pendingVariants;
+                std::unordered_set<ShaderVariantKey> landedVariants;
+                // variant jobs not handed to the compiler yet
+                std::unordered_map<ShaderVariantKey, size_t> queuedVariants;
+            };
+
+            struct VariantJob {
+                size_t typeJobIndex;
+                ShaderVariantKey variantKey;
+                bool prior;
+                ShaderCompileInput input;
+            };
 
-            std::unordered_map<ShaderTypeKey, std::unordered_map<ShaderVariantKey, std::future<ShaderCompileOutput>>> compileOutputs;
-            compileOutputs.reserve(inShaderTypes.size());
+            ShaderArtifactRegistry& artifactRegistry = ShaderArtifactRegistry::Get();
+            std::vector<TypeJob> typeJobs;
+            std::vector<VariantJob> variantJobs;
+            typeJobs.reserve(inShaderTypes.size());
 
             for (const auto* shaderType : inShaderTypes) {
-                auto typeKey = shaderType->GetKey();
-                auto sourceFile = Core::Paths::Translate(shaderType->GetSourceFile()).String();
+                const auto typeKey = shaderType->GetKey();
+                const auto sourceFile = Core::Paths::Translate(shaderType->GetSourceFile()).String();
 
                 auto includeDirectories = Common::VectorUtils::Combine(Internal::GetPresetIncludeDirectories(), shaderType->GetIncludeDirectories());
                 includeDirectories = Common::VectorUtils::Combine(includeDirectories, inOptions.includeDirectories);
                 includeDirectories = Internal::TranslateIncludeDirectories(includeDirectories);
-                const auto oldHash = typeArtifactGT.contains(typeKey) ? typeArtifactGT.at(typeKey).sourceHash : shaderSourceHashNotCompiled;
+                // hashing reads every source file, so it runs before the registry is locked
                 const auto newHash = ShaderUtils::ComputeShaderSourceHash(sourceFile, includeDirectories); // NOLINT
+                const auto& variantFields = shaderType->GetVariantFields();
 
-                if (oldHash != shaderSourceHashNotCompiled && oldHash == newHash) {
-                    continue;
-                }
-                typeArtifactGT[typeKey].sourceHash = newHash;
-                typeArtifactGT[typeKey].variantArtifacts.clear();
+                // variants built from the previous source are in use, requested variants are waited for by the
+                // renderer and the default variant is what most primitives draw with, these are compiled first
+                std::unordered_set<ShaderVariantKey> priorVariants = { ShaderUtils::ComputeVariantKey(variantFields, {}) };
+                {
+                    std::unique_lock lock(artifactRegistry.mutex);
+                    const auto artifactIter = artifactRegistry.typeArtifacts.find(typeKey);
+                    const auto compilingIter = artifactRegistry.compilingHashes.find(typeKey);
+                    const auto latestHash = compilingIter != artifactRegistry.compilingHashes.end() ? compilingIter->second
+                        : artifactIter != artifactRegistry.typeArtifacts.end() ? artifactIter->second.sourceHash
+                        : shaderSourceHashNotCompiled;
+                    if (latestHash != shaderSourceHashNotCompiled && latestHash == newHash) {
+                        continue;
+                    }
+                    artifactRegistry.compilingHashes[typeKey] = newHash;
 
-                const auto stage = shaderType->GetStage();
-                const auto& entryPoint = shaderType->GetEntryPoint();
-                const auto& variantFields = shaderType->GetVariantFields();
-                const auto source = Common::FileUtils::ReadTextFile(sourceFile).Unwrap();
+                    if (artifactIter != artifactRegistry.typeArtifacts.end()) {
+                        for (const auto& variantKey : artifactIter->second.variantArtifacts | std::views::keys) {
+                            priorVariants.emplace(variantKey);
+                        }
+                    }
+                    if (const auto requestedIter = artifactRegistry.requestedVariants.find(typeKey);
+                        requestedIter != artifactRegistry.requestedVariants.end()) {
+                        priorVariants.insert(requestedIter->second.begin(), requestedIter->second.end());
+                    }
+                }
 
-                Assert(!compileOutputs.contains(typeKey));
-                compileOutputs.emplace(std::make_pair(typeKey, std::unordered_map<ShaderVariantKey, std::future<ShaderCompileOutput>> {}));
-                auto& variantCompileOutputs = compileOutputs.at(typeKey);
+                const auto typeJobIndex = typeJobs.size();
+                auto& typeJob = typeJobs.emplace_back();
+                typeJob.typeKey = typeKey;
+                typeJob.sourceHash = newHash;
+                typeJob.pendingVariants = 0;
 
+                const auto source = Common::FileUtils::ReadTextFile(sourceFile).Unwrap();
                 for (const auto& variantSet : ShaderUtils::GetAllVariants(variantFields)) {
-                    const auto variantKey = ShaderUtils::ComputeVariantKey(variantFields, variantSet);
+                    auto& variantJob = variantJobs.emplace_back();
+                    variantJob.typeJobIndex = typeJobIndex;
+                    variantJob.variantKey = ShaderUtils::ComputeVariantKey(variantFields, variantSet);
+                    variantJob.prior = priorVariants.contains(variantJob.variantKey);
+                    variantJob.input.source = source;
+                    variantJob.input.entryPoint = shaderType->GetEntryPoint();
+                    variantJob.input.stage = shaderType->GetStage();
+                    variantJob.input.definitions = ShaderUtils::ComputeVariantDefinitions(variantFields, variantSet);
+                    variantJob.input.includeDirectories = includeDirectories;
+                    variantJob.input.sourceHash = newHash;
+                    typeJob.pendingVariants++;
+                }
+            }
 
-                    ShaderCompileInput input {};
-                    input.source = source;
-                    input.entryPoint = entryPoint;
-                    input.stage = stage;
-                    input.definitions = ShaderUtils::ComputeVariantDefinitions(variantFields, variantSet);
-                    input.includeDirectories = includeDirectories;
+            // prior variants of every type go first, the rest keep the order of their variant space
+            std::ranges::stable_partition(variantJobs, [](const VariantJob& inJob) -> bool { return inJob.prior; });
+            for (size_t i = 0; i < variantJobs.size(); i++) {
+                typeJobs[variantJobs[i].typeJobIndex].queuedVariants.emplace(variantJobs[i].variantKey, i);
+            }
 
-                    variantCompileOutputs.emplace(variantKey, ShaderCompiler::Get().Compile(input, inOptions));
+            // variants requested while their type compiles overtake the queued ones whenever the next variant is taken,
+            // called with the registry locked
+            size_t nextJobIndex = 0;
+            const auto takeNextJob = [&]() -> size_t {
+                for (auto& typeJob : typeJobs) {
+                    const auto requestedIter = artifactRegistry.requestedVariants.find(typeJob.typeKey);
+                    if (requestedIter == artifactRegistry.requestedVariants.end()) {
+                        continue;
+                    }
+                    for (const auto& variantKey : requestedIter->second) {
+                        if (const auto queuedIter = typeJob.queuedVariants.find(variantKey); queuedIter != typeJob.queuedVariants.end()) {
+                            const size_t jobIndex = queuedIter->second;
+                            typeJob.queuedVariants.erase(queuedIter);
+                            return jobIndex;
+                        }
+                    }
                 }
-            }
+                for (;; nextJobIndex++) {
+                    const auto& variantJob = variantJobs[nextJobIndex];
+                    if (typeJobs[variantJob.typeJobIndex].queuedVariants.erase(variantJob.variantKey) > 0) {
+                        return nextJobIndex++;
+                    }
+                }
+            };
+
+            // only as many variants as the compiler has threads are handed to it at once, so that the order of the
+            // rest stays open, every variant is published from its own completion whatever order they finish in
+            std::mutex landedMutex;
+            std::condition_variable landedCondition;
+            std::vector<std::pair<size_t, ShaderCompileOutput>> landedOutputs;
+            std::vector<std::pair<size_t, ShaderCompileOutput>> outputs;
+            const size_t maxCompilingJobs = Internal::GetShaderCompileThreadNum();
+            size_t queuedJobs = variantJobs.size();
+            size_t compilingJobs = 0;
 
             ShaderTypeCompileResult result;
-            for (auto& [typeKey, variantCompileOutputs] : compileOutputs) {
-                auto& typeArtifact = typeArtifactGT.at(typeKey);
-                for (auto& [variantKey, compileFuture] : variantCompileOutputs) {
-                    ShaderCompileOutput output = compileFuture.get(); // NOLINT
-                    if (output.success) {
+            while (queuedJobs > 0 || compilingJobs > 0) {
+                for (; queuedJobs > 0 && compilingJobs < maxCompilingJobs; queuedJobs--, compilingJobs++) {
+                    size_t jobIndex;
+                    {
+                        std::unique_lock lock(artifactRegistry.mutex);
+                        jobIndex = takeNextJob();
+                    }
+                    ShaderCompiler::Get().Compile(variantJobs[jobIndex].input, inOptions, [&, jobIndex](ShaderCompileOutput&& inOutput) -> void {
+                        std::unique_lock lock(landedMutex);
+                        landedOutputs.emplace_back(jobIndex, std::move(inOutput));
+                        landedCondition.notify_one();
+                    });
+                }
+
+                {
+                    std::unique_lock lock(landedMutex);
+                    landedCondition.wait(lock, [&]() -> bool { return !landedOutputs.empty(); });
+                    outputs.swap(landedOutputs);
+                }
+                for (auto& [jobIndex, output] : outputs) {
+                    compilingJobs--;
+                    const auto& variantJob = variantJobs[jobIndex];
+                    auto& typeJob = typeJobs[variantJob.typeJobIndex];
+
+                    // every variant is published as soon as it lands, older builds of the same variant stay usable until then
+                    std::unique_lock lock(artifactRegistry.mutex);
+                    const auto compilingIter = artifactRegistry.compilingHashes.find(typeJob.typeKey);
+                    const bool superseded = compilingIter == artifactRegistry.compilingHashes.end() || compilingIter->second != typeJob.sourceHash;
+
+                    if (!output.success) {
+                        result.errorInfos.emplace(std::make_pair(std::make_pair(typeJob.typeKey, variantJob.variantKey), output.errorInfo));
+                    } else if (!superseded) {
                         ShaderVariantArtifact variantArtifact;
                         variantArtifact.entryPoint = output.entryPoint;
                         variantArtifact.byteCode = std::move(output.byteCode);
                         variantArtifact.reflectionData = std::move(output.reflectionData);
-                        typeArtifact.variantArtifacts.emplace(variantKey, std::move(variantArtifact));
-                    } else {
-                        result.errorInfos.emplace(std::make_pair(std::make_pair(typeKey, variantKey), output.errorInfo));
+                        artifactRegistry.typeArtifacts[typeJob.typeKey].variantArtifacts[variantJob.variantKey] = Common::MakeShared<const ShaderVariantArtifact>(std::move(variantArtifact));
+                        if (const auto requestedIter = artifactRegistry.requestedVariants.find(typeJob.typeKey);
+                            requestedIter != artifactRegistry.requestedVariants.end()) {
+                            requestedIter->second.erase(variantJob.variantKey);
+                        }
+                        typeJob.landedVariants.emplace(variantJob.variantKey);
+                        artifactRegistry.version++;
+                    }
+
+                    // once the last variant lands the type is committed as a whole, variants that failed or no longer
+                    // exist in the new source are dropped
+                    if (--typeJob.pendingVariants > 0 || superseded) {
+                        continue;
                     }
+                    auto& typeArtifact = artifactRegistry.typeArtifacts[typeJob.typeKey];
+                    typeArtifact.sourceHash = typeJob.sourceHash;
+                    std::erase_if(typeArtifact.variantArtifacts, [&](const auto& inPair) -> bool { return !typeJob.landedVariants.contains(inPair.first); });
+                    artifactRegistry.compilingHashes.erase(compilingIter);
+                    artifactRegistry.version++;
                 }
+                outputs.clear();
             }
             result.success = result.errorInfos.empty();
             return result;
@@ -0,0 +1,240 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <algorithm>
+#include <array>
+
+#include <Common/Debug.h>
+#include <Common/Hash.h>
+#include <Core/Thread.h>
+#include <Render/UniformBufferRing.h>
+
+namespace Render::Internal {
+    static std::unordered_map<RHI::Device*, Common::UniquePtr<UniformBufferRing>>& GetUniformBufferRingMap()
+    {
+        static std::unordered_map<RHI::Device*, Common::UniquePtr<UniformBufferRing>> map;
+        return map;
+    }
+
+    static size_t AlignUp(size_t inValue, size_t inAlignment)
+    {
+        return (inValue + inAlignment - 1) / inAlignment * inAlignment;
+    }
+
+    // a frame slot comes back every uniformBufferRingFrameLatency frames, what its last turn did not use is stale and
+    // no longer read by the gpu
+    static bool IsStale(uint64_t inLastUsedFrame, uint64_t inFrameNumber)
+    {
+        return inLastUsedFrame + uniformBufferRingFrameLatency < inFrameNumber;
+    }
+}
+
+namespace Render {
+    size_t UniformBufferRing::BindGroupKey::Hash::operator()(const BindGroupKey& inKey) const
+    {
+        // hashed entry by entry, this runs once per draw
+        uint64_t result = reinterpret_cast<uint64_t>(inKey.layout);
+        for (const auto& [view, shaderVisibility] : inKey.entries) {
+            const std::array<uint64_t, 3> values = { result, reinterpret_cast<uint64_t>(view), static_cast<uint64_t>(shaderVisibility) };
+            result = Common::HashUtils::CityHash(values.data(), sizeof(values));
+        }
+        return result;
+    }
+
+    bool UniformBufferRing::BindGroupKey::operator==(const BindGroupKey& inRhs) const
+    {
+        return layout == inRhs.layout
+            && entries == inRhs.entries;
+    }
+
+    UniformBufferRing& UniformBufferRing::Get(RHI::Device& device)
+    {
+        auto& map = Internal::GetUniformBufferRingMap();
+        if (!map.contains(&device)) {
+            map.emplace(std::make_pair(&device, Common::UniquePtr<UniformBufferRing>(new UniformBufferRing(device))));
+        }
+        return *map.at(&device);
+    }
+
+    void UniformBufferRing::Destroy(RHI::Device& device)
+    {
+        Internal::GetUniformBufferRingMap().erase(&device);
+    }
+
+    UniformBufferRing::UniformBufferRing(RHI::Device& inDevice)
+        : device(inDevice)
+        , alignment(std::max<size_t>(inDevice.GetGpu().GetLimits().minUniformBufferOffsetAlignment, Internal::uniformBufferRingMinAlignment))
+        , currentFrame(0)
+        , lookupKey()
+    {
+        for (auto& frame : frames) {
+            frame.currentPage = 0;
+        }
+    }
+
+    UniformBufferRing::~UniformBufferRing()
+    {
+        for (auto& frame : frames) {
+            frame.bindGroups.clear();
+            for (auto& page : frame.pages) {
+                page.views.clear();
+                page.buffer->Unmap();
+            }
+        }
+    }
+
+    void UniformBufferRing::Recycle()
+    {
+        Flush();
+        currentFrame = static_cast<uint8_t>(Core::ThreadContext::FrameNumber() % Internal::uniformBufferRingFrameLatency);
+
+        auto& frame = frames[currentFrame];
+        const uint64_t frameNumber = Core::ThreadContext::FrameNumber();
+        // bind groups go first, a stale view is only referenced by stale bind groups
+        std::erase_if(frame.bindGroups, [&](const auto& inPair) -> bool { return Internal::IsStale(inPair.second.lastUsedFrame, frameNumber); });
+        for (auto& page : frame.pages) {
+            page.offset = 0;
+            page.flushedOffset = 0;
+            std::erase_if(page.views, [&](const auto& inPair) -> bool { return Internal::IsStale(inPair.second.lastUsedFrame, frameNumber); });
+        }
+        frame.currentPage = 0;
+    }
+
+    UniformAllocation UniformBufferRing::Allocate(size_t inSize)
+    {
+        Assert(inSize > 0);
+        const size_t alignedSize = Internal::AlignUp(inSize, alignment);
+
+        auto& frame = frames[currentFrame];
+        while (true) {
+            if (frame.currentPage == frame.pages.size()) {
+                frame.pages.emplace_back(CreatePage(std::max(Internal::uniformBufferRingPageSize, alignedSize)));
+            }
+
+            auto& page = frame.pages[frame.currentPage];
+            if (page.offset + alignedSize > page.size) {
+                frame.currentPage++;
+                continue;
+            }
+
+            UniformAllocation result {};
+            result.buffer = page.buffer.Get();
+            result.offset = page.offset;
+            result.size = alignedSize;
+            result.mappedData = page.mappedData + page.offset;
+            page.offset += alignedSize;
+            return result;
+        }
+    }
+
+    void UniformBufferRing::Flush()
+    {
+        for (auto& page : frames[currentFrame].pages) {
+            if (page.offset == page.flushedOffset) {
+                continue;
+            }
+            page.buffer->Flush(page.flushedOffset, page.offset - page.flushedOffset);
+            page.flushedOffset = page.offset;
+        }
+    }
+
+    bool UniformBufferRing::Contains(RHI::Buffer* inBuffer) const
+    {
+        return FindPage(inBuffer) != nullptr;
+    }
+
+    RHI::BufferView* UniformBufferRing::GetView(RHI::Buffer* inBuffer, const RHI::BufferViewCreateInfo& inCreateInfo)
+    {
+        auto* page = FindPage(inBuffer);
+        Assert(page != nullptr && inCreateInfo.type == RHI::BufferViewType::uniformBinding);
+
+        const uint64_t key = static_cast<uint64_t>(inCreateInfo.offsetInBytes) << 32 | inCreateInfo.sizeInBytes;
+        auto iter = page->views.find(key);
+        if (iter == page->views.end()) {
+            iter = page->views.emplace(key, CachedView { page->buffer->CreateBufferView(inCreateInfo), 0 }).first;
+        }
+        iter->second.lastUsedFrame = Core::ThreadContext::FrameNumber();
+        return iter->second.view.Get();
+    }
+
+    RHI::BindGroup* UniformBufferRing::GetBindGroup(const RHI::BindGroupCreateInfo& inCreateInfo)
+    {
+        // views of the pages live until they go stale, as long as the bind groups built from them, so their addresses
+        // identify the bound ranges
+        lookupKey.layout = inCreateInfo.layout;
+        lookupKey.entries.clear();
+        for (const auto& entry : inCreateInfo.entries) {
+            Assert(std::holds_alternative<RHI::BufferView*>(entry.entity));
+            lookupKey.entries.emplace_back(std::get<RHI::BufferView*>(entry.entity), entry.shaderVisibility.Value());
+        }
+
+        auto& bindGroups = frames[currentFrame].bindGroups;
+        auto iter = bindGroups.find(lookupKey);
+        if (iter == bindGroups.end()) {
+            auto createInfo = inCreateInfo;
+            createInfo.SetTransient(false);
+            iter = bindGroups.emplace(lookupKey, CachedBindGroup { device.CreateBindGroup(createInfo), 0 }).first;
+        }
+        iter->second.lastUsedFrame = Core::ThreadContext::FrameNumber();
+        return iter->second.bindGroup.Get();
+    }
+
+    size_t UniformBufferRing::GetAlignment() const
+    {
+        return alignment;
+    }
+
+    RHI::BufferState UniformBufferRing::GetState(RHI::Buffer* inBuffer) const
+    {
+        const auto* page = FindPage(inBuffer);
+        Assert(page != nullptr);
+        return page->state;
+    }
+
+    void UniformBufferRing::SetState(RHI::Buffer* inBuffer, RHI::BufferState inState)
+    {
+        auto* page = FindPage(inBuffer);
+        Assert(page != nullptr);
+        page->state = inState;
+    }
+
+    UniformBufferRing::Page UniformBufferRing::CreatePage(size_t inSize) const
+    {
+        Page result;
+        result.buffer = device.CreateBuffer(
+            RHI::BufferCreateInfo()
+                .SetSize(static_cast<uint32_t>(inSize))
+                .SetUsages(RHI::BufferUsageBits::uniform | RHI::BufferUsageBits::mapWrite)
+                .SetInitialState(RHI::BufferState::staging)
+                .SetDebugName("uniformBufferRingPage"));
+        result.size = inSize;
+        result.offset = 0;
+        result.flushedOffset = 0;
+        // pages stay mapped until the ring is destroyed, Flush publishes what a frame wrote
+        result.mappedData = static_cast<uint8_t*>(result.buffer->Map(RHI::MapMode::write, 0, inSize));
+        Assert(result.mappedData != nullptr);
+        result.state = RHI::BufferState::staging;
+        return result;
+    }
+
+    UniformBufferRing::Page* UniformBufferRing::FindPage(RHI::Buffer* inBuffer)
+    {
+        for (auto& page : frames[currentFrame].pages) {
+            if (page.buffer.Get() == inBuffer) {
+                return &page;
+            }
+        }
+        return nullptr;
+    }
+
+    const UniformBufferRing::Page* UniformBufferRing::FindPage(RHI::Buffer* inBuffer) const
+    {
+        for (const auto& page : frames[currentFrame].pages) {
+            if (page.buffer.Get() == inBuffer) {
+                return &page;
+            }
+        }
+        return nullptr;
+    }
+}
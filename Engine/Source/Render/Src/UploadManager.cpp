@@ -0,0 +1,361 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <Common/Utility.h>
+#include <Render/UploadManager.h>
+
+namespace Render::Internal {
+    static std::unordered_map<RHI::Device*, Common::UniquePtr<UploadManager>>& GetUploadManagerMap()
+    {
+        static std::unordered_map<RHI::Device*, Common::UniquePtr<UploadManager>> map;
+        return map;
+    }
+
+    static void CopySubResourceRows(const std::vector<uint8_t>& inPixels, uint8_t* outData, const RHI::TextureSubResourceCopyFootprint& inFootprint, size_t inBytesPerPixel)
+    {
+        const auto srcRowPitch = inFootprint.extent.x * inBytesPerPixel;
+        const auto srcSlicePitch = srcRowPitch * inFootprint.extent.y;
+        Assert(inPixels.size() >= srcSlicePitch * inFootprint.extent.z);
+
+        if (srcRowPitch == inFootprint.rowPitch && srcSlicePitch == inFootprint.slicePitch) {
+            std::memcpy(outData, inPixels.data(), srcSlicePitch * inFootprint.extent.z);
+            return;
+        }
+        for (auto z = 0u; z < inFootprint.extent.z; z++) {
+            for (auto y = 0u; y < inFootprint.extent.y; y++) {
+                const auto* src = inPixels.data() + srcSlicePitch * z + srcRowPitch * y;
+                auto* dst = outData + inFootprint.slicePitch * z + inFootprint.rowPitch * y;
+                std::memcpy(dst, src, srcRowPitch);
+            }
+        }
+    }
+}
+
+namespace Render {
+    UploadStats::UploadStats()
+        : uploads(0)
+        , bytesUploaded(0)
+        , submissions(0)
+        , stalls(0)
+    {
+    }
+
+    UploadManager& UploadManager::Get(RHI::Device& device)
+    {
+        auto& map = Internal::GetUploadManagerMap();
+        if (!map.contains(&device)) {
+            map.emplace(std::make_pair(&device, Common::UniquePtr<UploadManager>(new UploadManager(device))));
+        }
+        return *map.at(&device);
+    }
+
+    void UploadManager::Destroy(RHI::Device& device)
+    {
+        Internal::GetUploadManagerMap().erase(&device);
+    }
+
+    UploadManager::UploadManager(RHI::Device& inDevice)
+        : device(inDevice)
+        , queueType(inDevice.GetQueueNum(RHI::QueueType::transfer) > 0 ? RHI::QueueType::transfer : RHI::QueueType::graphics)
+        , alignment(std::max<size_t>(inDevice.GetGpu().GetLimits().optimalBufferCopyOffsetAlignment, Internal::uploadRingMinAlignment))
+        , budget(0)
+        , ringHead(0)
+        , ringTail(0)
+        , ringUsed(0)
+        , nextTicket(1)
+        , submittedTicket(0)
+    {
+        Assert(Internal::uploadRingSize % alignment == 0);
+        ringBuffer = device.CreateBuffer(
+            RHI::BufferCreateInfo()
+                .SetSize(Internal::uploadRingSize)
+                .SetUsages(RHI::BufferUsageBits::copySrc | RHI::BufferUsageBits::mapWrite)
+                .SetInitialState(RHI::BufferState::staging)
+                .SetDebugName("uploadRing"));
+    }
+
+    UploadManager::~UploadManager()
+    {
+        for (const auto& submission : inFlightSubmissions) {
+            submission.fence->Wait();
+        }
+    }
+
+    UploadTicket UploadManager::UploadTexture(
+        RHI::Texture* inTexture,
+        RHI::TextureAspect inAspect,
+        RHI::TextureState inBeforeState,
+        RHI::TextureState inAfterState,
+        std::vector<std::vector<uint8_t>>&& inSubResourcePixels,
+        TextureSubResourceWriter&& inWriter)
+    {
+        Assert(inTexture != nullptr);
+        const auto& createInfo = inTexture->GetCreateInfo();
+        const auto arraySize = createInfo.type == RHI::TextureType::t3D ? 1u : createInfo.depthOrArraySize;
+        Assert(inSubResourcePixels.size() == createInfo.mipLevels * arraySize);
+
+        Request request {};
+        request.buffer = nullptr;
+        request.texture = inTexture;
+        request.textureBeforeState = inBeforeState;
+        request.textureAfterState = inAfterState;
+        request.subResources.reserve(inSubResourcePixels.size());
+        request.footprints.reserve(inSubResourcePixels.size());
+        request.subResourceOffsets.reserve(inSubResourcePixels.size());
+
+        size_t size = 0;
+        for (auto m = 0; m < createInfo.mipLevels; m++) {
+            for (auto a = 0u; a < arraySize; a++) {
+                const RHI::TextureSubResourceInfo subResource(m, a, inAspect);
+                const auto& footprint = request.footprints.emplace_back(device.GetTextureSubResourceCopyFootprint(*inTexture, subResource));
+                size = Common::AlignUp(size, alignment);
+                request.subResources.emplace_back(subResource);
+                request.subResourceOffsets.emplace_back(size);
+                size += footprint.totalBytes;
+            }
+        }
+        request.size = size;
+
+        request.writer = [
+            footprints = request.footprints,
+            offsets = request.subResourceOffsets,
+            bytesPerPixel = RHI::GetBytesPerPixel(createInfo.format),
+            subResourcePixels = std::move(inSubResourcePixels),
+            writer = std::move(inWriter)
+        ](uint8_t* outData) -> void {
+            for (size_t i = 0; i < subResourcePixels.size(); i++) {
+                if (writer) {
+                    writer(subResourcePixels[i], outData + offsets[i], footprints[i]);
+                } else {
+                    Internal::CopySubResourceRows(subResourcePixels[i], outData + offsets[i], footprints[i], bytesPerPixel);
+                }
+            }
+        };
+        return Enqueue(std::move(request));
+    }
+
+    RHI::Semaphore* UploadManager::Submit()
+    {
+        Reclaim(false);
+        if (pendingRequests.empty()) {
+            return nullptr;
+        }
+
+        Submission submission;
+        submission.cmdBuffer = device.AcquireTransientCommandBuffer(queueType);
+        submission.fence = device.CreateFence(false);
+        submission.semaphore = (device.CreateSemaphore)();
+        submission.ringBytes = 0;
+
+        uint8_t* ringData = nullptr;
+        uint64_t submittedBytes = 0;
+        const auto recorder = submission.cmdBuffer->Begin();
+        {
+            const auto copyRecorder = recorder->BeginCopyPass();
+            while (!pendingRequests.empty()) {
+                auto& request = pendingRequests.front();
+                if (budget != 0 && submittedBytes != 0 && submittedBytes + request.size > budget) {
+                    break;
+                }
+
+                RHI::Buffer* stagingBuffer;
+                size_t stagingOffset;
+                if (request.size > Internal::uploadRingSize) {
+                    stagingBuffer = submission.dedicatedBuffers.emplace_back(device.CreateBuffer(
+                        RHI::BufferCreateInfo()
+                            .SetSize(static_cast<uint32_t>(request.size))
+                            .SetUsages(RHI::BufferUsageBits::copySrc | RHI::BufferUsageBits::mapWrite)
+                            .SetInitialState(RHI::BufferState::staging)
+                            .SetDebugName("uploadDedicatedStaging"))).Get();
+                    stagingOffset = 0;
+                    request.writer(static_cast<uint8_t*>(stagingBuffer->Map(RHI::MapMode::write, 0, request.size)));
+                    stagingBuffer->Unmap();
+                } else {
+                    size_t consumed;
+                    if (!TryAllocate(Common::AlignUp(request.size, alignment), stagingOffset, consumed)) {
+                        // the ring is held by earlier submissions, stall on the oldest one, or leave the rest to the
+                        // next frame when only this submission occupies the ring
+                        if (inFlightSubmissions.empty()) {
+                            break;
+                        }
+                        Reclaim(true);
+                        stats.stalls++;
+                        continue;
+                    }
+                    if (ringData == nullptr) {
+                        ringData = static_cast<uint8_t*>(ringBuffer->Map(RHI::MapMode::write, 0, Internal::uploadRingSize));
+                    }
+                    submission.ringBytes += consumed;
+                    stagingBuffer = ringBuffer.Get();
+                    request.writer(ringData + stagingOffset);
+                }
+
+                RecordRequest(*copyRecorder, stagingBuffer, stagingOffset, request);
+                submission.dstResources.emplace_back(request.buffer != nullptr ? static_cast<const void*>(request.buffer) : static_cast<const void*>(request.texture));
+                submittedBytes += request.size;
+                submittedTicket = request.ticket;
+                stats.uploads++;
+                pendingRequests.pop_front();
+            }
+            copyRecorder->EndPass();
+        }
+        recorder->End();
+
+        if (ringData != nullptr) {
+            // unmap flushes the written ranges of non coherent memory before the copies read them
+            ringBuffer->Unmap();
+        }
+        submission.ringEnd = ringHead;
+
+        if (submittedBytes == 0) {
+            return nullptr;
+        }
+        device.GetQueue(queueType, 0)->Submit(
+            submission.cmdBuffer,
+            RHI::QueueSubmitInfo()
+                .AddSignalSemaphore(submission.semaphore.Get())
+                .SetSignalFence(submission.fence.Get()));
+        stats.bytesUploaded += submittedBytes;
+        stats.submissions++;
+
+        // the semaphore is released on a later Submit() once the fence signals, by then the frame waiting on it is done
+        auto* semaphore = submission.semaphore.Get();
+        inFlightSubmissions.emplace_back(std::move(submission));
+        return semaphore;
+    }
+
+    bool UploadManager::IsSubmitted(UploadTicket inTicket) const
+    {
+        return inTicket <= submittedTicket;
+    }
+
+    void UploadManager::Discard(RHI::Buffer* inBuffer)
+    {
+        DiscardInternal(inBuffer);
+    }
+
+    void UploadManager::Discard(RHI::Texture* inTexture)
+    {
+        DiscardInternal(inTexture);
+    }
+
+    void UploadManager::SetBudget(uint64_t inBytes)
+    {
+        budget = inBytes;
+    }
+
+    size_t UploadManager::PendingCount() const
+    {
+        return pendingRequests.size();
+    }
+
+    const UploadStats& UploadManager::GetStats() const
+    {
+        return stats;
+    }
+
+    void UploadManager::ResetCounters()
+    {
+        stats = UploadStats();
+    }
+
+    UploadTicket UploadManager::Enqueue(Request&& inRequest)
+    {
+        inRequest.ticket = nextTicket++;
+        const auto ticket = inRequest.ticket;
+        pendingRequests.emplace_back(std::move(inRequest));
+        return ticket;
+    }
+
+    void UploadManager::DiscardInternal(const void* inResource)
+    {
+        std::erase_if(pendingRequests, [&](const Request& inRequest) -> bool {
+            return inRequest.buffer == inResource || inRequest.texture == inResource;
+        });
+        for (const auto& submission : inFlightSubmissions) {
+            if (std::ranges::find(submission.dstResources, inResource) != submission.dstResources.end()) {
+                submission.fence->Wait();
+            }
+        }
+    }
+
+    void UploadManager::Reclaim(bool inWaitOldest)
+    {
+        if (inWaitOldest && !inFlightSubmissions.empty()) {
+            inFlightSubmissions.front().fence->Wait();
+        }
+        while (!inFlightSubmissions.empty()) {
+            auto& submission = inFlightSubmissions.front();
+            if (!inWaitOldest && !submission.fence->IsSignaled()) {
+                break;
+            }
+            inWaitOldest = false;
+            if (submission.ringBytes > 0) {
+                ringTail = submission.ringEnd;
+                ringUsed -= submission.ringBytes;
+            }
+            inFlightSubmissions.pop_front();
+        }
+    }
+
+    bool UploadManager::TryAllocate(size_t inSize, size_t& outOffset, size_t& outConsumed)
+    {
+        if (ringUsed == 0) {
+            ringHead = 0;
+            ringTail = 0;
+        }
+
+        if (ringUsed == 0 || ringHead > ringTail) {
+            if (ringHead + inSize <= Internal::uploadRingSize) {
+                outOffset = ringHead;
+                outConsumed = inSize;
+            } else if (inSize <= ringTail) {
+                // skip the tail end of the ring and wrap around, the skipped bytes are freed with this allocation
+                outOffset = 0;
+                outConsumed = Internal::uploadRingSize - ringHead + inSize;
+            } else {
+                return false;
+            }
+        } else {
+            if (ringHead + inSize > ringTail) {
+                return false;
+            }
+            outOffset = ringHead;
+            outConsumed = inSize;
+        }
+
+        ringHead = outOffset + inSize;
+        ringUsed += outConsumed;
+        return true;
+    }
+
+    void UploadManager::RecordRequest(RHI::CopyPassCommandRecorder& inRecorder, RHI::Buffer* inStagingBuffer, size_t inStagingOffset, const Request& inRequest) const
+    {
+        if (inRequest.buffer != nullptr) {
+            inRecorder.ResourceBarrier(RHI::Barrier::Transition(inRequest.buffer, inRequest.bufferBeforeState, RHI::BufferState::copyDst));
+            inRecorder.CopyBufferToBuffer(inStagingBuffer, inRequest.buffer, RHI::BufferCopyInfo(inStagingOffset, inRequest.bufferDstOffset, inRequest.size));
+            inRecorder.ResourceBarrier(RHI::Barrier::Transition(inRequest.buffer, RHI::BufferState::copyDst, inRequest.bufferAfterState));
+            return;
+        }
+
+        inRecorder.ResourceBarrier(RHI::Barrier::Transition(inRequest.texture, inRequest.textureBeforeState, RHI::TextureState::copyDst));
+        for (size_t i = 0; i < inRequest.subResources.size(); i++) {
+            const auto& footprint = inRequest.footprints[i];
+            inRecorder.CopyBufferToTexture(
+                inStagingBuffer,
+                inRequest.texture,
+                RHI::BufferTextureCopyInfo()
+                    .SetBufferOffset(inStagingOffset + inRequest.subResourceOffsets[i])
+                    .SetBufferRowPitch(footprint.rowPitch)
+                    .SetBufferSlicePitch(footprint.slicePitch)
+                    .SetTextureSubResource(inRequest.subResources[i])
+                    .SetTextureOrigin({ 0, 0, 0 })
+                    .SetCopyRegion(footprint.extent));
+        }
+        inRecorder.ResourceBarrier(RHI::Barrier::Transition(inRequest.texture, RHI::TextureState::copyDst, inRequest.textureAfterState));
+    }
+}
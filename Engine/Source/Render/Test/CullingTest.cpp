@@ -0,0 +1,68 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <random>
+#include <vector>
+
+#include <Test/Test.h>
+#include <Common/Math/Projection.h>
+#include <Common/Math/View.h>
+#include <Render/Culling.h>
+
+using namespace Render;
+
+TEST(CullingTest, IdentityClipVolume)
+{
+    // with an identity world to clip matrix the frustum is the box -1 <= x, y <= 1, 0 <= z <= 1
+    const Frustum frustum = Frustum::FromWorldToClip(Common::FMat4x4Consts::identity);
+
+    const std::vector<Common::FSphere> spheres = {
+        { 0.0f, 0.0f, 0.5f, 0.1f },
+        { 3.0f, 0.0f, 0.5f, 0.5f },
+        { 1.2f, 0.0f, 0.5f, 0.5f },
+        { 0.0f, -3.0f, 0.5f, 1.0f },
+        { 0.0f, 0.0f, -0.5f, 0.6f },
+        { 0.0f, 0.0f, 2.0f, 0.5f }
+    };
+    VisibilityMask mask;
+    FrustumCulling::Cull(frustum, spheres, mask);
+
+    ASSERT_EQ(mask.Size(), spheres.size());
+    EXPECT_TRUE(mask.Test(0));
+    EXPECT_FALSE(mask.Test(1));
+    EXPECT_TRUE(mask.Test(2));
+    EXPECT_FALSE(mask.Test(3));
+    EXPECT_TRUE(mask.Test(4));
+    EXPECT_FALSE(mask.Test(5));
+    EXPECT_EQ(mask.VisibleNum(), 3);
+}
+
+TEST(CullingTest, SimdKernelMatchesScalarIntersects)
+{
+    const Common::FMat4x4 projection = Common::FReversedZPerspectiveProjection(90.0f, 1920.0f, 1080.0f, 0.1f, 1000.0f).GetProjectionMatrix();
+    const Common::FMat4x4 view = Common::FViewTransform::LookAt(Common::FVec3(0.0f, 0.0f, 0.0f), Common::FVec3(1.0f, 1.0f, 0.0f)).GetViewMatrix();
+    const Frustum frustum = Frustum::FromWorldToClip(projection * view);
+
+    // an odd count exercises the scalar tail and the 64 bit word boundaries
+    std::mt19937 random(42); // NOLINT
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> radius(0.0f, 50.0f);
+    std::vector<Common::FSphere> spheres(1003);
+    for (auto& sphere : spheres) {
+        sphere = Common::FSphere(position(random), position(random), position(random), radius(random));
+    }
+
+    VisibilityMask mask;
+    FrustumCulling::Cull(frustum, spheres, mask);
+
+    size_t visibleNum = 0;
+    for (size_t i = 0; i < spheres.size(); i++) {
+        const bool visible = frustum.Intersects(spheres[i]);
+        EXPECT_EQ(mask.Test(i), visible);
+        visibleNum += visible ? 1 : 0;
+    }
+    EXPECT_EQ(mask.VisibleNum(), visibleNum);
+    EXPECT_GT(visibleNum, 0);
+    EXPECT_LT(visibleNum, spheres.size());
+}
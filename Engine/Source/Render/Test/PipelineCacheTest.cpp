@@ -0,0 +1,125 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <filesystem>
+
+#include <Test/Test.h>
+
+#include <Common/Serialization.h>
+#include <Core/Thread.h>
+#include <Render/RenderCache.h>
+
+using namespace Render;
+
+struct PipelineCacheTest : testing::Test {
+    void SetUp() override
+    {
+        instance = RHI::Instance::GetByType(RHI::RHIType::dummy);
+
+        device = instance->GetGpu(0)->RequestDevice(
+            RHI::DeviceCreateInfo()
+                .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::graphics, 1)));
+
+        file = "../Test/Generated/Render/PipelineCache/Dummy.bin";
+        std::filesystem::remove(file.String());
+    }
+
+    void TearDown() override
+    {
+        DestroyDeviceResources(*device);
+    }
+
+    // a file as a previous session saved it, with one compute pipeline record whose shader never lands
+    void WriteFileWithUnresolvedRecord(uint64_t inRecordSize = sizeof(bool) * 2 + sizeof(uint64_t) * 2) const
+    {
+        std::vector<uint8_t> record;
+        {
+            Common::MemorySerializeStream stream(record);
+            stream.Write<bool>(false);
+            stream.Write<bool>(true);
+            stream.Write<uint64_t>(1);
+            stream.Write<uint64_t>(2);
+        }
+
+        const auto property = device->GetGpu().GetProperty();
+        Common::BinaryFileSerializeStream stream(file.String());
+        stream.Write<uint32_t>(Internal::pipelineCacheFormatVersion);
+        stream.Write<uint8_t>(static_cast<uint8_t>(device->GetGpu().GetInstance().GetRHIType()));
+        stream.Write<uint32_t>(property.vendorId);
+        stream.Write<uint32_t>(property.deviceId);
+        stream.Write<uint32_t>(property.driverVersion);
+        stream.Write<uint64_t>(0);
+        stream.Write<uint64_t>(1);
+        stream.Write<uint64_t>(3);
+        stream.Write<uint64_t>(inRecordSize);
+        stream.Write<uint8_t>(record.data(), record.size());
+    }
+
+    RHI::Instance* instance;
+    Common::UniquePtr<RHI::Device> device;
+    Common::Path file;
+};
+
+TEST_F(PipelineCacheTest, SaveAndLoadTest)
+{
+    ASSERT_FALSE(PipelineCache::Get(*device).Load(file));
+
+    PipelineCache::Get(*device).Save(file);
+    ASSERT_TRUE(file.Exists());
+
+    PipelineCache::Destroy(*device);
+    auto& pipelineCache = PipelineCache::Get(*device);
+    ASSERT_TRUE(pipelineCache.Load(file));
+    ASSERT_EQ(pipelineCache.PendingPrecacheCount(), 0);
+}
+
+TEST_F(PipelineCacheTest, IncompatibleFileTest)
+{
+    {
+        Common::BinaryFileSerializeStream stream(file.String());
+        Common::Serialize(stream, std::string("not a pipeline cache"));
+    }
+    ASSERT_FALSE(PipelineCache::Get(*device).Load(file));
+}
+
+TEST_F(PipelineCacheTest, CorruptFileTest)
+{
+    WriteFileWithUnresolvedRecord();
+    ASSERT_TRUE(PipelineCache::Get(*device).Load(file));
+
+    PipelineCache::Destroy(*device);
+    std::filesystem::resize_file(file.String(), std::filesystem::file_size(file.String()) - 4);
+    ASSERT_FALSE(PipelineCache::Get(*device).Load(file));
+
+    PipelineCache::Destroy(*device);
+    WriteFileWithUnresolvedRecord(UINT64_MAX / 2);
+    ASSERT_FALSE(PipelineCache::Get(*device).Load(file));
+    ASSERT_EQ(PipelineCache::Get(*device).PendingPrecacheCount(), 0);
+}
+
+TEST_F(PipelineCacheTest, UnresolvedPrecacheTest)
+{
+    Core::ScopedThreadTag threadTag(Core::ThreadTag::render);
+
+    // records still waiting for their shaders at session end are not saved again
+    WriteFileWithUnresolvedRecord();
+    ASSERT_TRUE(PipelineCache::Get(*device).Load(file));
+    ASSERT_EQ(PipelineCache::Get(*device).PendingPrecacheCount(), 1);
+    PipelineCache::Get(*device).Save(file);
+    PipelineCache::Destroy(*device);
+    ASSERT_TRUE(PipelineCache::Get(*device).Load(file));
+    ASSERT_EQ(PipelineCache::Get(*device).PendingPrecacheCount(), 0);
+
+    // and are dropped once they waited too many frames
+    PipelineCache::Destroy(*device);
+    WriteFileWithUnresolvedRecord();
+    auto& pipelineCache = PipelineCache::Get(*device);
+    ASSERT_TRUE(pipelineCache.Load(file));
+    for (auto i = 1; i < Internal::pipelinePrecacheMaxPendingFrames; i++) {
+        pipelineCache.WarmUp();
+    }
+    ASSERT_EQ(pipelineCache.PendingPrecacheCount(), 1);
+    pipelineCache.WarmUp();
+    ASSERT_EQ(pipelineCache.PendingPrecacheCount(), 0);
+}
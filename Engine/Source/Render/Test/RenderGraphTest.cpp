@@ -1,11 +1,16 @@
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstring>
+#include <tuple>
+#include <vector>
 
 #include <Test/Test.h>
 
 #include <Render/RenderCache.h>
 #include <Render/RenderGraph.h>
 #include <Render/RenderThread.h>
+#include <Render/UniformBufferRing.h>
 
 namespace Render {
     TEST(RenderGraphStateTest, MapsIndependentDepthStencilAccess)
@@ -71,6 +76,83 @@ namespace Render {
         builder.GetRHI(buffer)->Unmap();
     }
 
+    TEST_F(RenderGraphTest, AllocatesUniformsFromSharedRingPage)
+    {
+        RGBuilder builder(*device);
+        const uint32_t first = 1;
+        const std::array<float, 3> second = { 2.0f, 3.0f, 4.0f };
+        auto* firstView = builder.AllocateUniformBuffer(first);
+        auto* secondView = builder.AllocateUniformBuffer(second);
+        builder.Execute({});
+
+        const size_t alignment = UniformBufferRing::Get(*device).GetAlignment();
+        ASSERT_EQ(firstView->GetBuffer(), secondView->GetBuffer());
+        ASSERT_EQ(firstView->GetDesc().offsetInBytes % alignment, 0);
+        ASSERT_EQ(secondView->GetDesc().offsetInBytes, firstView->GetDesc().offsetInBytes + alignment);
+        ASSERT_EQ(secondView->GetDesc().sizeInBytes, alignment);
+        ASSERT_EQ(BufferPool::Get(*device).Size(), 0);
+
+        auto* rhiBuffer = builder.GetRHI(secondView->GetBuffer());
+        auto* const mappedData = static_cast<const uint8_t*>(rhiBuffer->Map(RHI::MapMode::read, 0, rhiBuffer->GetCreateInfo().size));
+        ASSERT_EQ(std::memcmp(mappedData + firstView->GetDesc().offsetInBytes, &first, sizeof(first)), 0);
+        ASSERT_EQ(std::memcmp(mappedData + secondView->GetDesc().offsetInBytes, second.data(), sizeof(second)), 0);
+        rhiBuffer->Unmap();
+    }
+
+    TEST_F(RenderGraphTest, ReusesMappedUniformRingPagesAndViews)
+    {
+        auto& uniformBufferRing = UniformBufferRing::Get(*device);
+        uniformBufferRing.Recycle();
+        const auto first = uniformBufferRing.Allocate(16);
+        uniformBufferRing.Flush();
+
+        // the same frame slot replays the same allocations on the page that stayed mapped
+        uniformBufferRing.Recycle();
+        const auto second = uniformBufferRing.Allocate(16);
+        ASSERT_EQ(first.buffer, second.buffer);
+        ASSERT_EQ(first.offset, second.offset);
+        ASSERT_EQ(first.mappedData, second.mappedData);
+        ASSERT_TRUE(uniformBufferRing.Contains(first.buffer));
+
+        const RHI::BufferViewCreateInfo viewCreateInfo(RHI::BufferViewType::uniformBinding, static_cast<uint32_t>(first.size), static_cast<uint32_t>(first.offset));
+        auto* view = uniformBufferRing.GetView(first.buffer, viewCreateInfo);
+        ASSERT_EQ(view, uniformBufferRing.GetView(second.buffer, viewCreateInfo));
+        uniformBufferRing.Flush();
+    }
+
+    TEST_F(RenderGraphTest, KeepsUniformRingBindGroupsUsedEveryTurn)
+    {
+        const RHI::ResourceBinding binding(RHI::BindingType::uniformBuffer, RHI::HlslBinding(RHI::HlslBindingRangeType::constantBuffer, 0));
+        const auto layout = device->CreateBindGroupLayout(RHI::BindGroupLayoutCreateInfo(0).AddEntry(RHI::BindGroupLayoutEntry(binding, RHI::ShaderStageBits::sVertex | RHI::ShaderStageBits::sPixel)));
+        const auto makeCreateInfo = [&](RHI::BufferView* inView, RHI::ShaderStageFlags inShaderVisibility) -> RHI::BindGroupCreateInfo {
+            RHI::BindGroupCreateInfo createInfo(layout.Get());
+            createInfo.AddEntry(RHI::BindGroupEntry(binding, inShaderVisibility, inView));
+            return createInfo;
+        };
+
+        auto& uniformBufferRing = UniformBufferRing::Get(*device);
+        uniformBufferRing.Recycle();
+        const auto allocation = uniformBufferRing.Allocate(16);
+        const RHI::BufferViewCreateInfo viewCreateInfo(RHI::BufferViewType::uniformBinding, static_cast<uint32_t>(allocation.size), static_cast<uint32_t>(allocation.offset));
+        auto* view = uniformBufferRing.GetView(allocation.buffer, viewCreateInfo);
+        auto* bindGroup = uniformBufferRing.GetBindGroup(makeCreateInfo(view, RHI::ShaderStageBits::sVertex));
+        ASSERT_EQ(bindGroup, uniformBufferRing.GetBindGroup(makeCreateInfo(view, RHI::ShaderStageBits::sVertex)));
+        // the whole key is compared, the same view with another visibility is another bind group
+        ASSERT_NE(bindGroup, uniformBufferRing.GetBindGroup(makeCreateInfo(view, RHI::ShaderStageBits::sPixel)));
+        uniformBufferRing.Flush();
+
+        // the frame slot comes back after a full turn and still finds what it used last turn
+        for (auto i = 0; i < Internal::uniformBufferRingFrameLatency; i++) {
+            Core::ThreadContext::IncFrameNumber();
+            uniformBufferRing.Recycle();
+        }
+        ASSERT_EQ(uniformBufferRing.Allocate(16).buffer, allocation.buffer);
+        ASSERT_EQ(uniformBufferRing.GetView(allocation.buffer, viewCreateInfo), view);
+        ASSERT_EQ(uniformBufferRing.GetBindGroup(makeCreateInfo(view, RHI::ShaderStageBits::sVertex)), bindGroup);
+        uniformBufferRing.Flush();
+        UniformBufferRing::Destroy(*device);
+    }
+
     TEST_F(RenderGraphTest, KeepsAllResourcesRequiredByLivePass)
     {
         RGBuilder builder(*device);
@@ -189,4 +271,150 @@ namespace Render {
         ASSERT_TRUE(producerExecuted);
         ASSERT_TRUE(consumerExecuted);
     }
+
+    TEST_F(RenderGraphTest, AliasesTransientsWithDisjointLifetimes)
+    {
+        RGBuilder builder(*device);
+        const RHI::BufferUsageFlags usages = RHI::BufferUsageBits::copySrc | RHI::BufferUsageBits::copyDst;
+        auto* result = builder.CreateBuffer(RGBufferDesc(64, RHI::BufferUsageBits::copyDst, RHI::BufferState::copyDst));
+        auto* first = builder.CreateBuffer(RGBufferDesc(256, usages, RHI::BufferState::copyDst));
+        auto* second = builder.CreateBuffer(RGBufferDesc(256, usages, RHI::BufferState::copyDst));
+        auto* third = builder.CreateBuffer(RGBufferDesc(512, usages, RHI::BufferState::copyDst));
+        result->MaskAsUsed();
+
+        // first -> second -> third -> result, first is dead before third is written
+        std::array<RHI::Buffer*, 3> rhiBuffers {};
+        const std::array<std::pair<RGBufferRef, RGBufferRef>, 4> copies = {
+            std::make_pair(nullptr, first),
+            std::make_pair(first, second),
+            std::make_pair(second, third),
+            std::make_pair(third, result)
+        };
+        for (auto i = 0; i < copies.size(); i++) {
+            const auto [src, dst] = copies[i];
+            RGCopyPassDesc passDesc;
+            if (src != nullptr) {
+                passDesc.copySrcs = { src };
+            }
+            passDesc.copyDsts = { dst };
+            builder.AddCopyPass(
+                "Copy",
+                passDesc,
+                [&rhiBuffers, i, dst](const RGBuilder& rg, RHI::CopyPassCommandRecorder&) -> void {
+                    if (i < rhiBuffers.size()) {
+                        rhiBuffers[i] = rg.GetRHI(dst);
+                    }
+                });
+        }
+        builder.Execute({});
+
+        ASSERT_EQ(rhiBuffers[0], rhiBuffers[2]);
+        ASSERT_NE(rhiBuffers[0], rhiBuffers[1]);
+        ASSERT_EQ(rhiBuffers[2]->GetCreateInfo().size, 512);
+
+        const auto stats = builder.GetTransientMemoryStats();
+        ASSERT_EQ(stats.transientResourceNum, 4);
+        ASSERT_EQ(stats.physicalResourceNum, 3);
+        ASSERT_EQ(stats.bytesWithoutAliasing, 64 + 256 + 256 + 512);
+        ASSERT_EQ(stats.bytesAllocated, 64 + 512 + 256);
+        ASSERT_EQ(BufferPool::Get(*device).Size(), 3);
+    }
+
+    TEST_F(RenderGraphTest, ReusesCompilationOfSameTopology)
+    {
+        auto& compileCache = RGCompileCache::Get(*device);
+        const auto buildAndExecute = [this](uint32_t inSize, bool inRequireSecond) -> std::pair<RHI::Buffer*, bool> {
+            RGBuilder builder(*device);
+            auto* first = builder.CreateBuffer(RGBufferDesc(inSize, RHI::BufferUsageBits::copyDst, RHI::BufferState::copyDst));
+            auto* second = builder.CreateBuffer(RGBufferDesc(inSize, RHI::BufferUsageBits::copyDst, RHI::BufferState::copyDst));
+            first->MaskAsUsed();
+            if (inRequireSecond) {
+                second->MaskAsUsed();
+            }
+
+            bool secondExecuted = false;
+            RGCopyPassDesc firstDesc;
+            firstDesc.copyDsts = { first };
+            builder.AddCopyPass("First", firstDesc, [](const RGBuilder&, RHI::CopyPassCommandRecorder&) -> void {});
+            RGCopyPassDesc secondDesc;
+            secondDesc.copyDsts = { second };
+            builder.AddCopyPass("Second", secondDesc, [&secondExecuted](const RGBuilder&, RHI::CopyPassCommandRecorder&) -> void { secondExecuted = true; });
+            builder.Execute({});
+            return { builder.GetRHI(first), secondExecuted };
+        };
+
+        ASSERT_FALSE(buildAndExecute(16, false).second);
+        ASSERT_EQ(compileCache.GetStats().misses, 1);
+        ASSERT_EQ(compileCache.GetStats().hits, 0);
+
+        // the second pass stays culled when its compilation is taken from the cache
+        const auto [buffer, secondExecuted] = buildAndExecute(16, false);
+        ASSERT_NE(buffer, nullptr);
+        ASSERT_FALSE(secondExecuted);
+        ASSERT_EQ(compileCache.GetStats().hits, 1);
+        ASSERT_EQ(compileCache.Size(), 1);
+
+        ASSERT_TRUE(buildAndExecute(16, true).second);
+        ASSERT_EQ(buildAndExecute(32, false).first->GetCreateInfo().size, 32);
+        ASSERT_EQ(compileCache.GetStats().misses, 3);
+        ASSERT_EQ(compileCache.Size(), 3);
+    }
+
+    TEST_F(RenderGraphTest, RecordsParallelRasterPassDrawRanges)
+    {
+        static constexpr size_t drawNum = 5000;
+
+        const auto recordDraws = [this](bool inParallelRecord) -> std::tuple<uint32_t, uint32_t, uint32_t, uint32_t> {
+            RGBuilder builder(*device, inParallelRecord);
+            auto* texture = builder.CreateTexture(
+                RGTextureDesc()
+                    .SetType(RHI::TextureType::t2D)
+                    .SetWidth(4)
+                    .SetHeight(4)
+                    .SetDepthOrArraySize(1)
+                    .SetFormat(RHI::PixelFormat::rgba8Unorm)
+                    .SetUsages(RHI::TextureUsageBits::renderAttachment)
+                    .SetMipLevels(1)
+                    .SetSamples(1)
+                    .SetInitialState(RHI::TextureState::renderTarget));
+            auto* view = builder.CreateTextureView(
+                texture,
+                RGTextureViewDesc(RHI::TextureViewType::colorAttachment, RHI::TextureViewDimension::tv2D));
+            texture->MaskAsUsed();
+
+            std::vector<std::atomic<uint32_t>> drawCounts(drawNum);
+            std::atomic<uint32_t> rangeNum = 0;
+            uint32_t preExecuteNum = 0;
+            uint32_t postExecuteNum = 0;
+            builder.AddParallelRasterPass(
+                "ParallelDraws",
+                RGRasterPassDesc().AddColorAttachment(RGColorAttachment(view, RHI::LoadOp::clear, RHI::StoreOp::store)),
+                {},
+                drawNum,
+                [&](const RGBuilder&, RHI::RasterPassCommandRecorder&, size_t inDrawBegin, size_t inDrawEnd) -> void {
+                    rangeNum++;
+                    for (auto i = inDrawBegin; i < inDrawEnd; i++) {
+                        drawCounts[i]++;
+                    }
+                },
+                [&preExecuteNum](const RGBuilder&, RHI::CommandRecorder&) -> void { preExecuteNum++; },
+                [&postExecuteNum](const RGBuilder&, RHI::CommandRecorder&) -> void { postExecuteNum++; });
+            builder.Execute({});
+
+            const auto drawnOnce = std::ranges::count_if(drawCounts, [](const auto& count) -> bool { return count.load() == 1; });
+            return { static_cast<uint32_t>(drawnOnce), rangeNum.load(), preExecuteNum, postExecuteNum };
+        };
+
+        const auto [serialDrawnOnce, serialRangeNum, serialPreExecuteNum, serialPostExecuteNum] = recordDraws(false);
+        ASSERT_EQ(serialDrawnOnce, drawNum);
+        ASSERT_EQ(serialRangeNum, 1);
+        ASSERT_EQ(serialPreExecuteNum, 1);
+        ASSERT_EQ(serialPostExecuteNum, 1);
+
+        const auto [parallelDrawnOnce, parallelRangeNum, parallelPreExecuteNum, parallelPostExecuteNum] = recordDraws(true);
+        ASSERT_EQ(parallelDrawnOnce, drawNum);
+        ASSERT_EQ(parallelRangeNum, drawNum / Internal::rgMinDrawsPerRecordTask);
+        ASSERT_EQ(parallelPreExecuteNum, 1);
+        ASSERT_EQ(parallelPostExecuteNum, 1);
+    }
 }
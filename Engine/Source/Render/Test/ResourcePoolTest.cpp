@@ -79,3 +79,72 @@ TEST_F(ResourcePoolTest, BasicTest)
     texturePool.Forfeit();
     ASSERT_EQ(texturePool.Size(), 1);
 }
+
+TEST_F(ResourcePoolTest, StatsTest)
+{
+    auto& bufferPool = BufferPool::Get(*device);
+    const PooledBufferDesc bufferDesc(1024, RHI::BufferUsageBits::uniform | RHI::BufferUsageBits::mapWrite, RHI::BufferState::staging, "a");
+
+    PooledBufferRef b1 = bufferPool.Allocate(bufferDesc);
+    ASSERT_EQ(bufferPool.GetStats().misses, 1);
+    ASSERT_EQ(bufferPool.GetStats().hits, 0);
+    ASSERT_EQ(bufferPool.GetStats().bytesResident, 1024);
+
+    // debug name is not a part of descriptor identity
+    b1.Reset();
+    PooledBufferDesc renamedDesc = bufferDesc;
+    renamedDesc.debugName = "b";
+    const PooledBufferRef b2 = bufferPool.Allocate(renamedDesc);
+    ASSERT_EQ(bufferPool.GetStats().hits, 1);
+    ASSERT_EQ(bufferPool.Size(), 1);
+
+    const PooledBufferRef b3 = bufferPool.Allocate(PooledBufferDesc(bufferDesc).SetSize(2048));
+    ASSERT_EQ(bufferPool.GetStats().misses, 2);
+    ASSERT_EQ(bufferPool.GetStats().bytesResident, 3072);
+    ASSERT_EQ(bufferPool.Size(), 2);
+
+    bufferPool.ResetCounters();
+    ASSERT_EQ(bufferPool.GetStats().hits, 0);
+    ASSERT_EQ(bufferPool.GetStats().misses, 0);
+    ASSERT_EQ(bufferPool.GetStats().bytesResident, 3072);
+}
+
+TEST_F(ResourcePoolTest, BudgetEvictionTest)
+{
+    auto& bufferPool = BufferPool::Get(*device);
+    PooledBufferDesc bufferDesc(1024, RHI::BufferUsageBits::storage, RHI::BufferState::undefined);
+
+    PooledBufferRef b1 = bufferPool.Allocate(bufferDesc);
+    Core::ThreadContext::IncFrameNumber();
+    PooledBufferRef b2 = bufferPool.Allocate(bufferDesc.SetSize(2048));
+    PooledBufferRef b3 = bufferPool.Allocate(bufferDesc.SetSize(4096));
+    ASSERT_EQ(bufferPool.GetStats().bytesResident, 7168);
+
+    // referenced resources are never evicted, even if the pool stays over budget
+    b1.Reset();
+    bufferPool.SetBudget(1024);
+    Core::ThreadContext::IncFrameNumber();
+    bufferPool.Forfeit();
+    ASSERT_EQ(bufferPool.Size(), 2);
+    ASSERT_EQ(bufferPool.GetStats().bytesResident, 6144);
+    ASSERT_EQ(bufferPool.GetStats().bytesEvicted, 1024);
+
+    b2.Reset();
+    bufferPool.SetBudget(0);
+    Core::ThreadContext::IncFrameNumber();
+    bufferPool.Forfeit();
+    ASSERT_EQ(bufferPool.Size(), 2);
+
+    // the least recently used resource goes first, eviction stops once resident bytes fit into the budget
+    b3.Reset();
+    bufferPool.SetBudget(4096);
+    Core::ThreadContext::IncFrameNumber();
+    bufferPool.Forfeit();
+    ASSERT_EQ(bufferPool.Size(), 1);
+    ASSERT_EQ(bufferPool.GetStats().bytesResident, 4096);
+    ASSERT_EQ(bufferPool.GetStats().bytesEvicted, 3072);
+
+    const PooledBufferRef b4 = bufferPool.Allocate(bufferDesc.SetSize(4096));
+    ASSERT_EQ(bufferPool.GetStats().hits, 1);
+    ASSERT_EQ(bufferPool.Size(), 1);
+}
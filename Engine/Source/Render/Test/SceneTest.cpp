@@ -3,6 +3,7 @@
 //
 
 #include <utility>
+#include <vector>
 
 #include <Test/Test.h>
 #include <Core/Thread.h>
@@ -29,11 +30,123 @@ TEST(SceneTest, StoresConcreteProxyTypesIndependently)
     scene.Add<SpotLightSceneProxy>(entity, std::move(spotLight));
     scene.Add<StaticPrimitiveSceneProxy>(entity, std::move(staticPrimitive));
 
-    EXPECT_EQ(scene.All<DirectionalLightSceneProxy>().size(), 1);
-    EXPECT_EQ(scene.All<PointLightSceneProxy>().size(), 1);
-    EXPECT_EQ(scene.All<SpotLightSceneProxy>().size(), 1);
-    EXPECT_EQ(scene.All<StaticPrimitiveSceneProxy>().size(), 1);
+    EXPECT_EQ(scene.All<DirectionalLightSceneProxy>().Size(), 1);
+    EXPECT_EQ(scene.All<PointLightSceneProxy>().Size(), 1);
+    EXPECT_EQ(scene.All<SpotLightSceneProxy>().Size(), 1);
+    EXPECT_EQ(scene.All<StaticPrimitiveSceneProxy>().Size(), 1);
     EXPECT_EQ(scene.Get<DirectionalLightSceneProxy>(entity).intensity, 1.0f);
     EXPECT_EQ(scene.Get<PointLightSceneProxy>(entity).intensity, 2.0f);
     EXPECT_EQ(scene.Get<SpotLightSceneProxy>(entity).intensity, 3.0f);
 }
+
+TEST(SceneTest, RemoveKeepsProxiesDense)
+{
+    Core::ScopedThreadTag threadTag(Core::ThreadTag::render);
+    Scene scene;
+    for (Scene::EntityId entity = 1; entity <= 4; entity++) {
+        PointLightSceneProxy pointLight;
+        pointLight.intensity = static_cast<float>(entity);
+        scene.Add<PointLightSceneProxy>(entity, std::move(pointLight));
+    }
+
+    scene.Remove<PointLightSceneProxy>(2);
+    scene.Remove<PointLightSceneProxy>(5);
+    const auto& pointLights = scene.All<PointLightSceneProxy>();
+    EXPECT_EQ(pointLights.Size(), 3);
+    EXPECT_FALSE(pointLights.Contains(2));
+    EXPECT_EQ(scene.Get<PointLightSceneProxy>(1).intensity, 1.0f);
+    EXPECT_EQ(scene.Get<PointLightSceneProxy>(3).intensity, 3.0f);
+    EXPECT_EQ(scene.Get<PointLightSceneProxy>(4).intensity, 4.0f);
+
+    float intensitySum = 0.0f;
+    for (const float intensity : pointLights.Column<&PointLightSceneProxy::intensity>()) {
+        intensitySum += intensity;
+    }
+    EXPECT_EQ(intensitySum, 8.0f);
+}
+
+TEST(SceneTest, UpdateTransformsSkipsMissingProxies)
+{
+    Core::ScopedThreadTag threadTag(Core::ThreadTag::render);
+    Scene scene;
+    scene.Add<StaticPrimitiveSceneProxy>(1, StaticPrimitiveSceneProxy());
+    scene.Add<StaticPrimitiveSceneProxy>(3, StaticPrimitiveSceneProxy());
+
+    const std::vector<Scene::EntityId> entities = { 3, 2, 1 };
+    std::vector<Common::FMat4x4> localToWorlds(entities.size(), Common::FMat4x4Consts::identity);
+    localToWorlds[0].At(0, 3) = 3.0f;
+    localToWorlds[2].At(0, 3) = 1.0f;
+    scene.UpdateTransforms<StaticPrimitiveSceneProxy>(entities.data(), localToWorlds.data(), entities.size());
+
+    EXPECT_EQ(scene.Get<StaticPrimitiveSceneProxy>(1).localToWorld.At(0, 3), 1.0f);
+    EXPECT_EQ(scene.Get<StaticPrimitiveSceneProxy>(3).localToWorld.At(0, 3), 3.0f);
+}
+
+TEST(SceneTest, HandlesSurviveSwapRemoveAndDetectReuse)
+{
+    Core::ScopedThreadTag threadTag(Core::ThreadTag::render);
+    Scene scene;
+    std::vector<SceneProxyHandle> handles;
+    for (Scene::EntityId entity = 0; entity < 4; entity++) {
+        SpotLightSceneProxy spotLight;
+        spotLight.intensity = static_cast<float>(entity);
+        handles.emplace_back(scene.Add<SpotLightSceneProxy>(entity, std::move(spotLight)));
+    }
+
+    const auto& spotLights = scene.All<SpotLightSceneProxy>();
+    scene.Remove<SpotLightSceneProxy>(0);
+    EXPECT_FALSE(spotLights.Valid(handles[0]));
+    EXPECT_TRUE(spotLights.Valid(handles[3]));
+    EXPECT_EQ(spotLights.Get(handles[3]).intensity, 3.0f);
+
+    const auto reused = scene.Add<SpotLightSceneProxy>(4, SpotLightSceneProxy());
+    EXPECT_EQ(reused.index, handles[0].index);
+    EXPECT_FALSE(spotLights.Valid(handles[0]));
+    EXPECT_TRUE(spotLights.Valid(reused));
+    EXPECT_EQ(spotLights.Find(4), reused);
+}
+
+TEST(SceneTest, SplitCoversAllProxies)
+{
+    Core::ScopedThreadTag threadTag(Core::ThreadTag::render);
+    Scene scene;
+    for (Scene::EntityId entity = 0; entity < 10; entity++) {
+        scene.Add<DirectionalLightSceneProxy>(entity, DirectionalLightSceneProxy());
+    }
+
+    const auto ranges = scene.All<DirectionalLightSceneProxy>().Split(4);
+    ASSERT_EQ(ranges.size(), 4);
+    size_t next = 0;
+    for (const auto& range : ranges) {
+        EXPECT_EQ(range.begin, next);
+        EXPECT_GE(range.Size(), 2);
+        next = range.end;
+    }
+    EXPECT_EQ(next, 10);
+    EXPECT_EQ(scene.All<DirectionalLightSceneProxy>().Split(4, 8).size(), 1);
+}
+
+TEST(SceneTest, WorldBoundsFollowTransforms)
+{
+    Core::ScopedThreadTag threadTag(Core::ThreadTag::render);
+    Scene scene;
+    StaticPrimitiveSceneProxy staticPrimitive;
+    staticPrimitive.localBoundingSphere = Common::FSphere(1.0f, 0.0f, 0.0f, 1.0f);
+    staticPrimitive.localToWorld.At(0, 3) = 5.0f;
+    scene.Add<StaticPrimitiveSceneProxy>(1, std::move(staticPrimitive));
+
+    const auto worldSpheres = scene.All<StaticPrimitiveSceneProxy>().Column<&StaticPrimitiveSceneProxy::worldBoundingSphere>();
+    EXPECT_FLOAT_EQ(worldSpheres[0].center.x, 6.0f);
+    EXPECT_FLOAT_EQ(worldSpheres[0].radius, 1.0f);
+
+    // the largest axis scale bounds the radius of a non-uniformly scaled sphere
+    Common::FMat4x4 localToWorld = Common::FMat4x4Consts::identity;
+    localToWorld.At(0, 0) = 2.0f;
+    localToWorld.At(2, 2) = 3.0f;
+    localToWorld.At(0, 3) = 10.0f;
+    constexpr Scene::EntityId entity = 1;
+    scene.UpdateTransforms<StaticPrimitiveSceneProxy>(&entity, &localToWorld, 1);
+    EXPECT_FLOAT_EQ(worldSpheres[0].center.x, 12.0f);
+    EXPECT_FLOAT_EQ(worldSpheres[0].center.y, 0.0f);
+    EXPECT_FLOAT_EQ(worldSpheres[0].radius, 3.0f);
+}
@@ -0,0 +1,183 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+#include <Test/Test.h>
+
+#include <Render/ShaderCache.h>
+
+using namespace Render;
+
+struct ShaderCacheTest : testing::Test {
+    void SetUp() override
+    {
+        directory = "../Test/Generated/Render/ShaderCache";
+        std::filesystem::remove_all(directory.String());
+
+        auto& shaderCache = ShaderCache::Get();
+        shaderCache.SetDirectory(directory);
+        shaderCache.SetEnabled(true);
+        shaderCache.ResetCounters();
+    }
+
+    static ShaderCompileInput MakeInput()
+    {
+        ShaderCompileInput input {};
+        input.entryPoint = "VSMain";
+        input.stage = RHI::ShaderStageBits::sVertex;
+        input.definitions = { "A=1", "B=0" };
+        input.sourceHash = 0x1234;
+        return input;
+    }
+
+    static ShaderCompileOptions MakeOptions()
+    {
+        ShaderCompileOptions options {};
+        options.byteCodeType = ShaderByteCodeType::spirv;
+        return options;
+    }
+
+    static ShaderCompileOutput MakeOutput(size_t inByteCodeSize)
+    {
+        std::vector<uint8_t> byteCode(inByteCodeSize);
+        for (auto i = 0; i < inByteCodeSize; i++) {
+            byteCode[i] = static_cast<uint8_t>(i);
+        }
+
+        ShaderCompileOutput output {};
+        output.success = true;
+        output.entryPoint = "VSMain";
+        output.byteCode = Common::MakeShared<const RHI::ShaderByteCode>(std::move(byteCode));
+        output.reflectionData.vertexBindings.emplace("POSITION", RHI::HlslVertexBinding("POSITION", 0));
+        output.reflectionData.vertexBindings.emplace("TEXCOORD", RHI::GlslVertexBinding(2));
+        output.reflectionData.resourceBindings.emplace("viewUniform", std::make_pair(0, RHI::ResourceBinding(RHI::BindingType::uniformBuffer, RHI::GlslBinding(3))));
+        output.reflectionData.resourceBindings.emplace("colorTex", std::make_pair(1, RHI::ResourceBinding(RHI::BindingType::texture, RHI::HlslBinding(RHI::HlslBindingRangeType::texture, 5))));
+        return output;
+    }
+
+    Common::Path directory;
+};
+
+TEST_F(ShaderCacheTest, KeyTest)
+{
+    const auto input = MakeInput();
+    const auto options = MakeOptions();
+    const auto key = ShaderCache::ComputeKey(input, options, 1);
+    ASSERT_EQ(key, ShaderCache::ComputeKey(input, options, 1));
+    ASSERT_NE(key, ShaderCache::ComputeKey(input, options, 2));
+
+    auto otherInput = input;
+    otherInput.definitions = { "A=1", "B=1" };
+    ASSERT_NE(key, ShaderCache::ComputeKey(otherInput, options, 1));
+    otherInput = input;
+    otherInput.sourceHash = 0x4321;
+    ASSERT_NE(key, ShaderCache::ComputeKey(otherInput, options, 1));
+
+    auto otherOptions = options;
+    otherOptions.byteCodeType = ShaderByteCodeType::dxil;
+    ASSERT_NE(key, ShaderCache::ComputeKey(input, otherOptions, 1));
+
+    // include directories only affect the byte code through the sources they resolve, which the source hash covers
+    otherInput = input;
+    otherInput.includeDirectories = { "Engine/Shader" };
+    ASSERT_EQ(key, ShaderCache::ComputeKey(otherInput, options, 1));
+}
+
+TEST_F(ShaderCacheTest, StoreAndLoadTest)
+{
+    auto& shaderCache = ShaderCache::Get();
+    const auto key = ShaderCache::ComputeKey(MakeInput(), MakeOptions(), 1);
+
+    ShaderCompileOutput output {};
+    ASSERT_FALSE(shaderCache.Load(key, output));
+
+    shaderCache.Store(key, MakeOutput(256));
+    ASSERT_TRUE(shaderCache.Load(key, output));
+    ASSERT_TRUE(output.success);
+    ASSERT_EQ(output.entryPoint, "VSMain");
+    ASSERT_EQ(output.byteCode->GetSize(), 256);
+    ASSERT_EQ(static_cast<const uint8_t*>(output.byteCode->GetData())[255], 255);
+
+    const auto& vertexBindings = output.reflectionData.vertexBindings;
+    ASSERT_EQ(vertexBindings.size(), 2);
+    ASSERT_EQ(std::get<RHI::HlslVertexBinding>(vertexBindings.at("POSITION")).semanticName, "POSITION");
+    ASSERT_EQ(std::get<RHI::GlslVertexBinding>(vertexBindings.at("TEXCOORD")).location, 2);
+
+    const auto& resourceBindings = output.reflectionData.resourceBindings;
+    ASSERT_EQ(resourceBindings.size(), 2);
+    ASSERT_EQ(resourceBindings.at("viewUniform").first, 0);
+    ASSERT_EQ(resourceBindings.at("viewUniform").second.type, RHI::BindingType::uniformBuffer);
+    ASSERT_EQ(std::get<RHI::GlslBinding>(resourceBindings.at("viewUniform").second.platformBinding).index, 3);
+    ASSERT_EQ(resourceBindings.at("colorTex").first, 1);
+    ASSERT_EQ(std::get<RHI::HlslBinding>(resourceBindings.at("colorTex").second.platformBinding).rangeType, RHI::HlslBindingRangeType::texture);
+    ASSERT_EQ(std::get<RHI::HlslBinding>(resourceBindings.at("colorTex").second.platformBinding).index, 5);
+
+    const auto stats = shaderCache.GetStats();
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(stats.misses, 1);
+    ASSERT_EQ(stats.writes, 1);
+}
+
+TEST_F(ShaderCacheTest, PruneTest)
+{
+    auto& shaderCache = ShaderCache::Get();
+    auto input = MakeInput();
+    std::vector<ShaderCacheKey> keys;
+    for (auto i = 0; i < 4; i++) {
+        input.sourceHash = i + 1;
+        keys.emplace_back(ShaderCache::ComputeKey(input, MakeOptions(), 1));
+        shaderCache.Store(keys.back(), MakeOutput(4096));
+        // entries written in the same clock tick would tie on the write time
+        std::filesystem::last_write_time(
+            (directory / std::format("{:016x}.bin", keys.back())).String(),
+            std::filesystem::file_time_type::clock::now() - std::chrono::hours(4 - i));
+    }
+
+    ASSERT_EQ(shaderCache.Prune(UINT64_MAX), 0);
+    ASSERT_EQ(shaderCache.Prune(2 * 4096 + 2048), 2);
+
+    ShaderCompileOutput output {};
+    ASSERT_FALSE(shaderCache.Load(keys[0], output));
+    ASSERT_FALSE(shaderCache.Load(keys[1], output));
+    ASSERT_TRUE(shaderCache.Load(keys[2], output));
+    ASSERT_TRUE(shaderCache.Load(keys[3], output));
+}
+
+TEST_F(ShaderCacheTest, CorruptEntryTest)
+{
+    auto& shaderCache = ShaderCache::Get();
+    auto input = MakeInput();
+    std::vector<ShaderCacheKey> keys;
+    for (auto i = 0; i < 2; i++) {
+        input.sourceHash = i + 1;
+        keys.emplace_back(ShaderCache::ComputeKey(input, MakeOptions(), 1));
+        shaderCache.Store(keys.back(), MakeOutput(256));
+    }
+
+    // one entry cut inside its byte code, the other with a byte code length far beyond the file
+    const auto truncatedPath = (directory / std::format("{:016x}.bin", keys[0])).String();
+    std::filesystem::resize_file(truncatedPath, std::filesystem::file_size(truncatedPath) / 2);
+    const auto corruptPath = (directory / std::format("{:016x}.bin", keys[1])).String();
+    {
+        std::fstream file(corruptPath, std::ios::binary | std::ios::in | std::ios::out);
+        // key, entry point length and the 6 bytes of "VSMain" come first
+        file.seekp(sizeof(uint64_t) * 2 + 6);
+        const uint64_t hugeSize = UINT64_MAX / 2;
+        file.write(reinterpret_cast<const char*>(&hugeSize), sizeof(hugeSize));
+    }
+
+    ShaderCompileOutput output {};
+    ASSERT_FALSE(shaderCache.Load(keys[0], output));
+    ASSERT_FALSE(shaderCache.Load(keys[1], output));
+    ASSERT_FALSE(std::filesystem::exists(truncatedPath));
+    ASSERT_FALSE(std::filesystem::exists(corruptPath));
+    ASSERT_EQ(shaderCache.GetStats().misses, 2);
+
+    shaderCache.Store(keys[0], MakeOutput(256));
+    ASSERT_TRUE(shaderCache.Load(keys[0], output));
+    ASSERT_EQ(output.byteCode->GetSize(), 256);
+}
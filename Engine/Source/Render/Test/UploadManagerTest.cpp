@@ -0,0 +1,178 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <Test/Test.h>
+
+#include <Render/RenderCache.h>
+#include <Render/UploadManager.h>
+
+using namespace Render;
+
+struct UploadManagerTest : testing::Test {
+    void SetUp() override
+    {
+        instance = RHI::Instance::GetByType(RHI::RHIType::dummy);
+
+        device = instance->GetGpu(0)->RequestDevice(
+            RHI::DeviceCreateInfo()
+                .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::graphics, 1)));
+    }
+
+    void TearDown() override
+    {
+        DestroyDeviceResources(*device);
+    }
+
+    Common::UniquePtr<RHI::Buffer> CreateBuffer(size_t inSize) const
+    {
+        return device->CreateBuffer(
+            RHI::BufferCreateInfo()
+                .SetSize(static_cast<uint32_t>(inSize))
+                .SetUsages(RHI::BufferUsageBits::vertex | RHI::BufferUsageBits::copyDst)
+                .SetInitialState(RHI::BufferState::undefined));
+    }
+
+    RHI::Instance* instance;
+    Common::UniquePtr<RHI::Device> device;
+};
+
+TEST_F(UploadManagerTest, BufferUploadTest)
+{
+    auto& uploadManager = UploadManager::Get(*device);
+    const auto buffer = CreateBuffer(4096);
+
+    std::vector<uint32_t> data(1024, 7);
+    const auto ticket = uploadManager.UploadBuffer(buffer.Get(), RHI::BufferState::undefined, RHI::BufferState::shaderReadOnly, std::move(data));
+    ASSERT_FALSE(uploadManager.IsSubmitted(ticket));
+    ASSERT_EQ(uploadManager.PendingCount(), 1);
+
+    ASSERT_NE(uploadManager.Submit(), nullptr);
+    ASSERT_TRUE(uploadManager.IsSubmitted(ticket));
+    ASSERT_EQ(uploadManager.PendingCount(), 0);
+    ASSERT_EQ(uploadManager.GetStats().uploads, 1);
+    ASSERT_EQ(uploadManager.GetStats().bytesUploaded, 4096);
+    ASSERT_EQ(uploadManager.GetStats().submissions, 1);
+
+    ASSERT_EQ(uploadManager.Submit(), nullptr);
+    ASSERT_EQ(uploadManager.GetStats().submissions, 1);
+}
+
+TEST_F(UploadManagerTest, FrameBudgetTest)
+{
+    auto& uploadManager = UploadManager::Get(*device);
+    uploadManager.SetBudget(8192);
+
+    std::vector<Common::UniquePtr<RHI::Buffer>> buffers;
+    std::vector<UploadTicket> tickets;
+    for (auto i = 0; i < 4; i++) {
+        buffers.emplace_back(CreateBuffer(4096));
+        tickets.emplace_back(uploadManager.UploadBuffer(buffers.back().Get(), RHI::BufferState::undefined, RHI::BufferState::shaderReadOnly, std::vector<uint8_t>(4096, i)));
+    }
+
+    ASSERT_NE(uploadManager.Submit(), nullptr);
+    ASSERT_TRUE(uploadManager.IsSubmitted(tickets[1]));
+    ASSERT_FALSE(uploadManager.IsSubmitted(tickets[2]));
+    ASSERT_EQ(uploadManager.PendingCount(), 2);
+
+    ASSERT_NE(uploadManager.Submit(), nullptr);
+    ASSERT_TRUE(uploadManager.IsSubmitted(tickets[3]));
+    ASSERT_EQ(uploadManager.PendingCount(), 0);
+    ASSERT_EQ(uploadManager.GetStats().submissions, 2);
+}
+
+TEST_F(UploadManagerTest, OversizedUploadTest)
+{
+    auto& uploadManager = UploadManager::Get(*device);
+    uploadManager.SetBudget(1024);
+
+    const auto smallBuffer = CreateBuffer(4096);
+    const auto largeBuffer = CreateBuffer(Internal::uploadRingSize + 4096);
+    const auto smallTicket = uploadManager.UploadBuffer(smallBuffer.Get(), RHI::BufferState::undefined, RHI::BufferState::shaderReadOnly, std::vector<uint8_t>(4096, 1));
+    const auto largeTicket = uploadManager.UploadBuffer(largeBuffer.Get(), RHI::BufferState::undefined, RHI::BufferState::shaderReadOnly, std::vector<uint8_t>(Internal::uploadRingSize + 4096, 2));
+
+    // a request over the budget is submitted alone, a request over the ring size gets a dedicated staging buffer
+    ASSERT_NE(uploadManager.Submit(), nullptr);
+    ASSERT_TRUE(uploadManager.IsSubmitted(smallTicket));
+    ASSERT_FALSE(uploadManager.IsSubmitted(largeTicket));
+    ASSERT_NE(uploadManager.Submit(), nullptr);
+    ASSERT_TRUE(uploadManager.IsSubmitted(largeTicket));
+    ASSERT_EQ(uploadManager.GetStats().bytesUploaded, Internal::uploadRingSize + 8192);
+}
+
+TEST_F(UploadManagerTest, RingWrapTest)
+{
+    auto& uploadManager = UploadManager::Get(*device);
+    constexpr size_t uploadSize = Internal::uploadRingSize * 3 / 8;
+
+    std::vector<Common::UniquePtr<RHI::Buffer>> buffers;
+    std::vector<UploadTicket> tickets;
+    for (auto i = 0; i < 2; i++) {
+        buffers.emplace_back(CreateBuffer(uploadSize));
+        tickets.emplace_back(uploadManager.UploadBuffer(buffers.back().Get(), RHI::BufferState::undefined, RHI::BufferState::shaderReadOnly, std::vector<uint8_t>(uploadSize, i)));
+    }
+    ASSERT_NE(uploadManager.Submit(), nullptr);
+    ASSERT_EQ(uploadManager.GetStats().stalls, 0);
+
+    // the third upload does not fit behind the first two, the manager waits for the in flight submission and wraps
+    buffers.emplace_back(CreateBuffer(uploadSize));
+    tickets.emplace_back(uploadManager.UploadBuffer(buffers.back().Get(), RHI::BufferState::undefined, RHI::BufferState::shaderReadOnly, std::vector<uint8_t>(uploadSize, 2)));
+    ASSERT_NE(uploadManager.Submit(), nullptr);
+    ASSERT_TRUE(uploadManager.IsSubmitted(tickets[2]));
+    ASSERT_EQ(uploadManager.GetStats().stalls, 1);
+}
+
+TEST_F(UploadManagerTest, TextureUploadTest)
+{
+    auto& uploadManager = UploadManager::Get(*device);
+    const auto texture = device->CreateTexture(
+        RHI::TextureCreateInfo()
+            .SetType(RHI::TextureType::t2D)
+            .SetWidth(64)
+            .SetHeight(64)
+            .SetDepthOrArraySize(1)
+            .SetFormat(RHI::PixelFormat::rgba8Unorm)
+            .SetUsages(RHI::TextureUsageBits::copyDst | RHI::TextureUsageBits::textureBinding)
+            .SetMipLevels(3)
+            .SetSamples(1)
+            .SetInitialState(RHI::TextureState::shaderReadOnly));
+
+    std::vector<std::vector<uint8_t>> pixels;
+    for (auto m = 0; m < 3; m++) {
+        const auto mipWidth = 64u >> m;
+        pixels.emplace_back(mipWidth * mipWidth * 4, static_cast<uint8_t>(m));
+    }
+
+    size_t writtenSubResources = 0;
+    const auto ticket = uploadManager.UploadTexture(
+        texture.Get(),
+        RHI::TextureAspect::color,
+        RHI::TextureState::shaderReadOnly,
+        RHI::TextureState::shaderReadOnly,
+        std::move(pixels),
+        [&](const std::vector<uint8_t>& inPixels, uint8_t* outData, const RHI::TextureSubResourceCopyFootprint& inFootprint) -> void {
+            ASSERT_EQ(inPixels.size(), inFootprint.extent.x * inFootprint.extent.y * 4);
+            writtenSubResources++;
+        });
+
+    ASSERT_NE(uploadManager.Submit(), nullptr);
+    ASSERT_TRUE(uploadManager.IsSubmitted(ticket));
+    ASSERT_EQ(writtenSubResources, 3);
+}
+
+TEST_F(UploadManagerTest, DiscardTest)
+{
+    auto& uploadManager = UploadManager::Get(*device);
+    auto buffer = CreateBuffer(4096);
+    const auto otherBuffer = CreateBuffer(4096);
+    uploadManager.UploadBuffer(buffer.Get(), RHI::BufferState::undefined, RHI::BufferState::shaderReadOnly, std::vector<uint8_t>(4096, 1));
+    const auto otherTicket = uploadManager.UploadBuffer(otherBuffer.Get(), RHI::BufferState::undefined, RHI::BufferState::shaderReadOnly, std::vector<uint8_t>(4096, 2));
+
+    uploadManager.Discard(buffer.Get());
+    buffer.Reset();
+    ASSERT_EQ(uploadManager.PendingCount(), 1);
+
+    ASSERT_NE(uploadManager.Submit(), nullptr);
+    ASSERT_TRUE(uploadManager.IsSubmitted(otherTicket));
+    ASSERT_EQ(uploadManager.GetStats().bytesUploaded, 4096);
+}
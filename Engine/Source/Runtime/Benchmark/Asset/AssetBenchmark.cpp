@@ -0,0 +1,212 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <AssetBenchmark.h>
+#include <Core/Paths.h>
+#include <Runtime/Asset/Archive.h>
+
+namespace Runtime::AssetBenchmark {
+    BenchmarkAsset::BenchmarkAsset(Core::Uri inUri)
+        : Asset(std::move(inUri))
+        , checksum(0.0f)
+    {
+    }
+
+    BenchmarkAsset::~BenchmarkAsset() = default;
+
+    void BenchmarkAsset::PostLoad()
+    {
+        checksum = 0.0f;
+        for (const float value : payload) {
+            checksum += value;
+        }
+    }
+}
+
+namespace Runtime::AssetBenchmark::Internal {
+    // a synthetic project of 5k assets: roots referencing shared mid level assets, which reference shared leaves, about
+    // the shape of levels, materials and textures
+    static constexpr size_t rootNum = 100;
+    static constexpr size_t midNum = 900;
+    static constexpr size_t leafNum = 4000;
+    static constexpr size_t midPerRoot = 9;
+    static constexpr size_t leafPerMid = 8;
+    static constexpr size_t leafPayloadSize = 4096;
+    static constexpr size_t midPayloadSize = 256;
+
+    static Core::Uri GetAssetUri(std::string_view inTier, size_t inIndex)
+    {
+        return Core::Uri(std::format("asset://Game/AssetBenchmark/{}{}", inTier, inIndex));
+    }
+
+    static Common::Path GetArchivePath()
+    {
+        return Core::Paths::GameRootDir() / "AssetBenchmark.expk";
+    }
+
+    static AssetPtr<BenchmarkAsset> MakeAsset(std::string_view inTier, size_t inIndex, size_t inPayloadSize)
+    {
+        AssetPtr<BenchmarkAsset> asset = new BenchmarkAsset(GetAssetUri(inTier, inIndex));
+        asset->payload.resize(inPayloadSize);
+        for (auto i = 0; i < inPayloadSize; i++) {
+            asset->payload[i] = static_cast<float>(inIndex + i);
+        }
+        return asset;
+    }
+
+    static void GenerateProject()
+    {
+        static bool generated = false;
+        if (generated) {
+            return;
+        }
+        generated = true;
+
+        Core::Paths::SetGameRoot((std::filesystem::temp_directory_path() / "ExplosionAssetBenchmark").string());
+
+        std::vector<AssetPtr<BenchmarkAsset>> leaves;
+        leaves.reserve(leafNum);
+        for (auto i = 0; i < leafNum; i++) {
+            leaves.emplace_back(MakeAsset("Leaf", i, leafPayloadSize));
+            AssetManager::Get().Save(leaves.back());
+        }
+
+        std::vector<AssetPtr<BenchmarkAsset>> mids;
+        mids.reserve(midNum);
+        for (auto i = 0; i < midNum; i++) {
+            auto& mid = mids.emplace_back(MakeAsset("Mid", i, midPayloadSize));
+            for (auto j = 0; j < leafPerMid; j++) {
+                mid->dependencies.emplace_back(leaves[(i * leafNum / midNum + j) % leafNum].StaticCast<Asset>());
+            }
+            AssetManager::Get().Save(mid);
+        }
+
+        for (auto i = 0; i < rootNum; i++) {
+            AssetPtr<BenchmarkAsset> root = MakeAsset("Root", i, 0);
+            for (auto j = 0; j < midPerRoot; j++) {
+                root->dependencies.emplace_back(mids[i * midPerRoot + j].StaticCast<Asset>());
+            }
+            AssetManager::Get().Save(root);
+        }
+
+        AssetArchiveWriter writer(GetArchivePath());
+        for (auto i = 0; i < leafNum; i++) {
+            writer.AddFile(GetAssetUri("Leaf", i));
+        }
+        for (auto i = 0; i < midNum; i++) {
+            writer.AddFile(GetAssetUri("Mid", i));
+        }
+        for (auto i = 0; i < rootNum; i++) {
+            writer.AddFile(GetAssetUri("Root", i));
+        }
+    }
+
+    static void SetAssetsProcessed(benchmark::State& inState)
+    {
+        inState.SetItemsProcessed(inState.iterations() * static_cast<int64_t>(rootNum + midNum + leafNum));
+    }
+
+    // one root after another, each load waits for its whole dependency tree before the next one is requested
+    static void SyncLoadRoots(benchmark::State& state)
+    {
+        GenerateProject();
+        for (auto _ : state) {
+            std::vector<AssetPtr<BenchmarkAsset>> roots;
+            roots.reserve(rootNum);
+            for (auto i = 0; i < rootNum; i++) {
+                roots.emplace_back(AssetManager::Get().SyncLoad<BenchmarkAsset>(GetAssetUri("Root", i), BenchmarkAsset::GetStaticClass()));
+            }
+            benchmark::DoNotOptimize(roots.data());
+        }
+        SetAssetsProcessed(state);
+    }
+
+    // every root requested up front, dependency reads and deserialization of different subtrees overlap on the pool
+    static void AsyncLoadRoots(benchmark::State& state)
+    {
+        GenerateProject();
+        const auto priority = static_cast<AssetLoadPriority>(state.range(0));
+        for (auto _ : state) {
+            std::vector<AssetLoadHandle> handles;
+            handles.reserve(rootNum);
+            for (auto i = 0; i < rootNum; i++) {
+                handles.emplace_back(AssetManager::Get().AsyncLoad<BenchmarkAsset>(GetAssetUri("Root", i), BenchmarkAsset::GetStaticClass(), {}, priority));
+            }
+            for (const auto& handle : handles) {
+                handle.Wait();
+            }
+            benchmark::DoNotOptimize(handles.data());
+        }
+        SetAssetsProcessed(state);
+    }
+
+    // same as AsyncLoadRoots at visible priority, with the assets read from one packed archive instead of loose files
+    static void AsyncLoadRootsFromArchive(benchmark::State& state)
+    {
+        GenerateProject();
+        AssetManager::Get().MountArchive(GetArchivePath());
+        for (auto _ : state) {
+            std::vector<AssetLoadHandle> handles;
+            handles.reserve(rootNum);
+            for (auto i = 0; i < rootNum; i++) {
+                handles.emplace_back(AssetManager::Get().AsyncLoad<BenchmarkAsset>(GetAssetUri("Root", i), BenchmarkAsset::GetStaticClass()));
+            }
+            for (const auto& handle : handles) {
+                handle.Wait();
+            }
+            benchmark::DoNotOptimize(handles.data());
+        }
+        AssetManager::Get().UnmountArchives();
+        SetAssetsProcessed(state);
+    }
+
+    // prefetch of the whole project dropped half way, measures how quickly cancelled requests drain from the pool
+    static void CancelPrefetch(benchmark::State& state)
+    {
+        GenerateProject();
+        for (auto _ : state) {
+            {
+                std::vector<AssetLoadHandle> handles;
+                handles.reserve(rootNum);
+                for (auto i = 0; i < rootNum; i++) {
+                    handles.emplace_back(AssetManager::Get().AsyncLoad<BenchmarkAsset>(GetAssetUri("Root", i), BenchmarkAsset::GetStaticClass(), {}, AssetLoadPriority::prefetch));
+                }
+                handles[0].Wait();
+            }
+            AssetLoadHandle handle = AssetManager::Get().AsyncLoad<BenchmarkAsset>(GetAssetUri("Root", rootNum - 1), BenchmarkAsset::GetStaticClass());
+            handle.Wait();
+        }
+    }
+
+    static void RegisterBenchmarkCase(std::string_view inCaseName, void (*inFunction)(benchmark::State&), bool inWithPriorityArgs)
+    {
+        std::string name = "Runtime::AssetBenchmark::";
+        name.append(inCaseName);
+
+        auto* benchmark = benchmark::RegisterBenchmark(name.c_str(), inFunction)
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+        if (inWithPriorityArgs) {
+            benchmark
+                ->Arg(static_cast<int64_t>(AssetLoadPriority::prefetch))
+                ->Arg(static_cast<int64_t>(AssetLoadPriority::visible));
+        }
+    }
+
+    const bool benchmarksRegistered = []() -> bool {
+        RegisterBenchmarkCase("SyncLoadRoots", &SyncLoadRoots, false);
+        RegisterBenchmarkCase("AsyncLoadRoots", &AsyncLoadRoots, true);
+        RegisterBenchmarkCase("AsyncLoadRootsFromArchive", &AsyncLoadRootsFromArchive, false);
+        RegisterBenchmarkCase("CancelPrefetch", &CancelPrefetch, false);
+        return true;
+    }();
+}
@@ -0,0 +1,27 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#pragma once
+
+#include <vector>
+
+#include <Runtime/Meta.h>
+#include <Runtime/Asset/Asset.h>
+
+namespace Runtime::AssetBenchmark {
+    class EClass() BenchmarkAsset final : public Asset {
+        EPolyDerivedClassBody(BenchmarkAsset)
+
+    public:
+        explicit BenchmarkAsset(Core::Uri inUri);
+        ~BenchmarkAsset() override;
+
+        // stands in for preparing the gpu upload of the payload
+        void PostLoad() override;
+
+        EProperty() std::vector<float> payload;
+        EProperty() std::vector<AssetPtr<Asset>> dependencies;
+        float checksum;
+    };
+}
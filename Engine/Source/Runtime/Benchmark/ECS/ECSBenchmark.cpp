@@ -2,8 +2,10 @@
 // Created by johnk on 2026/7/12.
 //
 
+#include <functional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -72,6 +74,7 @@ namespace Runtime::ECSBenchmark::Internal {
     constexpr int64_t smallEntityCount = 1 << 10;
     constexpr int64_t mediumEntityCount = 1 << 13;
     constexpr int64_t largeEntityCount = 1 << 16;
+    constexpr int64_t hugeEntityCount = 1 << 20;
 
     struct ExplosionBackend {
         static constexpr std::string_view name = "Explosion";
@@ -520,26 +523,60 @@ namespace Runtime::ECSBenchmark::Internal {
         SetEntitiesProcessed(state, entityCount);
     }
 
+    // ViewIterate split across ParallelEach ranges, the second argument bounds the number of threads
+    static void ViewParallelIterate(benchmark::State& state)
+    {
+        const auto entityCount = state.range(0);
+        const auto threadNum = static_cast<size_t>(state.range(1));
+        ECRegistry registry;
+        const auto entities = CreateEntities<ExplosionBackend>(registry, entityCount);
+        AddMotionComponents<ExplosionBackend>(registry, entities, false);
+        const auto view = registry.View<Position, Velocity>();
+
+        for (auto _ : state) {
+            const float sum = view.ParallelEach(0.0f, [](float& partial, Entity, const Position& position, const Velocity& velocity) -> void {
+                partial += position.x * velocity.x + position.y * velocity.y + position.z * velocity.z;
+            }, std::plus<float>(), 0, threadNum);
+            benchmark::DoNotOptimize(sum);
+        }
+
+        SetEntitiesProcessed(state, entityCount);
+    }
+
+    static void RegisterParallelBenchmarks()
+    {
+        auto* benchmark = benchmark::RegisterBenchmark("Runtime::ECSBenchmark::ViewParallelIterate/Explosion", &ViewParallelIterate)->UseRealTime();
+        const auto maxThreadNum = static_cast<int64_t>(std::max(std::thread::hardware_concurrency(), 1u));
+        for (int64_t threadNum = 1; threadNum < maxThreadNum; threadNum *= 2) {
+            benchmark->Args({ hugeEntityCount, threadNum });
+        }
+        benchmark->Args({ hugeEntityCount, maxThreadNum });
+    }
+
     template <typename Backend>
-    static void RegisterBenchmarkCase(std::string_view inCaseName, void (*inFunction)(benchmark::State&))
+    static void RegisterBenchmarkCase(std::string_view inCaseName, void (*inFunction)(benchmark::State&), bool inWithHugeCount = false)
     {
         std::string name = "Runtime::ECSBenchmark::";
         name.append(inCaseName);
         name += "/";
         name.append(Backend::name);
 
-        benchmark::RegisterBenchmark(name.c_str(), inFunction)
+        auto* benchmark = benchmark::RegisterBenchmark(name.c_str(), inFunction)
             ->Arg(smallEntityCount)
             ->Arg(mediumEntityCount)
             ->Arg(largeEntityCount);
+        if (inWithHugeCount) {
+            benchmark->Arg(hugeEntityCount);
+        }
     }
 
     template <typename Backend>
     static void RegisterBackendBenchmarks()
     {
-        RegisterBenchmarkCase<Backend>("EntityCreateDestroy", &EntityCreateDestroy<Backend>);
+        // archetype growth dominates at the huge count
+        RegisterBenchmarkCase<Backend>("EntityCreateDestroy", &EntityCreateDestroy<Backend>, true);
         RegisterBenchmarkCase<Backend>("ComponentAddRemove", &ComponentAddRemove<Backend>);
-        RegisterBenchmarkCase<Backend>("ThreeComponentChurn", &ThreeComponentChurn<Backend>);
+        RegisterBenchmarkCase<Backend>("ThreeComponentChurn", &ThreeComponentChurn<Backend>, true);
         RegisterBenchmarkCase<Backend>("ComponentGet", &ComponentGet<Backend>);
         RegisterBenchmarkCase<Backend>("ViewConstruct", &ViewConstruct<Backend>);
         RegisterBenchmarkCase<Backend>("ViewIterate", &ViewIterate<Backend>);
@@ -552,6 +589,7 @@ namespace Runtime::ECSBenchmark::Internal {
         RegisterBackendBenchmarks<ExplosionBackend>();
         RegisterBackendBenchmarks<EnTTBackend>();
         RegisterBackendBenchmarks<FlecsBackend>();
+        RegisterParallelBenchmarks();
         return true;
     }();
 }
@@ -0,0 +1,105 @@
+//
+// Created by johnk on 2026/10/17.
+//
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Common/Concurrent.h>
+#include <Core/Thread.h>
+#include <Runtime/ECS.h>
+#include <Runtime/Component/Transform.h>
+#include <Runtime/System/Scene.h>
+
+namespace Runtime::SceneBenchmark::Internal {
+    struct Fixture {
+        explicit Fixture(int64_t inEntityCount);
+
+        ECRegistry registry;
+        std::vector<Entity> movedEntities;
+        Common::CommandThread renderThread;
+    };
+
+    Fixture::Fixture(int64_t inEntityCount)
+        : renderThread("SceneBenchmarkRenderThread", 1 << 16)
+    {
+        movedEntities.reserve(inEntityCount);
+        for (int64_t i = 0; i < inEntityCount; i++) {
+            const Entity entity = registry.Create();
+            Common::FTransform transform;
+            transform.translation = Common::FVec3(static_cast<float>(i), 0.0f, 0.0f);
+            registry.Emplace<WorldTransform>(entity, transform);
+            movedEntities.emplace_back(entity);
+        }
+        renderThread.EmplaceTask([]() -> void { Core::ThreadContext::SetTag(Core::ThreadTag::render); });
+    }
+
+    // the previous SceneSystem path, one render thread task per moved entity and a hash lookup per task
+    static void PerEntityTransformTasks(benchmark::State& state)
+    {
+        Fixture fixture(state.range(0));
+        std::unordered_map<Entity, Render::StaticPrimitiveSceneProxy> proxies;
+        for (const Entity entity : fixture.movedEntities) {
+            proxies.emplace(entity, Render::StaticPrimitiveSceneProxy());
+        }
+
+        for (auto _ : state) {
+            for (const Entity entity : fixture.movedEntities) {
+                fixture.renderThread.EmplaceTask([&proxies, entity, transform = fixture.registry.Get<WorldTransform>(entity)]() -> void {
+                    proxies.at(entity).localToWorld = transform.localToWorld.GetTransformMatrix();
+                });
+            }
+            fixture.renderThread.Flush();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // the current SceneSystem path, one pass building the scene delta on the game thread and one render thread task
+    // applying it to the dense scene storage
+    static void BatchedSceneDelta(benchmark::State& state)
+    {
+        Fixture fixture(state.range(0));
+        Render::Scene scene;
+        fixture.renderThread.EmplaceTask([&]() -> void {
+            for (const Entity entity : fixture.movedEntities) {
+                scene.Add<Render::StaticPrimitiveSceneProxy>(entity, Render::StaticPrimitiveSceneProxy());
+            }
+        });
+        fixture.renderThread.Flush();
+
+        Runtime::Internal::SceneProxyDelta<StaticPrimitive, Render::StaticPrimitiveSceneProxy> delta;
+        for (auto _ : state) {
+            delta.Clear();
+            for (const Entity entity : fixture.movedEntities) {
+                delta.transformed.emplace_back(entity);
+                delta.transformedLocalToWorlds.emplace_back(Runtime::Internal::GetSceneProxyLocalToWorld(fixture.registry.Get<WorldTransform>(entity), true));
+            }
+            fixture.renderThread.EmplaceTask([&]() -> void { delta.Apply(scene); });
+            fixture.renderThread.Flush();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    static void RegisterBenchmarkCase(std::string_view inCaseName, void (*inFunction)(benchmark::State&))
+    {
+        std::string name = "Runtime::SceneBenchmark::";
+        name.append(inCaseName);
+
+        benchmark::RegisterBenchmark(name.c_str(), inFunction)
+            ->Arg(1 << 10)
+            ->Arg(10000)
+            ->Arg(100000)
+            ->Unit(benchmark::kMicrosecond)
+            ->UseRealTime();
+    }
+
+    const bool benchmarksRegistered = []() -> bool {
+        RegisterBenchmarkCase("PerEntityTransformTasks", &PerEntityTransformTasks);
+        RegisterBenchmarkCase("BatchedSceneDelta", &BatchedSceneDelta);
+        return true;
+    }();
+}
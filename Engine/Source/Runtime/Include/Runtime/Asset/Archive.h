@@ -0,0 +1,106 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <Common/File.h>
+#include <Common/FileSystem.h>
+#include <Common/Serialization.h>
+#include <Common/Utility.h>
+#include <Core/Uri.h>
+#include <Runtime/Api.h>
+
+namespace Runtime::Internal {
+    constexpr uint32_t assetArchiveMagic = 0x4b505845; // EXPK
+    constexpr uint32_t assetArchiveVersion = 1;
+    constexpr size_t assetArchiveChunkSize = 64 * 1024;
+    // chunk data starts aligned in the file, so stored chunks are copied out of the mapping with aligned loads
+    constexpr size_t assetArchiveChunkAlignment = 16;
+}
+
+namespace Runtime {
+    enum class AssetCompression : uint8_t {
+        none,
+        lz4,
+        max
+    };
+
+    struct AssetArchiveEntry {
+        uint64_t uriHash;
+        uint32_t uriOffset;
+        uint32_t uriSize;
+        uint64_t size;
+        uint32_t firstChunk;
+        uint32_t chunkNum;
+
+        AssetArchiveEntry();
+    };
+
+    struct AssetArchiveChunk {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t storedSize;
+        // chunks that do not shrink are stored as is
+        AssetCompression compression;
+
+        AssetArchiveChunk();
+    };
+
+    // packs assets into one archive file, cooking a project replaces tens of thousands of loose asset files with a few
+    // archives. layout: header, data chunks, then the table of contents sorted by uri hash, its chunk table and the
+    // uri strings used to resolve hash collisions
+    class RUNTIME_API AssetArchiveWriter {
+    public:
+        NonCopyable(AssetArchiveWriter)
+        explicit AssetArchiveWriter(const Common::Path& inPath, AssetCompression inCompression = AssetCompression::lz4);
+        ~AssetArchiveWriter();
+
+        void Add(const Core::Uri& inUri, const std::vector<uint8_t>& inBytes);
+        // packs the loose asset file the uri resolves to, returns false when the file does not exist
+        bool AddFile(const Core::Uri& inUri);
+        // writes the table of contents, no asset can be added afterward
+        void Finish();
+
+    private:
+        void Align(size_t inAlignment);
+        void WriteHeader(uint64_t inTocOffset);
+
+        Common::BinaryFileSerializeStream<> stream;
+        AssetCompression compression;
+        bool finished;
+        std::vector<AssetArchiveEntry> entries;
+        std::vector<AssetArchiveChunk> chunks;
+        std::string uris;
+    };
+
+    // read only view of an archive through a mapping of the whole file, chunks of an asset are decompressed in parallel
+    // on the job system. thread safe
+    class RUNTIME_API AssetArchive {
+    public:
+        NonCopyable(AssetArchive)
+        explicit AssetArchive(const Common::Path& inPath);
+        ~AssetArchive();
+
+        bool IsValid() const;
+        size_t AssetNum() const;
+        bool Contains(const Core::Uri& inUri) const;
+        // empty when the archive has no such asset or a chunk of it is corrupted
+        std::optional<std::vector<uint8_t>> Read(const Core::Uri& inUri) const;
+
+    private:
+        const AssetArchiveEntry* Find(const Core::Uri& inUri) const;
+        bool ReadChunk(const AssetArchiveChunk& inChunk, uint8_t* outData) const;
+
+        Common::MappedFile file;
+        bool valid;
+        std::vector<AssetArchiveEntry> entries;
+        std::vector<AssetArchiveChunk> chunks;
+        std::string uris;
+    };
+}
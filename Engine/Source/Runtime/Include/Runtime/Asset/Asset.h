@@ -4,18 +4,24 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
 #include <string>
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <Common/Memory.h>
 #include <Common/Serialization.h>
 #include <Common/Concurrent.h>
 #include <Common/Concepts.h>
 #include <Common/String.h>
+#include <Common/Utility.h>
 #include <Core/Uri.h>
 #include <Runtime/Meta.h>
+#include <Runtime/Asset/Archive.h>
 #include <Mirror/Mirror.h>
 #include <Runtime/Api.h>
 
@@ -122,6 +128,81 @@ namespace Runtime {
     template <Common::DerivedFrom<Asset> A> using OnAssetLoaded = std::function<void(AssetPtr<A>)>;
     template <Common::DerivedFrom<Asset> A> using OnSoftAssetLoaded = std::function<void()>;
 
+    enum class AssetLoadPriority : uint8_t {
+        // ahead of use, e.g. streaming a nearby level
+        prefetch,
+        // needed by what is on screen now, always scheduled before prefetch work
+        visible,
+        max
+    };
+
+    namespace Internal {
+        struct AssetLoadRequest;
+
+        struct AssetDependency {
+            Core::Uri uri;
+            const Mirror::Class* clazz;
+        };
+
+        // written in front of the serialized asset, lets the loader request dependencies before the asset is deserialized
+        struct AssetFileHeader {
+            static constexpr uint32_t currentVersion = 1;
+
+            uint32_t version;
+            std::vector<AssetDependency> dependencies;
+
+            AssetFileHeader();
+        };
+
+        // records the assets referenced by the asset serialized on this thread while alive
+        class RUNTIME_API AssetDependencyCollector {
+        public:
+            NonCopyable(AssetDependencyCollector)
+            explicit AssetDependencyCollector(std::vector<AssetDependency>& outDependencies);
+            ~AssetDependencyCollector();
+
+            static void Record(const Core::Uri& inUri, const Mirror::Class& inClass);
+
+        private:
+            std::vector<AssetDependency>* prevDependencies;
+        };
+    }
+
+    // shares the ownership of an async load, the load is cancelled at its next stage boundary once every handle of it
+    // is dropped, assets already loaded are not affected
+    class RUNTIME_API AssetLoadHandle {
+    public:
+        AssetLoadHandle();
+        AssetLoadHandle(const AssetLoadHandle& other);
+        AssetLoadHandle(AssetLoadHandle&& other) noexcept;
+        ~AssetLoadHandle();
+
+        AssetLoadHandle& operator=(const AssetLoadHandle& other);
+        AssetLoadHandle& operator=(AssetLoadHandle&& other) noexcept;
+
+        bool Valid() const;
+        // loaded or failed, and the callbacks of the load returned
+        bool Done() const;
+        // executes pending load stages on the calling thread until the load is done
+        void Wait() const;
+        // priorities only go up, a load shared by several requesters runs at the highest one asked for
+        void SetPriority(AssetLoadPriority inPriority) const;
+        void Reset();
+        template <Common::DerivedFrom<Asset> A = Asset> AssetPtr<A> Get() const;
+
+    private:
+        friend class AssetManager;
+
+        explicit AssetLoadHandle(Common::SharedPtr<Internal::AssetLoadRequest> inRequest);
+        AssetPtr<Asset> GetAsset() const;
+
+        Common::SharedPtr<Internal::AssetLoadRequest> request;
+    };
+
+    // loads assets in separate stages on the asset thread pool: mapping the file and reading its header, deserializing
+    // once every dependency listed in the header is loaded, and PostLoad() which creates the gpu resources. stages are
+    // picked by priority first and prefer requests that are closest to completion, dependencies are requested as soon as
+    // the header is read and inherit the priority of the asset that needs them. loads of the same uri share one request
     class RUNTIME_API AssetManager {
     public:
         static AssetManager& Get();
@@ -129,18 +210,54 @@ namespace Runtime {
 
         template <Common::DerivedFrom<Asset> A> AssetPtr<A> SyncLoad(const Core::Uri& uri, const Mirror::Class& clazz);
         template <Common::DerivedFrom<Asset> A> void SyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz);
-        template <Common::DerivedFrom<Asset> A> void AsyncLoad(const Core::Uri& uri, const Mirror::Class& clazz, const OnAssetLoaded<A>& onAssetLoaded);
-        template <Common::DerivedFrom<Asset> A> void AsyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz, const OnSoftAssetLoaded<A>& onSoftAssetLoaded);
+        // onAssetLoaded is invoked on the thread finishing the load, with nullptr when the load failed
+        template <Common::DerivedFrom<Asset> A> AssetLoadHandle AsyncLoad(const Core::Uri& uri, const Mirror::Class& clazz, const OnAssetLoaded<A>& onAssetLoaded = {}, AssetLoadPriority priority = AssetLoadPriority::visible);
+        // softAssetRef must outlive the load
+        template <Common::DerivedFrom<Asset> A> AssetLoadHandle AsyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz, const OnSoftAssetLoaded<A>& onSoftAssetLoaded = {}, AssetLoadPriority priority = AssetLoadPriority::visible);
         template <Common::DerivedFrom<Asset> A> void Save(const AssetPtr<A>& assetRef);
         template <Common::DerivedFrom<Asset> A> void SaveSoft(const SoftAssetPtr<A>& softAssetRef);
+        // assets packed in a mounted archive are read from it instead of their loose file, archives mounted later take
+        // precedence, e.g. patches over the base game
+        bool MountArchive(const Common::Path& inPath);
+        void UnmountArchives();
+        size_t InFlightCount();
 
     private:
-        template <Common::DerivedFrom<Asset> A> AssetPtr<A> LoadInternal(const Core::Uri& uri, const Mirror::Class& clazz);
+        friend class AssetLoadHandle;
+
+        using Request = Internal::AssetLoadRequest;
+        using RequestPtr = Common::SharedPtr<Request>;
+        using OnRequestDone = std::function<void(AssetPtr<Asset>)>;
 
         AssetManager();
 
+        AssetLoadHandle Load(const Core::Uri& inUri, const Mirror::Class& inClass, AssetLoadPriority inPriority, OnRequestDone inOnDone);
+        void WriteAsset(const Core::Uri& inUri, const Mirror::Any& inAsset);
+        void Retain(Request& inRequest);
+        void Release(Request& inRequest);
+        void Wait(const RequestPtr& inRequest);
+        Common::SharedPtr<AssetArchive> FindArchive(const Core::Uri& inUri);
+        void Boost(const RequestPtr& inRequest, AssetLoadPriority inPriority);
+        RequestPtr Acquire(const Core::Uri& inUri, const Mirror::Class& inClass, AssetLoadPriority inPriority);
+        void Enqueue(const RequestPtr& inRequest);
+        bool RunNextStage(std::unique_lock<std::mutex>& inLock);
+        void ReadStage(const RequestPtr& inRequest);
+        void DeserializeStage(const RequestPtr& inRequest);
+        void PostLoadStage(const RequestPtr& inRequest);
+        void Finish(const RequestPtr& inRequest, AssetPtr<Asset> inAsset);
+        // locked part of Finish(), hands out the callbacks to run once the lock is released, false when already finished
+        bool Complete(const RequestPtr& inRequest, AssetPtr<Asset> inAsset, std::vector<OnRequestDone>& outOnDones);
+        void Cancel(Request& inRequest);
+        // requests from inRequest down to inDependency, excluding inDependency, appended to outPath when it is reachable
+        bool FindDependencyPath(const RequestPtr& inRequest, const Request& inDependency, std::vector<RequestPtr>& outPath) const;
+
         std::mutex mutex;
+        std::condition_variable condition;
         std::unordered_map<Core::Uri, WeakAssetPtr<Asset>> weakAssetRefs;
+        std::unordered_map<Core::Uri, RequestPtr> inFlightRequests;
+        std::vector<Common::SharedPtr<AssetArchive>> archives;
+        // indexed by priority then by stage, a boosted request may sit in several queues and runs from the first popped
+        std::vector<std::vector<std::deque<RequestPtr>>> stageQueues;
         Common::ThreadPool threadPool;
     };
 }
@@ -157,6 +274,8 @@ namespace Common {
 
         static size_t Serialize(BinarySerializeStream& stream, const Runtime::AssetPtr<A>& value)
         {
+            Runtime::Internal::AssetDependencyCollector::Record(value.Uri(), value->GetClass());
+
             size_t serialized = 0;
             serialized += Serializer<Core::Uri>::Serialize(stream, value.Uri());
             serialized += Serializer<const Mirror::Class*>::Serialize(stream, &value->GetClass());
@@ -178,6 +297,41 @@ namespace Common {
         }
     };
 
+    template <>
+    struct Serializer<Runtime::Internal::AssetFileHeader> {
+        static constexpr size_t typeId = Common::HashUtils::StrCrc32("Runtime::AssetFileHeader");
+
+        static size_t Serialize(BinarySerializeStream& stream, const Runtime::Internal::AssetFileHeader& value)
+        {
+            size_t serialized = 0;
+            serialized += Serializer<uint32_t>::Serialize(stream, value.version);
+            serialized += Serializer<uint64_t>::Serialize(stream, value.dependencies.size());
+            for (const auto& dependency : value.dependencies) {
+                serialized += Serializer<Core::Uri>::Serialize(stream, dependency.uri);
+                serialized += Serializer<const Mirror::Class*>::Serialize(stream, dependency.clazz);
+            }
+            return serialized;
+        }
+
+        static size_t Deserialize(BinaryDeserializeStream& stream, Runtime::Internal::AssetFileHeader& value)
+        {
+            size_t deserialized = 0;
+            deserialized += Serializer<uint32_t>::Deserialize(stream, value.version);
+            if (value.version != Runtime::Internal::AssetFileHeader::currentVersion) {
+                return deserialized;
+            }
+
+            uint64_t dependencyNum;
+            deserialized += Serializer<uint64_t>::Deserialize(stream, dependencyNum);
+            value.dependencies.resize(dependencyNum);
+            for (auto& dependency : value.dependencies) {
+                deserialized += Serializer<Core::Uri>::Deserialize(stream, dependency.uri);
+                deserialized += Serializer<const Mirror::Class*>::Deserialize(stream, dependency.clazz);
+            }
+            return deserialized;
+        }
+    };
+
     template <DerivedFrom<Runtime::Asset> A>
     struct Serializer<Runtime::SoftAssetPtr<A>> {
         static constexpr size_t typeId = Common::HashUtils::StrCrc32("Runtime::SoftAssetRef");
@@ -544,69 +698,47 @@ namespace Runtime {
     }
 
     template <Common::DerivedFrom<Asset> A>
-    AssetPtr<A> AssetManager::SyncLoad(const Core::Uri& uri, const Mirror::Class& clazz)
+    AssetPtr<A> AssetLoadHandle::Get() const
     {
-        auto iter = weakAssetRefs.find(uri);
-        if (iter != weakAssetRefs.end() && !iter->second.Expired()) {
-            return iter->second.Lock().StaticCast<A>();
-        }
+        return GetAsset().template StaticCast<A>();
+    }
 
-        AssetPtr<A> result = LoadInternal<A>(uri, clazz);
-        AssetPtr<Asset> tempRef = result.template StaticCast<Asset>();
-        if (iter == weakAssetRefs.end()) {
-            weakAssetRefs.emplace(std::make_pair(uri, WeakAssetPtr<Asset>(tempRef)));
-        } else {
-            iter->second = tempRef;
-        }
-        return result;
+    template <Common::DerivedFrom<Asset> A>
+    AssetPtr<A> AssetManager::SyncLoad(const Core::Uri& uri, const Mirror::Class& clazz)
+    {
+        const AssetLoadHandle handle = Load(uri, clazz, AssetLoadPriority::visible, {});
+        handle.Wait();
+        return handle.Get<A>();
     }
 
     template <Common::DerivedFrom<Asset> A>
     void AssetManager::SyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz)
     {
-        softAssetRef = SyncLoad<A>(softAssetRef.Uri(), clazz);
+        AssetPtr<A> asset = SyncLoad<A>(softAssetRef.Uri(), clazz);
+        softAssetRef = asset;
     }
 
     template <Common::DerivedFrom<Asset> A>
-    void AssetManager::AsyncLoad(const Core::Uri& uri, const Mirror::Class& clazz, const OnAssetLoaded<A>& onAssetLoaded)
+    AssetLoadHandle AssetManager::AsyncLoad(const Core::Uri& uri, const Mirror::Class& clazz, const OnAssetLoaded<A>& onAssetLoaded, AssetLoadPriority priority)
     {
-        threadPool.EmplaceTask([=, this]() -> void {
-            AssetPtr<A> result = nullptr;
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-                auto iter = weakAssetRefs.find(uri);
-                if (iter != weakAssetRefs.end() && !iter->second.Expired()) {
-                    result = iter->second.Lock().StaticCast<A>();
-                }
-            }
-
-            if (result == nullptr) {
-                result = LoadInternal<A>(uri, clazz);
-            }
-
-            AssetPtr<Asset> tempRef = result.template StaticCast<Asset>();
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-                auto iter = weakAssetRefs.find(uri);
-                if (iter == weakAssetRefs.end()) {
-                    weakAssetRefs.emplace(std::make_pair(uri, WeakAssetPtr<Asset>(tempRef)));
-                } else {
-                    iter->second = tempRef;
-                }
-            }
-
-            onAssetLoaded(result);
-        });
+        OnRequestDone onDone;
+        if (onAssetLoaded) {
+            onDone = [onAssetLoaded](AssetPtr<Asset> asset) -> void {
+                onAssetLoaded(asset.StaticCast<A>());
+            };
+        }
+        return Load(uri, clazz, priority, std::move(onDone));
     }
 
     template <Common::DerivedFrom<Asset> A>
-    void AssetManager::AsyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz, const OnSoftAssetLoaded<A>& onSoftAssetLoaded)
+    AssetLoadHandle AssetManager::AsyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz, const OnSoftAssetLoaded<A>& onSoftAssetLoaded, AssetLoadPriority priority)
     {
-        threadPool.EmplaceTask([this, softAssetRef, onSoftAssetLoaded, clazz]() -> void {
-            AsyncLoad(softAssetRef.Uri(), clazz, [&](AssetPtr<A>& ref) -> void {
-                softAssetRef = ref;
+        return Load(softAssetRef.Uri(), clazz, priority, [&softAssetRef, onSoftAssetLoaded](AssetPtr<Asset> asset) -> void {
+            AssetPtr<A> typedAsset = asset.StaticCast<A>();
+            softAssetRef = typedAsset;
+            if (onSoftAssetLoaded) {
                 onSoftAssetLoaded();
-            });
+            }
         });
     }
 
@@ -614,32 +746,13 @@ namespace Runtime {
     void AssetManager::Save(const AssetPtr<A>& assetRef)
     {
         Assert(assetRef.Valid());
-        const Core::AssetUriParser parser(assetRef.Uri());
-        Common::BinaryFileSerializeStream stream(parser.Parse().Absolute().String());
-
-        const Mirror::Any ref = assetRef->GetClass().Cast(Mirror::ForwardAsArg(*assetRef.Get()));
-        ref.Serialize(stream);
+        WriteAsset(assetRef.Uri(), assetRef->GetClass().Cast(Mirror::ForwardAsArg(*assetRef.Get())));
     }
 
     template <Common::DerivedFrom<Asset> A>
     void AssetManager::SaveSoft(const SoftAssetPtr<A>& softAssetRef)
     {
-        Save(softAssetRef.Uri());
-    }
-
-    template <Common::DerivedFrom<Asset> A>
-    AssetPtr<A> AssetManager::LoadInternal(const Core::Uri& uri, const Mirror::Class& clazz)
-    {
-        const Core::AssetUriParser parser(uri);
-        Common::BinaryFileDeserializeStream stream(parser.Parse().Absolute().String());
-
-        Mirror::Any ptr = clazz.New(uri);
-        ptr.Deref().Deserialize(stream);
-
-        AssetPtr<A> result = Common::SharedPtr<A>(ptr.As<A*>());
-        result->SetUri(uri);
-        result->PostLoad();
-        return result;
+        Save(softAssetRef.Get());
     }
 }
 
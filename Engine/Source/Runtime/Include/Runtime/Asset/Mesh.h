@@ -28,7 +28,14 @@ namespace Runtime {
     struct RUNTIME_API EClass() StaticMeshLOD {
         EClassBody(MeshLOD)
 
+        StaticMeshLOD();
+
+        // derived from vertices, not serialized, refreshed when a mesh is loaded or its vertices are rebuilt
+        EFunc() void UpdateBounds();
+
         EProperty() StaticMeshVertices vertices;
+        Common::FBox bounds;
+        Common::FSphere boundingSphere;
         // TODO distance field data ?
         // TODO voxel data ?
     };
@@ -46,6 +53,8 @@ namespace Runtime {
         EFunc() const StaticMeshLOD& GetLOD(size_t inIndex) const;
         EFunc() StaticMeshLOD& EmplaceLOD();
 
+        void PostLoad() override;
+
     private:
         EProperty() AssetPtr<MaterialInstance> material;
         EProperty() std::vector<StaticMeshLOD> lodVec;
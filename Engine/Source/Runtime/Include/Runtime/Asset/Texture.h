@@ -97,6 +97,9 @@ namespace Runtime {
         EFunc() uint8_t GetMipLevels() const;
         EFunc() uint8_t GetSamples() const;
         EFunc() const std::string& GetName() const;
+        // false once PostLoad() released the pixels of a loaded texture, which it does outside the editor unless
+        // asset.texture.keepPixels is on, the sub resource pixels must not be accessed and saving the texture would drop them
+        EFunc() bool HasPixels() const;
         EFunc() Pixels& GetSubResourcePixels(uint8_t inMipLevel, uint8_t inArrayLayer);
         EFunc() const Pixels& GetSubResourcePixels(uint8_t inMipLevel, uint8_t inArrayLayer) const;
         EFunc() void SetType(TextureType inType);
@@ -110,9 +113,14 @@ namespace Runtime {
         EFunc() RHI::Texture* GetRHI() const;
         EFunc() RHI::TextureView* GetViewRHI() const;
         EFunc() void UpdateMips();
+        // uploads a copy of the sub resource pixels, PostLoad() does the same only in the editor or with
+        // asset.texture.keepPixels on, it otherwise moves them into the upload and leaves the loaded texture without pixels
         EFunc() void UpdateRHI();
 
     private:
+        void CreateRHI(std::vector<Pixels>&& inSubResourcePixelsData);
+        void DiscardRHIUpload() const;
+
         EProperty() TextureType type;
         EProperty() TextureFormat format;
         EProperty() uint32_t width;
@@ -8,7 +8,10 @@
 #include <array>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <tuple>
+#include <type_traits>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
@@ -16,6 +19,7 @@
 #include <Common/Delegate.h>
 #include <Common/Utility.h>
 #include <Common/Memory.h>
+#include <Core/JobSystem.h>
 #include <Mirror/Mirror.h>
 #include <Runtime/Meta.h>
 #include <Runtime/Api.h>
@@ -30,6 +34,7 @@ namespace Runtime {
     using SystemClass = const Mirror::Class*;
 
     class ECRegistry;
+    class ECCommandBuffer;
     class Client;
     struct SystemSetupContext;
 
@@ -43,9 +48,15 @@ namespace Runtime {
         explicit System(ECRegistry& inRegistry, const SystemSetupContext&);
         virtual ~System();
         virtual void Tick(float inDeltaTimeSeconds);
+        // structural changes recorded here are played back after the system in a sequential group, or at the barrier
+        // after the group in a concurrent one. temporary entities recorded here resolve until the system ticks again
+        ECCommandBuffer& Commands();
 
     protected:
         ECRegistry& registry;
+
+    private:
+        Common::UniquePtr<ECCommandBuffer> commands;
     };
 }
 
@@ -53,8 +64,17 @@ namespace Runtime::Internal {
     using ArchetypeId = Mirror::TypeId;
     using ElemPtr = void*;
 
+    // archetypes store all component columns of a run of rows in one chunk, columns start on a cache line inside the
+    // chunk, row ranges of a multiple of parallelEachRowAlignment rows then never share a cache line with each other
+    constexpr size_t archetypeChunkSize = 16 * 1024;
+    constexpr size_t archetypeColumnAlignment = 64;
+    constexpr size_t parallelEachRowAlignment = 64;
+    // entities created by a command buffer before its playback, the low bits index the creations of the buffer
+    constexpr Entity temporaryEntityBit = 1u << 31;
+
     template <typename T> const Mirror::Class* GetClass();
     template <typename T> struct MemberFuncPtrTraits;
+    size_t GetParallelEachGrainSize(size_t inGrainSize, size_t inRowsPerChunk);
 
     class RUNTIME_API TagStorage {
     public:
@@ -119,6 +139,31 @@ namespace Runtime::Internal {
         TagStorage tags;
     };
 
+    // chunks of archetypeChunkSize bytes shared by the archetypes of every registry, chunks released by one archetype
+    // are reused by the next one that grows. archetypes hold a reference to the pool so that it outlives registries
+    // destroyed during static destruction
+    class RUNTIME_API ArchetypeChunkPool {
+    public:
+        static const Common::SharedPtr<ArchetypeChunkPool>& Get();
+
+        ArchetypeChunkPool();
+        ~ArchetypeChunkPool();
+
+        NonCopyable(ArchetypeChunkPool)
+        NonMovable(ArchetypeChunkPool)
+
+        ElemPtr Allocate();
+        void Free(ElemPtr inChunk);
+        void Trim();
+        size_t AllocatedCount() const;
+        size_t FreeCount() const;
+
+    private:
+        mutable std::mutex mutex;
+        std::vector<ElemPtr> freeChunks;
+        size_t allocatedNum;
+    };
+
     class RUNTIME_API Archetype {
     public:
         struct CompMapping {
@@ -155,12 +200,16 @@ namespace Runtime::Internal {
         template <typename C> const C& GetComp(size_t inElemIndex) const;
         ElemPtr GetCompAt(size_t inElemIndex, size_t inCompIndex);
         const void* GetCompAt(size_t inElemIndex, size_t inCompIndex) const;
-        ElemPtr GetCompColumn(size_t inCompIndex);
-        const void* GetCompColumn(size_t inCompIndex) const;
+        ElemPtr GetCompColumn(size_t inChunkIndex, size_t inCompIndex);
+        const void* GetCompColumn(size_t inChunkIndex, size_t inCompIndex) const;
         size_t GetCompIndex(CompClass inCompClass) const;
         template <typename C> size_t GetCompIndex() const;
         Entity EntityAt(size_t inElemIndex) const;
         size_t Count() const;
+        // chunks holding at least one row, rows [i * RowsPerChunk(), (i + 1) * RowsPerChunk()) live in chunk i
+        size_t ChunkCount() const;
+        size_t RowsPerChunk() const;
+        size_t ChunkRowCount(size_t inChunkIndex) const;
         auto All() const;
         const std::vector<CompRtti>& GetCompRttis() const;
         const TagStorage& GetTags() const;
@@ -170,24 +219,32 @@ namespace Runtime::Internal {
         const Transition* FindRemoveTransition(CompClass inClass) const;
         const Transition& CacheAddTransition(CompClass inClass, Archetype& inArchetype);
         const Transition& CacheRemoveTransition(CompClass inClass, Archetype& inArchetype);
+        std::vector<CompMapping> MakeCompMappings(const Archetype& inDstArchetype) const;
 
     private:
         using CompRttiIndex = size_t;
         size_t Capacity() const;
-        void Reserve(float inRatio = 1.5f);
+        void BuildChunkLayout();
         void DestroyElements();
         void ReleaseMemory();
         void AllocateNewElemBack();
-        ElemPtr CompAt(ElemPtr inMemory, size_t inCompIndex, size_t inElemIndex) const;
+        void ReleaseUnusedChunks();
+        ElemPtr AllocateChunk() const;
+        void FreeChunk(ElemPtr inChunk) const;
         const Transition& CacheTransition(std::vector<Transition>& inTransitions, CompClass inClass, Archetype& inArchetype);
 
         ArchetypeId id;
         size_t count;
-        size_t capacity;
         std::vector<CompRtti> rttiVec;
         TagStorage tags;
         std::unordered_map<CompClass, CompRttiIndex> rttiMap;
-        std::vector<ElemPtr> compMemory;
+        // rows that do not fit a pooled chunk, or components aligned beyond a cache line, use chunks of their own size
+        size_t rowsPerChunk;
+        size_t chunkSize;
+        size_t chunkAlignment;
+        Common::SharedPtr<ArchetypeChunkPool> chunkPool;
+        std::vector<ElemPtr> chunks;
+        std::vector<size_t> compOffsets;
         std::vector<size_t> compStrides;
         std::vector<Entity> elemMap;
         std::vector<Transition> addTransitions;
@@ -249,6 +306,97 @@ namespace Runtime::Internal {
         std::vector<Entity> allocated;
     };
 
+    // components and tags an archetype must or must not contain, includes keep the order of the columns a query
+    // resolves, the other classes are sorted so that equal filters compare equal
+    struct RUNTIME_API ArchetypeFilter {
+        struct Hash {
+            size_t operator()(const ArchetypeFilter& inFilter) const;
+        };
+
+        ArchetypeFilter();
+        ArchetypeFilter(std::vector<CompClass> inIncludes, std::vector<TagClass> inTagIncludes, std::vector<CompClass> inExcludes, std::vector<TagClass> inTagExcludes);
+
+        bool Matches(const Archetype& inArchetype) const;
+        bool operator==(const ArchetypeFilter& inRhs) const;
+
+        std::vector<CompClass> includes;
+        std::vector<TagClass> tagIncludes;
+        std::vector<CompClass> excludes;
+        std::vector<TagClass> tagExcludes;
+    };
+
+    // archetypes matching a filter with the column indices of the included components, queries are owned by the
+    // registry, which matches every archetype it creates against them instead of views scanning all archetypes
+    class RUNTIME_API ArchetypeQuery {
+    public:
+        struct Entry {
+            Archetype* archetype;
+            std::vector<size_t> compIndices;
+        };
+
+        explicit ArchetypeQuery(ArchetypeFilter inFilter);
+        NonCopyable(ArchetypeQuery)
+        NonMovable(ArchetypeQuery)
+
+        const ArchetypeFilter& Filter() const;
+        // entries are only appended, views iterate the first Count() entries seen at their construction by index
+        size_t Count() const;
+        const Entry& At(size_t inIndex) const;
+        void Match(Archetype& inArchetype);
+        void Reset();
+
+    private:
+        ArchetypeFilter filter;
+        std::vector<Entry> entries;
+    };
+
+    // components and global components a system reads and writes. system classes declare them with the reads and writes
+    // meta as '|' separated class names, e.g. EClass(reads=Runtime::WorldTransform, writes=Runtime::Camera|GFoo), writes
+    // imply reads. a system class without any of the two meta is exclusive, it is never scheduled beside another system
+    class RUNTIME_API SystemAccess {
+    public:
+        static SystemAccess FromClass(SystemClass inClass);
+        static SystemAccess Exclusive();
+
+        SystemAccess();
+
+        SystemAccess& Read(const Mirror::Class* inClass);
+        SystemAccess& Write(const Mirror::Class* inClass);
+        template <typename... C> SystemAccess& Read();
+        template <typename... C> SystemAccess& Write();
+        bool IsExclusive() const;
+        bool CanRead(const Mirror::Class* inClass) const;
+        bool CanWrite(const Mirror::Class* inClass) const;
+        bool ConflictsWith(const SystemAccess& inOther) const;
+
+    private:
+        bool exclusive;
+        std::unordered_set<const Mirror::Class*> reads;
+        std::unordered_set<const Mirror::Class*> writes;
+    };
+
+    // the access of the system ticking on this thread, debug builds check the registry accesses of systems in automatic
+    // groups against it. scopes nest, a thread that waits on a system job may run another one meanwhile. jobs spawned by
+    // a system carry its access into their own scope, a null access leaves the registry accesses unchecked
+    class RUNTIME_API SystemAccessScope {
+    public:
+        static const SystemAccess* Current();
+
+        explicit SystemAccessScope(const SystemAccess& inAccess);
+        explicit SystemAccessScope(const SystemAccess* inAccess);
+        ~SystemAccessScope();
+
+        NonCopyable(SystemAccessScope)
+        NonMovable(SystemAccessScope)
+
+    private:
+        const SystemAccess* lastAccess;
+    };
+
+    void CheckSystemAccess(const Mirror::Class* inClass, bool inWrite);
+    template <typename C> void CheckSystemAccess(bool inWrite);
+    void CheckSystemStructuralChange();
+
     class SystemFactory {
     public:
         explicit SystemFactory(SystemClass inClass);
@@ -256,12 +404,16 @@ namespace Runtime::Internal {
         std::unordered_map<std::string, Mirror::Any> GetArguments();
         const std::unordered_map<std::string, Mirror::Any>& GetArguments() const;
         SystemClass GetClass() const;
+        // overrides the access declared by the meta of the system class
+        void SetAccess(SystemAccess inAccess);
+        const SystemAccess& GetAccess() const;
 
     private:
         void BuildArgumentLists();
 
         SystemClass clazz;
         std::unordered_map<std::string, Mirror::Any> arguments;
+        SystemAccess access;
     };
 }
 
@@ -355,6 +507,14 @@ namespace Runtime {
         NonMovable(BasicView)
 
         template <typename F> void Each(F&& inFunc) const;
+        // splits every chunk of the matching archetypes into ranges of inGrainSize rows (whole chunks by default, rounded
+        // up to whole cache lines otherwise) and runs them on the job system, inFunc is called concurrently and must not
+        // touch the registry structure
+        template <typename F> void ParallelEach(F&& inFunc, size_t inGrainSize = 0, size_t inMaxConcurrency = 0) const;
+        // same as above with an accumulator passed first to inFunc, every range folds into its own copy of inIdentity
+        // and the partial results are reduced in range order, so the result does not depend on scheduling
+        template <typename A, typename F, typename Rd> requires std::is_invocable_r_v<A, Rd, const A&, const A&>
+        A ParallelEach(A inIdentity, F&& inFunc, Rd&& inReduce, size_t inGrainSize = 0, size_t inMaxConcurrency = 0) const;
         const ResultVector& All() const;
         size_t Count() const;
         ConstIter Begin() const;
@@ -366,19 +526,27 @@ namespace Runtime {
         using CompColumnPtr = std::conditional_t<std::is_const_v<R>, const void*, void*>;
         using CompColumns = std::array<CompColumnPtr, sizeof...(C)>;
 
-        struct QueryEntry {
-            Internal::ArchetypeId archetype;
-            std::array<size_t, sizeof...(C)> compIndices;
+        using ArchetypeType = std::conditional_t<std::is_const_v<R>, const Internal::Archetype, Internal::Archetype>;
+        using QueryEntry = Internal::ArchetypeQuery::Entry;
+
+        // rows [begin, end) of one archetype chunk, chunk row 0 is element firstElem of the archetype
+        struct RowRange {
+            ArchetypeType* archetype;
+            CompColumns compColumns;
+            size_t firstElem;
+            size_t begin;
+            size_t end;
         };
 
-        template <typename A, size_t... I> CompColumns ResolveCompColumns(A& inArchetype, const QueryEntry& inEntry, std::index_sequence<I...>) const;
-        template <size_t... I> auto MakeResult(Internal::Archetype& inArchetype, size_t inElemIndex, const CompColumns& inCompColumns, std::index_sequence<I...>) const;
-        template <size_t... I> auto MakeResult(const Internal::Archetype& inArchetype, size_t inElemIndex, const CompColumns& inCompColumns, std::index_sequence<I...>) const;
+        template <typename F, typename... P> void EachInRange(F& inFunc, const RowRange& inRange, P&... inPrefix) const;
+        std::vector<RowRange> SplitRowRanges(size_t inGrainSize) const;
+        template <size_t... I> CompColumns ResolveCompColumns(ArchetypeType& inArchetype, const QueryEntry& inEntry, size_t inChunkIndex, std::index_sequence<I...>) const;
+        template <size_t... I> auto MakeResult(Entity inEntity, const CompColumns& inCompColumns, size_t inRowIndex, std::index_sequence<I...>) const;
         void Materialize() const;
-        void Evaluate(R& inRegistry);
+        static const Internal::ArchetypeFilter& Filter();
 
-        R* registry;
-        std::vector<QueryEntry> query;
+        const Internal::ArchetypeQuery* query;
+        size_t queryCount;
         mutable ResultVector result;
         mutable bool materialized;
     };
@@ -418,6 +586,10 @@ namespace Runtime {
         NonMovable(BasicRuntimeView)
 
         template <typename F> void Each(F&& inFunc) const;
+        // see BasicView::ParallelEach
+        template <typename F> void ParallelEach(F&& inFunc, size_t inGrainSize = 0, size_t inMaxConcurrency = 0) const;
+        template <typename A, typename F, typename Rd> requires std::is_invocable_r_v<A, Rd, const A&, const A&>
+        A ParallelEach(A inIdentity, F&& inFunc, Rd&& inReduce, size_t inGrainSize = 0, size_t inMaxConcurrency = 0) const;
         size_t Count() const;
         ConstIter Begin() const;
         ConstIter End() const;
@@ -426,22 +598,32 @@ namespace Runtime {
 
     private:
         using CompColumnPtr = std::conditional_t<std::is_const_v<R>, const void*, void*>;
-
-        struct QueryEntry {
-            Internal::ArchetypeId archetype;
-            std::vector<size_t> compIndices;
+        using ArchetypeType = std::conditional_t<std::is_const_v<R>, const Internal::Archetype, Internal::Archetype>;
+        using QueryEntry = Internal::ArchetypeQuery::Entry;
+
+        // see BasicView::RowRange, the columns of the chunk are stored aside
+        struct RowRange {
+            ArchetypeType* archetype;
+            size_t compColumnsIndex;
+            size_t firstElem;
+            size_t begin;
+            size_t end;
         };
 
-        template <typename ArgTuple, size_t... I> auto BuildCompSlots(std::index_sequence<I...>) const;
-        template <typename F, typename ArgTuple, typename A, size_t... I> void InvokeTraverseFuncInternal(F&& inFunc, A& inArchetype, size_t inElemIndex, const std::vector<CompColumnPtr>& inCompColumns, const std::array<size_t, sizeof...(I)>& inCompSlots, std::index_sequence<I...>) const;
-        template <typename C> decltype(auto) GetCompRef(size_t inElemIndex, const std::vector<CompColumnPtr>& inCompColumns, size_t inCompSlot) const;
+        // components of inFunc start after the entity and the sizeof...(P) leading arguments
+        template <typename F, size_t Offset> auto BuildCompSlots() const;
+        template <typename ArgTuple, size_t Offset, size_t... I> auto BuildCompSlots(std::index_sequence<I...>) const;
+        template <typename F, typename S, typename... P> void EachInRange(F& inFunc, const S& inCompSlots, const RowRange& inRange, const std::vector<CompColumnPtr>& inCompColumns, P&... inPrefix) const;
+        template <typename ArgTuple, size_t Offset, typename F, size_t... I, typename... P> void InvokeTraverseFuncInternal(F& inFunc, Entity inEntity, size_t inRowIndex, const std::vector<CompColumnPtr>& inCompColumns, const std::array<size_t, sizeof...(I)>& inCompSlots, std::index_sequence<I...>, P&... inPrefix) const;
+        std::vector<RowRange> SplitRowRanges(size_t inGrainSize, std::vector<std::vector<CompColumnPtr>>& outCompColumns) const;
+        void ResolveCompColumns(ArchetypeType& inArchetype, const QueryEntry& inEntry, size_t inChunkIndex, std::vector<CompColumnPtr>& outCompColumns) const;
+        size_t GetCompSlot(CompClass inClass) const;
+        template <typename C> decltype(auto) GetCompRef(size_t inRowIndex, const std::vector<CompColumnPtr>& inCompColumns, size_t inCompSlot) const;
         void MaterializeEntities() const;
-        void Evaluate(R& inRegistry, const RuntimeFilter& inFilter);
+        static Internal::ArchetypeFilter MakeArchetypeFilter(const RuntimeFilter& inFilter);
 
-        R* registry;
-        std::vector<CompClass> includes;
-        std::unordered_map<CompClass, size_t> slotMap;
-        std::vector<QueryEntry> query;
+        const Internal::ArchetypeQuery* query;
+        size_t queryCount;
         mutable ResultEntitiesVector resultEntities;
         mutable bool materialized;
     };
@@ -705,6 +887,7 @@ namespace Runtime {
     private:
         template <typename... T> friend class BasicView;
         template <ECRegistryOrConst R> friend class BasicRuntimeView;
+        friend class ECCommandBuffer;
 
         void NotifyConstructedDyn(CompClass inClass, Entity inEntity);
         void NotifyRemoveDyn(CompClass inClass, Entity inEntity);
@@ -712,6 +895,9 @@ namespace Runtime {
         void GNotifyRemoveDyn(CompClass inClass);
         void RegisterDataCompClass(CompClass inClass);
         void RegisterTagClass(TagClass inClass);
+        Internal::Archetype& EmplaceArchetype(Internal::ArchetypeLayout inLayout);
+        const Internal::ArchetypeQuery& EmplaceQuery(const Internal::ArchetypeFilter& inFilter) const;
+        void RebuildQueries();
         Internal::EntityPool::Location MoveEntityForAdd(const Internal::CompRtti& inRtti, Entity inEntity);
         Internal::EntityPool::Location MoveEntityForAddTag(TagClass inClass, Entity inEntity);
         Internal::EntityPool::Location MoveEntityForAdd(CompClass inClass, Entity inEntity, const Internal::EntityPool::Location& inLocation, Internal::ArchetypeLayout inLayout);
@@ -728,11 +914,92 @@ namespace Runtime {
         // transients, not copy or move
         std::unordered_map<CompClass, CompEvents> compEvents;
         std::unordered_map<GCompClass, GCompEvents> globalCompEvents;
+        // queries of the views built so far, views of const registries add queries too
+        mutable std::mutex queryMutex;
+        mutable std::unordered_map<Internal::ArchetypeFilter, Common::UniquePtr<Internal::ArchetypeQuery>, Internal::ArchetypeFilter::Hash> queries;
+    };
+
+    // records structural changes of a registry to apply them later on the thread that owns the registry, every thread
+    // that records needs a buffer of its own. entities created by a buffer get temporary ids that only this buffer can
+    // use until playback resolves them. playback folds the commands of every entity into one archetype change and moves
+    // the entities that share a source archetype and a change together, in the order they were first recorded. commands
+    // on entities that are no longer valid at playback, e.g. destroyed by another buffer, are skipped
+    class RUNTIME_API ECCommandBuffer {
+    public:
+        static bool IsTemporary(Entity inEntity);
+
+        explicit ECCommandBuffer(ECRegistry& inRegistry);
+        ~ECCommandBuffer();
+
+        NonCopyable(ECCommandBuffer)
+        NonMovable(ECCommandBuffer)
+
+        Entity Create();
+        void Destroy(Entity inEntity);
+        template <typename C, typename... Args> void Emplace(Entity inEntity, Args&&... inArgs);
+        template <typename C> void Remove(Entity inEntity);
+        template <typename T> void AddTag(Entity inEntity);
+        template <typename T> void RemoveTag(Entity inEntity);
+        void EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs);
+        void RemoveDyn(CompClass inClass, Entity inEntity);
+        void AddTagDyn(TagClass inClass, Entity inEntity);
+        void RemoveTagDyn(TagClass inClass, Entity inEntity);
+        // temporary entities resolve to the entities created by playback until the buffer is cleared or its temporaries
+        // are reset
+        Entity Resolve(Entity inEntity) const;
+        size_t Count() const;
+        bool Empty() const;
+        void Playback();
+        // reuses the temporary ids once all of them are resolved, does nothing while some still wait for playback
+        void ResetTemporaries();
+        void Clear();
+
+    private:
+        enum class CommandType : uint8_t {
+            destroy,
+            emplace,
+            remove,
+            addTag,
+            removeTag,
+            max
+        };
+
+        struct Command {
+            CommandType type;
+            Entity entity;
+            const Mirror::Class* clazz;
+            // index of the recorded component value, emplace only
+            size_t valueIndex;
+        };
+
+        struct CompValue {
+            Internal::CompRtti rtti;
+            Internal::ElemPtr memory;
+        };
+
+        void Record(CommandType inType, Entity inEntity, const Mirror::Class* inClass, size_t inValueIndex = 0);
+        Internal::ElemPtr AllocateValue(const Internal::CompRtti& inRtti);
+        void ReleaseValues();
+
+        ECRegistry& registry;
+        Common::SharedPtr<Internal::ArchetypeChunkPool> chunkPool;
+        std::vector<Command> commands;
+        // values are placed in pooled chunks and never move until playback, values that do not fit a chunk use their
+        // own allocation
+        std::vector<CompValue> values;
+        std::vector<Internal::ElemPtr> valueChunks;
+        size_t valueChunkOffset;
+        // temporary entities created so far, the ones with an index past resolvedEntities are created by next playback
+        size_t temporaryNum;
+        std::vector<Entity> resolvedEntities;
     };
 
+    // automatic groups tick systems whose declared accesses do not conflict in parallel, a system waits for every system
+    // registered before it that it conflicts with. setup and teardown of an automatic group stay sequential
     enum class SystemExecuteStrategy : uint8_t {
         sequential,
         concurrent,
+        automatic,
         max
     };
 
@@ -787,9 +1054,14 @@ namespace Runtime {
         std::vector<SystemGroup> systemGroups;
     };
 
+    // the system graph is compiled into job graphs once when the pipeline is created, every action re-executes one of the
+    // compiled graphs on the engine job system. ticks schedule automatic groups by the accesses of their systems, setup
+    // and teardown run automatic groups sequentially since constructors and destructors do not declare their accesses
     class SystemPipeline {
     public:
         explicit SystemPipeline(const SystemGraph& inGraph);
+        NonCopyable(SystemPipeline)
+        NonMovable(SystemPipeline)
 
     private:
         struct SystemContext {
@@ -805,9 +1077,15 @@ namespace Runtime {
         friend class SystemGraphExecutor;
         using ActionFunc = std::function<void(SystemContext&)>;
 
-        void ParallelPerformAction(const ActionFunc& inActionFunc);
+        static void PlaybackCommands(SystemContext& inSystemContext);
+
+        void CompileJobGraph(Core::JobGraph& outJobGraph, bool inScheduleAutomatic);
+        void ParallelPerformAction(Core::JobGraph& inJobGraph, const ActionFunc& inActionFunc);
 
         std::vector<SystemGroupContext> systemGraph;
+        Core::JobGraph lifecycleJobGraph;
+        Core::JobGraph tickJobGraph;
+        const ActionFunc* currentAction;
     };
 
     enum class PlayType : uint8_t {
@@ -893,6 +1171,51 @@ namespace Runtime::Internal {
         using ArgsTupleType = std::tuple<Args...>;
     };
 
+    inline size_t GetParallelEachGrainSize(size_t inGrainSize, size_t inRowsPerChunk)
+    {
+        if (inGrainSize == 0) {
+            return inRowsPerChunk;
+        }
+        return (inGrainSize + parallelEachRowAlignment - 1) / parallelEachRowAlignment * parallelEachRowAlignment;
+    }
+
+    inline void CheckSystemAccess(const Mirror::Class* inClass, bool inWrite)
+    {
+#if BUILD_CONFIG_DEBUG
+        const SystemAccess* access = SystemAccessScope::Current();
+        AssertWithReason(access == nullptr || (inWrite ? access->CanWrite(inClass) : access->CanRead(inClass)), "system accessed a component or global component it did not declare");
+#endif
+    }
+
+    template <typename C>
+    void CheckSystemAccess(bool inWrite)
+    {
+#if BUILD_CONFIG_DEBUG
+        CheckSystemAccess(GetClass<std::remove_const_t<C>>(), inWrite);
+#endif
+    }
+
+    inline void CheckSystemStructuralChange()
+    {
+#if BUILD_CONFIG_DEBUG
+        AssertWithReason(SystemAccessScope::Current() == nullptr, "systems of an automatic group must not change the registry structure, entities are changed through the command buffer");
+#endif
+    }
+
+    template <typename... C>
+    SystemAccess& SystemAccess::Read()
+    {
+        (Read(GetClass<C>()), ...);
+        return *this;
+    }
+
+    template <typename... C>
+    SystemAccess& SystemAccess::Write()
+    {
+        (Write(GetClass<C>()), ...);
+        return *this;
+    }
+
     inline auto Archetype::All() const
     {
         return std::views::all(elemMap);
@@ -900,29 +1223,40 @@ namespace Runtime::Internal {
 
     inline ElemPtr Archetype::GetCompAt(size_t inElemIndex, size_t inCompIndex)
     {
-        return CompAt(compMemory[inCompIndex], inCompIndex, inElemIndex);
+        return static_cast<uint8_t*>(GetCompColumn(inElemIndex / rowsPerChunk, inCompIndex)) + inElemIndex % rowsPerChunk * compStrides[inCompIndex];
     }
 
     inline const void* Archetype::GetCompAt(size_t inElemIndex, size_t inCompIndex) const
     {
-        return CompAt(compMemory[inCompIndex], inCompIndex, inElemIndex);
+        return static_cast<const uint8_t*>(GetCompColumn(inElemIndex / rowsPerChunk, inCompIndex)) + inElemIndex % rowsPerChunk * compStrides[inCompIndex];
+    }
+
+    inline ElemPtr Archetype::GetCompColumn(size_t inChunkIndex, size_t inCompIndex)
+    {
+        Assert(inChunkIndex < chunks.size() && inCompIndex < compOffsets.size());
+        return static_cast<uint8_t*>(chunks[inChunkIndex]) + compOffsets[inCompIndex];
     }
 
-    inline ElemPtr Archetype::GetCompColumn(size_t inCompIndex)
+    inline const void* Archetype::GetCompColumn(size_t inChunkIndex, size_t inCompIndex) const
     {
-        Assert(inCompIndex < compMemory.size());
-        return compMemory[inCompIndex];
+        Assert(inChunkIndex < chunks.size() && inCompIndex < compOffsets.size());
+        return static_cast<const uint8_t*>(chunks[inChunkIndex]) + compOffsets[inCompIndex];
     }
 
-    inline const void* Archetype::GetCompColumn(size_t inCompIndex) const
+    inline size_t Archetype::ChunkCount() const
     {
-        Assert(inCompIndex < compMemory.size());
-        return compMemory[inCompIndex];
+        return (count + rowsPerChunk - 1) / rowsPerChunk;
     }
 
-    inline ElemPtr Archetype::CompAt(ElemPtr inMemory, size_t inCompIndex, size_t inElemIndex) const
+    inline size_t Archetype::RowsPerChunk() const
     {
-        return static_cast<uint8_t*>(inMemory) + (inElemIndex * compStrides[inCompIndex]);
+        return rowsPerChunk;
+    }
+
+    inline size_t Archetype::ChunkRowCount(size_t inChunkIndex) const
+    {
+        Assert(inChunkIndex < ChunkCount());
+        return std::min(count - inChunkIndex * rowsPerChunk, rowsPerChunk);
     }
 
     inline Entity Archetype::EntityAt(size_t inElemIndex) const
@@ -1035,32 +1369,64 @@ namespace Runtime {
 
     template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
     BasicView<R, Contains<T...>, Exclude<E...>, C...>::BasicView(R& inRegistry)
-        : registry(&inRegistry)
+        : query(&inRegistry.EmplaceQuery(Filter()))
+        , queryCount(query->Count())
         , materialized(false)
     {
-        Evaluate(inRegistry);
+        (Internal::CheckSystemAccess<C>(!std::is_const_v<R> && !std::is_const_v<C>), ...);
     }
 
     template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
     template <typename F>
     void BasicView<R, Contains<T...>, Exclude<E...>, C...>::Each(F&& inFunc) const
     {
-        using Traits = Internal::MemberFuncPtrTraits<decltype(&F::operator())>;
+        for (size_t entryIndex = 0; entryIndex < queryCount; entryIndex++) {
+            const auto& entry = query->At(entryIndex);
+            ArchetypeType& archetype = *entry.archetype;
+            for (size_t chunk = 0; chunk < archetype.ChunkCount(); chunk++) {
+                const RowRange range { &archetype, ResolveCompColumns(archetype, entry, chunk, std::index_sequence_for<C...> {}), chunk * archetype.RowsPerChunk(), 0, archetype.ChunkRowCount(chunk) };
+                EachInRange(inFunc, range);
+            }
+        }
+    }
 
-        for (const auto& entry : query) {
-            auto& archetype = registry->archetypes.at(entry.archetype);
-            const auto count = archetype.Count();
-            if constexpr (Traits::ArgSize == 1) {
-                for (size_t i = 0; i < count; i++) {
-                    inFunc(archetype.EntityAt(i));
-                }
-            } else {
-                const CompColumns compColumns = ResolveCompColumns(archetype, entry, std::index_sequence_for<C...> {});
-                for (size_t i = 0; i < count; i++) {
-                    std::apply(inFunc, MakeResult(archetype, i, compColumns, std::index_sequence_for<C...> {}));
-                }
+    template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
+    template <typename F>
+    void BasicView<R, Contains<T...>, Exclude<E...>, C...>::ParallelEach(F&& inFunc, size_t inGrainSize, size_t inMaxConcurrency) const
+    {
+        const auto ranges = SplitRowRanges(inGrainSize);
+        // ranges may run on workers that are in the middle of another system job
+        const Internal::SystemAccess* access = Internal::SystemAccessScope::Current();
+        Core::JobSystem::Get().ParallelFor(ranges.size(), 1, [&](size_t inBegin, size_t inEnd) -> void {
+            const Internal::SystemAccessScope accessScope(access);
+            for (size_t i = inBegin; i < inEnd; i++) {
+                EachInRange(inFunc, ranges[i]);
             }
+        }, inMaxConcurrency);
+    }
+
+    template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
+    template <typename A, typename F, typename Rd> requires std::is_invocable_r_v<A, Rd, const A&, const A&>
+    A BasicView<R, Contains<T...>, Exclude<E...>, C...>::ParallelEach(A inIdentity, F&& inFunc, Rd&& inReduce, size_t inGrainSize, size_t inMaxConcurrency) const
+    {
+        const auto ranges = SplitRowRanges(inGrainSize);
+        std::vector<std::optional<A>> partials(ranges.size());
+        const Internal::SystemAccess* access = Internal::SystemAccessScope::Current();
+        Core::JobSystem::Get().ParallelFor(ranges.size(), 1, [&](size_t inBegin, size_t inEnd) -> void {
+            const Internal::SystemAccessScope accessScope(access);
+            for (size_t i = inBegin; i < inEnd; i++) {
+                // fold into a local copy, neighbouring partials are written by other workers
+                A partial = inIdentity;
+                EachInRange(inFunc, ranges[i], partial);
+                partials[i] = std::move(partial);
+            }
+        }, inMaxConcurrency);
+
+        A result = std::move(inIdentity);
+        for (const auto& partial : partials) {
+            result = inReduce(result, *partial);
         }
+        return result;
     }
 
     template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
@@ -1074,8 +1440,8 @@ namespace Runtime {
     size_t BasicView<R, Contains<T...>, Exclude<E...>, C...>::Count() const
     {
         size_t resultCount = 0;
-        for (const auto& entry : query) {
-            resultCount += registry->archetypes.at(entry.archetype).Count();
+        for (size_t entryIndex = 0; entryIndex < queryCount; entryIndex++) {
+            resultCount += query->At(entryIndex).archetype->Count();
         }
         return resultCount;
     }
@@ -1107,28 +1473,54 @@ namespace Runtime {
     }
 
     template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
-    template <typename A, size_t... I>
-    typename BasicView<R, Contains<T...>, Exclude<E...>, C...>::CompColumns BasicView<R, Contains<T...>, Exclude<E...>, C...>::ResolveCompColumns(A& inArchetype, const QueryEntry& inEntry, std::index_sequence<I...>) const
+    template <typename F, typename... P>
+    void BasicView<R, Contains<T...>, Exclude<E...>, C...>::EachInRange(F& inFunc, const RowRange& inRange, P&... inPrefix) const
     {
-        return { inArchetype.GetCompColumn(inEntry.compIndices[I])... };
+        using Traits = Internal::MemberFuncPtrTraits<decltype(&std::remove_cvref_t<F>::operator())>;
+
+        for (size_t i = inRange.begin; i < inRange.end; i++) {
+            const Entity entity = inRange.archetype->EntityAt(inRange.firstElem + i);
+            if constexpr (Traits::ArgSize == sizeof...(P) + 1) {
+                inFunc(inPrefix..., entity);
+            } else {
+                std::apply(inFunc, std::tuple_cat(std::forward_as_tuple(inPrefix...), MakeResult(entity, inRange.compColumns, i, std::index_sequence_for<C...> {})));
+            }
+        }
+    }
+
+    template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
+    std::vector<typename BasicView<R, Contains<T...>, Exclude<E...>, C...>::RowRange> BasicView<R, Contains<T...>, Exclude<E...>, C...>::SplitRowRanges(size_t inGrainSize) const
+    {
+        std::vector<RowRange> ranges;
+        for (size_t entryIndex = 0; entryIndex < queryCount; entryIndex++) {
+            const auto& entry = query->At(entryIndex);
+            ArchetypeType& archetype = *entry.archetype;
+            const size_t grainSize = Internal::GetParallelEachGrainSize(inGrainSize, archetype.RowsPerChunk());
+            for (size_t chunk = 0; chunk < archetype.ChunkCount(); chunk++) {
+                const CompColumns compColumns = ResolveCompColumns(archetype, entry, chunk, std::index_sequence_for<C...> {});
+                const auto rowCount = archetype.ChunkRowCount(chunk);
+                for (size_t begin = 0; begin < rowCount; begin += grainSize) {
+                    ranges.emplace_back(RowRange { &archetype, compColumns, chunk * archetype.RowsPerChunk(), begin, std::min(begin + grainSize, rowCount) });
+                }
+            }
+        }
+        return ranges;
     }
 
     template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
     template <size_t... I>
-    auto BasicView<R, Contains<T...>, Exclude<E...>, C...>::MakeResult(Internal::Archetype& inArchetype, size_t inElemIndex, const CompColumns& inCompColumns, std::index_sequence<I...>) const
+    typename BasicView<R, Contains<T...>, Exclude<E...>, C...>::CompColumns BasicView<R, Contains<T...>, Exclude<E...>, C...>::ResolveCompColumns(ArchetypeType& inArchetype, const QueryEntry& inEntry, size_t inChunkIndex, std::index_sequence<I...>) const
     {
-        return typename BasicView<R, Contains<T...>, Exclude<E...>, C...>::ResultVector::value_type(
-            inArchetype.EntityAt(inElemIndex),
-            static_cast<std::conditional_t<std::is_const_v<C>, const std::remove_const_t<C>, std::remove_const_t<C>>*>(inCompColumns[I])[inElemIndex]...);
+        return { inArchetype.GetCompColumn(inChunkIndex, inEntry.compIndices[I])... };
     }
 
     template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
     template <size_t... I>
-    auto BasicView<R, Contains<T...>, Exclude<E...>, C...>::MakeResult(const Internal::Archetype& inArchetype, size_t inElemIndex, const CompColumns& inCompColumns, std::index_sequence<I...>) const
+    auto BasicView<R, Contains<T...>, Exclude<E...>, C...>::MakeResult(Entity inEntity, const CompColumns& inCompColumns, size_t inRowIndex, std::index_sequence<I...>) const
     {
-        return typename BasicView<R, Contains<T...>, Exclude<E...>, C...>::ResultVector::value_type(
-            inArchetype.EntityAt(inElemIndex),
-            static_cast<const std::remove_const_t<C>*>(inCompColumns[I])[inElemIndex]...);
+        return typename ResultVector::value_type(
+            inEntity,
+            static_cast<std::conditional_t<std::is_const_v<R>, const std::remove_const_t<C>, C>*>(inCompColumns[I])[inRowIndex]...);
     }
 
     template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
@@ -1139,91 +1531,112 @@ namespace Runtime {
         }
 
         result.reserve(Count());
-        for (const auto& entry : query) {
-            auto& archetype = registry->archetypes.at(entry.archetype);
-            const auto count = archetype.Count();
-            const CompColumns compColumns = ResolveCompColumns(archetype, entry, std::index_sequence_for<C...> {});
-            for (size_t i = 0; i < count; i++) {
-                result.emplace_back(MakeResult(archetype, i, compColumns, std::index_sequence_for<C...> {}));
+        for (size_t entryIndex = 0; entryIndex < queryCount; entryIndex++) {
+            const auto& entry = query->At(entryIndex);
+            ArchetypeType& archetype = *entry.archetype;
+            for (size_t chunk = 0; chunk < archetype.ChunkCount(); chunk++) {
+                const CompColumns compColumns = ResolveCompColumns(archetype, entry, chunk, std::index_sequence_for<C...> {});
+                const auto firstElem = chunk * archetype.RowsPerChunk();
+                for (size_t i = 0; i < archetype.ChunkRowCount(chunk); i++) {
+                    result.emplace_back(MakeResult(archetype.EntityAt(firstElem + i), compColumns, i, std::index_sequence_for<C...> {}));
+                }
             }
         }
         materialized = true;
     }
 
     template <ECRegistryOrConst R, typename... T, typename... E, typename... C>
-    void BasicView<R, Contains<T...>, Exclude<E...>, C...>::Evaluate(R& inRegistry)
+    const Internal::ArchetypeFilter& BasicView<R, Contains<T...>, Exclude<E...>, C...>::Filter()
     {
         static_assert((std::is_empty_v<T> && ...), "Tags<> accepts only empty tag types");
         static_assert(((sizeof(T) == 1 && alignof(T) == 1) && ...), "tag components must have the one-byte empty layout");
 
-        std::vector<CompClass> includeCompIds;
-        includeCompIds.reserve(sizeof...(C));
-        (void) std::initializer_list<int> { ([&]() -> void {
-            includeCompIds.emplace_back(Internal::GetClass<std::decay_t<C>>());
-        }(), 0)... };
-
-        std::vector<TagClass> includeTagIds;
-        includeTagIds.reserve(sizeof...(T));
-        (void) std::initializer_list<int> { ([&]() -> void {
-            includeTagIds.emplace_back(Internal::GetClass<T>());
-        }(), 0)... };
-
-        std::vector<CompClass> excludeCompIds;
-        excludeCompIds.reserve(sizeof...(E));
-        (void) std::initializer_list<int> { ([&]() -> void {
-            excludeCompIds.emplace_back(Internal::GetClass<E>());
-        }(), 0)... };
-
-        for (auto& archetype : inRegistry.archetypes | std::views::values) {
-            const bool containsComps = std::ranges::all_of(includeCompIds, [&](CompClass clazz) -> bool { return archetype.ContainsComp(clazz); });
-            const bool containsTags = std::ranges::all_of(includeTagIds, [&](TagClass clazz) -> bool { return archetype.ContainsTag(clazz); });
-            if (!containsComps || !containsTags || !archetype.NotContainsAny(excludeCompIds)) {
-                continue;
-            }
-
-            query.emplace_back(QueryEntry {
-                archetype.Id(),
-                { archetype.GetCompIndex(Internal::GetClass<std::decay_t<C>>())... }
-            });
-        }
+        // excluded classes can be either components or tags
+        static const Internal::ArchetypeFilter filter(
+            { Internal::GetClass<std::decay_t<C>>()... },
+            { Internal::GetClass<T>()... },
+            { Internal::GetClass<E>()... },
+            { Internal::GetClass<E>()... });
+        return filter;
     }
 
     template <ECRegistryOrConst R>
     BasicRuntimeView<R>::BasicRuntimeView(R& inRegistry, const RuntimeFilter& inFilter)
-        : registry(&inRegistry)
+        : query(&inRegistry.EmplaceQuery(MakeArchetypeFilter(inFilter)))
+        , queryCount(query->Count())
         , materialized(false)
     {
-        Evaluate(inRegistry, inFilter);
+        for (const auto* clazz : inFilter.includes) {
+            Internal::CheckSystemAccess(clazz, !std::is_const_v<R>);
+        }
     }
 
     template <ECRegistryOrConst R>
     template <typename F>
     void BasicRuntimeView<R>::Each(F&& inFunc) const
     {
-        using Traits = Internal::MemberFuncPtrTraits<decltype(&F::operator())>;
-        const auto compSlots = BuildCompSlots<typename Traits::ArgsTupleType>(std::make_index_sequence<Traits::ArgSize - 1> {});
+        const auto compSlots = BuildCompSlots<F, 1>();
         std::vector<CompColumnPtr> compColumns;
-        compColumns.reserve(includes.size());
+        compColumns.reserve(query->Filter().includes.size());
+
+        for (size_t entryIndex = 0; entryIndex < queryCount; entryIndex++) {
+            const auto& entry = query->At(entryIndex);
+            ArchetypeType& archetype = *entry.archetype;
+            for (size_t chunk = 0; chunk < archetype.ChunkCount(); chunk++) {
+                ResolveCompColumns(archetype, entry, chunk, compColumns);
+                EachInRange(inFunc, compSlots, RowRange { &archetype, 0, chunk * archetype.RowsPerChunk(), 0, archetype.ChunkRowCount(chunk) }, compColumns);
+            }
+        }
+    }
 
-        for (const auto& entry : query) {
-            auto& archetype = registry->archetypes.at(entry.archetype);
-            const auto count = archetype.Count();
-            compColumns.clear();
-            for (const size_t compIndex : entry.compIndices) {
-                compColumns.emplace_back(archetype.GetCompColumn(compIndex));
+    template <ECRegistryOrConst R>
+    template <typename F>
+    void BasicRuntimeView<R>::ParallelEach(F&& inFunc, size_t inGrainSize, size_t inMaxConcurrency) const
+    {
+        const auto compSlots = BuildCompSlots<F, 1>();
+        std::vector<std::vector<CompColumnPtr>> compColumns;
+        const auto ranges = SplitRowRanges(inGrainSize, compColumns);
+        // see BasicView::ParallelEach
+        const Internal::SystemAccess* access = Internal::SystemAccessScope::Current();
+        Core::JobSystem::Get().ParallelFor(ranges.size(), 1, [&](size_t inBegin, size_t inEnd) -> void {
+            const Internal::SystemAccessScope accessScope(access);
+            for (size_t i = inBegin; i < inEnd; i++) {
+                EachInRange(inFunc, compSlots, ranges[i], compColumns[ranges[i].compColumnsIndex]);
             }
-            for (size_t i = 0; i < count; i++) {
-                InvokeTraverseFuncInternal<F, typename Traits::ArgsTupleType>(std::forward<F>(inFunc), archetype, i, compColumns, compSlots, std::make_index_sequence<Traits::ArgSize - 1> {});
+        }, inMaxConcurrency);
+    }
+
+    template <ECRegistryOrConst R>
+    template <typename A, typename F, typename Rd> requires std::is_invocable_r_v<A, Rd, const A&, const A&>
+    A BasicRuntimeView<R>::ParallelEach(A inIdentity, F&& inFunc, Rd&& inReduce, size_t inGrainSize, size_t inMaxConcurrency) const
+    {
+        const auto compSlots = BuildCompSlots<F, 2>();
+        std::vector<std::vector<CompColumnPtr>> compColumns;
+        const auto ranges = SplitRowRanges(inGrainSize, compColumns);
+        std::vector<std::optional<A>> partials(ranges.size());
+        const Internal::SystemAccess* access = Internal::SystemAccessScope::Current();
+        Core::JobSystem::Get().ParallelFor(ranges.size(), 1, [&](size_t inBegin, size_t inEnd) -> void {
+            const Internal::SystemAccessScope accessScope(access);
+            for (size_t i = inBegin; i < inEnd; i++) {
+                A partial = inIdentity;
+                EachInRange(inFunc, compSlots, ranges[i], compColumns[ranges[i].compColumnsIndex], partial);
+                partials[i] = std::move(partial);
             }
+        }, inMaxConcurrency);
+
+        A result = std::move(inIdentity);
+        for (const auto& partial : partials) {
+            result = inReduce(result, *partial);
         }
+        return result;
     }
 
     template <ECRegistryOrConst R>
     size_t BasicRuntimeView<R>::Count() const
     {
         size_t resultCount = 0;
-        for (const auto& entry : query) {
-            resultCount += registry->archetypes.at(entry.archetype).Count();
+        for (size_t entryIndex = 0; entryIndex < queryCount; entryIndex++) {
+            resultCount += query->At(entryIndex).archetype->Count();
         }
         return resultCount;
     }
@@ -1255,31 +1668,89 @@ namespace Runtime {
     }
 
     template <ECRegistryOrConst R>
-    template <typename ArgTuple, size_t... I>
+    template <typename F, size_t Offset>
+    auto BasicRuntimeView<R>::BuildCompSlots() const
+    {
+        using Traits = Internal::MemberFuncPtrTraits<decltype(&std::remove_cvref_t<F>::operator())>;
+        return BuildCompSlots<typename Traits::ArgsTupleType, Offset>(std::make_index_sequence<Traits::ArgSize - Offset> {});
+    }
+
+    template <ECRegistryOrConst R>
+    template <typename ArgTuple, size_t Offset, size_t... I>
     auto BasicRuntimeView<R>::BuildCompSlots(std::index_sequence<I...>) const
     {
         return std::array<size_t, sizeof...(I)> {
-            slotMap.at(Internal::GetClass<std::decay_t<std::tuple_element_t<I + 1, ArgTuple>>>())...
+            GetCompSlot(Internal::GetClass<std::decay_t<std::tuple_element_t<I + Offset, ArgTuple>>>())...
         };
     }
 
     template <ECRegistryOrConst R>
-    template <typename F, typename ArgTuple, typename A, size_t... I>
-    void BasicRuntimeView<R>::InvokeTraverseFuncInternal(F&& inFunc, A& inArchetype, size_t inElemIndex, const std::vector<CompColumnPtr>& inCompColumns, const std::array<size_t, sizeof...(I)>& inCompSlots, std::index_sequence<I...>) const
+    template <typename F, typename S, typename... P>
+    void BasicRuntimeView<R>::EachInRange(F& inFunc, const S& inCompSlots, const RowRange& inRange, const std::vector<CompColumnPtr>& inCompColumns, P&... inPrefix) const
+    {
+        using Traits = Internal::MemberFuncPtrTraits<decltype(&std::remove_cvref_t<F>::operator())>;
+        constexpr size_t offset = sizeof...(P) + 1;
+
+        for (size_t i = inRange.begin; i < inRange.end; i++) {
+            InvokeTraverseFuncInternal<typename Traits::ArgsTupleType, offset>(inFunc, inRange.archetype->EntityAt(inRange.firstElem + i), i, inCompColumns, inCompSlots, std::make_index_sequence<Traits::ArgSize - offset> {}, inPrefix...);
+        }
+    }
+
+    template <ECRegistryOrConst R>
+    template <typename ArgTuple, size_t Offset, typename F, size_t... I, typename... P>
+    void BasicRuntimeView<R>::InvokeTraverseFuncInternal(F& inFunc, Entity inEntity, size_t inRowIndex, const std::vector<CompColumnPtr>& inCompColumns, const std::array<size_t, sizeof...(I)>& inCompSlots, std::index_sequence<I...>, P&... inPrefix) const
     {
-        inFunc(inArchetype.EntityAt(inElemIndex), GetCompRef<std::tuple_element_t<I + 1, ArgTuple>>(inElemIndex, inCompColumns, inCompSlots[I])...);
+        inFunc(inPrefix..., inEntity, GetCompRef<std::tuple_element_t<I + Offset, ArgTuple>>(inRowIndex, inCompColumns, inCompSlots[I])...);
+    }
+
+    template <ECRegistryOrConst R>
+    std::vector<typename BasicRuntimeView<R>::RowRange> BasicRuntimeView<R>::SplitRowRanges(size_t inGrainSize, std::vector<std::vector<CompColumnPtr>>& outCompColumns) const
+    {
+        std::vector<RowRange> ranges;
+        for (size_t entryIndex = 0; entryIndex < queryCount; entryIndex++) {
+            const auto& entry = query->At(entryIndex);
+            ArchetypeType& archetype = *entry.archetype;
+            const size_t grainSize = Internal::GetParallelEachGrainSize(inGrainSize, archetype.RowsPerChunk());
+            for (size_t chunk = 0; chunk < archetype.ChunkCount(); chunk++) {
+                ResolveCompColumns(archetype, entry, chunk, outCompColumns.emplace_back());
+                const auto rowCount = archetype.ChunkRowCount(chunk);
+                for (size_t begin = 0; begin < rowCount; begin += grainSize) {
+                    ranges.emplace_back(RowRange { &archetype, outCompColumns.size() - 1, chunk * archetype.RowsPerChunk(), begin, std::min(begin + grainSize, rowCount) });
+                }
+            }
+        }
+        return ranges;
+    }
+
+    template <ECRegistryOrConst R>
+    void BasicRuntimeView<R>::ResolveCompColumns(ArchetypeType& inArchetype, const QueryEntry& inEntry, size_t inChunkIndex, std::vector<CompColumnPtr>& outCompColumns) const
+    {
+        outCompColumns.clear();
+        outCompColumns.reserve(inEntry.compIndices.size());
+        for (const size_t compIndex : inEntry.compIndices) {
+            outCompColumns.emplace_back(inArchetype.GetCompColumn(inChunkIndex, compIndex));
+        }
+    }
+
+    template <ECRegistryOrConst R>
+    size_t BasicRuntimeView<R>::GetCompSlot(CompClass inClass) const
+    {
+        const auto& includes = query->Filter().includes;
+        const auto iter = std::ranges::find(includes, inClass);
+        Assert(iter != includes.end());
+        return iter - includes.begin();
     }
 
     template <ECRegistryOrConst R>
     template <typename C>
-    decltype(auto) BasicRuntimeView<R>::GetCompRef(size_t inElemIndex, const std::vector<CompColumnPtr>& inCompColumns, size_t inCompSlot) const
+    decltype(auto) BasicRuntimeView<R>::GetCompRef(size_t inRowIndex, const std::vector<CompColumnPtr>& inCompColumns, size_t inCompSlot) const
     {
         static_assert(std::is_reference_v<C>);
         using Value = std::remove_cv_t<std::remove_reference_t<C>>;
         if constexpr (std::is_const_v<std::remove_reference_t<C>> || std::is_const_v<R>) {
-            return static_cast<const Value*>(inCompColumns[inCompSlot])[inElemIndex];
+            return static_cast<const Value*>(inCompColumns[inCompSlot])[inRowIndex];
         } else {
-            return static_cast<Value*>(inCompColumns[inCompSlot])[inElemIndex];
+            return static_cast<Value*>(inCompColumns[inCompSlot])[inRowIndex];
         }
     }
 
@@ -1291,8 +1762,8 @@ namespace Runtime {
         }
 
         resultEntities.reserve(Count());
-        for (const auto& entry : query) {
-            const auto& archetype = registry->archetypes.at(entry.archetype);
+        for (size_t entryIndex = 0; entryIndex < queryCount; entryIndex++) {
+            const auto& archetype = *query->At(entryIndex).archetype;
             const auto count = archetype.Count();
             for (size_t i = 0; i < count; i++) {
                 resultEntities.emplace_back(archetype.EntityAt(i));
@@ -1302,34 +1773,18 @@ namespace Runtime {
     }
 
     template <ECRegistryOrConst R>
-    void BasicRuntimeView<R>::Evaluate(R& inRegistry, const RuntimeFilter& inFilter)
+    Internal::ArchetypeFilter BasicRuntimeView<R>::MakeArchetypeFilter(const RuntimeFilter& inFilter)
     {
-        includes.assign(inFilter.includes.begin(), inFilter.includes.end());
-        const std::vector tagIncludes(inFilter.tagIncludes.begin(), inFilter.tagIncludes.end());
-        const std::vector excludes(inFilter.excludes.begin(), inFilter.excludes.end());
-        const std::vector tagExcludes(inFilter.tagExcludes.begin(), inFilter.tagExcludes.end());
-
-        slotMap.reserve(includes.size());
-        for (auto i = 0; i < includes.size(); i++) {
-            slotMap.emplace(includes[i], i);
-        }
-
-        for (auto& archetype : inRegistry.archetypes | std::views::values) {
-            const bool containsComps = std::ranges::all_of(includes, [&](CompClass clazz) -> bool { return archetype.ContainsComp(clazz); });
-            const bool containsTags = std::ranges::all_of(tagIncludes, [&](TagClass clazz) -> bool { return archetype.ContainsTag(clazz); });
-            const bool excludesComps = std::ranges::none_of(excludes, [&](CompClass clazz) -> bool { return archetype.ContainsComp(clazz); });
-            const bool excludesTags = std::ranges::none_of(tagExcludes, [&](TagClass clazz) -> bool { return archetype.ContainsTag(clazz); });
-            if (!containsComps || !containsTags || !excludesComps || !excludesTags) {
-                continue;
-            }
+        // the order of the sets is arbitrary, sorted includes let equal filters share one query
+        std::vector<CompClass> includes(inFilter.includes.begin(), inFilter.includes.end());
+        std::ranges::sort(includes);
 
-            auto& entry = query.emplace_back();
-            entry.archetype = archetype.Id();
-            entry.compIndices.reserve(includes.size());
-            for (const auto* clazz : includes) {
-                entry.compIndices.emplace_back(archetype.GetCompIndex(clazz));
-            }
-        }
+        return {
+            std::move(includes),
+            { inFilter.tagIncludes.begin(), inFilter.tagIncludes.end() },
+            { inFilter.excludes.begin(), inFilter.excludes.end() },
+            { inFilter.tagExcludes.begin(), inFilter.tagExcludes.end() }
+        };
     }
 
     template <typename C>
@@ -1550,6 +2005,7 @@ namespace Runtime {
     template <typename C>
     C& ECRegistry::Get(Entity inEntity)
     {
+        Internal::CheckSystemAccess<C>(true);
         const auto location = entities.GetLocation(inEntity);
         return location.archetype->template GetComp<C>(location.elemIndex);
     }
@@ -1557,6 +2013,7 @@ namespace Runtime {
     template <typename C>
     const C& ECRegistry::Get(Entity inEntity) const
     {
+        Internal::CheckSystemAccess<C>(false);
         const auto location = entities.GetLocation(inEntity);
         return location.archetype->template GetComp<C>(location.elemIndex);
     }
@@ -1706,6 +2163,36 @@ namespace Runtime {
         GNotifyUpdatedDyn(Internal::GetClass<G>());
     }
 
+    template <typename C, typename ... Args>
+    void ECCommandBuffer::Emplace(Entity inEntity, Args&&... inArgs)
+    {
+        const Internal::CompRtti rtti = Internal::CompRtti::Create<C>();
+        const Internal::ElemPtr memory = AllocateValue(rtti);
+        std::construct_at(static_cast<C*>(memory), std::forward<Args>(inArgs)...);
+        Record(CommandType::emplace, inEntity, rtti.Class(), values.size());
+        values.emplace_back(rtti, memory);
+    }
+
+    template <typename C>
+    void ECCommandBuffer::Remove(Entity inEntity)
+    {
+        RemoveDyn(Internal::GetClass<C>(), inEntity);
+    }
+
+    template <typename T>
+    void ECCommandBuffer::AddTag(Entity inEntity)
+    {
+        static_assert(std::is_empty_v<T> && sizeof(T) == 1 && alignof(T) == 1, "tag components must have the one-byte empty layout");
+        AddTagDyn(Internal::GetClass<T>(), inEntity);
+    }
+
+    template <typename T>
+    void ECCommandBuffer::RemoveTag(Entity inEntity)
+    {
+        static_assert(std::is_empty_v<T> && sizeof(T) == 1 && alignof(T) == 1, "tag components must have the one-byte empty layout");
+        RemoveTagDyn(Internal::GetClass<T>(), inEntity);
+    }
+
     template <typename S>
     Internal::SystemFactory& SystemGroup::EmplaceSystem()
     {
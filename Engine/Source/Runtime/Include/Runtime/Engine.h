@@ -45,8 +45,8 @@ namespace Runtime {
 
         std::unordered_set<World*> worlds;
         Render::RenderModule* renderModule;
-        std::future<void> lastFrameRenderThreadFence;
-        std::future<void> last2FrameRenderThreadFence;
+        Render::RenderThread::Fence lastFrameRenderThreadFence;
+        Render::RenderThread::Fence last2FrameRenderThreadFence;
     };
 
     class RUNTIME_API MinEngine final : public Engine {
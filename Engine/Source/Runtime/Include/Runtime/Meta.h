@@ -13,5 +13,7 @@ namespace Runtime {
         static constexpr const auto* globalComp = "globalComp";
         static constexpr const auto* gameReadOnly = "gameReadOnly";
         static constexpr const auto* tag = "tag";
+        static constexpr const auto* reads = "reads";
+        static constexpr const auto* writes = "writes";
     };
 }
@@ -4,7 +4,8 @@
 
 #pragma once
 
-#include <optional>
+#include <mutex>
+#include <vector>
 
 #include <Runtime/ECS.h>
 #include <Runtime/Component/Light.h>
@@ -19,6 +20,55 @@
 #include <Render/SceneProxy/Primitive.h>
 #include <Render/VertexFactory.h>
 
+namespace Runtime::Internal {
+    // per-frame changes of one scene proxy type, recorded in one pass on the game thread and applied by a single render
+    // thread task, every array pair is index aligned
+    template <typename Component, typename SceneProxy>
+    struct SceneProxyDelta {
+        void Clear();
+        bool Empty() const;
+        void Apply(Render::Scene& inScene);
+
+        std::vector<Entity> removed;
+        std::vector<Entity> created;
+        std::vector<Component> createdComponents;
+        std::vector<Common::FMat4x4> createdLocalToWorlds;
+        std::vector<Entity> updated;
+        std::vector<Component> updatedComponents;
+        std::vector<Entity> transformed;
+        std::vector<Common::FMat4x4> transformedLocalToWorlds;
+    };
+
+    struct SceneDelta {
+        void Clear();
+        bool Empty() const;
+        void Apply(Render::Scene& inScene);
+
+        SceneProxyDelta<DirectionalLight, Render::DirectionalLightSceneProxy> directionalLights;
+        SceneProxyDelta<PointLight, Render::PointLightSceneProxy> pointLights;
+        SceneProxyDelta<SpotLight, Render::SpotLightSceneProxy> spotLights;
+        SceneProxyDelta<StaticPrimitive, Render::StaticPrimitiveSceneProxy> staticPrimitives;
+    };
+
+    // deltas applied by the render thread come back here cleared, the game thread records the next frames into their
+    // kept capacity instead of growing fresh arrays every frame. render thread tasks hold a reference to the pool so
+    // that it outlives the scene system
+    class SceneDeltaPool {
+    public:
+        SceneDeltaPool();
+
+        NonCopyable(SceneDeltaPool)
+        NonMovable(SceneDeltaPool)
+
+        SceneDelta Acquire();
+        void Release(SceneDelta&& inDelta);
+
+    private:
+        std::mutex mutex;
+        std::vector<SceneDelta> freeDeltas;
+    };
+}
+
 namespace Runtime {
     class RUNTIME_API EClass() SceneSystem final : public System {
         EPolyDerivedClassBody(SceneSystem)
@@ -33,11 +83,11 @@ namespace Runtime {
         void Tick(float inDeltaTimeSeconds) override;
 
     private:
-        template <typename Component, typename SceneProxy> void ProcessSceneProxyEvents(EventsObserver<Component>& inObserver, bool inWithScale = false);
-        template <typename Component, typename SceneProxy> void QueueCreateSceneProxy(Entity inEntity, bool inWithScale = false);
-        template <typename Component, typename SceneProxy> void QueueUpdateSceneProxyContent(Entity inEntity);
-        template <typename SceneProxy> void QueueUpdateSceneProxyTransform(Entity inEntity, bool inWithScale = false);
-        template <typename SceneProxy> void QueueRemoveSceneProxy(Entity inEntity);
+        template <typename Component, typename SceneProxy> void RecordSceneProxyEvents(EventsObserver<Component>& inObserver, Internal::SceneProxyDelta<Component, SceneProxy>& outDelta, bool inWithScale = false);
+        template <typename Component, typename SceneProxy> void RecordCreateSceneProxy(Entity inEntity, Internal::SceneProxyDelta<Component, SceneProxy>& outDelta, bool inWithScale = false);
+        template <typename Component, typename SceneProxy> void RecordUpdateSceneProxyTransform(Entity inEntity, Internal::SceneProxyDelta<Component, SceneProxy>& outDelta, bool inWithScale = false);
+        void RecordTransformUpdates();
+        void SubmitSceneDelta();
 
         Render::RenderModule& renderModule;
         Observer transformUpdatedObserver;
@@ -45,6 +95,9 @@ namespace Runtime {
         EventsObserver<PointLight> pointLightsObserver;
         EventsObserver<SpotLight> spotLightsObserver;
         EventsObserver<StaticPrimitive> staticPrimitivesObserver;
+        Common::SharedPtr<Internal::SceneDeltaPool> sceneDeltaPool;
+        Internal::SceneDelta sceneDelta;
+        std::vector<bool> transformUpdateMarks;
     };
 }
 
@@ -55,16 +108,9 @@ namespace Runtime::Internal {
         Unimplement();
     }
 
-    template <typename SceneProxy>
-    static void UpdateSceneProxyWorldTransform(SceneProxy& outSceneProxy, const WorldTransform& inTransform, bool withScale = true)
-    {
-        outSceneProxy.localToWorld = withScale ? inTransform.localToWorld.GetTransformMatrix() : inTransform.localToWorld.GetTransformMatrixNoScale();
-    }
-
-    template <typename T>
-    static std::optional<T> GetOptional(const T* inObj)
+    inline Common::FMat4x4 GetSceneProxyLocalToWorld(const WorldTransform& inTransform, bool inWithScale)
     {
-        return inObj == nullptr ? std::optional<T>() : *inObj;
+        return inWithScale ? inTransform.localToWorld.GetTransformMatrix() : inTransform.localToWorld.GetTransformMatrixNoScale();
     }
 }
 
@@ -125,7 +171,8 @@ namespace Runtime::Internal {
         }
 
         RHI::Device* device = EngineHolder::Get().GetRenderModule().GetDevice();
-        outSceneProxy.mesh = new Render::MeshRenderData(*device, gpuVertices, vertices.indices);
+        outSceneProxy.mesh = new Render::MeshRenderData(*device, std::move(gpuVertices), std::vector<uint32_t>(vertices.indices));
+        outSceneProxy.localBoundingSphere = inComponent.mesh->GetLOD(0).boundingSphere;
 
         const Render::VertexFactoryType& vertexFactoryType = Render::StaticMeshVertexFactory::Get();
         const Material* material = materialInstance->GetMaterial().Get();
@@ -142,68 +189,79 @@ namespace Runtime::Internal {
     }
 }
 
+namespace Runtime::Internal {
+    template <typename Component, typename SceneProxy>
+    void SceneProxyDelta<Component, SceneProxy>::Clear()
+    {
+        removed.clear();
+        created.clear();
+        createdComponents.clear();
+        createdLocalToWorlds.clear();
+        updated.clear();
+        updatedComponents.clear();
+        transformed.clear();
+        transformedLocalToWorlds.clear();
+    }
+
+    template <typename Component, typename SceneProxy>
+    bool SceneProxyDelta<Component, SceneProxy>::Empty() const
+    {
+        return removed.empty() && created.empty() && updated.empty() && transformed.empty();
+    }
+
+    template <typename Component, typename SceneProxy>
+    void SceneProxyDelta<Component, SceneProxy>::Apply(Render::Scene& inScene)
+    {
+        for (const Entity e : removed) {
+            inScene.Remove<SceneProxy>(e);
+        }
+        for (size_t i = 0; i < created.size(); i++) {
+            SceneProxy sceneProxy;
+            UpdateSceneProxyContent(sceneProxy, createdComponents[i]);
+            sceneProxy.localToWorld = createdLocalToWorlds[i];
+            inScene.Add<SceneProxy>(created[i], std::move(sceneProxy));
+        }
+        for (size_t i = 0; i < updated.size(); i++) {
+            SceneProxy sceneProxy = inScene.Get<SceneProxy>(updated[i]);
+            UpdateSceneProxyContent(sceneProxy, updatedComponents[i]);
+            inScene.Set<SceneProxy>(updated[i], std::move(sceneProxy));
+        }
+        inScene.UpdateTransforms<SceneProxy>(transformed.data(), transformedLocalToWorlds.data(), transformed.size());
+    }
+}
+
 namespace Runtime {
     template <typename Component, typename SceneProxy>
-    void SceneSystem::ProcessSceneProxyEvents(EventsObserver<Component>& inObserver, bool inWithScale)
+    void SceneSystem::RecordSceneProxyEvents(EventsObserver<Component>& inObserver, Internal::SceneProxyDelta<Component, SceneProxy>& outDelta, bool inWithScale)
     {
-        inObserver.Removed().Each([this](Entity e) -> void { QueueRemoveSceneProxy<SceneProxy>(e); });
-        inObserver.Constructed().Each([this, inWithScale](Entity e) -> void {
+        inObserver.Removed().Each([&](Entity e) -> void { outDelta.removed.emplace_back(e); });
+        inObserver.Constructed().Each([&](Entity e) -> void {
             if (registry.Valid(e) && registry.Has<Component>(e)) {
-                QueueCreateSceneProxy<Component, SceneProxy>(e, inWithScale);
+                RecordCreateSceneProxy(e, outDelta, inWithScale);
             }
         });
-        inObserver.Updated().Each([this](Entity e) -> void {
+        inObserver.Updated().Each([&](Entity e) -> void {
             if (registry.Valid(e) && registry.Has<Component>(e)) {
-                QueueUpdateSceneProxyContent<Component, SceneProxy>(e);
+                outDelta.updated.emplace_back(e);
+                outDelta.updatedComponents.emplace_back(registry.Get<Component>(e));
             }
         });
         inObserver.Clear();
     }
 
     template <typename Component, typename SceneProxy>
-    void SceneSystem::QueueCreateSceneProxy(Entity inEntity, bool inWithScale)
+    void SceneSystem::RecordCreateSceneProxy(Entity inEntity, Internal::SceneProxyDelta<Component, SceneProxy>& outDelta, bool inWithScale)
     {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
-        const auto& component = registry.Get<Component>(inEntity);
         const auto* transform = registry.Find<WorldTransform>(inEntity);
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene.Get(), inEntity, component, transform = Internal::GetOptional(transform), inWithScale]() -> void {
-            SceneProxy sceneProxy;
-            Internal::UpdateSceneProxyContent(sceneProxy, component);
-            if (transform.has_value()) {
-                Internal::UpdateSceneProxyWorldTransform(sceneProxy, transform.value(), inWithScale);
-            }
-            scene->Add<SceneProxy>(inEntity, std::move(sceneProxy));
-        });
+        outDelta.created.emplace_back(inEntity);
+        outDelta.createdComponents.emplace_back(registry.Get<Component>(inEntity));
+        outDelta.createdLocalToWorlds.emplace_back(transform == nullptr ? Common::FMat4x4Consts::identity : Internal::GetSceneProxyLocalToWorld(*transform, inWithScale));
     }
 
     template <typename Component, typename SceneProxy>
-    void SceneSystem::QueueUpdateSceneProxyContent(Entity inEntity)
-    {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
-        const auto& component = registry.Get<Component>(inEntity);
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene.Get(), inEntity, component]() -> void {
-            auto& sceneProxy = scene->Get<SceneProxy>(inEntity);
-            Internal::UpdateSceneProxyContent(sceneProxy, component);
-        });
-    }
-
-    template <typename SceneProxy>
-    void SceneSystem::QueueUpdateSceneProxyTransform(Entity inEntity, bool inWithScale)
-    {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
-        const auto& transform = registry.Get<WorldTransform>(inEntity);
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene.Get(), inEntity, transform, inWithScale]() -> void {
-            auto& sceneProxy = scene->Get<SceneProxy>(inEntity);
-            Internal::UpdateSceneProxyWorldTransform(sceneProxy, transform, inWithScale);
-        });
-    }
-
-    template <typename SceneProxy>
-    void SceneSystem::QueueRemoveSceneProxy(Entity inEntity)
+    void SceneSystem::RecordUpdateSceneProxyTransform(Entity inEntity, Internal::SceneProxyDelta<Component, SceneProxy>& outDelta, bool inWithScale)
     {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene.Get(), inEntity]() -> void {
-            scene->Remove<SceneProxy>(inEntity);
-        });
+        outDelta.transformed.emplace_back(inEntity);
+        outDelta.transformedLocalToWorlds.emplace_back(Internal::GetSceneProxyLocalToWorld(registry.Get<WorldTransform>(inEntity), inWithScale));
     }
 }
@@ -0,0 +1,331 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+
+#include <lz4.h>
+
+#include <Common/Debug.h>
+#include <Common/Hash.h>
+#include <Core/JobSystem.h>
+#include <Core/Paths.h>
+#include <Runtime/Asset/Archive.h>
+
+namespace Runtime::Internal {
+    // serialized sizes of the table of contents parts
+    static constexpr uint64_t archiveTocHeaderSize = 3 * sizeof(uint64_t);
+    static constexpr uint64_t archiveEntrySize = 2 * sizeof(uint64_t) + 4 * sizeof(uint32_t);
+    static constexpr uint64_t archiveChunkSize = sizeof(uint64_t) + 2 * sizeof(uint32_t) + sizeof(uint8_t);
+
+    static uint64_t HashAssetUri(const Core::Uri& inUri)
+    {
+        const auto& str = inUri.Str();
+        return Common::HashUtils::CityHash(str.data(), str.size());
+    }
+
+    static std::vector<uint8_t> CompressChunk(const uint8_t* inData, size_t inSize)
+    {
+        std::vector<uint8_t> result(LZ4_compressBound(static_cast<int>(inSize)));
+        const auto compressedSize = LZ4_compress_default(
+            reinterpret_cast<const char*>(inData),
+            reinterpret_cast<char*>(result.data()),
+            static_cast<int>(inSize),
+            static_cast<int>(result.size()));
+        result.resize(compressedSize > 0 ? compressedSize : 0);
+        return result;
+    }
+}
+
+namespace Runtime {
+    AssetArchiveEntry::AssetArchiveEntry()
+        : uriHash(0)
+        , uriOffset(0)
+        , uriSize(0)
+        , size(0)
+        , firstChunk(0)
+        , chunkNum(0)
+    {
+    }
+
+    AssetArchiveChunk::AssetArchiveChunk()
+        : offset(0)
+        , size(0)
+        , storedSize(0)
+        , compression(AssetCompression::none)
+    {
+    }
+
+    AssetArchiveWriter::AssetArchiveWriter(const Common::Path& inPath, AssetCompression inCompression)
+        : stream(inPath.String())
+        , compression(inCompression)
+        , finished(false)
+    {
+        WriteHeader(0);
+    }
+
+    AssetArchiveWriter::~AssetArchiveWriter()
+    {
+        if (!finished) {
+            Finish();
+        }
+    }
+
+    void AssetArchiveWriter::Add(const Core::Uri& inUri, const std::vector<uint8_t>& inBytes)
+    {
+        Assert(!finished);
+        const size_t chunkNum = (inBytes.size() + Internal::assetArchiveChunkSize - 1) / Internal::assetArchiveChunkSize;
+
+        std::vector<std::vector<uint8_t>> compressedChunks(chunkNum);
+        if (compression == AssetCompression::lz4) {
+            Core::JobSystem::Get().ParallelFor(chunkNum, 1, [&](size_t inBegin, size_t inEnd) -> void {
+                for (auto i = inBegin; i < inEnd; i++) {
+                    const size_t offset = i * Internal::assetArchiveChunkSize;
+                    compressedChunks[i] = Internal::CompressChunk(inBytes.data() + offset, std::min(Internal::assetArchiveChunkSize, inBytes.size() - offset));
+                }
+            });
+        }
+
+        AssetArchiveEntry& entry = entries.emplace_back();
+        entry.uriHash = Internal::HashAssetUri(inUri);
+        entry.uriOffset = static_cast<uint32_t>(uris.size());
+        entry.uriSize = static_cast<uint32_t>(inUri.Str().size());
+        entry.size = inBytes.size();
+        entry.firstChunk = static_cast<uint32_t>(chunks.size());
+        entry.chunkNum = static_cast<uint32_t>(chunkNum);
+        uris += inUri.Str();
+
+        for (auto i = 0; i < chunkNum; i++) {
+            const size_t offset = i * Internal::assetArchiveChunkSize;
+            const size_t size = std::min(Internal::assetArchiveChunkSize, inBytes.size() - offset);
+            const auto& compressed = compressedChunks[i];
+            const bool stored = compressed.empty() || compressed.size() >= size;
+
+            Align(Internal::assetArchiveChunkAlignment);
+            AssetArchiveChunk& chunk = chunks.emplace_back();
+            chunk.offset = stream.Loc();
+            chunk.size = static_cast<uint32_t>(size);
+            chunk.storedSize = static_cast<uint32_t>(stored ? size : compressed.size());
+            chunk.compression = stored ? AssetCompression::none : compression;
+            stream.Write(stored ? inBytes.data() + offset : compressed.data(), chunk.storedSize);
+        }
+    }
+
+    bool AssetArchiveWriter::AddFile(const Core::Uri& inUri)
+    {
+        const Core::AssetUriParser parser(inUri);
+        const Common::MappedFile file(parser.Parse().Absolute().String());
+        if (!file.IsMapped()) {
+            return false;
+        }
+        Add(inUri, std::vector<uint8_t>(file.Data(), file.Data() + file.Size()));
+        return true;
+    }
+
+    void AssetArchiveWriter::Finish()
+    {
+        Assert(!finished);
+        finished = true;
+
+        std::ranges::sort(entries, [](const AssetArchiveEntry& lhs, const AssetArchiveEntry& rhs) -> bool {
+            return lhs.uriHash < rhs.uriHash;
+        });
+
+        Align(sizeof(uint64_t));
+        const uint64_t tocOffset = stream.Loc();
+        stream.Write<uint64_t>(entries.size());
+        stream.Write<uint64_t>(chunks.size());
+        stream.Write<uint64_t>(uris.size());
+        for (const auto& entry : entries) {
+            stream.Write(entry.uriHash);
+            stream.Write(entry.uriOffset);
+            stream.Write(entry.uriSize);
+            stream.Write(entry.size);
+            stream.Write(entry.firstChunk);
+            stream.Write(entry.chunkNum);
+        }
+        for (const auto& chunk : chunks) {
+            stream.Write(chunk.offset);
+            stream.Write(chunk.size);
+            stream.Write(chunk.storedSize);
+            stream.Write(static_cast<uint8_t>(chunk.compression));
+        }
+        stream.Write(uris.data(), uris.size());
+
+        stream.Seek(-static_cast<int64_t>(stream.Loc()));
+        WriteHeader(tocOffset);
+        stream.Close();
+    }
+
+    void AssetArchiveWriter::Align(size_t inAlignment)
+    {
+        static constexpr std::array<uint8_t, 64> zeros {};
+        const size_t padding = (inAlignment - stream.Loc() % inAlignment) % inAlignment;
+        stream.Write(zeros.data(), padding);
+    }
+
+    void AssetArchiveWriter::WriteHeader(uint64_t inTocOffset)
+    {
+        stream.Write(Internal::assetArchiveMagic);
+        stream.Write(Internal::assetArchiveVersion);
+        stream.Write<uint64_t>(Internal::assetArchiveChunkSize);
+        stream.Write(inTocOffset);
+    }
+
+    AssetArchive::AssetArchive(const Common::Path& inPath)
+        : file(inPath.String())
+        , valid(false)
+    {
+        if (!file.IsMapped()) {
+            return;
+        }
+
+        Common::MappedFileDeserializeStream stream(inPath.String());
+        uint32_t magic;
+        uint32_t version;
+        uint64_t chunkSize;
+        uint64_t tocOffset;
+        stream.Read(magic);
+        stream.Read(version);
+        stream.Read(chunkSize);
+        stream.Read(tocOffset);
+        if (magic != Internal::assetArchiveMagic || version != Internal::assetArchiveVersion || chunkSize != Internal::assetArchiveChunkSize || tocOffset == 0 || tocOffset >= file.Size()) {
+            return;
+        }
+
+        stream.Seek(static_cast<int64_t>(tocOffset - stream.Loc()));
+        uint64_t entryNum;
+        uint64_t chunkNum;
+        uint64_t urisSize;
+        if (tocOffset + Internal::archiveTocHeaderSize > file.Size()) {
+            return;
+        }
+        stream.Read(entryNum);
+        stream.Read(chunkNum);
+        stream.Read(urisSize);
+        if (tocOffset + Internal::archiveTocHeaderSize + entryNum * Internal::archiveEntrySize + chunkNum * Internal::archiveChunkSize + urisSize > file.Size()) {
+            return;
+        }
+
+        entries.resize(entryNum);
+        for (auto& entry : entries) {
+            stream.Read(entry.uriHash);
+            stream.Read(entry.uriOffset);
+            stream.Read(entry.uriSize);
+            stream.Read(entry.size);
+            stream.Read(entry.firstChunk);
+            stream.Read(entry.chunkNum);
+        }
+        chunks.resize(chunkNum);
+        for (auto& chunk : chunks) {
+            uint8_t compression;
+            stream.Read(chunk.offset);
+            stream.Read(chunk.size);
+            stream.Read(chunk.storedSize);
+            stream.Read(compression);
+            chunk.compression = static_cast<AssetCompression>(compression);
+        }
+        uris.resize(urisSize);
+        stream.Read(uris.data(), uris.size());
+
+        const bool tocValid = std::ranges::all_of(entries, [&](const AssetArchiveEntry& entry) -> bool {
+            return static_cast<uint64_t>(entry.uriOffset) + entry.uriSize <= uris.size()
+                && static_cast<uint64_t>(entry.firstChunk) + entry.chunkNum <= chunks.size()
+                && entry.chunkNum == (entry.size + Internal::assetArchiveChunkSize - 1) / Internal::assetArchiveChunkSize;
+        });
+        if (!tocValid) {
+            return;
+        }
+
+        // only the chunks of the requested assets are touched from now on
+        file.Advise(Common::MappedFileAccess::random);
+        valid = true;
+    }
+
+    AssetArchive::~AssetArchive() = default;
+
+    bool AssetArchive::IsValid() const
+    {
+        return valid;
+    }
+
+    size_t AssetArchive::AssetNum() const
+    {
+        return entries.size();
+    }
+
+    bool AssetArchive::Contains(const Core::Uri& inUri) const
+    {
+        return Find(inUri) != nullptr;
+    }
+
+    std::optional<std::vector<uint8_t>> AssetArchive::Read(const Core::Uri& inUri) const
+    {
+        const auto* entry = Find(inUri);
+        if (entry == nullptr) {
+            return std::nullopt;
+        }
+
+        std::vector<uint8_t> result(entry->size);
+        std::atomic<bool> corrupted = false;
+        Core::JobSystem::Get().ParallelFor(entry->chunkNum, 1, [&](size_t inBegin, size_t inEnd) -> void {
+            for (auto i = inBegin; i < inEnd; i++) {
+                const auto& chunk = chunks[entry->firstChunk + i];
+                const size_t offset = i * Internal::assetArchiveChunkSize;
+                if (chunk.size != std::min(Internal::assetArchiveChunkSize, result.size() - offset) || !ReadChunk(chunk, result.data() + offset)) {
+                    corrupted.store(true, std::memory_order_relaxed);
+                }
+            }
+        });
+        if (corrupted.load(std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    const AssetArchiveEntry* AssetArchive::Find(const Core::Uri& inUri) const
+    {
+        if (!valid) {
+            return nullptr;
+        }
+
+        const auto& str = inUri.Str();
+        const auto hash = Internal::HashAssetUri(inUri);
+        for (auto iter = std::ranges::lower_bound(entries, hash, {}, &AssetArchiveEntry::uriHash);
+            iter != entries.end() && iter->uriHash == hash;
+            ++iter) {
+            if (std::string_view(uris).substr(iter->uriOffset, iter->uriSize) == str) {
+                return &*iter;
+            }
+        }
+        return nullptr;
+    }
+
+    bool AssetArchive::ReadChunk(const AssetArchiveChunk& inChunk, uint8_t* outData) const
+    {
+        if (inChunk.offset + inChunk.storedSize > file.Size()) {
+            return false;
+        }
+
+        const uint8_t* storedData = file.Data() + inChunk.offset;
+        if (inChunk.compression == AssetCompression::none) {
+            if (inChunk.storedSize != inChunk.size) {
+                return false;
+            }
+            memcpy(outData, storedData, inChunk.size);
+            return true;
+        }
+        if (inChunk.compression == AssetCompression::lz4) {
+            const auto decompressedSize = LZ4_decompress_safe(
+                reinterpret_cast<const char*>(storedData),
+                reinterpret_cast<char*>(outData),
+                static_cast<int>(inChunk.storedSize),
+                static_cast<int>(inChunk.size));
+            return decompressedSize == static_cast<int>(inChunk.size);
+        }
+        return false;
+    }
+}
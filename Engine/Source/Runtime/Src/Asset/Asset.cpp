@@ -2,8 +2,104 @@
 // Created by johnk on 2023/10/10.
 //
 
+#include <algorithm>
+#include <ranges>
+#include <thread>
+
+#include <Core/Log.h>
 #include <Runtime/Asset/Asset.h>
 
+namespace Runtime::Internal {
+    enum class AssetLoadStage : uint8_t {
+        read,
+        deserialize,
+        postLoad,
+        max
+    };
+
+    enum class AssetLoadState : uint8_t {
+        pending,
+        loaded,
+        failed,
+        cancelled,
+        max
+    };
+
+    struct AssetLoadRequest {
+        AssetLoadRequest(Core::Uri inUri, const Mirror::Class& inClass, AssetLoadPriority inPriority);
+
+        Core::Uri uri;
+        const Mirror::Class* clazz;
+        AssetLoadPriority priority;
+        AssetLoadState state;
+        AssetLoadStage stage;
+        // set while the request waits in the stage queues for its current stage
+        bool queued;
+        // set once the load finished and its callbacks returned
+        bool done;
+        // handles plus requests waiting for this one as a dependency
+        uint32_t refCount;
+        uint32_t pendingDependencyNum;
+        // decompressed bytes of an asset read from an archive, the stream reads from them
+        std::vector<uint8_t> bytes;
+        Common::UniquePtr<Common::BinaryDeserializeStream> stream;
+        std::vector<Common::SharedPtr<AssetLoadRequest>> dependencies;
+        std::vector<Common::SharedPtr<AssetLoadRequest>> dependents;
+        // dependencies found loaded when the header was read, kept alive until the asset references them
+        std::vector<AssetPtr<Asset>> loadedDependencies;
+        std::vector<std::function<void(AssetPtr<Asset>)>> onDones;
+        AssetPtr<Asset> asset;
+    };
+
+    static thread_local std::vector<AssetDependency>* collectingDependencies = nullptr;
+
+    static uint8_t GetAssetThreadNum()
+    {
+        return static_cast<uint8_t>(std::clamp(std::thread::hardware_concurrency(), 2u, 16u));
+    }
+
+    AssetLoadRequest::AssetLoadRequest(Core::Uri inUri, const Mirror::Class& inClass, AssetLoadPriority inPriority)
+        : uri(std::move(inUri))
+        , clazz(&inClass)
+        , priority(inPriority)
+        , state(AssetLoadState::pending)
+        , stage(AssetLoadStage::read)
+        , queued(false)
+        , done(false)
+        , refCount(0)
+        , pendingDependencyNum(0)
+    {
+    }
+
+    AssetFileHeader::AssetFileHeader()
+        : version(currentVersion)
+    {
+    }
+
+    AssetDependencyCollector::AssetDependencyCollector(std::vector<AssetDependency>& outDependencies)
+        : prevDependencies(std::exchange(collectingDependencies, &outDependencies))
+    {
+    }
+
+    AssetDependencyCollector::~AssetDependencyCollector()
+    {
+        collectingDependencies = prevDependencies;
+    }
+
+    void AssetDependencyCollector::Record(const Core::Uri& inUri, const Mirror::Class& inClass)
+    {
+        if (collectingDependencies == nullptr) {
+            return;
+        }
+        const auto iter = std::ranges::find_if(*collectingDependencies, [&](const AssetDependency& dependency) -> bool {
+            return dependency.uri == inUri;
+        });
+        if (iter == collectingDependencies->end()) {
+            collectingDependencies->push_back({ inUri, &inClass });
+        }
+    }
+}
+
 namespace Runtime {
     Asset::Asset() = default;
 
@@ -26,6 +122,95 @@ namespace Runtime {
 
     void Asset::PostLoad() {}
 
+    AssetLoadHandle::AssetLoadHandle() = default;
+
+    AssetLoadHandle::AssetLoadHandle(Common::SharedPtr<Internal::AssetLoadRequest> inRequest)
+        : request(std::move(inRequest))
+    {
+    }
+
+    AssetLoadHandle::AssetLoadHandle(const AssetLoadHandle& other)
+        : request(other.request)
+    {
+        if (request != nullptr) {
+            auto& manager = AssetManager::Get();
+            std::unique_lock lock(manager.mutex);
+            manager.Retain(*request);
+        }
+    }
+
+    AssetLoadHandle::AssetLoadHandle(AssetLoadHandle&& other) noexcept
+        : request(std::move(other.request))
+    {
+    }
+
+    AssetLoadHandle::~AssetLoadHandle()
+    {
+        Reset();
+    }
+
+    AssetLoadHandle& AssetLoadHandle::operator=(const AssetLoadHandle& other)
+    {
+        if (this != &other) {
+            AssetLoadHandle copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    AssetLoadHandle& AssetLoadHandle::operator=(AssetLoadHandle&& other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            request = std::move(other.request);
+        }
+        return *this;
+    }
+
+    bool AssetLoadHandle::Valid() const
+    {
+        return request != nullptr;
+    }
+
+    bool AssetLoadHandle::Done() const
+    {
+        Assert(Valid());
+        std::unique_lock lock(AssetManager::Get().mutex);
+        return request->done;
+    }
+
+    void AssetLoadHandle::Wait() const
+    {
+        Assert(Valid());
+        AssetManager::Get().Wait(request);
+    }
+
+    void AssetLoadHandle::SetPriority(AssetLoadPriority inPriority) const
+    {
+        Assert(Valid());
+        auto& manager = AssetManager::Get();
+        std::unique_lock lock(manager.mutex);
+        manager.Boost(request, inPriority);
+    }
+
+    void AssetLoadHandle::Reset()
+    {
+        if (request == nullptr) {
+            return;
+        }
+        auto& manager = AssetManager::Get();
+        std::unique_lock lock(manager.mutex);
+        manager.Release(*request);
+        request.Reset();
+    }
+
+    AssetPtr<Asset> AssetLoadHandle::GetAsset() const
+    {
+        Assert(Valid());
+        std::unique_lock lock(AssetManager::Get().mutex);
+        return request->state == Internal::AssetLoadState::loaded ? request->asset : nullptr;
+    }
+
     AssetManager& AssetManager::Get()
     {
         static AssetManager instance;
@@ -33,9 +218,401 @@ namespace Runtime {
     }
 
     AssetManager::AssetManager()
-        : threadPool("AssetThreadPool", 4)
+        : stageQueues(static_cast<size_t>(AssetLoadPriority::max), std::vector<std::deque<RequestPtr>>(static_cast<size_t>(Internal::AssetLoadStage::max)))
+        , threadPool("AssetThreadPool", Internal::GetAssetThreadNum())
     {
     }
 
     AssetManager::~AssetManager() = default;
+
+    size_t AssetManager::InFlightCount()
+    {
+        std::unique_lock lock(mutex);
+        return inFlightRequests.size();
+    }
+
+    bool AssetManager::MountArchive(const Common::Path& inPath)
+    {
+        auto archive = Common::MakeShared<AssetArchive>(inPath);
+        if (!archive->IsValid()) {
+            return false;
+        }
+        std::unique_lock lock(mutex);
+        archives.emplace_back(std::move(archive));
+        return true;
+    }
+
+    void AssetManager::UnmountArchives()
+    {
+        std::unique_lock lock(mutex);
+        archives.clear();
+    }
+
+    Common::SharedPtr<AssetArchive> AssetManager::FindArchive(const Core::Uri& inUri)
+    {
+        std::unique_lock lock(mutex);
+        for (auto iter = archives.rbegin(); iter != archives.rend(); ++iter) {
+            if ((*iter)->Contains(inUri)) {
+                return *iter;
+            }
+        }
+        return nullptr;
+    }
+
+    AssetLoadHandle AssetManager::Load(const Core::Uri& inUri, const Mirror::Class& inClass, AssetLoadPriority inPriority, OnRequestDone inOnDone)
+    {
+        RequestPtr request;
+        AssetPtr<Asset> loadedAsset;
+        {
+            std::unique_lock lock(mutex);
+            if (const auto iter = weakAssetRefs.find(inUri);
+                iter != weakAssetRefs.end() && !iter->second.Expired()) {
+                loadedAsset = iter->second.Lock();
+                request = Common::MakeShared<Request>(inUri, inClass, inPriority);
+                request->state = Internal::AssetLoadState::loaded;
+                request->done = true;
+                request->asset = loadedAsset;
+            } else {
+                request = Acquire(inUri, inClass, inPriority);
+                if (inOnDone) {
+                    request->onDones.emplace_back(std::move(inOnDone));
+                }
+            }
+            Retain(*request);
+        }
+
+        if (loadedAsset != nullptr && inOnDone) {
+            inOnDone(loadedAsset);
+        }
+        return AssetLoadHandle(std::move(request));
+    }
+
+    void AssetManager::WriteAsset(const Core::Uri& inUri, const Mirror::Any& inAsset)
+    {
+        Internal::AssetFileHeader header;
+        std::vector<uint8_t> body;
+        {
+            Internal::AssetDependencyCollector collector(header.dependencies);
+            Common::MemorySerializeStream bodyStream(body);
+            inAsset.Serialize(bodyStream);
+        }
+
+        const Core::AssetUriParser parser(inUri);
+        Common::BinaryFileSerializeStream stream(parser.Parse().Absolute().String());
+        Common::Serialize(stream, header);
+        stream.Write(body.data(), body.size());
+    }
+
+    void AssetManager::Retain(Request& inRequest)
+    {
+        inRequest.refCount++;
+    }
+
+    void AssetManager::Release(Request& inRequest)
+    {
+        Assert(inRequest.refCount > 0);
+        inRequest.refCount--;
+        if (inRequest.refCount == 0 && inRequest.state == Internal::AssetLoadState::pending) {
+            Cancel(inRequest);
+        }
+    }
+
+    void AssetManager::Wait(const RequestPtr& inRequest)
+    {
+        // helping with the queued stages keeps sync loads from worker threads, e.g. of a dependency missing in a header,
+        // from starving the pool
+        std::unique_lock lock(mutex);
+        while (!inRequest->done) {
+            if (!RunNextStage(lock)) {
+                condition.wait(lock);
+            }
+        }
+    }
+
+    void AssetManager::Boost(const RequestPtr& inRequest, AssetLoadPriority inPriority)
+    {
+        if (inRequest->state != Internal::AssetLoadState::pending || inPriority <= inRequest->priority) {
+            return;
+        }
+
+        inRequest->priority = inPriority;
+        if (inRequest->queued) {
+            Enqueue(inRequest);
+        }
+        for (const auto& dependency : inRequest->dependencies) {
+            Boost(dependency, inPriority);
+        }
+    }
+
+    AssetManager::RequestPtr AssetManager::Acquire(const Core::Uri& inUri, const Mirror::Class& inClass, AssetLoadPriority inPriority)
+    {
+        if (const auto iter = inFlightRequests.find(inUri);
+            iter != inFlightRequests.end()) {
+            Boost(iter->second, inPriority);
+            return iter->second;
+        }
+
+        auto request = Common::MakeShared<Request>(inUri, inClass, inPriority);
+        inFlightRequests.emplace(inUri, request);
+        Enqueue(request);
+        return request;
+    }
+
+    void AssetManager::Enqueue(const RequestPtr& inRequest)
+    {
+        inRequest->queued = true;
+        stageQueues[static_cast<size_t>(inRequest->priority)][static_cast<size_t>(inRequest->stage)].emplace_back(inRequest);
+        threadPool.EmplaceTask([this]() -> void {
+            std::unique_lock lock(mutex);
+            RunNextStage(lock);
+        });
+        condition.notify_all();
+    }
+
+    bool AssetManager::RunNextStage(std::unique_lock<std::mutex>& inLock)
+    {
+        // later stages first, finishing started requests releases their memory and dependencies sooner
+        for (auto priority = static_cast<int32_t>(AssetLoadPriority::max) - 1; priority >= 0; priority--) {
+            for (auto stage = static_cast<int32_t>(Internal::AssetLoadStage::max) - 1; stage >= 0; stage--) {
+                auto& queue = stageQueues[priority][stage];
+                while (!queue.empty()) {
+                    const RequestPtr request = std::move(queue.front());
+                    queue.pop_front();
+                    if (!request->queued || request->state != Internal::AssetLoadState::pending || request->stage != static_cast<Internal::AssetLoadStage>(stage)) {
+                        continue;
+                    }
+                    request->queued = false;
+
+                    inLock.unlock();
+                    if (stage == static_cast<int32_t>(Internal::AssetLoadStage::read)) {
+                        ReadStage(request);
+                    } else if (stage == static_cast<int32_t>(Internal::AssetLoadStage::deserialize)) {
+                        DeserializeStage(request);
+                    } else {
+                        PostLoadStage(request);
+                    }
+                    inLock.lock();
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void AssetManager::ReadStage(const RequestPtr& inRequest)
+    {
+        Common::UniquePtr<Common::BinaryDeserializeStream> stream;
+        if (const auto archive = FindArchive(inRequest->uri);
+            archive != nullptr) {
+            auto bytes = archive->Read(inRequest->uri);
+            if (!bytes.has_value()) {
+                Finish(inRequest, nullptr);
+                return;
+            }
+            inRequest->bytes = std::move(bytes.value());
+            stream = new Common::MemoryDeserializeStream(inRequest->bytes);
+        } else {
+            const Core::AssetUriParser parser(inRequest->uri);
+            auto* mappedStream = new Common::MappedFileDeserializeStream(parser.Parse().Absolute().String());
+            stream = mappedStream;
+            if (!mappedStream->IsMapped()) {
+                Finish(inRequest, nullptr);
+                return;
+            }
+        }
+
+        Internal::AssetFileHeader header;
+        if (!Common::Deserialize(*stream, header).first || header.version != Internal::AssetFileHeader::currentVersion) {
+            Finish(inRequest, nullptr);
+            return;
+        }
+
+        std::unique_lock lock(mutex);
+        if (inRequest->state != Internal::AssetLoadState::pending) {
+            return;
+        }
+
+        inRequest->stream = std::move(stream);
+        bool cyclic = false;
+        std::vector<RequestPtr> cycle;
+        for (const auto& dependency : header.dependencies) {
+            if (dependency.clazz == nullptr || dependency.uri == inRequest->uri) {
+                continue;
+            }
+            if (const auto iter = weakAssetRefs.find(dependency.uri);
+                iter != weakAssetRefs.end() && !iter->second.Expired()) {
+                inRequest->loadedDependencies.emplace_back(iter->second.Lock());
+                continue;
+            }
+
+            RequestPtr dependencyRequest = Acquire(dependency.uri, *dependency.clazz, inRequest->priority);
+            // every asset on a cycle waits for the next one to be deserialized, which never happens, so the whole cycle
+            // fails to load instead
+            if (FindDependencyPath(dependencyRequest, *inRequest, cycle)) {
+                LogError(Asset, "failed to load {}, it references itself through the dependency cycle of {}", inRequest->uri.Str(), dependency.uri.Str());
+                cyclic = true;
+                break;
+            }
+            Retain(*dependencyRequest);
+            dependencyRequest->dependents.emplace_back(inRequest);
+            inRequest->dependencies.emplace_back(std::move(dependencyRequest));
+            inRequest->pendingDependencyNum++;
+        }
+
+        if (cyclic) {
+            // failed under one lock, a request on the cycle released by an earlier failure must not start to deserialize
+            cycle.insert(cycle.begin(), inRequest);
+            std::vector<std::pair<RequestPtr, std::vector<OnRequestDone>>> failedRequests;
+            for (const auto& request : cycle) {
+                std::vector<OnRequestDone> onDones;
+                if (Complete(request, nullptr, onDones)) {
+                    failedRequests.emplace_back(request, std::move(onDones));
+                }
+            }
+            lock.unlock();
+
+            for (const auto& [request, onDones] : failedRequests) {
+                for (const auto& onDone : onDones) {
+                    onDone(nullptr);
+                }
+            }
+
+            lock.lock();
+            for (const auto& request : failedRequests | std::views::keys) {
+                request->done = true;
+            }
+            condition.notify_all();
+            return;
+        }
+        if (inRequest->pendingDependencyNum == 0) {
+            inRequest->stage = Internal::AssetLoadStage::deserialize;
+            Enqueue(inRequest);
+        }
+    }
+
+    void AssetManager::DeserializeStage(const RequestPtr& inRequest)
+    {
+        // dependencies are loaded by now, the asset pointers inside resolve to them through weakAssetRefs
+        Mirror::Any object = inRequest->clazz->New(inRequest->uri);
+        object.Deref().Deserialize(*inRequest->stream);
+
+        AssetPtr<Asset> asset = Common::SharedPtr<Asset>(object.As<Asset*>());
+        asset->SetUri(inRequest->uri);
+
+        std::unique_lock lock(mutex);
+        if (inRequest->state != Internal::AssetLoadState::pending) {
+            lock.unlock();
+            return;
+        }
+
+        inRequest->stream.Reset();
+        inRequest->bytes = {};
+        inRequest->asset = std::move(asset);
+        inRequest->stage = Internal::AssetLoadStage::postLoad;
+        Enqueue(inRequest);
+    }
+
+    void AssetManager::PostLoadStage(const RequestPtr& inRequest)
+    {
+        inRequest->asset->PostLoad();
+        Finish(inRequest, inRequest->asset);
+    }
+
+    void AssetManager::Finish(const RequestPtr& inRequest, AssetPtr<Asset> inAsset)
+    {
+        std::vector<OnRequestDone> onDones;
+        {
+            std::unique_lock lock(mutex);
+            if (!Complete(inRequest, inAsset, onDones)) {
+                return;
+            }
+        }
+
+        for (const auto& onDone : onDones) {
+            onDone(inAsset);
+        }
+
+        std::unique_lock lock(mutex);
+        inRequest->done = true;
+        condition.notify_all();
+    }
+
+    bool AssetManager::Complete(const RequestPtr& inRequest, AssetPtr<Asset> inAsset, std::vector<OnRequestDone>& outOnDones)
+    {
+        if (inRequest->state != Internal::AssetLoadState::pending) {
+            return false;
+        }
+
+        inRequest->state = inAsset != nullptr ? Internal::AssetLoadState::loaded : Internal::AssetLoadState::failed;
+        inRequest->asset = inAsset;
+        inRequest->stream.Reset();
+        inRequest->bytes = {};
+        if (inAsset != nullptr) {
+            if (const auto iter = weakAssetRefs.find(inRequest->uri);
+                iter == weakAssetRefs.end()) {
+                weakAssetRefs.emplace(std::make_pair(inRequest->uri, WeakAssetPtr<Asset>(inAsset)));
+            } else {
+                iter->second = inAsset;
+            }
+        }
+        if (const auto iter = inFlightRequests.find(inRequest->uri);
+            iter != inFlightRequests.end() && iter->second.Get() == inRequest.Get()) {
+            inFlightRequests.erase(iter);
+        }
+
+        for (const auto& dependency : inRequest->dependencies) {
+            Release(*dependency);
+        }
+        inRequest->dependencies.clear();
+        inRequest->loadedDependencies.clear();
+
+        for (const auto& dependent : inRequest->dependents) {
+            if (dependent->state != Internal::AssetLoadState::pending) {
+                continue;
+            }
+            Assert(dependent->pendingDependencyNum > 0);
+            dependent->pendingDependencyNum--;
+            if (dependent->pendingDependencyNum == 0) {
+                dependent->stage = Internal::AssetLoadStage::deserialize;
+                Enqueue(dependent);
+            }
+        }
+        inRequest->dependents.clear();
+        outOnDones.swap(inRequest->onDones);
+        return true;
+    }
+
+    void AssetManager::Cancel(Request& inRequest)
+    {
+        inRequest.state = Internal::AssetLoadState::cancelled;
+        if (const auto iter = inFlightRequests.find(inRequest.uri);
+            iter != inFlightRequests.end() && iter->second.Get() == &inRequest) {
+            inFlightRequests.erase(iter);
+        }
+
+        for (const auto& dependency : inRequest.dependencies) {
+            Release(*dependency);
+        }
+        inRequest.dependencies.clear();
+        inRequest.dependents.clear();
+        inRequest.loadedDependencies.clear();
+        inRequest.onDones.clear();
+        inRequest.done = true;
+        condition.notify_all();
+    }
+
+    bool AssetManager::FindDependencyPath(const RequestPtr& inRequest, const Request& inDependency, std::vector<RequestPtr>& outPath) const
+    {
+        if (inRequest.Get() == &inDependency) {
+            return true;
+        }
+        outPath.emplace_back(inRequest);
+        for (const auto& dependency : inRequest->dependencies) {
+            if (FindDependencyPath(dependency, inDependency, outPath)) {
+                return true;
+            }
+        }
+        outPath.pop_back();
+        return false;
+    }
 }
@@ -2,9 +2,40 @@
 // Created by johnk on 2025/3/21.
 //
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include <Runtime/Asset/Mesh.h>
 
 namespace Runtime {
+    StaticMeshLOD::StaticMeshLOD() = default;
+
+    void StaticMeshLOD::UpdateBounds()
+    {
+        if (vertices.positions.empty()) {
+            bounds = Common::FBox();
+            boundingSphere = Common::FSphere();
+            return;
+        }
+
+        Common::FVec3 min(std::numeric_limits<float>::max());
+        Common::FVec3 max(std::numeric_limits<float>::lowest());
+        for (const auto& position : vertices.positions) {
+            min = Common::FVec3(std::min(min.x, position.x), std::min(min.y, position.y), std::min(min.z, position.z));
+            max = Common::FVec3(std::max(max.x, position.x), std::max(max.y, position.y), std::max(max.z, position.z));
+        }
+        bounds = Common::FBox(min, max);
+
+        // centered on the box, the farthest vertex is tighter than the half diagonal for most meshes
+        const Common::FVec3 center = bounds.Center();
+        float radiusSquared = 0.0f;
+        for (const auto& position : vertices.positions) {
+            radiusSquared = std::max(radiusSquared, (position - center).ModelSquared());
+        }
+        boundingSphere = Common::FSphere(center, std::sqrt(radiusSquared));
+    }
+
     StaticMesh::StaticMesh(Core::Uri inUri)
         : Asset(std::move(inUri))
     {
@@ -36,4 +67,11 @@ namespace Runtime {
     {
         return lodVec.emplace_back();
     }
+
+    void StaticMesh::PostLoad()
+    {
+        for (auto& lod : lodVec) {
+            lod.UpdateBounds();
+        }
+    }
 }
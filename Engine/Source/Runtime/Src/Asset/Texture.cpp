@@ -2,9 +2,17 @@
 // Created by johnk on 2025/3/24.
 //
 
+#include <Core/Console.h>
+#include <Render/UploadManager.h>
 #include <Runtime/Asset/Texture.h>
 
 namespace Runtime::Internal {
+    static Core::ConsoleSettingValue<bool> csTextureKeepPixels(
+        "asset.texture.keepPixels",
+        "keep the pixels of loaded textures on the cpu after their upload outside the editor too, needed to save them again, the editor always keeps them",
+        false,
+        Core::CSFlagBits::configOverridable);
+
     struct TextureTypeInfo {
         RHI::TextureType rhiType;
         RHI::TextureViewDimension rhiViewDimension;
@@ -101,11 +109,25 @@ namespace Runtime {
     {
     }
 
-    Texture::~Texture() = default;
+    Texture::~Texture()
+    {
+        DiscardRHIUpload();
+    }
 
     void Texture::PostLoad()
     {
-        UpdateRHI();
+        // games move the loaded pixels into the upload, only the editor or callers that save loaded textures again need a copy
+        if (EngineHolder::Get().IsEditor() || Internal::csTextureKeepPixels.GetGT()) {
+            UpdateRHI();
+            return;
+        }
+        CreateRHI(std::move(subResourcePixelsData));
+        subResourcePixelsData.clear();
+    }
+
+    bool Texture::HasPixels() const
+    {
+        return !subResourcePixelsData.empty();
     }
 
     TextureType Texture::GetType() const
@@ -150,6 +172,7 @@ namespace Runtime {
 
     Texture::Pixels& Texture::GetSubResourcePixels(uint8_t inMipLevel, uint8_t inArrayLayer)
     {
+        AssertWithReason(HasPixels(), "pixels of the texture were released after its upload, see asset.texture.keepPixels");
         if (type == TextureType::t3D) {
             Assert(inArrayLayer == 0);
             return subResourcePixelsData[Internal::GetSubResourceIndex(inMipLevel, 0, 1)];
@@ -159,6 +182,7 @@ namespace Runtime {
 
     const Texture::Pixels& Texture::GetSubResourcePixels(uint8_t inMipLevel, uint8_t inArrayLayer) const
     {
+        AssertWithReason(HasPixels(), "pixels of the texture were released after its upload, see asset.texture.keepPixels");
         if (type == TextureType::t3D) {
             Assert(inArrayLayer == 0);
             return subResourcePixelsData[Internal::GetSubResourceIndex(inMipLevel, 0, 1)];
@@ -237,10 +261,21 @@ namespace Runtime {
     }
 
     void Texture::UpdateRHI()
+    {
+        CreateRHI(std::vector<Pixels>(subResourcePixelsData));
+    }
+
+    void Texture::CreateRHI(std::vector<Pixels>&& inSubResourcePixelsData)
     {
         const auto& renderModule = EngineHolder::Get().GetRenderModule();
         auto* device = renderModule.GetDevice();
 
+        DiscardRHIUpload();
+        {
+            // released through the render thread, behind the discard above
+            const auto lastTexture = std::move(texture);
+            const auto lastTextureView = std::move(textureView);
+        }
         texture = device->CreateTexture(
             RHI::TextureCreateInfo()
                 .SetType(Internal::GetTextureTypeInfo(type).rhiType)
@@ -262,104 +297,43 @@ namespace Runtime {
                 .SetMipLevels(0, mipLevels)
                 .SetArrayLayers(0, type == TextureType::t3D ? 1 : depthOrArraySize));
 
+        Render::TextureSubResourceWriter writer;
+        if (Internal::IsDepthAndStencilFormat(format)) {
+            writer = [format = format](const std::vector<uint8_t>& inPixels, uint8_t* outData, const RHI::TextureSubResourceCopyFootprint& inFootprint) -> void {
+                Internal::CopyDepthStencilSubResourceToStaging(format, inPixels, outData, inFootprint);
+            };
+        }
+
         renderModule.GetRenderThread().EmplaceTask([
             device,
             texturePtr = texture.Get(),
-            type = type,
-            format = format,
-            depthOrArraySize = depthOrArraySize,
-            mipLevels = mipLevels,
             aspect = Internal::GetTextureAspect(format),
-            subResourcePixelsData = subResourcePixelsData,
-            name = name
-        ]() -> void {
-            const auto arraySize = type == TextureType::t3D ? 1 : depthOrArraySize;
-
-            std::vector<RHI::TextureSubResourceCopyFootprint> copyFootprints;
-            copyFootprints.reserve(mipLevels * arraySize);
-            for (auto m = 0; m < mipLevels; m++) {
-                for (auto a = 0; a < arraySize; a++) {
-                    copyFootprints.emplace_back(device->GetTextureSubResourceCopyFootprint(*texturePtr, RHI::TextureSubResourceInfo(m, a, aspect)));
-                }
-            }
-
-            const auto bufferCopyOffsetAlignment = static_cast<size_t>(device->GetGpu().GetLimits().optimalBufferCopyOffsetAlignment);
-            Assert(bufferCopyOffsetAlignment > 0);
-
-            std::vector<size_t> copyOffsets;
-            copyOffsets.reserve(copyFootprints.size());
-            size_t totalBytes = 0;
-            for (const auto& copyFootprint : copyFootprints) {
-                totalBytes = Common::AlignUp(totalBytes, bufferCopyOffsetAlignment);
-                copyOffsets.emplace_back(totalBytes);
-                totalBytes += copyFootprint.totalBytes;
-            }
-
-            const Common::UniquePtr<RHI::Buffer> stagingBuffer = device->CreateBuffer(
-                RHI::BufferCreateInfo()
-                    .SetSize(totalBytes)
-                    .SetUsages(RHI::BufferUsageBits::copySrc | RHI::BufferUsageBits::mapWrite)
-                    .SetInitialState(RHI::BufferState::staging)
-                    .SetDebugName(std::format("StagingBuffer-{}", name)));
-
-            const auto bytesPerPixel = RHI::GetBytesPerPixel(static_cast<RHI::PixelFormat>(format));
-
-            auto* dstData = static_cast<uint8_t*>(stagingBuffer->Map(RHI::MapMode::write, 0, totalBytes));
-            for (auto m = 0; m < mipLevels; m++) {
-                for (auto a = 0; a < arraySize; a++) {
-                    const auto subResourceIndex = Internal::GetSubResourceIndex(m, a, arraySize);
-                    const auto& srcPixels = subResourcePixelsData[subResourceIndex];
-                    const auto& dstCopyFootprint = copyFootprints[subResourceIndex];
-                    const auto dstSubResourceOffset = copyOffsets[subResourceIndex];
-
-                    if (Internal::IsDepthAndStencilFormat(format)) {
-                        Internal::CopyDepthStencilSubResourceToStaging(format, srcPixels, dstData + dstSubResourceOffset, dstCopyFootprint);
-                        continue;
-                    }
-
-                    const auto srcRowPitch = dstCopyFootprint.extent.x * bytesPerPixel;
-                    const auto srcSlicePitch = srcRowPitch * dstCopyFootprint.extent.y;
-                    for (auto z = 0u; z < dstCopyFootprint.extent.z; z++) {
-                        for (auto y = 0u; y < dstCopyFootprint.extent.y; y++) {
-                            const auto* src = srcPixels.data() + srcSlicePitch * z + srcRowPitch * y;
-                            auto* dst = dstData + dstSubResourceOffset + dstCopyFootprint.slicePitch * z + dstCopyFootprint.rowPitch * y;
-                            memcpy(dst, src, srcRowPitch);
-                        }
-                    }
-                }
-            }
-            stagingBuffer->Unmap();
-
-            const Common::UniquePtr<RHI::CommandBuffer> cmdBuffer = device->CreateCommandBuffer(RHI::QueueType::transfer);
-            const auto recoder = cmdBuffer->Begin();
-            {
-                const auto passRecoder = recoder->BeginCopyPass();
-                {
-                    for (auto m = 0; m < mipLevels; m++) {
-                        for (auto a = 0; a < arraySize; a++) {
-                            const auto subResourceIndex = Internal::GetSubResourceIndex(m, a, arraySize);
-                            passRecoder->CopyBufferToTexture(
-                                stagingBuffer.Get(),
-                                texturePtr,
-                                RHI::BufferTextureCopyInfo()
-                                    .SetBufferOffset(copyOffsets[subResourceIndex])
-                                    .SetBufferRowPitch(copyFootprints[subResourceIndex].rowPitch)
-                                    .SetBufferSlicePitch(copyFootprints[subResourceIndex].slicePitch)
-                                    .SetTextureSubResource(RHI::TextureSubResourceInfo(m, a, aspect))
-                                    .SetTextureOrigin({ 0, 0, 0 })
-                                    .SetCopyRegion(copyFootprints[subResourceIndex].extent));
-                        }
-                    }
-                }
-                passRecoder->EndPass();
-            }
-            recoder->End();
+            subResourcePixelsData = std::move(inSubResourcePixelsData),
+            writer = std::move(writer)
+        ]() mutable -> void {
+            Render::UploadManager::Get(*device).UploadTexture(
+                texturePtr,
+                aspect,
+                RHI::TextureState::shaderReadOnly,
+                RHI::TextureState::shaderReadOnly,
+                std::move(subResourcePixelsData),
+                std::move(writer));
+        });
+    }
 
-            const Common::UniquePtr<RHI::Fence> fence = device->CreateFence(false);
-            device
-                ->GetQueue(RHI::QueueType::transfer, 0)
-                ->Submit(cmdBuffer.Get(), RHI::QueueSubmitInfo().SetSignalFence(fence.Get()));
-            fence->Wait();
+    void Texture::DiscardRHIUpload() const
+    {
+        if (!texture.Valid()) {
+            return;
+        }
+        // texture is reset on the game thread right after this without waiting for the render thread, a pending upload
+        // is only safe because the render thread runs its tasks in fifo order, the discard queued here runs before the
+        // release of the rhi texture that RenderThreadPtr queues behind it
+        EngineHolder::Get().GetRenderModule().GetRenderThread().EmplaceTask([
+            device = EngineHolder::Get().GetRenderModule().GetDevice(),
+            texturePtr = texture.Get()
+        ]() -> void {
+            Render::UploadManager::Get(*device).Discard(texturePtr);
         });
     }
 
@@ -2,25 +2,31 @@
 // Created by johnk on 2024/10/31.
 //
 
-#include <taskflow/taskflow.hpp>
-
 #include <cstddef>
 #include <cstring>
+#include <map>
 #include <new>
+#include <optional>
 #include <utility>
 
-#include <Core/Thread.h>
+#include <Common/String.h>
 #include <Runtime/ECS.h>
 
 namespace Runtime {
     System::System(ECRegistry& inRegistry, const SystemSetupContext&)
         : registry(inRegistry)
+        , commands(Common::MakeUnique<ECCommandBuffer>(inRegistry))
     {
     }
 
     System::~System() = default;
 
     void System::Tick(float inDeltaTimeSeconds) {}
+
+    ECCommandBuffer& System::Commands()
+    {
+        return *commands;
+    }
 }
 
 namespace Runtime::Internal {
@@ -29,6 +35,11 @@ namespace Runtime::Internal {
         return inClass->GetMetaBoolOr(MetaPresets::globalComp, false);
     }
 
+    static size_t AlignUp(size_t inValue, size_t inAlignment)
+    {
+        return (inValue + inAlignment - 1) / inAlignment * inAlignment;
+    }
+
     TagStorage::TagStorage() = default;
 
     TagStorage::TagStorage(std::vector<TagClass> inTags)
@@ -211,23 +222,80 @@ namespace Runtime::Internal {
         return ArchetypeLayout(std::move(result), tags);
     }
 
+    const Common::SharedPtr<ArchetypeChunkPool>& ArchetypeChunkPool::Get()
+    {
+        static Common::SharedPtr<ArchetypeChunkPool> instance = Common::MakeShared<ArchetypeChunkPool>();
+        return instance;
+    }
+
+    ArchetypeChunkPool::ArchetypeChunkPool()
+        : allocatedNum(0)
+    {
+    }
+
+    ArchetypeChunkPool::~ArchetypeChunkPool()
+    {
+        Assert(allocatedNum == freeChunks.size());
+        Trim();
+    }
+
+    ElemPtr ArchetypeChunkPool::Allocate()
+    {
+        {
+            std::unique_lock lock(mutex);
+            if (!freeChunks.empty()) {
+                ElemPtr chunk = freeChunks.back();
+                freeChunks.pop_back();
+                return chunk;
+            }
+            allocatedNum++;
+        }
+        return ::operator new(archetypeChunkSize, std::align_val_t(archetypeColumnAlignment));
+    }
+
+    void ArchetypeChunkPool::Free(ElemPtr inChunk)
+    {
+        std::unique_lock lock(mutex);
+        freeChunks.emplace_back(inChunk);
+    }
+
+    void ArchetypeChunkPool::Trim()
+    {
+        std::unique_lock lock(mutex);
+        for (ElemPtr chunk : freeChunks) {
+            ::operator delete(chunk, std::align_val_t(archetypeColumnAlignment));
+        }
+        allocatedNum -= freeChunks.size();
+        freeChunks.clear();
+    }
+
+    size_t ArchetypeChunkPool::AllocatedCount() const
+    {
+        std::unique_lock lock(mutex);
+        return allocatedNum;
+    }
+
+    size_t ArchetypeChunkPool::FreeCount() const
+    {
+        std::unique_lock lock(mutex);
+        return freeChunks.size();
+    }
+
     Archetype::Archetype(ArchetypeLayout inLayout)
         : id(inLayout.Id())
         , count(0)
-        , capacity(0)
         , rttiVec(inLayout.CompRttis())
         , tags(inLayout.Tags())
-        , compMemory(rttiVec.size(), nullptr)
-        , compStrides(rttiVec.size())
+        , rowsPerChunk(0)
+        , chunkSize(0)
+        , chunkAlignment(archetypeColumnAlignment)
+        , chunkPool(ArchetypeChunkPool::Get())
     {
         rttiMap.reserve(rttiVec.size());
         for (auto i = 0; i < rttiVec.size(); i++) {
-            auto& rtti = rttiVec[i];
-            const auto clazz = rtti.Class();
-            rttiMap.emplace(clazz, i);
-            compStrides[i] = rtti.MemorySize();
-
+            rttiMap.emplace(rttiVec[i].Class(), i);
         }
+        BuildChunkLayout();
     }
 
     Archetype::~Archetype()
@@ -239,25 +307,33 @@ namespace Runtime::Internal {
     Archetype::Archetype(const Archetype& inOther)
         : id(inOther.id)
         , count(inOther.count)
-        , capacity(inOther.capacity)
         , rttiVec(inOther.rttiVec)
         , tags(inOther.tags)
         , rttiMap(inOther.rttiMap)
-        , compMemory(rttiVec.size(), nullptr)
+        , rowsPerChunk(inOther.rowsPerChunk)
+        , chunkSize(inOther.chunkSize)
+        , chunkAlignment(inOther.chunkAlignment)
+        , chunkPool(inOther.chunkPool)
+        , compOffsets(inOther.compOffsets)
         , compStrides(inOther.compStrides)
         , elemMap(inOther.elemMap)
     {
-        for (size_t compIndex = 0; compIndex < rttiVec.size(); compIndex++) {
-            const auto& rtti = rttiVec[compIndex];
-            if (capacity > 0) {
-                compMemory[compIndex] = ::operator new(capacity * rtti.MemorySize(), std::align_val_t(rtti.MemoryAlignment()));
-            }
-            if (rtti.TriviallyRelocatable()) {
-                if (count > 0) {
-                    std::memcpy(compMemory[compIndex], inOther.compMemory[compIndex], count * compStrides[compIndex]);
+        if (rttiVec.empty()) {
+            return;
+        }
+
+        chunks.reserve(ChunkCount());
+        for (size_t chunkIndex = 0; chunkIndex < ChunkCount(); chunkIndex++) {
+            chunks.emplace_back(AllocateChunk());
+            const auto rowCount = ChunkRowCount(chunkIndex);
+            for (size_t compIndex = 0; compIndex < rttiVec.size(); compIndex++) {
+                const auto& rtti = rttiVec[compIndex];
+                if (rtti.TriviallyRelocatable()) {
+                    std::memcpy(GetCompColumn(chunkIndex, compIndex), inOther.GetCompColumn(chunkIndex, compIndex), rowCount * compStrides[compIndex]);
+                    continue;
                 }
-            } else {
-                for (size_t elemIndex = 0; elemIndex < count; elemIndex++) {
+                for (size_t rowIndex = 0; rowIndex < rowCount; rowIndex++) {
+                    const auto elemIndex = chunkIndex * rowsPerChunk + rowIndex;
                     rtti.CopyConstructFrom(GetCompAt(elemIndex, compIndex), const_cast<void*>(inOther.GetCompAt(elemIndex, compIndex)));
                 }
             }
@@ -267,14 +343,19 @@ namespace Runtime::Internal {
     Archetype::Archetype(Archetype&& inOther) noexcept
         : id(inOther.id)
         , count(std::exchange(inOther.count, 0))
-        , capacity(std::exchange(inOther.capacity, 0))
         , rttiVec(std::move(inOther.rttiVec))
         , tags(std::move(inOther.tags))
         , rttiMap(std::move(inOther.rttiMap))
-        , compMemory(std::move(inOther.compMemory))
+        , rowsPerChunk(inOther.rowsPerChunk)
+        , chunkSize(inOther.chunkSize)
+        , chunkAlignment(inOther.chunkAlignment)
+        , chunkPool(inOther.chunkPool)
+        , chunks(std::move(inOther.chunks))
+        , compOffsets(std::move(inOther.compOffsets))
         , compStrides(std::move(inOther.compStrides))
         , elemMap(std::move(inOther.elemMap))
     {
+        inOther.chunks.clear();
     }
 
     Archetype& Archetype::operator=(const Archetype& inOther)
@@ -295,11 +376,16 @@ namespace Runtime::Internal {
         ReleaseMemory();
         id = inOther.id;
         count = std::exchange(inOther.count, 0);
-        capacity = std::exchange(inOther.capacity, 0);
         rttiVec = std::move(inOther.rttiVec);
         tags = std::move(inOther.tags);
         rttiMap = std::move(inOther.rttiMap);
-        compMemory = std::move(inOther.compMemory);
+        rowsPerChunk = inOther.rowsPerChunk;
+        chunkSize = inOther.chunkSize;
+        chunkAlignment = inOther.chunkAlignment;
+        chunkPool = inOther.chunkPool;
+        chunks = std::move(inOther.chunks);
+        inOther.chunks.clear();
+        compOffsets = std::move(inOther.compOffsets);
         compStrides = std::move(inOther.compStrides);
         elemMap = std::move(inOther.elemMap);
         addTransitions.clear();
@@ -342,12 +428,25 @@ namespace Runtime::Internal {
     size_t Archetype::EmplaceElem(Entity inEntity, Archetype& inSrcArchetype, size_t inSrcElemIndex, const std::vector<CompMapping>& inCompMappings)
     {
         const auto newElemIndex = EmplaceElem(inEntity);
+        if (inCompMappings.empty()) {
+            return newElemIndex;
+        }
+
+        const auto dstChunkIndex = newElemIndex / rowsPerChunk;
+        const auto srcChunkIndex = inSrcElemIndex / inSrcArchetype.rowsPerChunk;
+        auto* dstChunk = static_cast<uint8_t*>(chunks[dstChunkIndex]);
+        auto* srcChunk = static_cast<uint8_t*>(inSrcArchetype.chunks[srcChunkIndex]);
+        const auto dstRowIndex = newElemIndex - dstChunkIndex * rowsPerChunk;
+        const auto srcRowIndex = inSrcElemIndex - srcChunkIndex * inSrcArchetype.rowsPerChunk;
         for (const auto& mapping : inCompMappings) {
             const auto& dstRtti = rttiVec[mapping.dstCompIndex];
+            const auto stride = compStrides[mapping.dstCompIndex];
+            ElemPtr dst = dstChunk + compOffsets[mapping.dstCompIndex] + dstRowIndex * stride;
+            ElemPtr src = srcChunk + inSrcArchetype.compOffsets[mapping.srcCompIndex] + srcRowIndex * stride;
             if (dstRtti.TriviallyRelocatable()) {
-                std::memcpy(GetCompAt(newElemIndex, mapping.dstCompIndex), inSrcArchetype.GetCompAt(inSrcElemIndex, mapping.srcCompIndex), compStrides[mapping.dstCompIndex]);
+                std::memcpy(dst, src, stride);
             } else {
-                dstRtti.MoveConstructFrom(GetCompAt(newElemIndex, mapping.dstCompIndex), inSrcArchetype.GetCompAt(inSrcElemIndex, mapping.srcCompIndex));
+                dstRtti.MoveConstructFrom(dst, src);
             }
         }
         return newElemIndex;
@@ -366,26 +465,38 @@ namespace Runtime::Internal {
         const auto lastElemIndex = count - 1;
         Entity movedEntity = entityNull;
 
-        if (inElemIndex == lastElemIndex) {
-            for (size_t compIndex = 0; compIndex < rttiVec.size(); compIndex++) {
-                if (!rttiVec[compIndex].TriviallyRelocatable()) {
-                    rttiVec[compIndex].Destruct(GetCompAt(inElemIndex, compIndex));
-                }
-            }
-        } else {
+        if (!rttiVec.empty()) {
+            // locate both rows once, the chunk lookups are not hoisted by the compiler across the copies below
+            const auto chunkIndex = inElemIndex / rowsPerChunk;
+            const auto lastChunkIndex = lastElemIndex / rowsPerChunk;
+            const auto rowIndex = inElemIndex - chunkIndex * rowsPerChunk;
+            const auto lastRowIndex = lastElemIndex - lastChunkIndex * rowsPerChunk;
+            auto* chunk = static_cast<uint8_t*>(chunks[chunkIndex]);
+            auto* lastChunk = static_cast<uint8_t*>(chunks[lastChunkIndex]);
+
             for (size_t compIndex = 0; compIndex < rttiVec.size(); compIndex++) {
                 const auto& rtti = rttiVec[compIndex];
-                ElemPtr elem = GetCompAt(inElemIndex, compIndex);
-                ElemPtr lastElem = GetCompAt(lastElemIndex, compIndex);
+                const auto stride = compStrides[compIndex];
+                ElemPtr elem = chunk + compOffsets[compIndex] + rowIndex * stride;
+                if (inElemIndex == lastElemIndex) {
+                    if (!rtti.TriviallyRelocatable()) {
+                        rtti.Destruct(elem);
+                    }
+                    continue;
+                }
+
+                ElemPtr lastElem = lastChunk + compOffsets[compIndex] + lastRowIndex * stride;
                 if (rtti.TriviallyRelocatable()) {
-                    std::memcpy(elem, lastElem, compStrides[compIndex]);
+                    std::memcpy(elem, lastElem, stride);
                 } else {
                     rtti.Destruct(elem);
                     rtti.MoveConstructFrom(elem, lastElem);
                     rtti.Destruct(lastElem);
                 }
             }
+        }
 
+        if (inElemIndex != lastElemIndex) {
             const auto entityToLastElem = elemMap.at(lastElemIndex);
             elemMap[inElemIndex] = entityToLastElem;
             movedEntity = entityToLastElem;
@@ -393,6 +504,7 @@ namespace Runtime::Internal {
 
         elemMap.pop_back();
         count--;
+        ReleaseUnusedChunks();
         return movedEntity;
     }
 
@@ -464,51 +576,63 @@ namespace Runtime::Internal {
         return CacheTransition(removeTransitions, inClass, inArchetype);
     }
 
-    const Archetype::Transition& Archetype::CacheTransition(std::vector<Transition>& inTransitions, CompClass inClass, Archetype& inArchetype)
+    std::vector<Archetype::CompMapping> Archetype::MakeCompMappings(const Archetype& inDstArchetype) const
     {
-        auto& transition = inTransitions.emplace_back(Transition { inClass, &inArchetype, {} });
-        transition.compMappings.reserve(rttiVec.size());
+        std::vector<CompMapping> result;
+        result.reserve(rttiVec.size());
         for (size_t srcCompIndex = 0; srcCompIndex < rttiVec.size(); srcCompIndex++) {
-            const auto dstIter = inArchetype.rttiMap.find(rttiVec[srcCompIndex].Class());
-            if (dstIter != inArchetype.rttiMap.end()) {
-                transition.compMappings.emplace_back(srcCompIndex, dstIter->second);
+            const auto dstIter = inDstArchetype.rttiMap.find(rttiVec[srcCompIndex].Class());
+            if (dstIter != inDstArchetype.rttiMap.end()) {
+                result.emplace_back(srcCompIndex, dstIter->second);
             }
         }
-        return transition;
+        return result;
     }
 
-    size_t Archetype::Capacity() const
+    const Archetype::Transition& Archetype::CacheTransition(std::vector<Transition>& inTransitions, CompClass inClass, Archetype& inArchetype)
     {
-        return capacity;
+        return inTransitions.emplace_back(Transition { inClass, &inArchetype, MakeCompMappings(inArchetype) });
     }
 
-    void Archetype::Reserve(float inRatio)
+    size_t Archetype::Capacity() const
     {
-        Assert(inRatio > 1.0f);
-        const size_t newCapacity = static_cast<size_t>(std::ceil(static_cast<float>(std::max(Capacity(), static_cast<size_t>(1))) * inRatio));
-        std::vector<ElemPtr> newCompMemory(rttiVec.size(), nullptr);
+        return chunks.size() * rowsPerChunk;
+    }
 
+    void Archetype::BuildChunkLayout()
+    {
+        compOffsets.resize(rttiVec.size());
+        compStrides.resize(rttiVec.size());
+        size_t rowSize = 0;
         for (size_t compIndex = 0; compIndex < rttiVec.size(); compIndex++) {
-            const auto& rtti = rttiVec[compIndex];
-            newCompMemory[compIndex] = ::operator new(newCapacity * rtti.MemorySize(), std::align_val_t(rtti.MemoryAlignment()));
-            if (rtti.TriviallyRelocatable()) {
-                if (count > 0) {
-                    std::memcpy(newCompMemory[compIndex], compMemory[compIndex], count * compStrides[compIndex]);
-                }
-            } else {
-                for (size_t elemIndex = 0; elemIndex < count; elemIndex++) {
-                    ElemPtr dstElem = CompAt(newCompMemory[compIndex], compIndex, elemIndex);
-                    ElemPtr srcElem = GetCompAt(elemIndex, compIndex);
-                    rtti.MoveConstructFrom(dstElem, srcElem);
-                    rtti.Destruct(srcElem);
-                }
-            }
-            if (compMemory[compIndex] != nullptr) {
-                ::operator delete(compMemory[compIndex], std::align_val_t(rtti.MemoryAlignment()));
+            compStrides[compIndex] = rttiVec[compIndex].MemorySize();
+            chunkAlignment = std::max(chunkAlignment, rttiVec[compIndex].MemoryAlignment());
+            rowSize += compStrides[compIndex];
+        }
+
+        // an archetype without components only uses the chunk size to bound the rows of a parallel range
+        if (rowSize == 0) {
+            rowsPerChunk = archetypeChunkSize;
+            return;
+        }
+
+        const auto layoutSize = [&](size_t inRowNum) -> size_t {
+            size_t offset = 0;
+            for (size_t compIndex = 0; compIndex < rttiVec.size(); compIndex++) {
+                offset = AlignUp(offset, std::max(archetypeColumnAlignment, rttiVec[compIndex].MemoryAlignment()));
+                compOffsets[compIndex] = offset;
+                offset += inRowNum * compStrides[compIndex];
             }
+            return offset;
+        };
+
+        // column padding costs at most a cache line per component, so the first guess is off by a few rows at most
+        rowsPerChunk = archetypeChunkSize / rowSize;
+        while (rowsPerChunk > 1 && layoutSize(rowsPerChunk) > archetypeChunkSize) {
+            rowsPerChunk--;
         }
-        compMemory = std::move(newCompMemory);
-        capacity = newCapacity;
+        rowsPerChunk = std::max(rowsPerChunk, static_cast<size_t>(1));
+        chunkSize = std::max(AlignUp(layoutSize(rowsPerChunk), archetypeColumnAlignment), archetypeChunkSize);
     }
 
     void Archetype::DestroyElements()
@@ -527,23 +651,48 @@ namespace Runtime::Internal {
 
     void Archetype::ReleaseMemory()
     {
-        for (size_t compIndex = 0; compIndex < compMemory.size(); compIndex++) {
-            if (compMemory[compIndex] != nullptr) {
-                ::operator delete(compMemory[compIndex], std::align_val_t(rttiVec[compIndex].MemoryAlignment()));
-                compMemory[compIndex] = nullptr;
-            }
+        for (ElemPtr chunk : chunks) {
+            FreeChunk(chunk);
         }
-        capacity = 0;
+        chunks.clear();
     }
 
     void Archetype::AllocateNewElemBack()
     {
-        if (Count() == Capacity()) {
-            Reserve();
+        // rows never move on growth, a full archetype only appends one more chunk
+        if (count == Capacity() && !rttiVec.empty()) {
+            chunks.emplace_back(AllocateChunk());
         }
         count++;
     }
 
+    void Archetype::ReleaseUnusedChunks()
+    {
+        // keep one empty chunk so that an entity moving back and forth over a chunk boundary does not hit the pool,
+        // the last two chunks are both empty once the rows fit into the ones before them
+        while (chunks.size() > 1 && count <= (chunks.size() - 2) * rowsPerChunk) {
+            FreeChunk(chunks.back());
+            chunks.pop_back();
+        }
+    }
+
+    ElemPtr Archetype::AllocateChunk() const
+    {
+        if (chunkSize == archetypeChunkSize && chunkAlignment == archetypeColumnAlignment) {
+            return chunkPool->Allocate();
+        }
+        return ::operator new(chunkSize, std::align_val_t(chunkAlignment));
+    }
+
+    void Archetype::FreeChunk(ElemPtr inChunk) const
+    {
+        if (chunkSize == archetypeChunkSize && chunkAlignment == archetypeColumnAlignment) {
+            chunkPool->Free(inChunk);
+            return;
+        }
+        ::operator delete(inChunk, std::align_val_t(chunkAlignment));
+    }
+
     EntityPool::EntityPool()
         : locations(1)
         , states(1)
@@ -683,8 +832,194 @@ namespace Runtime::Internal {
         return allocated.end();
     }
 
+    size_t ArchetypeFilter::Hash::operator()(const ArchetypeFilter& inFilter) const
+    {
+        size_t result = 0;
+        const auto combine = [&](const std::vector<const Mirror::Class*>& inClasses) -> void {
+            for (const auto* clazz : inClasses) {
+                result ^= std::hash<const Mirror::Class*> {}(clazz) + 0x9e3779b9 + (result << 6) + (result >> 2);
+            }
+            // keeps the same classes in different lists apart
+            result = result * 31 + inClasses.size();
+        };
+        combine(inFilter.includes);
+        combine(inFilter.tagIncludes);
+        combine(inFilter.excludes);
+        combine(inFilter.tagExcludes);
+        return result;
+    }
+
+    ArchetypeFilter::ArchetypeFilter() = default;
+
+    ArchetypeFilter::ArchetypeFilter(std::vector<CompClass> inIncludes, std::vector<TagClass> inTagIncludes, std::vector<CompClass> inExcludes, std::vector<TagClass> inTagExcludes)
+        : includes(std::move(inIncludes))
+        , tagIncludes(std::move(inTagIncludes))
+        , excludes(std::move(inExcludes))
+        , tagExcludes(std::move(inTagExcludes))
+    {
+        std::ranges::sort(tagIncludes);
+        std::ranges::sort(excludes);
+        std::ranges::sort(tagExcludes);
+    }
+
+    bool ArchetypeFilter::Matches(const Archetype& inArchetype) const
+    {
+        return std::ranges::all_of(includes, [&](CompClass clazz) -> bool { return inArchetype.ContainsComp(clazz); })
+            && std::ranges::all_of(tagIncludes, [&](TagClass clazz) -> bool { return inArchetype.ContainsTag(clazz); })
+            && std::ranges::none_of(excludes, [&](CompClass clazz) -> bool { return inArchetype.ContainsComp(clazz); })
+            && std::ranges::none_of(tagExcludes, [&](TagClass clazz) -> bool { return inArchetype.ContainsTag(clazz); });
+    }
+
+    bool ArchetypeFilter::operator==(const ArchetypeFilter& inRhs) const
+    {
+        return includes == inRhs.includes
+            && tagIncludes == inRhs.tagIncludes
+            && excludes == inRhs.excludes
+            && tagExcludes == inRhs.tagExcludes;
+    }
+
+    ArchetypeQuery::ArchetypeQuery(ArchetypeFilter inFilter)
+        : filter(std::move(inFilter))
+    {
+    }
+
+    const ArchetypeFilter& ArchetypeQuery::Filter() const
+    {
+        return filter;
+    }
+
+    size_t ArchetypeQuery::Count() const
+    {
+        return entries.size();
+    }
+
+    const ArchetypeQuery::Entry& ArchetypeQuery::At(size_t inIndex) const
+    {
+        return entries[inIndex];
+    }
+
+    void ArchetypeQuery::Match(Archetype& inArchetype)
+    {
+        if (!filter.Matches(inArchetype)) {
+            return;
+        }
+
+        auto& entry = entries.emplace_back();
+        entry.archetype = &inArchetype;
+        entry.compIndices.reserve(filter.includes.size());
+        for (const auto* clazz : filter.includes) {
+            entry.compIndices.emplace_back(inArchetype.GetCompIndex(clazz));
+        }
+    }
+
+    void ArchetypeQuery::Reset()
+    {
+        entries.clear();
+    }
+
+    SystemAccess SystemAccess::FromClass(SystemClass inClass)
+    {
+        if (!inClass->HasMeta(MetaPresets::reads) && !inClass->HasMeta(MetaPresets::writes)) {
+            return Exclusive();
+        }
+
+        SystemAccess result;
+        const auto declare = [&](const char* inKey, bool inWrite) -> void {
+            if (!inClass->HasMeta(inKey)) {
+                return;
+            }
+            for (const auto& name : Common::StringUtils::Split(inClass->GetMeta(inKey), "|")) {
+                // a key without value declares nothing
+                if (name.empty() || name == "true") {
+                    continue;
+                }
+                const Mirror::Class* clazz = Mirror::Class::Find(name);
+                AssertWithReason(clazz != nullptr, "system access names a class that is not reflected");
+                inWrite ? result.Write(clazz) : result.Read(clazz);
+            }
+        };
+        declare(MetaPresets::reads, false);
+        declare(MetaPresets::writes, true);
+        return result;
+    }
+
+    SystemAccess SystemAccess::Exclusive()
+    {
+        SystemAccess result;
+        result.exclusive = true;
+        return result;
+    }
+
+    SystemAccess::SystemAccess()
+        : exclusive(false)
+    {
+    }
+
+    SystemAccess& SystemAccess::Read(const Mirror::Class* inClass)
+    {
+        reads.emplace(inClass);
+        return *this;
+    }
+
+    SystemAccess& SystemAccess::Write(const Mirror::Class* inClass)
+    {
+        writes.emplace(inClass);
+        return *this;
+    }
+
+    bool SystemAccess::IsExclusive() const
+    {
+        return exclusive;
+    }
+
+    bool SystemAccess::CanRead(const Mirror::Class* inClass) const
+    {
+        return exclusive || reads.contains(inClass) || writes.contains(inClass);
+    }
+
+    bool SystemAccess::CanWrite(const Mirror::Class* inClass) const
+    {
+        return exclusive || writes.contains(inClass);
+    }
+
+    bool SystemAccess::ConflictsWith(const SystemAccess& inOther) const
+    {
+        if (exclusive || inOther.exclusive) {
+            return true;
+        }
+        const auto writesAny = [](const SystemAccess& inWriter, const SystemAccess& inAccessor) -> bool {
+            return std::ranges::any_of(inWriter.writes, [&](const Mirror::Class* clazz) -> bool { return inAccessor.CanRead(clazz); });
+        };
+        return writesAny(*this, inOther) || writesAny(inOther, *this);
+    }
+
+    static thread_local const SystemAccess* currentSystemAccess = nullptr;
+
+    const SystemAccess* SystemAccessScope::Current()
+    {
+        return currentSystemAccess;
+    }
+
+    SystemAccessScope::SystemAccessScope(const SystemAccess& inAccess)
+        : lastAccess(currentSystemAccess)
+    {
+        currentSystemAccess = &inAccess;
+    }
+
+    SystemAccessScope::SystemAccessScope(const SystemAccess* inAccess)
+        : lastAccess(currentSystemAccess)
+    {
+        currentSystemAccess = inAccess;
+    }
+
+    SystemAccessScope::~SystemAccessScope()
+    {
+        currentSystemAccess = lastAccess;
+    }
+
     SystemFactory::SystemFactory(SystemClass inClass)
         : clazz(inClass)
+        , access(SystemAccess::FromClass(inClass))
     {
         BuildArgumentLists();
     }
@@ -718,6 +1053,16 @@ namespace Runtime::Internal {
         return clazz;
     }
 
+    void SystemFactory::SetAccess(SystemAccess inAccess)
+    {
+        access = std::move(inAccess);
+    }
+
+    const SystemAccess& SystemFactory::GetAccess() const
+    {
+        return access;
+    }
+
     void SystemFactory::BuildArgumentLists()
     {
         const auto& memberVariables = clazz->GetMemberVariables();
@@ -1010,6 +1355,7 @@ namespace Runtime {
         dataCompClasses = inOther.dataCompClasses;
         tagClasses = inOther.tagClasses;
         RebindEntityArchetypes();
+        RebuildQueries();
         return *this;
     }
 
@@ -1024,11 +1370,13 @@ namespace Runtime {
         dataCompClasses = std::move(inOther.dataCompClasses);
         tagClasses = std::move(inOther.tagClasses);
         RebindEntityArchetypes();
+        RebuildQueries();
         return *this;
     }
 
     Entity ECRegistry::Create()
     {
+        Internal::CheckSystemStructuralChange();
         const Entity result = entities.Allocate();
         Internal::Archetype& archetype = archetypes.at(0);
         const auto elemIndex = archetype.EmplaceElem(result);
@@ -1038,6 +1386,7 @@ namespace Runtime {
 
     void ECRegistry::Create(Entity inEntity)
     {
+        Internal::CheckSystemStructuralChange();
         entities.Allocate(inEntity);
         Internal::Archetype& archetype = archetypes.at(0);
         const auto elemIndex = archetype.EmplaceElem(inEntity);
@@ -1046,6 +1395,7 @@ namespace Runtime {
 
     void ECRegistry::Destroy(Entity inEntity)
     {
+        Internal::CheckSystemStructuralChange();
         const auto location = entities.GetLocation(inEntity);
         Internal::Archetype& archetype = *location.archetype;
         if (!compEvents.empty()) {
@@ -1072,12 +1422,14 @@ namespace Runtime {
 
     void ECRegistry::Clear()
     {
+        Internal::CheckSystemStructuralChange();
         entities.Clear();
         globalComps.clear();
         archetypes.clear();
         dataCompClasses.clear();
         tagClasses.clear();
         archetypes.emplace(0, Internal::Archetype());
+        RebuildQueries();
     }
 
     void ECRegistry::Each(const EntityTraverseFunc& inFunc) const
@@ -1154,6 +1506,7 @@ namespace Runtime {
 
     void ECRegistry::NotifyUpdatedDyn(CompClass inClass, Entity inEntity)
     {
+        Internal::CheckSystemAccess(inClass, true);
         if (compEvents.empty()) {
             return;
         }
@@ -1310,6 +1663,46 @@ namespace Runtime {
         tagClasses.emplace(inClass);
     }
 
+    Internal::Archetype& ECRegistry::EmplaceArchetype(Internal::ArchetypeLayout inLayout)
+    {
+        const Internal::ArchetypeId archetypeId = inLayout.Id();
+        auto iter = archetypes.find(archetypeId);
+        if (iter == archetypes.end()) {
+            iter = archetypes.emplace(archetypeId, Internal::Archetype(std::move(inLayout))).first;
+
+            std::unique_lock lock(queryMutex);
+            for (const auto& query : queries | std::views::values) {
+                query->Match(iter->second);
+            }
+        }
+        return iter->second;
+    }
+
+    const Internal::ArchetypeQuery& ECRegistry::EmplaceQuery(const Internal::ArchetypeFilter& inFilter) const
+    {
+        std::unique_lock lock(queryMutex);
+        auto iter = queries.find(inFilter);
+        if (iter == queries.end()) {
+            iter = queries.emplace(inFilter, Common::MakeUnique<Internal::ArchetypeQuery>(inFilter)).first;
+            // the query only hands out archetypes to views, which keep them const for const registries
+            for (auto& archetype : const_cast<ECRegistry*>(this)->archetypes | std::views::values) {
+                iter->second->Match(archetype);
+            }
+        }
+        return *iter->second;
+    }
+
+    void ECRegistry::RebuildQueries()
+    {
+        std::unique_lock lock(queryMutex);
+        for (const auto& query : queries | std::views::values) {
+            query->Reset();
+            for (auto& archetype : archetypes | std::views::values) {
+                query->Match(archetype);
+            }
+        }
+    }
+
     Mirror::Any ECRegistry::EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs)
     {
         const auto location = MoveEntityForAdd(Internal::CompRtti(inClass), inEntity);
@@ -1327,6 +1720,7 @@ namespace Runtime {
 
     Internal::EntityPool::Location ECRegistry::MoveEntityForAdd(const Internal::CompRtti& inRtti, Entity inEntity)
     {
+        Internal::CheckSystemStructuralChange();
         const CompClass inClass = inRtti.Class();
         RegisterDataCompClass(inClass);
         const auto location = entities.GetLocation(inEntity);
@@ -1338,6 +1732,7 @@ namespace Runtime {
 
     Internal::EntityPool::Location ECRegistry::MoveEntityForAddTag(TagClass inClass, Entity inEntity)
     {
+        Internal::CheckSystemStructuralChange();
         RegisterTagClass(inClass);
         const auto location = entities.GetLocation(inEntity);
         if (const auto* transition = location.archetype->FindAddTransition(inClass)) {
@@ -1350,11 +1745,7 @@ namespace Runtime {
     {
         Internal::Archetype& archetype = *inLocation.archetype;
         Assert(archetype.FindAddTransition(inClass) == nullptr);
-        const Internal::ArchetypeId newArchetypeId = inLayout.Id();
-        if (!archetypes.contains(newArchetypeId)) {
-            archetypes.emplace(newArchetypeId, Internal::Archetype(std::move(inLayout)));
-        }
-        Internal::Archetype& newArchetype = archetypes.at(newArchetypeId);
+        Internal::Archetype& newArchetype = EmplaceArchetype(std::move(inLayout));
         const auto& transition = archetype.CacheAddTransition(inClass, newArchetype);
         if (newArchetype.FindRemoveTransition(inClass) == nullptr) {
             newArchetype.CacheRemoveTransition(inClass, archetype);
@@ -1375,18 +1766,14 @@ namespace Runtime {
 
     void ECRegistry::MoveEntityForRemove(CompClass inClass, Entity inEntity)
     {
+        Internal::CheckSystemStructuralChange();
         const auto location = entities.GetLocation(inEntity);
         Internal::Archetype& archetype = *location.archetype;
         const Internal::Archetype::Transition* transition = archetype.FindRemoveTransition(inClass);
 
         if (transition == nullptr) {
             Assert(archetype.Contains(inClass));
-            Internal::ArchetypeLayout newLayout = archetype.GetLayout().Without(inClass);
-            const Internal::ArchetypeId newArchetypeId = newLayout.Id();
-            if (!archetypes.contains(newArchetypeId)) {
-                archetypes.emplace(newArchetypeId, Internal::Archetype(std::move(newLayout)));
-            }
-            Internal::Archetype& newArchetype = archetypes.at(newArchetypeId);
+            Internal::Archetype& newArchetype = EmplaceArchetype(archetype.GetLayout().Without(inClass));
             transition = &archetype.CacheRemoveTransition(inClass, newArchetype);
             if (newArchetype.FindAddTransition(inClass) == nullptr) {
                 newArchetype.CacheAddTransition(inClass, archetype);
@@ -1430,6 +1817,7 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::GetDyn(CompClass inClass, Entity inEntity)
     {
+        Internal::CheckSystemAccess(inClass, true);
         Assert(Valid(inEntity) && HasDyn(inClass, inEntity));
         Mirror::Any compRef = entities.GetArchetypePtr(inEntity)->GetComp(entities.GetElemIndex(inEntity), inClass);
         return compRef;
@@ -1437,6 +1825,7 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::GetDyn(CompClass inClass, Entity inEntity) const
     {
+        Internal::CheckSystemAccess(inClass, false);
         Assert(Valid(inEntity) && HasDyn(inClass, inEntity));
         Mirror::Any compRef = entities.GetArchetypePtr(inEntity)->GetComp(entities.GetElemIndex(inEntity), inClass);
         return compRef.ConstRef();
@@ -1469,6 +1858,7 @@ namespace Runtime {
 
     void ECRegistry::GNotifyUpdatedDyn(GCompClass inClass)
     {
+        Internal::CheckSystemAccess(inClass, true);
         const auto iter = globalCompEvents.find(inClass);
         if (iter == globalCompEvents.end()) {
             return;
@@ -1496,6 +1886,7 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::GEmplaceDyn(GCompClass inClass, const Mirror::ArgumentList& inArgs)
     {
+        Internal::CheckSystemStructuralChange();
         Assert(Internal::IsGlobalCompClass(inClass));
         Assert(!GHasDyn(inClass));
         globalComps.emplace(inClass, inClass->ConstructDyn(inArgs));
@@ -1505,6 +1896,7 @@ namespace Runtime {
 
     void ECRegistry::GRemoveDyn(GCompClass inClass)
     {
+        Internal::CheckSystemStructuralChange();
         Assert(Internal::IsGlobalCompClass(inClass));
         Assert(GHasDyn(inClass));
         GNotifyRemoveDyn(inClass);
@@ -1546,6 +1938,7 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::GGetDyn(GCompClass inClass)
     {
+        Internal::CheckSystemAccess(inClass, true);
         Assert(Internal::IsGlobalCompClass(inClass));
         Assert(GHasDyn(inClass));
         return globalComps.at(inClass).Ref();
@@ -1553,6 +1946,7 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::GGetDyn(GCompClass inClass) const
     {
+        Internal::CheckSystemAccess(inClass, false);
         Assert(Internal::IsGlobalCompClass(inClass));
         Assert(GHasDyn(inClass));
         return globalComps.at(inClass).ConstRef();
@@ -1576,6 +1970,325 @@ namespace Runtime {
         return globalComps.size();
     }
 
+    bool ECCommandBuffer::IsTemporary(Entity inEntity)
+    {
+        return (inEntity & Internal::temporaryEntityBit) != 0;
+    }
+
+    ECCommandBuffer::ECCommandBuffer(ECRegistry& inRegistry)
+        : registry(inRegistry)
+        , chunkPool(Internal::ArchetypeChunkPool::Get())
+        , valueChunkOffset(Internal::archetypeChunkSize)
+        , temporaryNum(0)
+    {
+    }
+
+    ECCommandBuffer::~ECCommandBuffer()
+    {
+        ReleaseValues();
+    }
+
+    Entity ECCommandBuffer::Create()
+    {
+        Assert(temporaryNum < Internal::temporaryEntityBit);
+        return Internal::temporaryEntityBit | static_cast<Entity>(temporaryNum++);
+    }
+
+    void ECCommandBuffer::Destroy(Entity inEntity)
+    {
+        Record(CommandType::destroy, inEntity, nullptr);
+    }
+
+    void ECCommandBuffer::EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs)
+    {
+        const Internal::CompRtti rtti(inClass);
+        const Internal::ElemPtr memory = AllocateValue(rtti);
+        inClass->InplaceNewDyn(memory, inArgs);
+        Record(CommandType::emplace, inEntity, inClass, values.size());
+        values.emplace_back(rtti, memory);
+    }
+
+    void ECCommandBuffer::RemoveDyn(CompClass inClass, Entity inEntity)
+    {
+        Record(CommandType::remove, inEntity, inClass);
+    }
+
+    void ECCommandBuffer::AddTagDyn(TagClass inClass, Entity inEntity)
+    {
+        Assert(inClass->SizeOf() == 1 && inClass->AlignOf() == 1);
+        Record(CommandType::addTag, inEntity, inClass);
+    }
+
+    void ECCommandBuffer::RemoveTagDyn(TagClass inClass, Entity inEntity)
+    {
+        Record(CommandType::removeTag, inEntity, inClass);
+    }
+
+    Entity ECCommandBuffer::Resolve(Entity inEntity) const
+    {
+        if (!IsTemporary(inEntity)) {
+            return inEntity;
+        }
+        const size_t index = inEntity & ~Internal::temporaryEntityBit;
+        Assert(index < resolvedEntities.size());
+        return resolvedEntities[index];
+    }
+
+    size_t ECCommandBuffer::Count() const
+    {
+        return commands.size() + temporaryNum - resolvedEntities.size();
+    }
+
+    bool ECCommandBuffer::Empty() const
+    {
+        return Count() == 0;
+    }
+
+    void ECCommandBuffer::Playback()
+    {
+        struct ClassChange {
+            const Mirror::Class* clazz;
+            bool tag;
+            bool presentBefore;
+            bool present;
+            // value of the last emplace, values.size() if the component was not emplaced by the buffer
+            size_t valueIndex;
+        };
+
+        struct EntityChange {
+            Entity entity;
+            bool destroyed;
+            std::vector<ClassChange> classChanges;
+        };
+
+        struct Batch {
+            Internal::Archetype* srcArchetype;
+            std::vector<size_t> changeIndices;
+        };
+
+        using BatchKey = std::pair<Internal::Archetype*, std::vector<std::pair<const Mirror::Class*, bool>>>;
+
+        if (Empty()) {
+            return;
+        }
+
+        // temporaries are created in recording order, the entities they resolve to do not depend on the batching below
+        resolvedEntities.reserve(temporaryNum);
+        while (resolvedEntities.size() < temporaryNum) {
+            resolvedEntities.emplace_back(registry.Create());
+        }
+
+        // fold the commands of every entity into the components and tags it ends up with
+        std::vector<EntityChange> changes;
+        std::unordered_map<Entity, size_t> changeIndices;
+        for (const auto& command : commands) {
+            // another buffer or the registry may have destroyed the entity since the command was recorded
+            const Entity entity = Resolve(command.entity);
+            if (!registry.Valid(entity)) {
+                continue;
+            }
+            const auto [changeIter, inserted] = changeIndices.emplace(entity, changes.size());
+            if (inserted) {
+                changes.emplace_back(entity, false, std::vector<ClassChange> {});
+            }
+            auto& change = changes[changeIter->second];
+            if (change.destroyed) {
+                continue;
+            }
+
+            if (command.type == CommandType::destroy) {
+                change.destroyed = true;
+                continue;
+            }
+
+            auto classIter = std::ranges::find_if(change.classChanges, [&](const ClassChange& classChange) -> bool { return classChange.clazz == command.clazz; });
+            if (classIter == change.classChanges.end()) {
+                const bool tag = command.type == CommandType::addTag || command.type == CommandType::removeTag;
+                const auto* archetype = registry.entities.GetArchetypePtr(entity);
+                const bool present = tag ? archetype->ContainsTag(command.clazz) : archetype->ContainsComp(command.clazz);
+                classIter = change.classChanges.emplace(change.classChanges.end(), command.clazz, tag, present, present, values.size());
+            }
+            const bool add = command.type == CommandType::emplace || command.type == CommandType::addTag;
+            Assert(classIter->present != add);
+            classIter->present = add;
+            classIter->valueIndex = command.type == CommandType::emplace ? command.valueIndex : values.size();
+        }
+
+        // entities that leave the same archetype through the same change are moved together, batches keep the order
+        // their first entity was recorded in
+        std::vector<Batch> batches;
+        std::map<BatchKey, size_t> batchIndices;
+        std::vector<std::pair<Entity, size_t>> replacements;
+        for (size_t changeIndex = 0; changeIndex < changes.size(); changeIndex++) {
+            auto& [entity, destroyed, classChanges] = changes[changeIndex];
+            if (destroyed) {
+                continue;
+            }
+
+            std::erase_if(classChanges, [&](const ClassChange& classChange) -> bool {
+                // a component removed and emplaced again keeps its row, only the value is replaced
+                if (classChange.presentBefore && classChange.present && classChange.valueIndex != values.size()) {
+                    replacements.emplace_back(entity, classChange.valueIndex);
+                }
+                return classChange.presentBefore == classChange.present;
+            });
+            if (classChanges.empty()) {
+                continue;
+            }
+            std::ranges::sort(classChanges, [](const ClassChange& lhs, const ClassChange& rhs) -> bool { return lhs.clazz < rhs.clazz; });
+
+            BatchKey key { registry.entities.GetArchetypePtr(entity), {} };
+            key.second.reserve(classChanges.size());
+            for (const auto& classChange : classChanges) {
+                key.second.emplace_back(classChange.clazz, classChange.present);
+            }
+            const auto [batchIter, inserted] = batchIndices.emplace(std::move(key), batches.size());
+            if (inserted) {
+                batches.emplace_back(batchIter->first.first, std::vector<size_t> {});
+            }
+            batches[batchIter->second].changeIndices.emplace_back(changeIndex);
+        }
+
+        const bool hasEvents = !registry.compEvents.empty();
+        for (const auto& [srcArchetypePtr, batchChangeIndices] : batches) {
+            Internal::Archetype& srcArchetype = *srcArchetypePtr;
+            const auto& batchClassChanges = changes[batchChangeIndices.front()].classChanges;
+
+            Internal::ArchetypeLayout layout = srcArchetype.GetLayout();
+            for (const auto& classChange : batchClassChanges) {
+                if (!classChange.present) {
+                    layout = layout.Without(classChange.clazz);
+                } else if (classChange.tag) {
+                    registry.RegisterTagClass(classChange.clazz);
+                    layout = layout.WithTag(classChange.clazz);
+                } else {
+                    registry.RegisterDataCompClass(classChange.clazz);
+                    layout = layout.WithComp(values[classChange.valueIndex].rtti);
+                }
+            }
+            Internal::Archetype& dstArchetype = registry.EmplaceArchetype(std::move(layout));
+            const auto compMappings = srcArchetype.MakeCompMappings(dstArchetype);
+            std::vector<size_t> dstCompIndices(batchClassChanges.size());
+            for (size_t i = 0; i < batchClassChanges.size(); i++) {
+                if (batchClassChanges[i].present && !batchClassChanges[i].tag) {
+                    dstCompIndices[i] = dstArchetype.GetCompIndex(batchClassChanges[i].clazz);
+                }
+            }
+
+            for (const size_t changeIndex : batchChangeIndices) {
+                const auto& [entity, destroyed, classChanges] = changes[changeIndex];
+                if (hasEvents) {
+                    for (const auto& classChange : classChanges) {
+                        if (!classChange.present) {
+                            registry.NotifyRemoveDyn(classChange.clazz, entity);
+                        }
+                    }
+                }
+
+                // event listeners must not move the entities of this buffer
+                const auto location = registry.entities.GetLocation(entity);
+                Assert(location.archetype == &srcArchetype);
+                const size_t elemIndex = dstArchetype.EmplaceElem(entity, srcArchetype, location.elemIndex, compMappings);
+                registry.entities.SetLocation(entity, dstArchetype, elemIndex);
+                registry.EraseArchetypeElem(srcArchetype, location.elemIndex);
+
+                for (size_t i = 0; i < classChanges.size(); i++) {
+                    if (classChanges[i].present && !classChanges[i].tag) {
+                        const auto& [rtti, memory] = values[classChanges[i].valueIndex];
+                        rtti.MoveConstructFrom(dstArchetype.GetCompAt(elemIndex, dstCompIndices[i]), memory);
+                    }
+                }
+                if (hasEvents) {
+                    for (const auto& classChange : classChanges) {
+                        if (classChange.present) {
+                            registry.NotifyConstructedDyn(classChange.clazz, entity);
+                        }
+                    }
+                }
+            }
+        }
+
+        for (const auto& [entity, valueIndex] : replacements) {
+            const auto& [rtti, memory] = values[valueIndex];
+            registry.NotifyRemoveDyn(rtti.Class(), entity);
+            const auto location = registry.entities.GetLocation(entity);
+            const size_t compIndex = location.archetype->GetCompIndex(rtti.Class());
+            const Internal::ElemPtr comp = location.archetype->GetCompAt(location.elemIndex, compIndex);
+            location.archetype->GetCompRttis()[compIndex].Destruct(comp);
+            rtti.MoveConstructFrom(comp, memory);
+            registry.NotifyConstructedDyn(rtti.Class(), entity);
+        }
+
+        for (const auto& change : changes) {
+            if (change.destroyed) {
+                registry.Destroy(change.entity);
+            }
+        }
+
+        commands.clear();
+        ReleaseValues();
+    }
+
+    void ECCommandBuffer::ResetTemporaries()
+    {
+        if (resolvedEntities.size() != temporaryNum) {
+            return;
+        }
+        temporaryNum = 0;
+        resolvedEntities.clear();
+    }
+
+    void ECCommandBuffer::Clear()
+    {
+        commands.clear();
+        ReleaseValues();
+        temporaryNum = 0;
+        resolvedEntities.clear();
+    }
+
+    void ECCommandBuffer::Record(CommandType inType, Entity inEntity, const Mirror::Class* inClass, size_t inValueIndex)
+    {
+        Assert(inEntity != entityNull);
+        Assert(!IsTemporary(inEntity) || (inEntity & ~Internal::temporaryEntityBit) < temporaryNum);
+        commands.emplace_back(inType, inEntity, inClass, inValueIndex);
+    }
+
+    Internal::ElemPtr ECCommandBuffer::AllocateValue(const Internal::CompRtti& inRtti)
+    {
+        const size_t size = inRtti.MemorySize();
+        const size_t alignment = inRtti.MemoryAlignment();
+        if (size > Internal::archetypeChunkSize || alignment > Internal::archetypeColumnAlignment) {
+            return ::operator new(size, std::align_val_t(alignment));
+        }
+
+        valueChunkOffset = Common::AlignUp(valueChunkOffset, alignment);
+        if (valueChunkOffset + size > Internal::archetypeChunkSize) {
+            valueChunks.emplace_back(chunkPool->Allocate());
+            valueChunkOffset = 0;
+        }
+        const Internal::ElemPtr result = static_cast<uint8_t*>(valueChunks.back()) + valueChunkOffset;
+        valueChunkOffset += size;
+        return result;
+    }
+
+    void ECCommandBuffer::ReleaseValues()
+    {
+        // values moved into the registry are left moved-from, they are destructed here like the ones never used
+        for (const auto& [rtti, memory] : values) {
+            rtti.Destruct(memory);
+            if (rtti.MemorySize() > Internal::archetypeChunkSize || rtti.MemoryAlignment() > Internal::archetypeColumnAlignment) {
+                ::operator delete(memory, std::align_val_t(rtti.MemoryAlignment()));
+            }
+        }
+        values.clear();
+
+        for (const Internal::ElemPtr chunk : valueChunks) {
+            chunkPool->Free(chunk);
+        }
+        valueChunks.clear();
+        valueChunkOffset = Internal::archetypeChunkSize;
+    }
+
     SystemGroup::SystemGroup(std::string inName, SystemExecuteStrategy inStrategy)
         : name(std::move(inName))
         , strategy(inStrategy)
@@ -1728,6 +2441,7 @@ namespace Runtime {
     }
 
     SystemPipeline::SystemPipeline(const SystemGraph& inGraph)
+        : currentAction(nullptr)
     {
         const auto& systemGroups = inGraph.GetGroups();
         systemGraph.reserve(systemGroups.size());
@@ -1742,51 +2456,101 @@ namespace Runtime {
                 systemContexts.emplace_back(factory, nullptr);
             }
         }
+        CompileJobGraph(lifecycleJobGraph, false);
+        CompileJobGraph(tickJobGraph, true);
     }
 
-    void SystemPipeline::ParallelPerformAction(const ActionFunc& inActionFunc)
+    void SystemPipeline::CompileJobGraph(Core::JobGraph& outJobGraph, bool inScheduleAutomatic)
     {
-        tf::Taskflow taskFlow;
-        auto lastBarrier = taskFlow.emplace([]() -> void { Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker); });
+        std::optional<Core::JobId> lastBarrier;
+        const auto emplaceSystemJob = [&](SystemContext& systemContext, bool inPlaybackCommands, bool inCheckAccess) -> Core::JobId {
+            return outJobGraph.Emplace([this, &systemContext, inPlaybackCommands, inCheckAccess]() -> void {
+                {
+                    std::optional<Internal::SystemAccessScope> accessScope;
+                    if (inCheckAccess) {
+                        accessScope.emplace(systemContext.factory.GetAccess());
+                    }
+                    (*currentAction)(systemContext);
+                }
+                if (inPlaybackCommands) {
+                    PlaybackCommands(systemContext);
+                }
+            });
+        };
+        // the barrier plays back the commands of the group in system order, whatever order the systems ran in
+        const auto emplacePlaybackBarrier = [&](SystemGroupContext& groupContext) -> Core::JobId {
+            return outJobGraph.Emplace([&groupContext]() -> void {
+                for (auto& systemContext : groupContext.systems) {
+                    PlaybackCommands(systemContext);
+                }
+            });
+        };
 
         for (auto& groupContext : systemGraph) {
-            if (groupContext.strategy == SystemExecuteStrategy::sequential) {
-                tf::Task lastTask = lastBarrier;
+            if (groupContext.systems.empty()) {
+                continue;
+            }
+
+            const auto strategy = groupContext.strategy == SystemExecuteStrategy::automatic && !inScheduleAutomatic
+                ? SystemExecuteStrategy::sequential
+                : groupContext.strategy;
+            if (strategy == SystemExecuteStrategy::sequential) {
                 for (auto& systemContext : groupContext.systems) {
-                    auto task = taskFlow.emplace([&]() -> void {
-                        Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker);
-                        inActionFunc(systemContext);
-                    });
-                    task.succeed(lastTask);
-                    lastTask = task;
+                    const auto job = emplaceSystemJob(systemContext, true, false);
+                    if (lastBarrier.has_value()) {
+                        outJobGraph.Precede(*lastBarrier, job);
+                    }
+                    lastBarrier = job;
                 }
-                lastBarrier = lastTask;
-            } else if (groupContext.strategy == SystemExecuteStrategy::concurrent) {
-                std::vector<tf::Task> tasks;
-                tasks.reserve(groupContext.systems.size());
-
+            } else if (strategy == SystemExecuteStrategy::concurrent) {
+                const auto barrier = emplacePlaybackBarrier(groupContext);
                 for (auto& systemContext : groupContext.systems) {
-                    tasks.emplace_back(taskFlow.emplace([&]() -> void {
-                        Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker);
-                        inActionFunc(systemContext);
-                    }));
-                    tasks.back().succeed(lastBarrier);
+                    const auto job = emplaceSystemJob(systemContext, false, false);
+                    if (lastBarrier.has_value()) {
+                        outJobGraph.Precede(*lastBarrier, job);
+                    }
+                    outJobGraph.Precede(job, barrier);
                 }
-
-                auto barrier = taskFlow.emplace([]() -> void { Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker); });
-                for (const auto& task : tasks) {
-                    barrier.succeed(task);
+                lastBarrier = barrier;
+            } else if (strategy == SystemExecuteStrategy::automatic) {
+                const auto barrier = emplacePlaybackBarrier(groupContext);
+                std::vector<Core::JobId> jobs;
+                jobs.reserve(groupContext.systems.size());
+                for (auto& systemContext : groupContext.systems) {
+                    const auto job = emplaceSystemJob(systemContext, false, true);
+                    if (lastBarrier.has_value()) {
+                        outJobGraph.Precede(*lastBarrier, job);
+                    }
+                    // conflicting systems tick in registration order
+                    const auto& access = systemContext.factory.GetAccess();
+                    for (size_t i = 0; i < jobs.size(); i++) {
+                        if (groupContext.systems[i].factory.GetAccess().ConflictsWith(access)) {
+                            outJobGraph.Precede(jobs[i], job);
+                        }
+                    }
+                    outJobGraph.Precede(job, barrier);
+                    jobs.emplace_back(job);
                 }
                 lastBarrier = barrier;
             } else {
                 QuickFail();
             }
         }
+    }
+
+    void SystemPipeline::PlaybackCommands(SystemContext& inSystemContext)
+    {
+        // the teardown action has already destroyed the system and the commands it did not play back
+        if (inSystemContext.instance != nullptr) {
+            inSystemContext.instance->Commands().Playback();
+        }
+    }
 
-        tf::Executor executor;
-        executor
-            .run(taskFlow)
-            .wait();
+    void SystemPipeline::ParallelPerformAction(Core::JobGraph& inJobGraph, const ActionFunc& inActionFunc)
+    {
+        currentAction = &inActionFunc;
+        Core::JobSystem::Get().Run(inJobGraph);
+        currentAction = nullptr;
     }
 
     SystemSetupContext::SystemSetupContext()
@@ -1800,14 +2564,14 @@ namespace Runtime {
         , systemGraph(inSystemGraph)
         , pipeline(inSystemGraph)
     {
-        pipeline.ParallelPerformAction([&](SystemPipeline::SystemContext& context) -> void {
+        pipeline.ParallelPerformAction(pipeline.lifecycleJobGraph, [&](SystemPipeline::SystemContext& context) -> void {
             context.instance = context.factory.Build(inEcRegistry, inSetupContext);
         });
     }
 
     SystemGraphExecutor::~SystemGraphExecutor()
     {
-        pipeline.ParallelPerformAction([](SystemPipeline::SystemContext& context) -> void {
+        pipeline.ParallelPerformAction(pipeline.lifecycleJobGraph, [](SystemPipeline::SystemContext& context) -> void {
             context.instance = nullptr;
         });
         ecRegistry.CheckEventsUnbound();
@@ -1815,7 +2579,9 @@ namespace Runtime {
 
     void SystemGraphExecutor::Tick(float inDeltaTimeSeconds)
     {
-        pipeline.ParallelPerformAction([&](const SystemPipeline::SystemContext& context) -> void {
+        pipeline.ParallelPerformAction(pipeline.tickJobGraph, [&](const SystemPipeline::SystemContext& context) -> void {
+            // temporaries of the last tick resolve until here
+            context.instance->Commands().ResetTemporaries();
             context.instance->Tick(inDeltaTimeSeconds);
         });
     }
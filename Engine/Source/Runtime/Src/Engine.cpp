@@ -26,6 +26,9 @@ namespace Runtime {
     }
 
     Engine::Engine(const EngineInitParams& inParams)
+        : renderModule(nullptr)
+        , lastFrameRenderThreadFence(0)
+        , last2FrameRenderThreadFence(0)
     {
         Core::ThreadContext::SetTag(Core::ThreadTag::game);
         GameWorkerThreads::Get().Start();
@@ -68,13 +71,11 @@ namespace Runtime {
     void Engine::Tick(float inDeltaTimeSeconds)
     {
         // game thread can run faster than render thread 1 frame as max
-        if (last2FrameRenderThreadFence.valid()) {
-            last2FrameRenderThreadFence.wait();
-        }
+        auto& renderThread = renderModule->GetRenderThread();
+        renderThread.WaitFence(last2FrameRenderThreadFence);
 
         Core::ThreadContext::IncFrameNumber();
 
-        auto& renderThread = renderModule->GetRenderThread();
         renderThread.EmplaceTask([renderModule = renderModule]() -> void {
             Core::ThreadContext::IncFrameNumber();
             Core::Console::Get().PerformRenderThreadSettingsCopy();
@@ -89,8 +90,8 @@ namespace Runtime {
         }
 
         GameThread::Get().Flush();
-        last2FrameRenderThreadFence = std::move(lastFrameRenderThreadFence);
-        lastFrameRenderThreadFence = renderThread.EmplaceTask([]() -> void {});
+        last2FrameRenderThreadFence = lastFrameRenderThreadFence;
+        lastFrameRenderThreadFence = renderThread.EmplaceFence();
     }
 
     void Engine::AttachLogFile() const // NOLINT
@@ -2,13 +2,54 @@
 // Created by johnk on 2025/1/9.
 //
 
-#include <unordered_set>
 #include <utility>
 
 #include <Runtime/System/Scene.h>
 #include <Runtime/Engine.h>
 #include <Runtime/Component/Transform.h>
 
+namespace Runtime::Internal {
+    void SceneDelta::Clear()
+    {
+        directionalLights.Clear();
+        pointLights.Clear();
+        spotLights.Clear();
+        staticPrimitives.Clear();
+    }
+
+    bool SceneDelta::Empty() const
+    {
+        return directionalLights.Empty() && pointLights.Empty() && spotLights.Empty() && staticPrimitives.Empty();
+    }
+
+    void SceneDelta::Apply(Render::Scene& inScene)
+    {
+        directionalLights.Apply(inScene);
+        pointLights.Apply(inScene);
+        spotLights.Apply(inScene);
+        staticPrimitives.Apply(inScene);
+    }
+
+    SceneDeltaPool::SceneDeltaPool() = default;
+
+    SceneDelta SceneDeltaPool::Acquire()
+    {
+        std::unique_lock lock(mutex);
+        if (freeDeltas.empty()) {
+            return {};
+        }
+        SceneDelta delta = std::move(freeDeltas.back());
+        freeDeltas.pop_back();
+        return delta;
+    }
+
+    void SceneDeltaPool::Release(SceneDelta&& inDelta)
+    {
+        std::unique_lock lock(mutex);
+        freeDeltas.emplace_back(std::move(inDelta));
+    }
+}
+
 namespace Runtime {
     SceneSystem::SceneSystem(ECRegistry& inRegistry, const SystemSetupContext& inContext)
         : System(inRegistry, inContext)
@@ -18,6 +59,7 @@ namespace Runtime {
         , pointLightsObserver(inRegistry.EventsObserver<PointLight>())
         , spotLightsObserver(inRegistry.EventsObserver<SpotLight>())
         , staticPrimitivesObserver(inRegistry.EventsObserver<StaticPrimitive>())
+        , sceneDeltaPool(Common::MakeShared<Internal::SceneDeltaPool>())
     {
         transformUpdatedObserver
             .ObConstructed<WorldTransform>()
@@ -25,10 +67,11 @@ namespace Runtime {
 
         inRegistry.GEmplace<SceneHolder>(renderModule.NewScene());
 
-        inRegistry.View<DirectionalLight>().Each([this](Entity e, DirectionalLight&) -> void { QueueCreateSceneProxy<DirectionalLight, Render::DirectionalLightSceneProxy>(e); });
-        inRegistry.View<PointLight>().Each([this](Entity e, PointLight&) -> void { QueueCreateSceneProxy<PointLight, Render::PointLightSceneProxy>(e); });
-        inRegistry.View<SpotLight>().Each([this](Entity e, SpotLight&) -> void { QueueCreateSceneProxy<SpotLight, Render::SpotLightSceneProxy>(e); });
-        inRegistry.View<StaticPrimitive>().Each([this](Entity e, StaticPrimitive&) -> void { QueueCreateSceneProxy<StaticPrimitive, Render::StaticPrimitiveSceneProxy>(e, true); });
+        inRegistry.View<DirectionalLight>().Each([this](Entity e, DirectionalLight&) -> void { RecordCreateSceneProxy(e, sceneDelta.directionalLights); });
+        inRegistry.View<PointLight>().Each([this](Entity e, PointLight&) -> void { RecordCreateSceneProxy(e, sceneDelta.pointLights); });
+        inRegistry.View<SpotLight>().Each([this](Entity e, SpotLight&) -> void { RecordCreateSceneProxy(e, sceneDelta.spotLights); });
+        inRegistry.View<StaticPrimitive>().Each([this](Entity e, StaticPrimitive&) -> void { RecordCreateSceneProxy(e, sceneDelta.staticPrimitives, true); });
+        SubmitSceneDelta();
     }
 
     SceneSystem::~SceneSystem() // NOLINT
@@ -38,31 +81,57 @@ namespace Runtime {
 
     void SceneSystem::Tick(float inDeltaTimeSeconds)
     {
-        ProcessSceneProxyEvents<DirectionalLight, Render::DirectionalLightSceneProxy>(directionalLightsObserver);
-        ProcessSceneProxyEvents<PointLight, Render::PointLightSceneProxy>(pointLightsObserver);
-        ProcessSceneProxyEvents<SpotLight, Render::SpotLightSceneProxy>(spotLightsObserver);
-        ProcessSceneProxyEvents<StaticPrimitive, Render::StaticPrimitiveSceneProxy>(staticPrimitivesObserver, true);
-
-        std::unordered_set<Entity> changedWorldTransforms;
-        transformUpdatedObserver.Each([&](Entity e) -> void { changedWorldTransforms.emplace(e); });
-        for (const Entity e : changedWorldTransforms) {
-            if (!registry.Valid(e) || !registry.Has<WorldTransform>(e)) {
+        RecordSceneProxyEvents(directionalLightsObserver, sceneDelta.directionalLights);
+        RecordSceneProxyEvents(pointLightsObserver, sceneDelta.pointLights);
+        RecordSceneProxyEvents(spotLightsObserver, sceneDelta.spotLights);
+        RecordSceneProxyEvents(staticPrimitivesObserver, sceneDelta.staticPrimitives, true);
+        RecordTransformUpdates();
+        SubmitSceneDelta();
+    }
+
+    void SceneSystem::RecordTransformUpdates()
+    {
+        // the observer may record an entity several times per frame, marks dedup them without hashing
+        for (const Entity e : transformUpdatedObserver) {
+            if (e >= transformUpdateMarks.size()) {
+                transformUpdateMarks.resize(e + 1, false);
+            }
+            if (transformUpdateMarks[e] || !registry.Valid(e) || !registry.Has<WorldTransform>(e)) {
                 continue;
             }
+            transformUpdateMarks[e] = true;
+
             if (registry.Has<DirectionalLight>(e)) {
-                QueueUpdateSceneProxyTransform<Render::DirectionalLightSceneProxy>(e);
+                RecordUpdateSceneProxyTransform(e, sceneDelta.directionalLights);
             }
             if (registry.Has<PointLight>(e)) {
-                QueueUpdateSceneProxyTransform<Render::PointLightSceneProxy>(e);
+                RecordUpdateSceneProxyTransform(e, sceneDelta.pointLights);
             }
             if (registry.Has<SpotLight>(e)) {
-                QueueUpdateSceneProxyTransform<Render::SpotLightSceneProxy>(e);
+                RecordUpdateSceneProxyTransform(e, sceneDelta.spotLights);
             }
             if (registry.Has<StaticPrimitive>(e)) {
-                QueueUpdateSceneProxyTransform<Render::StaticPrimitiveSceneProxy>(e, true);
+                RecordUpdateSceneProxyTransform(e, sceneDelta.staticPrimitives, true);
             }
         }
-
+        for (const Entity e : transformUpdatedObserver) {
+            transformUpdateMarks[e] = false;
+        }
         transformUpdatedObserver.Clear();
     }
+
+    void SceneSystem::SubmitSceneDelta()
+    {
+        if (sceneDelta.Empty()) {
+            return;
+        }
+        // the applied delta is cleared and handed back with its capacity, with the render thread one frame behind the
+        // pool settles at two deltas that are swapped every frame
+        renderModule.GetRenderThread().EmplaceTask([scene = registry.GGet<SceneHolder>().scene.Get(), delta = std::move(sceneDelta), pool = sceneDeltaPool]() mutable -> void {
+            delta.Apply(*scene);
+            delta.Clear();
+            pool->Release(std::move(delta));
+        });
+        sceneDelta = sceneDeltaPool->Acquire();
+    }
 }
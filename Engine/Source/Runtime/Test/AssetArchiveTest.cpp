@@ -0,0 +1,97 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <filesystem>
+
+#include <Test/Test.h>
+
+#include <AssetTest.h>
+#include <Runtime/Asset/Archive.h>
+
+struct AssetArchiveTest : testing::Test {
+    void SetUp() override
+    {
+        file = "../Test/Generated/Runtime/AssetArchiveTest.expk";
+        std::filesystem::remove(file.String());
+    }
+
+    void TearDown() override
+    {
+        AssetManager::Get().UnmountArchives();
+    }
+
+    static std::vector<uint8_t> MakeBytes(size_t inSize, bool inCompressible)
+    {
+        std::vector<uint8_t> result(inSize);
+        uint32_t state = 0x12345678;
+        for (auto i = 0; i < inSize; i++) {
+            state = state * 1664525u + 1013904223u;
+            result[i] = inCompressible ? static_cast<uint8_t>(i / 64) : static_cast<uint8_t>(state >> 24);
+        }
+        return result;
+    }
+
+    Common::Path file;
+};
+
+TEST_F(AssetArchiveTest, WriteAndReadTest)
+{
+    const Core::Uri smallUri("asset://Game/Small");
+    const Core::Uri largeUri("asset://Game/Large");
+    const Core::Uri noiseUri("asset://Game/Noise");
+    const Core::Uri emptyUri("asset://Game/Empty");
+    const auto small = MakeBytes(1000, true);
+    const auto large = MakeBytes(Runtime::Internal::assetArchiveChunkSize * 3 + 123, true);
+    const auto noise = MakeBytes(Runtime::Internal::assetArchiveChunkSize + 7, false);
+    {
+        AssetArchiveWriter writer(file);
+        writer.Add(smallUri, small);
+        writer.Add(largeUri, large);
+        writer.Add(noiseUri, noise);
+        writer.Add(emptyUri, {});
+    }
+    // compressible assets must not be stored as is
+    ASSERT_LT(std::filesystem::file_size(file.String()), small.size() + large.size() + noise.size());
+
+    const AssetArchive archive(file);
+    ASSERT_TRUE(archive.IsValid());
+    ASSERT_EQ(archive.AssetNum(), 4);
+    ASSERT_FALSE(archive.Contains(Core::Uri("asset://Game/Missing")));
+    ASSERT_FALSE(archive.Read(Core::Uri("asset://Game/Missing")).has_value());
+    ASSERT_EQ(archive.Read(smallUri), small);
+    ASSERT_EQ(archive.Read(largeUri), large);
+    ASSERT_EQ(archive.Read(noiseUri), noise);
+    ASSERT_EQ(archive.Read(emptyUri), std::vector<uint8_t>());
+}
+
+TEST_F(AssetArchiveTest, InvalidArchiveTest)
+{
+    ASSERT_FALSE(AssetArchive(file).IsValid());
+    {
+        Common::BinaryFileSerializeStream stream(file.String());
+        Common::Serialize(stream, std::string("not an asset archive"));
+    }
+    ASSERT_FALSE(AssetArchive(file).IsValid());
+    ASSERT_FALSE(AssetManager::Get().MountArchive(file));
+}
+
+TEST_F(AssetArchiveTest, MountTest)
+{
+    static Core::Uri uri("asset://Engine/Test/Generated/Runtime/AssetArchiveTest.MountTest");
+    {
+        AssetPtr<TestAsset> asset = MakeShared<TestAsset>(uri, 5, "packed");
+        AssetManager::Get().Save(asset);
+
+        AssetArchiveWriter writer(file);
+        ASSERT_TRUE(writer.AddFile(uri));
+    }
+    // the archive is the only copy left
+    std::filesystem::remove(Core::AssetUriParser(uri).Parse().Absolute().String());
+
+    ASSERT_TRUE(AssetManager::Get().MountArchive(file));
+    AssetPtr<TestAsset> restore = AssetManager::Get().SyncLoad<TestAsset>(uri, TestAsset::GetStaticClass());
+    ASSERT_TRUE(restore.Valid());
+    ASSERT_EQ(restore->a, 5);
+    ASSERT_EQ(restore->b, "packed");
+}
@@ -2,9 +2,14 @@
 // Created by johnk on 2023/10/16.
 //
 
+#include <atomic>
+
 #include <Test/Test.h>
 
 #include <AssetTest.h>
+#include <Core/Console.h>
+#include <Runtime/Engine.h>
+#include <Runtime/Asset/Texture.h>
 
 TEST(AssetTest, AssetRefTest0)
 {
@@ -71,12 +76,112 @@ TEST(AssetTest, AsyncLoadTest)
 
     AssetPtr<TestAsset> asset = MakeShared<TestAsset>(uri, 1, "hello");
     AssetManager::Get().Save(asset);
+    asset.Reset();
 
-    AssetManager::Get().AsyncLoad<TestAsset>(uri, TestAsset::GetStaticClass(), [&](AssetPtr<TestAsset> restore) -> void {
+    std::atomic<uint32_t> loadedCount = 0;
+    const AssetLoadHandle handle = AssetManager::Get().AsyncLoad<TestAsset>(uri, TestAsset::GetStaticClass(), [&](AssetPtr<TestAsset> restore) -> void {
         ASSERT_EQ(restore.Uri(), uri);
         ASSERT_EQ(restore->a, 1);
         ASSERT_EQ(restore->b, "hello");
+        loadedCount++;
+    });
+    handle.Wait();
+    ASSERT_TRUE(handle.Done());
+    ASSERT_EQ(loadedCount, 1);
+    ASSERT_EQ(handle.Get<TestAsset>()->b, "hello");
+}
+
+TEST(AssetTest, DependencyLoadTest)
+{
+    static Core::Uri childUri("asset://Engine/Test/Generated/Runtime/AssetTest.DependencyLoadTest.Child");
+    static Core::Uri parentUri("asset://Engine/Test/Generated/Runtime/AssetTest.DependencyLoadTest.Parent");
+    {
+        AssetPtr<TestAsset> child = MakeShared<TestAsset>(childUri, 2, "child");
+        AssetPtr<TestDependentAsset> parent = MakeShared<TestDependentAsset>(parentUri, child);
+        AssetManager::Get().Save(child);
+        AssetManager::Get().Save(parent);
+    }
+
+    const AssetLoadHandle handle = AssetManager::Get().AsyncLoad<TestDependentAsset>(parentUri, TestDependentAsset::GetStaticClass(), {}, AssetLoadPriority::prefetch);
+    handle.SetPriority(AssetLoadPriority::visible);
+    handle.Wait();
+
+    AssetPtr<TestDependentAsset> parent = handle.Get<TestDependentAsset>();
+    ASSERT_TRUE(parent.Valid());
+    ASSERT_EQ(parent->child.Uri(), childUri);
+    ASSERT_EQ(parent->child->a, 2);
+    ASSERT_EQ(parent->child->b, "child");
+
+    AssetPtr<TestAsset> child = AssetManager::Get().SyncLoad<TestAsset>(childUri, TestAsset::GetStaticClass());
+    ASSERT_EQ(child.Get(), parent->child.Get());
+}
+
+TEST(AssetTest, DeduplicateLoadTest)
+{
+    static Core::Uri uri("asset://Engine/Test/Generated/Runtime/AssetTest.DeduplicateLoadTest");
+    {
+        AssetPtr<TestAsset> asset = MakeShared<TestAsset>(uri, 3, "shared");
+        AssetManager::Get().Save(asset);
+    }
+
+    const AssetLoadHandle handle0 = AssetManager::Get().AsyncLoad<TestAsset>(uri, TestAsset::GetStaticClass(), {}, AssetLoadPriority::prefetch);
+    const AssetLoadHandle handle1 = AssetManager::Get().AsyncLoad<TestAsset>(uri, TestAsset::GetStaticClass());
+    handle0.Wait();
+    handle1.Wait();
+    ASSERT_TRUE(handle0.Get().Valid());
+    ASSERT_EQ(handle0.Get().Get(), handle1.Get().Get());
+}
+
+TEST(AssetTest, CancelLoadTest)
+{
+    static Core::Uri uri("asset://Engine/Test/Generated/Runtime/AssetTest.CancelLoadTest");
+    {
+        AssetPtr<TestAsset> asset = MakeShared<TestAsset>(uri, 4, "cancel");
+        AssetManager::Get().Save(asset);
+    }
+
+    AssetLoadHandle handle = AssetManager::Get().AsyncLoad<TestAsset>(uri, TestAsset::GetStaticClass(), {}, AssetLoadPriority::prefetch);
+    handle.Reset();
+    ASSERT_FALSE(handle.Valid());
+
+    // a dropped load must not keep a later load of the same asset from completing
+    AssetPtr<TestAsset> restore = AssetManager::Get().SyncLoad<TestAsset>(uri, TestAsset::GetStaticClass());
+    ASSERT_EQ(restore->a, 4);
+    ASSERT_EQ(restore->b, "cancel");
+}
+
+TEST(AssetTest, MissingAssetLoadTest)
+{
+    static Core::Uri uri("asset://Engine/Test/Generated/Runtime/AssetTest.MissingAssetLoadTest");
+
+    bool called = false;
+    const AssetLoadHandle handle = AssetManager::Get().AsyncLoad<TestAsset>(uri, TestAsset::GetStaticClass(), [&](AssetPtr<TestAsset> restore) -> void {
+        ASSERT_FALSE(restore.Valid());
+        called = true;
     });
+    handle.Wait();
+    ASSERT_TRUE(called);
+    ASSERT_FALSE(handle.Get().Valid());
+}
+
+TEST(AssetTest, CyclicDependencyLoadTest)
+{
+    static Core::Uri uriA("asset://Engine/Test/Generated/Runtime/AssetTest.CyclicDependencyLoadTest.A");
+    static Core::Uri uriB("asset://Engine/Test/Generated/Runtime/AssetTest.CyclicDependencyLoadTest.B");
+    {
+        AssetPtr<TestCyclicAsset> a = MakeShared<TestCyclicAsset>(uriA);
+        AssetPtr<TestCyclicAsset> b = MakeShared<TestCyclicAsset>(uriB);
+        a->other = b.StaticCast<Asset>();
+        b->other = a.StaticCast<Asset>();
+        AssetManager::Get().Save(a);
+        AssetManager::Get().Save(b);
+        a->other.Reset();
+    }
+
+    // a cycle can not be loaded, it fails instead of waiting on itself forever
+    AssetPtr<TestCyclicAsset> restore = AssetManager::Get().SyncLoad<TestCyclicAsset>(uriA, TestCyclicAsset::GetStaticClass());
+    ASSERT_FALSE(restore.Valid());
+    ASSERT_EQ(AssetManager::Get().InFlightCount(), 0);
 }
 
 TEST(AssetTest, PolySaveLoadTest)
@@ -92,3 +197,58 @@ TEST(AssetTest, PolySaveLoadTest)
     ASSERT_EQ(result->a, 1);
     ASSERT_EQ(result->b, "hello");
 }
+
+struct TextureAssetTest : testing::Test {
+    void SetUp() override
+    {
+        EngineInitParams engineInitParams {};
+        engineInitParams.rhiType = RHI::GetAbbrStringByType(RHI::RHIType::dummy);
+        EngineHolder::Load("RuntimeTest", engineInitParams);
+    }
+
+    void TearDown() override
+    {
+        EngineHolder::Unload();
+    }
+};
+
+TEST_F(TextureAssetTest, LoadSaveLoadTest)
+{
+    static Core::Uri uri("asset://Engine/Test/Generated/Runtime/AssetTest.TextureLoadSaveLoadTest");
+    {
+        AssetPtr<Texture> texture = MakeShared<Texture>(uri);
+        texture->SetType(TextureType::t2D);
+        texture->SetFormat(TextureFormat::rgba8Unorm);
+        texture->SetWidth(2);
+        texture->SetHeight(2);
+        texture->SetMipLevels(2);
+        texture->UpdateMips();
+        texture->GetSubResourcePixels(0, 0) = std::vector<uint8_t>(16, 1);
+        texture->GetSubResourcePixels(1, 0) = std::vector<uint8_t>(4, 2);
+        AssetManager::Get().Save(texture);
+    }
+
+    // outside the editor a loaded texture moves its pixels into the upload by default
+    {
+        AssetPtr<Texture> loaded = AssetManager::Get().SyncLoad<Texture>(uri, Texture::GetStaticClass());
+        ASSERT_FALSE(loaded->HasPixels());
+        ASSERT_EQ(loaded->GetWidth(), 2);
+    }
+
+    // callers that save loaded textures again ask to keep the pixels
+    auto& keepPixels = Core::Console::Get().GetSettingValue<bool>("asset.texture.keepPixels");
+    keepPixels.Set(true);
+    {
+        AssetPtr<Texture> loaded = AssetManager::Get().SyncLoad<Texture>(uri, Texture::GetStaticClass());
+        ASSERT_TRUE(loaded->HasPixels());
+        ASSERT_EQ(loaded->GetSubResourcePixels(0, 0), std::vector<uint8_t>(16, 1));
+        AssetManager::Get().Save(loaded);
+    }
+
+    AssetPtr<Texture> reloaded = AssetManager::Get().SyncLoad<Texture>(uri, Texture::GetStaticClass());
+    ASSERT_TRUE(reloaded->HasPixels());
+    ASSERT_EQ(reloaded->GetWidth(), 2);
+    ASSERT_EQ(reloaded->GetSubResourcePixels(0, 0), std::vector<uint8_t>(16, 1));
+    ASSERT_EQ(reloaded->GetSubResourcePixels(1, 0), std::vector<uint8_t>(4, 2));
+    keepPixels.Set(false);
+}
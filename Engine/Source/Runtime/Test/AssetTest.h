@@ -32,3 +32,36 @@ struct EClass() TestAsset : public Asset {
     EProperty()
     std::string b;
 };
+
+struct EClass() TestDependentAsset : public Asset {
+    EPolyDerivedClassBody(TestDependentAsset)
+
+    explicit TestDependentAsset(Core::Uri uri)
+        : Asset(std::move(uri))
+        , child()
+    {
+    }
+
+    TestDependentAsset(Core::Uri inUri, AssetPtr<TestAsset> inChild)
+        : Asset(std::move(inUri))
+        , child(std::move(inChild))
+    {
+    }
+
+    EProperty()
+    AssetPtr<TestAsset> child;
+};
+
+struct EClass() TestCyclicAsset : public Asset {
+    EPolyDerivedClassBody(TestCyclicAsset)
+
+    explicit TestCyclicAsset(Core::Uri uri)
+        : Asset(std::move(uri))
+        , other()
+    {
+    }
+
+    // the asset class is incomplete here, so the reference is held as a plain asset
+    EProperty()
+    AssetPtr<Asset> other;
+};
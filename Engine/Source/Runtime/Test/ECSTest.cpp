@@ -5,6 +5,9 @@
 #include <ECSTest.h>
 #include <Test/Test.h>
 
+#include <atomic>
+#include <functional>
+#include <string>
 #include <utility>
 
 uint32_t LifetimeComp::instanceCount = 0;
@@ -270,6 +273,148 @@ TEST(ECSTest, ViewArchetypeGrowthTest)
     ASSERT_EQ(runtimeSum, 2080);
 }
 
+TEST(ECSTest, ViewQueryCacheTest)
+{
+    ECRegistry registry;
+    const auto entity0 = registry.Create();
+    registry.Emplace<CompA>(entity0, 1);
+    ASSERT_EQ(registry.View<CompA>().Count(), 1);
+    ASSERT_EQ(registry.View<CompA>(Exclude<CompB> {}).Count(), 1);
+    ASSERT_EQ(registry.RuntimeView(RuntimeFilter().Include<CompA>().Include<CompB>()).Count(), 0);
+
+    // archetypes created after the queries are matched against them
+    const auto entity1 = registry.Create();
+    registry.Emplace<CompA>(entity1, 2);
+    registry.Emplace<CompB>(entity1, 3.0f);
+    const auto entity2 = registry.Create();
+    registry.Emplace<CompA>(entity2, 4);
+    registry.AddTag<TestTag>(entity2);
+
+    ASSERT_EQ(registry.View<CompA>().Count(), 3);
+    ASSERT_EQ(registry.View<CompA>(Exclude<CompB> {}).Count(), 2);
+    ASSERT_EQ(registry.View<CompA>(Tags<TestTag> {}).Count(), 1);
+    ASSERT_EQ(std::as_const(registry).View<CompA>(Exclude<TestTag> {}).Count(), 2);
+
+    float sum = 0;
+    registry.RuntimeView(RuntimeFilter().Include<CompB>().Include<CompA>()).Each([&](Entity, const CompA& compA, const CompB& compB) -> void {
+        sum += static_cast<float>(compA.value) + compB.value;
+    });
+    ASSERT_EQ(sum, 5.0f);
+    ASSERT_EQ(registry.RuntimeView(RuntimeFilter().Include<CompA>().ExcludeTag<TestTag>()).Count(), 2);
+
+    ECRegistry copy;
+    ASSERT_EQ(copy.View<CompA>().Count(), 0);
+    copy = registry;
+    ASSERT_EQ(copy.View<CompA>().Count(), 3);
+    copy.Destroy(entity0);
+    ASSERT_EQ(copy.View<CompA>().Count(), 2);
+    ASSERT_EQ(registry.View<CompA>().Count(), 3);
+
+    registry.Clear();
+    ASSERT_EQ(registry.View<CompA>().Count(), 0);
+    const auto entity3 = registry.Create();
+    registry.Emplace<CompA>(entity3, 5);
+    registry.Emplace<CompB>(entity3, 6.0f);
+    ASSERT_EQ(registry.View<CompA>().Count(), 1);
+    ASSERT_EQ(registry.View<CompA>(Exclude<CompB> {}).Count(), 0);
+}
+
+TEST(ECSTest, ParallelEachTest)
+{
+    ECRegistry registry;
+    for (int32_t value = 0; value < 10000; value++) {
+        const auto entity = registry.Create();
+        registry.Emplace<CompA>(entity, value);
+        if (value % 2 == 0) {
+            registry.Emplace<CompB>(entity, static_cast<float>(value) * 0.1f);
+        }
+    }
+
+    const auto view = registry.View<CompA>();
+    view.ParallelEach([](Entity, CompA& comp) -> void { comp.value *= 2; }, 64);
+    int64_t sum = 0;
+    view.Each([&](Entity, const CompA& comp) -> void { sum += comp.value; });
+    ASSERT_EQ(sum, 99990000);
+
+    std::atomic<uint32_t> entityCount = 0;
+    view.ParallelEach([&](Entity) -> void { ++entityCount; }, 64);
+    ASSERT_EQ(entityCount, 10000);
+
+    const auto add = [](int64_t lhs, int64_t rhs) -> int64_t { return lhs + rhs; };
+    ASSERT_EQ(view.ParallelEach(int64_t { 0 }, [](int64_t& partial, Entity, const CompA& comp) -> void { partial += comp.value; }, add, 64), 99990000);
+
+    const auto runtimeView = registry.RuntimeView(RuntimeFilter().Include<CompA>().Include<CompB>());
+    ASSERT_EQ(runtimeView.ParallelEach(int64_t { 0 }, [](int64_t& count, Entity) -> void { count++; }, add, 64), 5000);
+    ASSERT_EQ(runtimeView.ParallelEach(int64_t { 0 }, [](int64_t& partial, Entity, const CompB&, const CompA& comp) -> void { partial += comp.value; }, add, 64), 49990000);
+
+    // partial sums are reduced in range order, float results do not depend on the number of threads
+    const auto floatSum = [&](size_t inMaxConcurrency) -> float {
+        return runtimeView.ParallelEach(0.0f, [](float& partial, Entity, const CompB& comp) -> void { partial += comp.value; }, std::plus<float>(), 64, inMaxConcurrency);
+    };
+    const float serialSum = floatSum(1);
+    for (auto i = 0; i < 8; i++) {
+        ASSERT_EQ(floatSum(0), serialSum);
+    }
+}
+
+TEST(ECSTest, ChunkStorageTest)
+{
+    const auto& chunkPool = Internal::ArchetypeChunkPool::Get();
+    const auto lifetimeCount = LifetimeComp::instanceCount;
+    size_t allocatedChunkNum;
+    {
+        ECRegistry registry;
+        std::vector<Entity> entities;
+        for (int32_t value = 0; value < 5000; value++) {
+            const auto entity = registry.Create();
+            registry.Emplace<CompA>(entity, value);
+            registry.Emplace<LifetimeComp>(entity, std::to_string(value));
+            entities.emplace_back(entity);
+        }
+
+        // growth appends chunks without moving the rows already stored
+        const auto* firstComp = &registry.Get<CompA>(entities[0]);
+        for (int32_t value = 5000; value < 10000; value++) {
+            const auto entity = registry.Create();
+            registry.Emplace<CompA>(entity, value);
+            registry.Emplace<LifetimeComp>(entity, std::to_string(value));
+            entities.emplace_back(entity);
+        }
+        ASSERT_EQ(&registry.Get<CompA>(entities[0]), firstComp);
+        ASSERT_EQ(LifetimeComp::instanceCount, lifetimeCount + 10000);
+
+        for (size_t i = 0; i < entities.size(); i += 3) {
+            registry.Destroy(entities[i]);
+        }
+        for (size_t i = 0; i < entities.size(); i++) {
+            if (i % 3 == 0) {
+                continue;
+            }
+            ASSERT_EQ(registry.Get<CompA>(entities[i]).value, static_cast<int32_t>(i));
+            ASSERT_EQ(registry.Get<LifetimeComp>(entities[i]).value, std::to_string(i));
+        }
+
+        const ECRegistry copy = registry;
+        int64_t sum = 0;
+        copy.View<const CompA, const LifetimeComp>().Each([&](Entity, const CompA& compA, const LifetimeComp& lifetimeComp) -> void {
+            ASSERT_EQ(std::to_string(compA.value), lifetimeComp.value);
+            sum += compA.value;
+        });
+        ASSERT_EQ(sum, 33326667);
+        allocatedChunkNum = chunkPool->AllocatedCount();
+    }
+    ASSERT_EQ(LifetimeComp::instanceCount, lifetimeCount);
+
+    // chunks released by the destroyed registry are reused instead of allocated again
+    {
+        ECRegistry registry;
+        for (int32_t value = 0; value < 10000; value++) {
+            registry.Emplace<CompA>(registry.Create(), value);
+        }
+        ASSERT_EQ(chunkPool->AllocatedCount(), allocatedChunkNum);
+    }
+}
+
 TEST(ECSTest, ComponentLifetimeTest)
 {
     const auto baselineInstanceCount = LifetimeComp::instanceCount;
@@ -790,3 +935,282 @@ TEST(ECSTest, ECSRegistrySaveLoadTest)
         ASSERT_EQ(registry.GCompCount(), 2);
     }
 }
+
+TEST(ECSTest, CommandBufferTest)
+{
+    ECRegistry registry;
+    const auto entity0 = registry.Create();
+    const auto entity1 = registry.Create();
+    const auto entity2 = registry.Create();
+    registry.Emplace<CompA>(entity0, 1);
+    registry.Emplace<CompA>(entity1, 2);
+    registry.AddTag<TestTag>(entity1);
+
+    ECCommandBuffer commands(registry);
+    const auto temp0 = commands.Create();
+    const auto temp1 = commands.Create();
+    ASSERT_TRUE(ECCommandBuffer::IsTemporary(temp0));
+    ASSERT_FALSE(ECCommandBuffer::IsTemporary(entity0));
+    commands.Emplace<CompA>(temp0, 3);
+    commands.Emplace<CompB>(temp0, 4.0f);
+    commands.AddTag<TestTag>(temp1);
+    commands.Emplace<CompB>(entity0, 5.0f);
+    commands.Remove<CompA>(entity0);
+    commands.Remove<CompA>(entity1);
+    commands.Emplace<CompA>(entity1, 6);
+    commands.RemoveTag<TestTag>(entity1);
+    commands.Destroy(entity2);
+    ASSERT_EQ(commands.Count(), 11);
+    ASSERT_EQ(registry.Count(), 3);
+    ASSERT_EQ(registry.Get<CompA>(entity0).value, 1);
+
+    commands.Playback();
+    ASSERT_TRUE(commands.Empty());
+    ASSERT_EQ(registry.Count(), 4);
+    ASSERT_FALSE(registry.Valid(entity2));
+
+    const auto entity3 = commands.Resolve(temp0);
+    const auto entity4 = commands.Resolve(temp1);
+    ASSERT_EQ(commands.Resolve(entity0), entity0);
+    ASSERT_TRUE(registry.Valid(entity3) && registry.Valid(entity4));
+    ASSERT_EQ(registry.Get<CompA>(entity3).value, 3);
+    ASSERT_EQ(registry.Get<CompB>(entity3).value, 4.0f);
+    ASSERT_TRUE(registry.HasTag<TestTag>(entity4));
+    ASSERT_EQ(registry.CompCount(entity4), 0);
+    ASSERT_FALSE(registry.Has<CompA>(entity0));
+    ASSERT_EQ(registry.Get<CompB>(entity0).value, 5.0f);
+    ASSERT_EQ(registry.Get<CompA>(entity1).value, 6);
+    ASSERT_FALSE(registry.HasTag<TestTag>(entity1));
+
+    // temporaries recorded after a playback keep resolving until the buffer is cleared
+    const auto temp2 = commands.Create();
+    commands.EmplaceDyn(&Mirror::Class::Get<CompA>(), temp2, Mirror::ForwardAsArgList(7));
+    commands.Remove<CompB>(entity3);
+    commands.Playback();
+    ASSERT_EQ(commands.Resolve(temp0), entity3);
+    ASSERT_EQ(registry.Get<CompA>(commands.Resolve(temp2)).value, 7);
+    ASSERT_FALSE(registry.Has<CompB>(entity3));
+    commands.Clear();
+}
+
+TEST(ECSTest, CommandBufferBatchTest)
+{
+    const auto baselineInstanceCount = LifetimeComp::instanceCount;
+    {
+        ECRegistry registry;
+        ECCommandBuffer commands(registry);
+        std::vector<Entity> entities;
+        for (auto i = 0; i < 1000; i++) {
+            const auto entity = commands.Create();
+            commands.Emplace<CompA>(entity, i);
+            commands.Emplace<LifetimeComp>(entity, std::to_string(i));
+            if (i % 2 == 0) {
+                commands.AddTag<TestTag>(entity);
+            }
+            // never reaches the registry
+            if (i % 3 == 0) {
+                commands.Emplace<CompB>(entity, 1.0f);
+                commands.Remove<CompB>(entity);
+            }
+            entities.emplace_back(entity);
+        }
+        ASSERT_EQ(LifetimeComp::instanceCount, baselineInstanceCount + 1000);
+
+        commands.Playback();
+        ASSERT_EQ(LifetimeComp::instanceCount, baselineInstanceCount + 1000);
+        ASSERT_EQ((registry.View<CompA, LifetimeComp>().Count()), 1000);
+        ASSERT_EQ(registry.View<CompA>(Tags<TestTag> {}).Count(), 500);
+        ASSERT_EQ(registry.View<CompB>().Count(), 0);
+        for (auto i = 0; i < 1000; i++) {
+            const auto entity = commands.Resolve(entities[i]);
+            // entities are created in recording order
+            if (i > 0) {
+                ASSERT_GT(entity, commands.Resolve(entities[i - 1]));
+            }
+            ASSERT_EQ(registry.Get<CompA>(entity).value, i);
+            ASSERT_EQ(registry.Get<LifetimeComp>(entity).value, std::to_string(i));
+        }
+
+        for (auto i = 0; i < 1000; i += 2) {
+            commands.Remove<LifetimeComp>(commands.Resolve(entities[i]));
+        }
+        // recorded values are destructed with the buffer if they were never played back
+        commands.Emplace<LifetimeComp>(commands.Resolve(entities[0]), "dropped");
+        commands.Clear();
+        ASSERT_EQ(LifetimeComp::instanceCount, baselineInstanceCount + 1000);
+    }
+    ASSERT_EQ(LifetimeComp::instanceCount, baselineInstanceCount);
+}
+
+TEST(ECSTest, CommandBufferEventTest)
+{
+    EventCounts countA;
+    EventCounts countTag;
+    ECRegistry registry;
+    const auto constructedCallbackA = registry.Events<CompA>().onConstructed.BindLambda([&](ECRegistry& inRegistry, Entity inEntity) -> void {
+        ASSERT_TRUE(inRegistry.Has<CompA>(inEntity));
+        countA.onConstructed++;
+    });
+    const auto removeCallbackA = registry.Events<CompA>().onRemove.BindLambda([&](ECRegistry& inRegistry, Entity inEntity) -> void {
+        ASSERT_TRUE(inRegistry.Has<CompA>(inEntity));
+        countA.onRemove++;
+    });
+    const auto constructedCallbackTag = registry.Events<TestTag>().onConstructed.BindLambda([&](ECRegistry&, Entity) -> void { countTag.onConstructed++; });
+    const auto removeCallbackTag = registry.Events<TestTag>().onRemove.BindLambda([&](ECRegistry&, Entity) -> void { countTag.onRemove++; });
+
+    const auto entity0 = registry.Create();
+    registry.Emplace<CompA>(entity0, 1);
+    countA = EventCounts();
+
+    ECCommandBuffer commands(registry);
+    const auto entity1 = commands.Create();
+    commands.Emplace<CompA>(entity1, 2);
+    commands.AddTag<TestTag>(entity1);
+    commands.Remove<CompA>(entity0);
+    commands.Emplace<CompA>(entity0, 3);
+    ASSERT_EQ(countA, EventCounts(0, 0, 0));
+
+    commands.Playback();
+    ASSERT_EQ(countA, EventCounts(2, 0, 1));
+    ASSERT_EQ(countTag, EventCounts(1, 0, 0));
+    ASSERT_EQ(registry.Get<CompA>(entity0).value, 3);
+
+    commands.Destroy(commands.Resolve(entity1));
+    commands.Playback();
+    ASSERT_EQ(countA, EventCounts(2, 0, 2));
+    ASSERT_EQ(countTag, EventCounts(1, 0, 1));
+
+    registry.Events<CompA>().onConstructed.Unbind(constructedCallbackA);
+    registry.Events<CompA>().onRemove.Unbind(removeCallbackA);
+    registry.Events<TestTag>().onConstructed.Unbind(constructedCallbackTag);
+    registry.Events<TestTag>().onRemove.Unbind(removeCallbackTag);
+}
+
+TEST(ECSTest, CommandBufferInvalidEntityTest)
+{
+    const auto baselineInstanceCount = LifetimeComp::instanceCount;
+    ECRegistry registry;
+    const auto entity0 = registry.Create();
+    const auto entity1 = registry.Create();
+    registry.Emplace<CompA>(entity1, 1);
+
+    // both buffers destroy entity0, the one played back last skips it like every other command on it
+    ECCommandBuffer commands0(registry);
+    ECCommandBuffer commands1(registry);
+    commands0.Destroy(entity0);
+    commands1.Destroy(entity0);
+    commands1.Emplace<LifetimeComp>(entity0, "dropped");
+    commands1.Destroy(entity1);
+    commands1.Remove<CompA>(entity1);
+    commands0.Playback();
+    ASSERT_FALSE(registry.Valid(entity0));
+    commands1.Playback();
+    ASSERT_FALSE(registry.Valid(entity1));
+    ASSERT_EQ(registry.Count(), 0);
+    ASSERT_EQ(LifetimeComp::instanceCount, baselineInstanceCount);
+
+    // temporary ids are only reused once every one of them is resolved
+    const auto temp0 = commands0.Create();
+    commands0.ResetTemporaries();
+    commands0.Playback();
+    const auto entity2 = commands0.Resolve(temp0);
+    ASSERT_TRUE(registry.Valid(entity2));
+    commands0.ResetTemporaries();
+    ASSERT_EQ(commands0.Create(), temp0);
+    ASSERT_EQ(commands0.Count(), 1);
+    commands0.Playback();
+    ASSERT_NE(commands0.Resolve(temp0), entity2);
+    ASSERT_EQ(registry.Count(), 2);
+}
+
+TEST(ECSTest, SystemAccessTest)
+{
+    const auto access = Internal::SystemAccess::FromClass(&AccessTestSystem::GetStaticClass());
+    ASSERT_FALSE(access.IsExclusive());
+    ASSERT_TRUE(access.CanRead(&CompA::GetStaticClass()));
+    ASSERT_FALSE(access.CanWrite(&CompA::GetStaticClass()));
+    ASSERT_TRUE(access.CanRead(&CompB::GetStaticClass()));
+    ASSERT_TRUE(access.CanWrite(&CompB::GetStaticClass()));
+    ASSERT_TRUE(access.CanWrite(&GCompA::GetStaticClass()));
+    ASSERT_FALSE(access.CanRead(&GCompB::GetStaticClass()));
+    ASSERT_TRUE(Internal::SystemAccess::FromClass(&System::GetStaticClass()).IsExclusive());
+
+    const auto readA = Internal::SystemAccess().Read<CompA>();
+    const auto writeA = Internal::SystemAccess().Write<CompA>();
+    ASSERT_FALSE(readA.ConflictsWith(readA));
+    ASSERT_TRUE(readA.ConflictsWith(writeA));
+    ASSERT_TRUE(writeA.ConflictsWith(readA));
+    ASSERT_TRUE(writeA.ConflictsWith(writeA));
+    ASSERT_FALSE(access.ConflictsWith(Internal::SystemAccess().Read<CompA>().Write<GCompB>()));
+    ASSERT_TRUE(access.ConflictsWith(Internal::SystemAccess().Read<CompB>()));
+    ASSERT_TRUE(Internal::SystemAccess::Exclusive().ConflictsWith(Internal::SystemAccess()));
+}
+
+TEST(ECSTest, SystemAccessScopeTest)
+{
+    ECRegistry registry;
+    const auto entity = registry.Create();
+    registry.Emplace<CompA>(entity, 1);
+    registry.Emplace<CompB>(entity, 2.0f);
+    registry.GEmplace<GCompA>(3);
+
+    const auto access = Internal::SystemAccess().Read<CompA>().Write<CompB, GCompA>();
+    ASSERT_EQ(Internal::SystemAccessScope::Current(), nullptr);
+    {
+        const Internal::SystemAccessScope scope(access);
+        ASSERT_EQ(Internal::SystemAccessScope::Current(), &access);
+
+        // declared accesses pass the checks of debug builds
+        float sum = 0.0f;
+        registry.View<const CompA, CompB>().Each([&](Entity, const CompA& compA, CompB& compB) -> void {
+            compB.value += 1.0f;
+            sum += static_cast<float>(compA.value) + compB.value;
+        });
+        ASSERT_EQ(sum, 4.0f);
+        ASSERT_EQ(std::as_const(registry).Get<CompA>(entity).value, 1);
+        registry.Get<CompB>(entity).value = 4.0f;
+        registry.GGet<GCompA>().value = 5;
+
+        {
+            const auto exclusive = Internal::SystemAccess::Exclusive();
+            const Internal::SystemAccessScope nestedScope(exclusive);
+            ASSERT_EQ(Internal::SystemAccessScope::Current(), &exclusive);
+        }
+        ASSERT_EQ(Internal::SystemAccessScope::Current(), &access);
+    }
+    ASSERT_EQ(Internal::SystemAccessScope::Current(), nullptr);
+    ASSERT_EQ(registry.Get<CompB>(entity).value, 4.0f);
+}
+
+TEST(ECSTest, ParallelEachAccessScopeTest)
+{
+    ECRegistry registry;
+    for (int32_t value = 0; value < 1000; value++) {
+        const auto entity = registry.Create();
+        registry.Emplace<CompA>(entity, value);
+        registry.Emplace<CompB>(entity, 0.0f);
+    }
+
+    // ranges run on other threads carry the access of the system that started the loop
+    std::atomic<uint32_t> mismatchCount = 0;
+    const auto access = Internal::SystemAccess().Read<CompA>().Write<CompB>();
+    {
+        const Internal::SystemAccessScope scope(access);
+        registry.View<const CompA, CompB>().ParallelEach([&](Entity, const CompA& compA, CompB& compB) -> void {
+            mismatchCount += Internal::SystemAccessScope::Current() == &access ? 0 : 1;
+            compB.value = static_cast<float>(compA.value);
+        }, 16);
+        const auto add = [](int64_t lhs, int64_t rhs) -> int64_t { return lhs + rhs; };
+        const auto sum = registry.RuntimeView(RuntimeFilter().Include<CompA>()).ParallelEach(int64_t { 0 }, [&](int64_t& partial, Entity, const CompA& comp) -> void {
+            mismatchCount += Internal::SystemAccessScope::Current() == &access ? 0 : 1;
+            partial += comp.value;
+        }, add, 16);
+        ASSERT_EQ(sum, 499500);
+    }
+    ASSERT_EQ(mismatchCount, 0);
+
+    registry.View<const CompB>().ParallelEach([&](Entity, const CompB&) -> void {
+        mismatchCount += Internal::SystemAccessScope::Current() == nullptr ? 0 : 1;
+    }, 16);
+    ASSERT_EQ(mismatchCount, 0);
+}
@@ -98,6 +98,16 @@ struct EClass(globalComp) GCompB {
     EProperty() float value;
 };
 
+class EClass(reads=CompA, writes=CompB|GCompA) AccessTestSystem : public System {
+    EPolyDerivedClassBody(AccessTestSystem)
+
+public:
+    AccessTestSystem(ECRegistry& inRegistry, const SystemSetupContext& inContext)
+        : System(inRegistry, inContext)
+    {
+    }
+};
+
 struct EventCounts {
     uint32_t onConstructed;
     uint32_t onUpdated;
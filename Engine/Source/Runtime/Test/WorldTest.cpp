@@ -2,8 +2,13 @@
 // Created by johnk on 2024/12/25.
 //
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include <WorldTest.h>
 #include <Test/Test.h>
+#include <Core/JobSystem.h>
 #include <Runtime/World.h>
 #include <Runtime/Engine.h>
 using namespace Runtime;
@@ -197,3 +202,220 @@ TEST_F(WorldTest, ConcurrentTest)
     }
     world.Stop();
 }
+
+CommandsTest_SpawnSystemA::CommandsTest_SpawnSystemA(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+{
+}
+
+CommandsTest_SpawnSystemA::~CommandsTest_SpawnSystemA() = default;
+
+void CommandsTest_SpawnSystemA::Tick(float inDeltaTimeSeconds)
+{
+    const auto entity = Commands().Create();
+    Commands().Emplace<Position>(entity, 1.0f, 0.0f);
+}
+
+CommandsTest_SpawnSystemB::CommandsTest_SpawnSystemB(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+{
+}
+
+CommandsTest_SpawnSystemB::~CommandsTest_SpawnSystemB() = default;
+
+void CommandsTest_SpawnSystemB::Tick(float inDeltaTimeSeconds)
+{
+    const auto entity = Commands().Create();
+    Commands().Emplace<Position>(entity, 2.0f, 0.0f);
+    Commands().Emplace<Velocity>(entity, 0.0f, 1.0f);
+}
+
+CommandsTest_VerifySystem::CommandsTest_VerifySystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+{
+    registry.GEmplace<GCommandsTest_Context>().tickCount = 0;
+}
+
+CommandsTest_VerifySystem::~CommandsTest_VerifySystem() = default;
+
+void CommandsTest_VerifySystem::Tick(float inDeltaTimeSeconds)
+{
+    auto& context = registry.GGet<GCommandsTest_Context>();
+    context.tickCount++;
+
+    // commands of the concurrent spawners are played back at the barrier of their group, before this group runs
+    std::vector<float> xs;
+    registry.View<Position>().Each([&](Entity, const Position& position) -> void { xs.emplace_back(position.x); });
+    ASSERT_EQ(xs.size(), 2 * context.tickCount);
+    ASSERT_EQ(registry.View<Velocity>().Count(), context.tickCount);
+    ASSERT_EQ(std::ranges::count(xs, 1.0f), context.tickCount);
+}
+
+TEST_F(WorldTest, CommandsTest)
+{
+    SystemGraph systemGraph;
+    auto& spawnGroup = systemGraph.AddGroup("SpawnGroup", SystemExecuteStrategy::concurrent);
+    spawnGroup.EmplaceSystem<CommandsTest_SpawnSystemA>();
+    spawnGroup.EmplaceSystem<CommandsTest_SpawnSystemB>();
+    auto& verifyGroup = systemGraph.AddGroup("VerifyGroup", SystemExecuteStrategy::sequential);
+    verifyGroup.EmplaceSystem<CommandsTest_VerifySystem>();
+
+    World world("TestWorld", nullptr, PlayType::game);
+    world.SetSystemGraph(systemGraph);
+    world.Play();
+    for (auto i = 0; i < 5; i++) {
+        engine->Tick(0.0167f);
+    }
+    world.Stop();
+}
+
+namespace {
+    constexpr uint32_t automaticTestEntityNum = 1024;
+    std::atomic<uint32_t> automaticTestRendezvousCount = 0;
+
+    // non-conflicting systems of an automatic group tick at the same time when the job system has workers to spare
+    void AutomaticTestRendezvous(uint32_t inTickCount)
+    {
+        automaticTestRendezvousCount++;
+        if (Core::JobSystem::Get().WorkerNum() < 2) {
+            return;
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (automaticTestRendezvousCount < inTickCount * 2) {
+            ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+            std::this_thread::yield();
+        }
+    }
+}
+
+AutomaticTest_MoveSystem::AutomaticTest_MoveSystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+{
+    for (uint32_t i = 0; i < automaticTestEntityNum; i++) {
+        const auto entity = registry.Create();
+        registry.Emplace<Position>(entity, 0.0f, static_cast<float>(i));
+        registry.Emplace<Velocity>(entity, 1.0f, 0.0f);
+    }
+}
+
+AutomaticTest_MoveSystem::~AutomaticTest_MoveSystem() = default;
+
+void AutomaticTest_MoveSystem::Tick(float inDeltaTimeSeconds)
+{
+    // ranges of the parallel loop are checked against the access of this system, whichever worker runs them
+    const auto* access = Internal::SystemAccessScope::Current();
+    ASSERT_NE(access, nullptr);
+    std::atomic<uint32_t> mismatchCount = 0;
+    registry.View<Position, const Velocity>().ParallelEach([&](Entity, Position& position, const Velocity& velocity) -> void {
+        mismatchCount += Internal::SystemAccessScope::Current() == access ? 0 : 1;
+        position.x += velocity.x;
+        position.y += velocity.y;
+    }, 64);
+    ASSERT_EQ(mismatchCount, 0);
+}
+
+AutomaticTest_RendezvousSystemA::AutomaticTest_RendezvousSystemA(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+    , tickCount(0)
+{
+}
+
+AutomaticTest_RendezvousSystemA::~AutomaticTest_RendezvousSystemA() = default;
+
+void AutomaticTest_RendezvousSystemA::Tick(float inDeltaTimeSeconds)
+{
+    AutomaticTestRendezvous(++tickCount);
+}
+
+AutomaticTest_RendezvousSystemB::AutomaticTest_RendezvousSystemB(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+    , tickCount(0)
+{
+}
+
+AutomaticTest_RendezvousSystemB::~AutomaticTest_RendezvousSystemB() = default;
+
+void AutomaticTest_RendezvousSystemB::Tick(float inDeltaTimeSeconds)
+{
+    AutomaticTestRendezvous(++tickCount);
+}
+
+AutomaticTest_SpawnSystem::AutomaticTest_SpawnSystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+    , firstTemporary(entityNull)
+{
+}
+
+AutomaticTest_SpawnSystem::~AutomaticTest_SpawnSystem() = default;
+
+void AutomaticTest_SpawnSystem::Tick(float inDeltaTimeSeconds)
+{
+    // temporary ids are reused every tick
+    const auto entity = Commands().Create();
+    if (firstTemporary == entityNull) {
+        firstTemporary = entity;
+    }
+    ASSERT_EQ(entity, firstTemporary);
+    Commands().Emplace<Position>(entity, -1.0f, 0.0f);
+}
+
+AutomaticTest_VerifySystem::AutomaticTest_VerifySystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+{
+    registry.GEmplace<GAutomaticTest_Context>().tickCount = 0;
+}
+
+AutomaticTest_VerifySystem::~AutomaticTest_VerifySystem() = default;
+
+void AutomaticTest_VerifySystem::Tick(float inDeltaTimeSeconds)
+{
+    auto& context = registry.GGet<GAutomaticTest_Context>();
+    context.tickCount++;
+
+    // reads positions after the move system that writes them, entities spawned in this tick wait for the barrier
+    const auto expectedX = static_cast<float>(context.tickCount);
+    uint32_t movedCount = 0;
+    registry.View<const Position, const Velocity>().Each([&](Entity, const Position& position, const Velocity&) -> void {
+        movedCount += Common::CompareNumber(position.x, expectedX) ? 1 : 0;
+    });
+    ASSERT_EQ(movedCount, automaticTestEntityNum);
+    ASSERT_EQ(registry.View<const Position>().Count(), automaticTestEntityNum + context.tickCount - 1);
+}
+
+AutomaticTest_BarrierVerifySystem::AutomaticTest_BarrierVerifySystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+{
+}
+
+AutomaticTest_BarrierVerifySystem::~AutomaticTest_BarrierVerifySystem() = default;
+
+void AutomaticTest_BarrierVerifySystem::Tick(float inDeltaTimeSeconds)
+{
+    const auto& context = registry.GGet<GAutomaticTest_Context>();
+    ASSERT_EQ(registry.View<Position>().Count(), automaticTestEntityNum + context.tickCount);
+    ASSERT_EQ(registry.View<Position>(Exclude<Velocity> {}).Count(), context.tickCount);
+}
+
+TEST_F(WorldTest, AutomaticTest)
+{
+    automaticTestRendezvousCount = 0;
+
+    SystemGraph systemGraph;
+    auto& automaticGroup = systemGraph.AddGroup("AutomaticGroup", SystemExecuteStrategy::automatic);
+    automaticGroup.EmplaceSystem<AutomaticTest_MoveSystem>();
+    automaticGroup.EmplaceSystem<AutomaticTest_RendezvousSystemA>();
+    automaticGroup.EmplaceSystem<AutomaticTest_RendezvousSystemB>();
+    automaticGroup.EmplaceSystem<AutomaticTest_SpawnSystem>();
+    automaticGroup.EmplaceSystem<AutomaticTest_VerifySystem>();
+    auto& verifyGroup = systemGraph.AddGroup("VerifyGroup", SystemExecuteStrategy::sequential);
+    verifyGroup.EmplaceSystem<AutomaticTest_BarrierVerifySystem>();
+
+    World world("TestWorld", nullptr, PlayType::game);
+    world.SetSystemGraph(systemGraph);
+    world.Play();
+    for (auto i = 0; i < 5; i++) {
+        engine->Tick(0.0167f);
+    }
+    world.Stop();
+    ASSERT_EQ(automaticTestRendezvousCount, 10);
+}
@@ -84,3 +84,105 @@ struct EClass() ConcurrentTest_VerifySystem : public Runtime::System {
 
     void Tick(float inDeltaTimeSeconds) override;
 };
+
+struct EClass(globalComp) GCommandsTest_Context {
+    EClassBody(GCommandsTest_Context)
+
+    uint32_t tickCount;
+};
+
+struct EClass() CommandsTest_SpawnSystemA : public Runtime::System {
+    EPolyDerivedClassBody(CommandsTest_SpawnSystemA)
+
+    explicit CommandsTest_SpawnSystemA(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~CommandsTest_SpawnSystemA() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+};
+
+struct EClass() CommandsTest_SpawnSystemB : public Runtime::System {
+    EPolyDerivedClassBody(CommandsTest_SpawnSystemB)
+
+    explicit CommandsTest_SpawnSystemB(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~CommandsTest_SpawnSystemB() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+};
+
+struct EClass() CommandsTest_VerifySystem : public Runtime::System {
+    EPolyDerivedClassBody(CommandsTest_VerifySystem)
+
+    explicit CommandsTest_VerifySystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~CommandsTest_VerifySystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+};
+
+struct EClass(globalComp) GAutomaticTest_Context {
+    EClassBody(GAutomaticTest_Context)
+
+    uint32_t tickCount;
+};
+
+class EClass(reads=Velocity, writes=Position) AutomaticTest_MoveSystem : public Runtime::System {
+    EPolyDerivedClassBody(AutomaticTest_MoveSystem)
+
+    explicit AutomaticTest_MoveSystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~AutomaticTest_MoveSystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+};
+
+class EClass(reads=Velocity) AutomaticTest_RendezvousSystemA : public Runtime::System {
+    EPolyDerivedClassBody(AutomaticTest_RendezvousSystemA)
+
+    explicit AutomaticTest_RendezvousSystemA(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~AutomaticTest_RendezvousSystemA() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+
+private:
+    uint32_t tickCount;
+};
+
+class EClass(reads=Velocity) AutomaticTest_RendezvousSystemB : public Runtime::System {
+    EPolyDerivedClassBody(AutomaticTest_RendezvousSystemB)
+
+    explicit AutomaticTest_RendezvousSystemB(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~AutomaticTest_RendezvousSystemB() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+
+private:
+    uint32_t tickCount;
+};
+
+class EClass(reads=Velocity) AutomaticTest_SpawnSystem : public Runtime::System {
+    EPolyDerivedClassBody(AutomaticTest_SpawnSystem)
+
+    explicit AutomaticTest_SpawnSystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~AutomaticTest_SpawnSystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+
+private:
+    Runtime::Entity firstTemporary;
+};
+
+class EClass(reads=Position|Velocity, writes=GAutomaticTest_Context) AutomaticTest_VerifySystem : public Runtime::System {
+    EPolyDerivedClassBody(AutomaticTest_VerifySystem)
+
+    explicit AutomaticTest_VerifySystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~AutomaticTest_VerifySystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+};
+
+struct EClass() AutomaticTest_BarrierVerifySystem : public Runtime::System {
+    EPolyDerivedClassBody(AutomaticTest_BarrierVerifySystem)
+
+    explicit AutomaticTest_BarrierVerifySystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~AutomaticTest_BarrierVerifySystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+};
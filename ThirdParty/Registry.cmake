@@ -31,6 +31,7 @@ find_package(VulkanMemoryAllocator REQUIRED GLOBAL)
 find_package(debugbreak REQUIRED GLOBAL)
 find_package(RapidJSON REQUIRED GLOBAL)
 find_package(clipp REQUIRED GLOBAL)
+find_package(lz4 REQUIRED GLOBAL)
 find_package(dxc REQUIRED GLOBAL)
 find_package(VulkanHeaders REQUIRED GLOBAL)
 find_package(VulkanLoader REQUIRED GLOBAL)
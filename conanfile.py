@@ -22,6 +22,7 @@ class ExplosionConan(ConanFile):
         self.requires("glfw/3.4")
         self.requires("rapidjson/cci.20250205")
         self.requires("imgui/1.92.8-docking")
+        self.requires("lz4/1.10.0")
         if self.settings.os == "Windows":
             self.requires("directx-headers/1.610.2")
 